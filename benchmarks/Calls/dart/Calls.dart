@@ -18,6 +18,7 @@ main() async {
   final target = Target();
   final target2 = Target2();
   final target3 = Target3();
+  final ops = <Op>[AddZero(), SubZero(), MulOne(), OrZero(), XorZero(), Neg()];
 
   // Ensure the call sites will have another target in the ICData.
   performAwaitCallsClosureTargetPolymorphic(returnAsync);
@@ -35,6 +36,7 @@ main() async {
   performSyncCallsInstanceTargetPolymorphic(target);
   performSyncCallsInstanceTargetPolymorphic(target2);
   performSyncCallsInstanceTargetPolymorphic(target3);
+  performSyncCallsInstanceTargetMegamorphic(ops);
   performAwaitAsyncCallsInstanceTargetPolymorphicManyAwaits(target);
   performAwaitAsyncCallsInstanceTargetPolymorphicManyAwaits(target2);
   performAwaitAsyncCallsInstanceTargetPolymorphicManyAwaits(target3);
@@ -91,6 +93,8 @@ main() async {
       () => performSyncCallsClosureTarget(returnSync)).report();
   SyncCallBenchmark('Calls.SyncCallInstanceTargetPolymorphic',
       () => performSyncCallsInstanceTargetPolymorphic(target)).report();
+  SyncCallBenchmark('Calls.SyncCallInstanceTargetMegamorphic',
+      () => performSyncCallsInstanceTargetMegamorphic(ops)).report();
 
   SyncCallBenchmark('Calls.IterableSyncStarIterablePolymorphic',
       () => performSyncIterationPolymorphic(generateNumbersSyncStar)).report();
@@ -276,6 +280,21 @@ int performSyncCallsInstanceTargetPolymorphic(Target target) {
   return iterationLimitSync;
 }
 
+// Dispatches on many receiver classes in turn, like the loop of an
+// interpreter.
+@pragma('vm:never-inline')
+@pragma('dart2js:noInline')
+int performSyncCallsInstanceTargetMegamorphic(List<Op> ops) {
+  int sum = 0;
+  int j = 0;
+  for (int i = 0; i < iterationLimitSync; ++i) {
+    sum += ops[j].apply(i);
+    if (++j == ops.length) j = 0;
+  }
+  if (sum != sumOfIterationLimitSync) throw 'BUG';
+  return iterationLimitSync;
+}
+
 @pragma('vm:never-inline')
 @pragma('dart2js:noInline')
 int performSyncCalls() {
@@ -500,6 +519,34 @@ class Target3 extends Target {
   int returnSync(int i) => i;
 }
 
+abstract class Op {
+  int apply(int i);
+}
+
+class AddZero extends Op {
+  int apply(int i) => i + 0;
+}
+
+class SubZero extends Op {
+  int apply(int i) => i - 0;
+}
+
+class MulOne extends Op {
+  int apply(int i) => i * 1;
+}
+
+class OrZero extends Op {
+  int apply(int i) => i | 0;
+}
+
+class XorZero extends Op {
+  int apply(int i) => i ^ 0;
+}
+
+class Neg extends Op {
+  int apply(int i) => -(-i);
+}
+
 typedef PerformSyncCallsFunction = int Function();
 typedef PerformAsyncCallsFunction = Future<int> Function();
 
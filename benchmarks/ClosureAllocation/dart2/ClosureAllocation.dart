@@ -0,0 +1,192 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Micro-benchmarks for closures passed to small higher-order functions.
+//
+// Each call of a kernel creates closures that capture local variables, and
+// so a context holding them. Once the higher-order function and the closure
+// calls are inlined, neither the closures nor the contexts escape and the VM
+// does not need to allocate them.
+//
+// After timing a kernel, the benchmark also reports the bytes of closures and
+// contexts that one run of it allocates, which should be 0 once they are
+// sunk.
+
+import 'dart:developer';
+import 'dart:isolate';
+import 'dart:math' as math;
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+import 'package:vm_service/vm_service.dart' as vm_service;
+import 'package:vm_service/vm_service_io.dart' as vm_service_io;
+
+@pragma('vm:prefer-inline')
+void forEachInt(List<int> list, void Function(int) f) {
+  for (int i = 0; i < list.length; i++) {
+    f(list[i]);
+  }
+}
+
+@pragma('vm:prefer-inline')
+int foldInt(List<int> list, int initial, int Function(int, int) combine) {
+  int value = initial;
+  for (int i = 0; i < list.length; i++) {
+    value = combine(value, list[i]);
+  }
+  return value;
+}
+
+@pragma('vm:prefer-inline')
+bool anyInt(List<int> list, bool Function(int) test) {
+  for (int i = 0; i < list.length; i++) {
+    if (test(list[i])) return true;
+  }
+  return false;
+}
+
+abstract class ClosureBenchmark extends BenchmarkBase {
+  final List<int> list = List<int>.generate(16, (i) => i);
+  int result = 0;
+
+  ClosureBenchmark(String kernel) : super('ClosureAllocation.$kernel');
+
+  // The result of a single call of the kernel.
+  int kernel(int seed);
+
+  int get expected;
+
+  void run() {
+    int sum = 0;
+    for (int i = 0; i < 1000; i++) {
+      sum += kernel(i & 1);
+    }
+    result = sum;
+  }
+
+  void teardown() {
+    if (result != expected) {
+      throw 'Unexpected result';
+    }
+  }
+}
+
+class ForEachBenchmark extends ClosureBenchmark {
+  ForEachBenchmark() : super('forEach');
+
+  // Captures a variable that the closure modifies.
+  int kernel(int seed) {
+    int sum = seed;
+    forEachInt(list, (x) {
+      sum += x;
+    });
+    return sum;
+  }
+
+  int get expected => 1000 * 120 + 500;
+}
+
+class FoldBenchmark extends ClosureBenchmark {
+  FoldBenchmark() : super('fold');
+
+  // Captures a variable that the closure only reads.
+  int kernel(int seed) {
+    final scale = seed + 1;
+    return foldInt(list, 0, (sum, x) => sum + x * scale);
+  }
+
+  int get expected => 500 * 120 + 500 * 240;
+}
+
+class AnyBenchmark extends ClosureBenchmark {
+  AnyBenchmark() : super('any');
+
+  // Captures a variable in a closure that is called conditionally.
+  int kernel(int seed) {
+    final limit = 15 + seed;
+    return anyInt(list, (x) => x >= limit) ? 1 : 0;
+  }
+
+  int get expected => 500;
+}
+
+class HeapSample {
+  final int scavenges;
+  final int bytes;
+
+  HeapSample(this.scavenges, this.bytes);
+}
+
+// Counts allocations through the allocation profile of the VM service.
+//
+// A profile taken right after a full GC finds new space empty. As long as no
+// scavenge happens afterwards, later profiles still see every object
+// allocated since then, dead or alive. Only closures and contexts are
+// counted, because the service calls themselves allocate plenty of other
+// objects.
+class AllocationCounter {
+  static const countedClasses = {'_Closure', 'Context'};
+
+  final vm_service.VmService service;
+  final String isolateId;
+
+  AllocationCounter(this.service, this.isolateId);
+
+  static Future<AllocationCounter> connect() async {
+    final info = await Service.controlWebServer(enable: true);
+    final serverUri = info.serverUri;
+    final service = await vm_service_io.vmServiceConnectUri(
+        'ws://${serverUri.authority}${serverUri.path}ws');
+    return AllocationCounter(service, Service.getIsolateID(Isolate.current));
+  }
+
+  Future<HeapSample> sample({bool gc: false}) async {
+    final profile = await service.callMethod('_getAllocationProfile',
+        isolateId: isolateId, args: gc ? {'gc': true} : {});
+    final json = profile.json;
+    int bytes = 0;
+    for (final member in json['members']) {
+      if (countedClasses.contains(member['class']['name'])) {
+        bytes += member['bytesCurrent'];
+      }
+    }
+    return HeapSample(json['_heaps']['new']['collections'], bytes);
+  }
+
+  // Returns the bytes of closures and contexts that [run] allocates.
+  Future<int> allocatedBytes(void Function() run) async {
+    for (int attempt = 0; attempt < 3; attempt++) {
+      final start = await sample(gc: true);
+      final baseline = await sample();
+      run();
+      final end = await sample();
+      if (end.scavenges == start.scavenges) {
+        // Taking a sample allocates a few closures and contexts itself, as
+        // many before the run as after it.
+        final overhead = baseline.bytes - start.bytes;
+        return math.max(0, end.bytes - baseline.bytes - overhead);
+      }
+    }
+    throw 'New space was scavenged during every measurement';
+  }
+
+  void dispose() {
+    service.dispose();
+  }
+}
+
+main() async {
+  final benchmarks = [
+    ForEachBenchmark(),
+    FoldBenchmark(),
+    AnyBenchmark(),
+  ];
+  final counter = await AllocationCounter.connect();
+  for (var bench in benchmarks) {
+    bench.report();
+    final bytes = await counter.allocatedBytes(bench.run);
+    print('${bench.name}.AllocatedBytes(MemoryUse): $bytes');
+    bench.teardown();
+  }
+  counter.dispose();
+}
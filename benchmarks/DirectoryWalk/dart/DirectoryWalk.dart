@@ -0,0 +1,61 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures walking a directory tree with Directory.walk on one thread and on
+// several, and listing it with the recursive Directory.list for comparison.
+// The walks on several threads list sibling subtrees concurrently, so they
+// should be faster than the one on a single thread on a machine with more
+// than one processor.
+
+import 'dart:io';
+
+const int topLevelDirectories = 16;
+const int subdirectories = 16;
+const int filesPerDirectory = 32;
+const int entries = topLevelDirectories * subdirectories * filesPerDirectory +
+    topLevelDirectories * subdirectories +
+    topLevelDirectories;
+
+void createTree(Directory root) {
+  for (int i = 0; i < topLevelDirectories; i++) {
+    for (int j = 0; j < subdirectories; j++) {
+      final dir = Directory('${root.path}/d$i/d$j')
+        ..createSync(recursive: true);
+      for (int k = 0; k < filesPerDirectory; k++) {
+        File('${dir.path}/f$k').createSync();
+      }
+    }
+  }
+}
+
+// Runs [run] repeatedly for about two seconds after a warm-up run, and
+// prints the time per walk.
+Future<void> report(String name, Stream<FileSystemEntity> walk()) async {
+  Future<void> run() async {
+    final count = await walk().length;
+    if (count != entries) throw 'Found $count entries, expected $entries';
+  }
+
+  await run();
+  final watch = Stopwatch()..start();
+  int runs = 0;
+  while (runs == 0 || watch.elapsedMicroseconds < 2000000) {
+    await run();
+    runs++;
+  }
+  final double us = watch.elapsedMicroseconds / runs;
+  print('DirectoryWalk.$name(RunTime): $us us.');
+}
+
+Future<void> main() async {
+  final root = Directory.systemTemp.createTempSync('directory_walk');
+  try {
+    createTree(root);
+    await report('List', () => root.list(recursive: true));
+    await report('Walk1', () => Directory.walk(root.path, concurrency: 1));
+    await report('Walk8', () => Directory.walk(root.path, concurrency: 8));
+  } finally {
+    root.deleteSync(recursive: true);
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures 4KB reads at random offsets of a file with RandomAccessFile,
+// issued from several open files at once so that they are batched by the
+// file I/O engine. The synchronous variant reads the same offsets one at a
+// time on the isolate and is the baseline for the asynchronous ones.
+
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+const int fileSize = 64 * 1024 * 1024;
+const int readSize = 4 * 1024;
+const int readsPerRun = 4096;
+
+// Offsets aligned to [readSize], the same for every run.
+final List<int> offsets = () {
+  final random = Random(42);
+  return List<int>.generate(readsPerRun,
+      (_) => random.nextInt(fileSize ~/ readSize) * readSize);
+}();
+
+Future<void> readAsync(List<RandomAccessFile> files) async {
+  final buffers = [for (int i = 0; i < files.length; i++) Uint8List(readSize)];
+  Future<void> reader(int index) async {
+    final file = files[index];
+    final buffer = buffers[index];
+    for (int i = index; i < readsPerRun; i += files.length) {
+      await file.setPosition(offsets[i]);
+      if (await file.readInto(buffer) != readSize) throw 'Short read';
+    }
+  }
+
+  await Future.wait([for (int i = 0; i < files.length; i++) reader(i)]);
+}
+
+void readSync(RandomAccessFile file) {
+  final buffer = Uint8List(readSize);
+  for (int i = 0; i < readsPerRun; i++) {
+    file.setPositionSync(offsets[i]);
+    if (file.readIntoSync(buffer) != readSize) throw 'Short read';
+  }
+}
+
+// Runs [run] repeatedly for about two seconds after a warm-up run, and
+// prints the time per read.
+Future<void> report(String name, Future<void> Function() run) async {
+  await run();
+  final watch = Stopwatch()..start();
+  int runs = 0;
+  while (runs == 0 || watch.elapsedMicroseconds < 2000000) {
+    await run();
+    runs++;
+  }
+  final double us = watch.elapsedMicroseconds / (runs * readsPerRun);
+  print('FileRandomRead.$name(RunTime): $us us.');
+}
+
+Future<void> main() async {
+  final dir = Directory.systemTemp.createTempSync('file_random_read');
+  try {
+    final file = File('${dir.path}/data');
+    final data = Uint8List(1024 * 1024);
+    final sink = file.openSync(mode: FileMode.write);
+    for (int written = 0; written < fileSize; written += data.length) {
+      sink.writeFromSync(data);
+    }
+    sink.closeSync();
+
+    final syncFile = file.openSync();
+    await report('Sync', () async => readSync(syncFile));
+    syncFile.closeSync();
+
+    for (final concurrency in [1, 16]) {
+      final files = [for (int i = 0; i < concurrency; i++) file.openSync()];
+      await report('Async$concurrency', () => readAsync(files));
+      for (final f in files) {
+        f.closeSync();
+      }
+    }
+  } finally {
+    dir.deleteSync(recursive: true);
+  }
+}
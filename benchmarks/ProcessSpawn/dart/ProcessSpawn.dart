@@ -0,0 +1,63 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures how fast processes can be started from a VM with heaps of
+// different sizes. The cost of starting a process with fork grows with the
+// size of the heap, because the page tables of the parent are copied.
+
+import 'dart:io';
+import 'dart:typed_data';
+
+const int kPageSize = 4096;
+
+// Keeps the heap alive, and touches every page so that it is resident.
+List<Uint8List> retained = <Uint8List>[];
+
+void growHeapTo(int megabytes) {
+  final current = retained.length;
+  for (int i = current; i < megabytes; i++) {
+    final chunk = Uint8List(1024 * 1024);
+    for (int j = 0; j < chunk.length; j += kPageSize) {
+      chunk[j] = 1;
+    }
+    retained.add(chunk);
+  }
+}
+
+Future<void> spawn(String executable) async {
+  final result = await Process.run(executable, const <String>[]);
+  if (result.exitCode != 0) {
+    throw 'Unexpected exit code ${result.exitCode} from $executable';
+  }
+}
+
+Future<double> measureFor(String executable, int minimumMillis) async {
+  final minimumMicros = minimumMillis * 1000;
+  final watch = Stopwatch()..start();
+  int spawns = 0;
+  while (watch.elapsedMicroseconds < minimumMicros) {
+    await spawn(executable);
+    spawns++;
+  }
+  return watch.elapsedMicroseconds / spawns;
+}
+
+Future<void> report(String executable, int heapMegabytes) async {
+  growHeapTo(heapMegabytes);
+  await measureFor(executable, 500); // warm-up
+  final double us = await measureFor(executable, 2000);
+  final name = 'ProcessSpawn.Heap${heapMegabytes}MB';
+  print('$name(RunTime): $us us.');
+  print('$name(SpawnsPerSecond): ${1000000 ~/ us}');
+}
+
+Future<void> main() async {
+  if (Platform.isWindows) {
+    return;
+  }
+  final executable = File('/bin/true').existsSync() ? '/bin/true' : 'true';
+  for (final megabytes in [0, 256, 1024, 2048]) {
+    await report(executable, megabytes);
+  }
+}
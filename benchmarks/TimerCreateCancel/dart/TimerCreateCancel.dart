@@ -0,0 +1,58 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures the cost of resetting idle timeouts: canceling one of many active
+// long timers and creating a new one in its place. Run with and without
+// --timer-wheel to compare the timer heap with the native timer wheel.
+
+import 'dart:async';
+
+const int batchSize = 1000;
+
+int seed = 42;
+
+int nextRandom(int max) {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed % max;
+}
+
+void neverCalled() {
+  throw 'Timer fired during the benchmark';
+}
+
+// Idle timeouts between one and two minutes, which do not fire while the
+// benchmark runs.
+Timer newTimer() =>
+    Timer(Duration(milliseconds: 60000 + nextRandom(60000)), neverCalled);
+
+// Returns the time to cancel and recreate a batch of timers.
+double measureFor(List<Timer> timers, int minimumMillis) {
+  final minimumMicros = minimumMillis * 1000;
+  final watch = Stopwatch()..start();
+  int batches = 0;
+  while (batches == 0 || watch.elapsedMicroseconds < minimumMicros) {
+    for (int i = 0; i < batchSize; i++) {
+      final index = nextRandom(timers.length);
+      timers[index].cancel();
+      timers[index] = newTimer();
+    }
+    batches++;
+  }
+  return watch.elapsedMicroseconds / batches;
+}
+
+void report(String variant, int active) {
+  final timers = List<Timer>.generate(active, (_) => newTimer());
+  measureFor(timers, 500); // warm-up
+  final double us = measureFor(timers, 2000);
+  print('TimerCreateCancel.$variant(RunTime): $us us.');
+  for (final timer in timers) {
+    timer.cancel();
+  }
+}
+
+void main() {
+  report('Active1K', 1000);
+  report('Active1M', 1000000);
+}
@@ -0,0 +1,279 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Micro-benchmarks for simple loops over typed data lists.
+//
+// The map kernels compute each element of a Float64List from the elements of
+// other lists at the same index, which the VM can do two elements at a time.
+// The reduce kernels combine all elements of a Float64List or an Int32List
+// into a single value.
+//
+// All kernels are counted loops that the VM unrolls. Compare with a run under
+// --no-unroll-loops to measure the unrolling.
+
+import 'dart:typed_data';
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+abstract class Float64ListBenchmark extends BenchmarkBase {
+  final int size;
+  Float64List x;
+  Float64List y;
+  Float64List result;
+
+  Float64ListBenchmark(String kernel, this.size)
+      : super('TypedDataLoops.Float64List.$kernel.$size');
+
+  void setup() {
+    x = Float64List(size);
+    y = Float64List(size);
+    result = Float64List(size);
+    for (int i = 0; i < size; ++i) {
+      x[i] = (i % 17).toDouble();
+      y[i] = (i % 5).toDouble();
+    }
+  }
+
+  void warmup() {
+    for (int i = 0; i < 100; ++i) {
+      run();
+    }
+  }
+
+  // The value of the element at [i] after run.
+  double expected(int i);
+
+  void teardown() {
+    for (int i = 0; i < size; ++i) {
+      if (result[i] != expected(i)) {
+        throw 'Unexpected result';
+      }
+    }
+  }
+}
+
+class Float64ListScaleBenchmark extends Float64ListBenchmark {
+  Float64ListScaleBenchmark(int size) : super('scale', size);
+
+  void run() {
+    final x = this.x;
+    final result = this.result;
+    for (int i = 0; i < x.length; i++) {
+      result[i] = x[i] * 2.5;
+    }
+  }
+
+  double expected(int i) => (i % 17) * 2.5;
+}
+
+class Float64ListAddBenchmark extends Float64ListBenchmark {
+  Float64ListAddBenchmark(int size) : super('add', size);
+
+  void run() {
+    final x = this.x;
+    final y = this.y;
+    final result = this.result;
+    for (int i = 0; i < x.length; i++) {
+      result[i] = x[i] + y[i];
+    }
+  }
+
+  double expected(int i) => (i % 17) + (i % 5).toDouble();
+}
+
+class Float64ListAxpyBenchmark extends Float64ListBenchmark {
+  Float64ListAxpyBenchmark(int size) : super('axpy', size);
+
+  void run() {
+    final x = this.x;
+    final y = this.y;
+    final result = this.result;
+    for (int i = 0; i < x.length; i++) {
+      result[i] = 3.0 * x[i] + y[i];
+    }
+  }
+
+  double expected(int i) => 3.0 * (i % 17) + (i % 5);
+}
+
+class Float64ListFillBenchmark extends Float64ListBenchmark {
+  Float64ListFillBenchmark(int size) : super('fill', size);
+
+  void run() {
+    final result = this.result;
+    for (int i = 0; i < result.length; i++) {
+      result[i] = 1.5;
+    }
+  }
+
+  double expected(int i) => 1.5;
+}
+
+abstract class ReduceBenchmark extends BenchmarkBase {
+  final int size;
+  num result;
+
+  ReduceBenchmark(String list, String kernel, this.size)
+      : super('TypedDataLoops.$list.$kernel.$size');
+
+  void warmup() {
+    for (int i = 0; i < 100; ++i) {
+      run();
+    }
+  }
+
+  num get expected;
+
+  void teardown() {
+    if (result != expected) {
+      throw 'Unexpected result';
+    }
+  }
+}
+
+class Float64ListSumBenchmark extends ReduceBenchmark {
+  Float64List x;
+
+  Float64ListSumBenchmark(int size) : super('Float64List', 'sum', size);
+
+  void setup() {
+    x = Float64List(size);
+    for (int i = 0; i < size; ++i) {
+      x[i] = (i % 17).toDouble();
+    }
+  }
+
+  void run() {
+    final x = this.x;
+    double sum = 0.0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i];
+    }
+    result = sum;
+  }
+
+  num get expected {
+    double sum = 0.0;
+    for (int i = 0; i < size; ++i) {
+      sum += i % 17;
+    }
+    return sum;
+  }
+}
+
+class Float64ListDotBenchmark extends ReduceBenchmark {
+  Float64List x;
+  Float64List y;
+
+  Float64ListDotBenchmark(int size) : super('Float64List', 'dot', size);
+
+  void setup() {
+    x = Float64List(size);
+    y = Float64List(size);
+    for (int i = 0; i < size; ++i) {
+      x[i] = (i % 17).toDouble();
+      y[i] = (i % 5).toDouble();
+    }
+  }
+
+  void run() {
+    final x = this.x;
+    final y = this.y;
+    double sum = 0.0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i] * y[i];
+    }
+    result = sum;
+  }
+
+  num get expected {
+    double sum = 0.0;
+    for (int i = 0; i < size; ++i) {
+      sum += (i % 17) * (i % 5);
+    }
+    return sum;
+  }
+}
+
+class Int32ListSumBenchmark extends ReduceBenchmark {
+  Int32List x;
+
+  Int32ListSumBenchmark(int size) : super('Int32List', 'sum', size);
+
+  void setup() {
+    x = Int32List(size);
+    for (int i = 0; i < size; ++i) {
+      x[i] = i % 1000 - 500;
+    }
+  }
+
+  void run() {
+    final x = this.x;
+    int sum = 0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i];
+    }
+    result = sum;
+  }
+
+  num get expected {
+    int sum = 0;
+    for (int i = 0; i < size; ++i) {
+      sum += i % 1000 - 500;
+    }
+    return sum;
+  }
+}
+
+class Int32ListMaxBenchmark extends ReduceBenchmark {
+  Int32List x;
+
+  Int32ListMaxBenchmark(int size) : super('Int32List', 'max', size);
+
+  void setup() {
+    x = Int32List(size);
+    for (int i = 0; i < size; ++i) {
+      x[i] = (i * 7919) % 10007;
+    }
+  }
+
+  void run() {
+    final x = this.x;
+    int max = x[0];
+    for (int i = 1; i < x.length; i++) {
+      if (x[i] > max) max = x[i];
+    }
+    result = max;
+  }
+
+  num get expected {
+    int max = 0;
+    for (int i = 0; i < size; ++i) {
+      final value = (i * 7919) % 10007;
+      if (value > max) max = value;
+    }
+    return max;
+  }
+}
+
+main() {
+  final sizes = [8, 256, 16384];
+  final benchmarks = [
+    for (int size in sizes) ...[
+      Float64ListScaleBenchmark(size),
+      Float64ListAddBenchmark(size),
+      Float64ListAxpyBenchmark(size),
+      Float64ListFillBenchmark(size),
+    ],
+    for (int size in sizes) ...[
+      Float64ListSumBenchmark(size),
+      Float64ListDotBenchmark(size),
+      Int32ListSumBenchmark(size),
+      Int32ListMaxBenchmark(size),
+    ],
+  ];
+  for (var bench in benchmarks) {
+    bench.report();
+  }
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures the throughput of gzip compression of inputs of different sizes,
+// on a single thread and with the parallel deflate filter.
+
+import 'dart:io';
+import 'dart:typed_data';
+
+const List<String> words = <String>[
+  'the', 'quick', 'brown', 'fox', 'jumps', 'over', 'lazy', 'dog', 'lorem', //
+  'ipsum', 'dolor', 'sit', 'amet', 'consectetur', 'adipiscing', 'elit', //
+  'sed', 'do', 'eiusmod', 'tempor', 'incididunt', 'ut', 'labore', 'et', //
+];
+
+// Text-like input, which compresses about as well as typical HTTP bodies.
+Uint8List generateInput(int size) {
+  final input = Uint8List(size);
+  int seed = 42;
+  int i = 0;
+  while (i < size) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    final word = words[(seed >> 16) % words.length];
+    for (int j = 0; j < word.length && i < size; j++) {
+      input[i++] = word.codeUnitAt(j);
+    }
+    if (i < size) {
+      input[i++] = (seed & 0xf) == 0 ? 10 : 32;
+    }
+  }
+  return input;
+}
+
+double measureFor(GZipCodec codec, Uint8List input, int minimumMillis) {
+  final minimumMicros = minimumMillis * 1000;
+  final watch = Stopwatch()..start();
+  int runs = 0;
+  int compressed = 0;
+  while (runs == 0 || watch.elapsedMicroseconds < minimumMicros) {
+    compressed += codec.encode(input).length;
+    runs++;
+  }
+  if (compressed == 0) {
+    throw 'Unexpected empty output';
+  }
+  return watch.elapsedMicroseconds / runs;
+}
+
+void report(String variant, GZipCodec codec, Uint8List input, String size) {
+  measureFor(codec, input, 500); // warm-up
+  final double us = measureFor(codec, input, 2000);
+  final name = 'ZLibDeflate.$variant.$size';
+  print('$name(RunTime): $us us.');
+  print('$name(MBPerSecond): ${(input.length / us).toStringAsFixed(2)}');
+}
+
+void main() {
+  final sizes = <String, int>{
+    '1KB': 1024,
+    '64KB': 64 * 1024,
+    '1MB': 1024 * 1024,
+    '100MB': 100 * 1024 * 1024,
+  };
+  for (final size in sizes.keys) {
+    final input = generateInput(sizes[size]);
+    report('Serial', GZipCodec(), input, size);
+    report('Parallel', GZipCodec(parallel: true), input, size);
+  }
+}
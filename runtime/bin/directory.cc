@@ -8,6 +8,7 @@
 #include "bin/directory.h"
 
 #include "bin/dartutils.h"
+#include "bin/file.h"
 #include "bin/io_buffer.h"
 #include "bin/namespace.h"
 #include "bin/typed_data_utils.h"
@@ -15,6 +16,7 @@
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
@@ -361,16 +363,25 @@ CObject* Directory::ListStartRequest(const CObjectArray& request) {
   }
   Namespace* namespc = CObjectToNamespacePointer(request[0]);
   RefCntReleaseScope<Namespace> rs(namespc);
-  if ((request.Length() != 4) || !request[1]->IsUint8Array() ||
-      !request[2]->IsBool() || !request[3]->IsBool()) {
+  if (((request.Length() != 4) && (request.Length() != 5)) ||
+      !request[1]->IsUint8Array() || !request[2]->IsBool() ||
+      !request[3]->IsBool()) {
     return CreateIllegalArgumentError();
   }
   CObjectUint8Array path(request[1]);
   CObjectBool recursive(request[2]);
   CObjectBool follow_links(request[3]);
+  bool with_stat = false;
+  if (request.Length() == 5) {
+    if (!request[4]->IsBool()) {
+      return CreateIllegalArgumentError();
+    }
+    CObjectBool with_stat_object(request[4]);
+    with_stat = with_stat_object.Value();
+  }
   AsyncDirectoryListing* dir_listing = new AsyncDirectoryListing(
       namespc, reinterpret_cast<const char*>(path.Buffer()), recursive.Value(),
-      follow_links.Value());
+      follow_links.Value(), with_stat);
   if (dir_listing->error()) {
     // Report error now, so we capture the correct OSError.
     CObject* err = CObject::NewOSError();
@@ -402,6 +413,7 @@ CObject* Directory::ListNextRequest(const CObjectArray& request) {
   CObjectArray* response = new CObjectArray(CObject::NewArray(kArraySize));
   dir_listing->SetArray(response, kArraySize);
   Directory::List(dir_listing);
+  dir_listing->FinishArray();
   // In case the listing ended before it hit the buffer length, we need to
   // override the array length.
   response->AsApiCObject()->value.as_array.length = dir_listing->index();
@@ -446,8 +458,61 @@ CObject* Directory::RenameRequest(const CObjectArray& request) {
              : CObject::NewOSError();
 }
 
+void AsyncDirectoryListing::SetArray(CObjectArray* array, intptr_t length) {
+  ASSERT(length % 2 == 0);
+  array_ = array;
+  index_ = 0;
+  length_ = length;
+  if (with_stat_) {
+    // Reserve the first entry for the packed entries.
+    array_->SetAt(index_++, new CObjectInt32(CObject::NewInt32(kListStat)));
+    array_->SetAt(index_++, CObject::Null());
+  }
+}
+
+void AsyncDirectoryListing::FinishArray() {
+  if (!with_stat_ || (packed_length_ == 0)) {
+    return;
+  }
+  array_->SetAt(1, new CObjectExternalUint8Array(CObject::NewExternalUint8Array(
+                       packed_length_, packed_, packed_, IOBuffer::Finalizer)));
+  packed_ = NULL;
+  packed_length_ = 0;
+  packed_capacity_ = 0;
+}
+
+bool AsyncDirectoryListing::AddPackedEntry(Response type, const char* arg) {
+  const intptr_t path_length = strlen(arg);
+  const intptr_t record_size =
+      Utils::RoundUp(kPackedHeaderSize + path_length, sizeof(int64_t));
+  if (packed_length_ + record_size > packed_capacity_) {
+    intptr_t capacity = Utils::Maximum(packed_capacity_ * 2,
+                                       packed_length_ + record_size);
+    capacity = Utils::Maximum(capacity, 4 * KB);
+    uint8_t* packed = reinterpret_cast<uint8_t*>(realloc(packed_, capacity));
+    if (packed == NULL) {
+      return HandleError();
+    }
+    packed_ = packed;
+    packed_capacity_ = capacity;
+  }
+  uint8_t* record = packed_ + packed_length_;
+  memset(record, 0, record_size);
+  int64_t stat[File::kStatSize];
+  top()->Stat(this, stat);
+  memmove(record, stat, kPackedStatSize);
+  int32_t header[2] = {type, static_cast<int32_t>(path_length)};
+  memmove(record + kPackedStatSize, header, sizeof(header));
+  memmove(record + kPackedHeaderSize, arg, path_length);
+  packed_length_ += record_size;
+  return packed_length_ < kPackedBatchSize;
+}
+
 bool AsyncDirectoryListing::AddFileSystemEntityToResponse(Response type,
                                                           const char* arg) {
+  if (with_stat_ && (arg != NULL)) {
+    return AddPackedEntry(type, arg);
+  }
   array_->SetAt(index_++, new CObjectInt32(CObject::NewInt32(type)));
   if (arg != NULL) {
     size_t len = strlen(arg);
@@ -591,11 +656,15 @@ static bool ListNext(DirectoryListing* listing) {
     case kListLink:
       return listing->HandleLink(listing->CurrentPath());
 
-    case kListDirectory:
+    case kListDirectory: {
+      // Handle the directory before descending into it, so that the handler
+      // can still look at the entry in the listing of its parent.
+      bool more = listing->HandleDirectory(listing->CurrentPath());
       if (listing->recursive()) {
         listing->Push(new DirectoryListingEntry(listing->top()));
       }
-      return listing->HandleDirectory(listing->CurrentPath());
+      return more;
+    }
 
     case kListError:
       return listing->HandleError();
@@ -615,6 +684,12 @@ static bool ListNext(DirectoryListing* listing) {
   return false;
 }
 
+#if !defined(HOST_OS_LINUX)
+void DirectoryListingEntry::Stat(DirectoryListing* listing, int64_t* data) {
+  File::Stat(listing->namespc(), listing->CurrentPath(), data);
+}
+#endif  // !defined(HOST_OS_LINUX)
+
 void Directory::List(DirectoryListing* listing) {
   if (listing->error()) {
     listing->HandleError();
@@ -7,6 +7,7 @@
 
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/file.h"
 #include "bin/namespace.h"
 #include "bin/reference_counting.h"
 #include "bin/thread.h"
@@ -69,6 +70,9 @@ class DirectoryListingEntry {
 
   ListType Next(DirectoryListing* listing);
 
+  // Fills |data| as File::Stat does for the entry last returned by Next.
+  void Stat(DirectoryListing* listing, int64_t* data);
+
   DirectoryListingEntry* parent() const { return parent_; }
 
   LinkList* link() { return link_; }
@@ -161,18 +165,30 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
     kListDirectory = 1,
     kListLink = 2,
     kListError = 3,
-    kListDone = 4
+    kListDone = 4,
+    kListStat = 5
   };
 
+  // When |with_stat| is set, files, directories and links are not added to
+  // the response array as separate entries. Instead each is packed together
+  // with its File::Stat data into a single Uint8List, which is the first
+  // entry of the response, tagged kListStat. A packed record is laid out as
+  // kPackedStatSize bytes of stat data, then the list type and the path
+  // length as 32-bit integers, then the path, padded to a multiple of 8.
   AsyncDirectoryListing(Namespace* namespc,
                         const char* dir_name,
                         bool recursive,
-                        bool follow_links)
+                        bool follow_links,
+                        bool with_stat = false)
       : ReferenceCounted(),
         DirectoryListing(namespc, dir_name, recursive, follow_links),
         array_(NULL),
         index_(0),
-        length_(0) {}
+        length_(0),
+        with_stat_(with_stat),
+        packed_(NULL),
+        packed_length_(0),
+        packed_capacity_(0) {}
 
   virtual bool HandleDirectory(const char* dir_name);
   virtual bool HandleFile(const char* file_name);
@@ -180,21 +196,30 @@ class AsyncDirectoryListing : public ReferenceCounted<AsyncDirectoryListing>,
   virtual bool HandleError();
   virtual void HandleDone();
 
-  void SetArray(CObjectArray* array, intptr_t length) {
-    ASSERT(length % 2 == 0);
-    array_ = array;
-    index_ = 0;
-    length_ = length;
-  }
+  void SetArray(CObjectArray* array, intptr_t length);
+
+  // Stores the packed entries in the response array. Must be called once the
+  // listing has filled the array.
+  void FinishArray();
 
   intptr_t index() const { return index_; }
 
+  static const intptr_t kPackedStatSize = File::kStatSize * sizeof(int64_t);
+  static const intptr_t kPackedHeaderSize = kPackedStatSize + 8;
+  // A response is finished once this many bytes of entries have been packed.
+  static const intptr_t kPackedBatchSize = 64 * KB;
+
  private:
-  virtual ~AsyncDirectoryListing() {}
+  virtual ~AsyncDirectoryListing() { free(packed_); }
   bool AddFileSystemEntityToResponse(Response response, const char* arg);
+  bool AddPackedEntry(Response response, const char* arg);
   CObjectArray* array_;
   intptr_t index_;
   intptr_t length_;
+  bool with_stat_;
+  uint8_t* packed_;
+  intptr_t packed_length_;
+  intptr_t packed_capacity_;
 
   friend class ReferenceCounted<AsyncDirectoryListing>;
   DISALLOW_IMPLICIT_CONSTRUCTORS(AsyncDirectoryListing);
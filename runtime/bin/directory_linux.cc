@@ -14,6 +14,7 @@
 #include <string.h>     // NOLINT
 #include <sys/param.h>  // NOLINT
 #include <sys/stat.h>   // NOLINT
+#include <sys/syscall.h>  // NOLINT
 #include <unistd.h>     // NOLINT
 
 #include "bin/crypto.h"
@@ -80,6 +81,37 @@ struct LinkList {
   LinkList* next;
 };
 
+// The layout of the records returned by getdents64.
+struct LinuxDirent64 {
+  ino64_t d_ino;
+  off64_t d_off;
+  unsigned short d_reclen;  // NOLINT
+  unsigned char d_type;
+  char d_name[1];
+};
+
+// Directory entries are read with getdents64 into this buffer, which is
+// large enough to read most directories with a single system call.
+struct DirectoryBuffer {
+  static const intptr_t kSize = 32 * KB;
+
+  DirectoryBuffer() : position(0), length(0) {}
+
+  intptr_t position;
+  intptr_t length;
+  union {
+    LinuxDirent64 align;
+    char data[kSize];
+  };
+};
+
+void DirectoryListingEntry::Stat(DirectoryListing* listing, int64_t* data) {
+  // Stat the entry relative to the directory being listed, which saves
+  // resolving the full path again for every entry.
+  const char* name = listing->path_buffer().AsString() + path_length_;
+  File::StatAt(fd_, name, data);
+}
+
 ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
   if (done_) {
     return kListDone;
@@ -98,13 +130,7 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
   }
 
   if (lister_ == 0) {
-    do {
-      lister_ = reinterpret_cast<intptr_t>(fdopendir(fd_));
-    } while ((lister_ == 0) && (errno == EINTR));
-    if (lister_ == 0) {
-      done_ = true;
-      return kListError;
-    }
+    lister_ = reinterpret_cast<intptr_t>(new DirectoryBuffer());
     if (parent_ != NULL) {
       if (!listing->path_buffer().Add(File::PathSeparator())) {
         return kListError;
@@ -118,9 +144,21 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
 
   // Iterate the directory and post the directories and files to the
   // ports.
-  errno = 0;
-  dirent* entry = readdir(reinterpret_cast<DIR*>(lister_));
-  if (entry != NULL) {
+  DirectoryBuffer* buffer = reinterpret_cast<DirectoryBuffer*>(lister_);
+  if (buffer->position >= buffer->length) {
+    intptr_t bytes = TEMP_FAILURE_RETRY(
+        syscall(SYS_getdents64, fd_, buffer->data, DirectoryBuffer::kSize));
+    if (bytes < 0) {
+      done_ = true;
+      return kListError;
+    }
+    buffer->position = 0;
+    buffer->length = bytes;
+  }
+  if (buffer->position < buffer->length) {
+    LinuxDirent64* entry =
+        reinterpret_cast<LinuxDirent64*>(buffer->data + buffer->position);
+    buffer->position += entry->d_reclen;
     if (!listing->path_buffer().Add(entry->d_name)) {
       done_ = true;
       return kListError;
@@ -213,19 +251,14 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
     }
   }
   done_ = true;
-
-  if (errno != 0) {
-    return kListError;
-  }
-
   return kListDone;
 }
 
 DirectoryListingEntry::~DirectoryListingEntry() {
   ResetLink();
-  if (lister_ != 0) {
-    // This also closes fd_.
-    VOID_NO_RETRY_EXPECTED(closedir(reinterpret_cast<DIR*>(lister_)));
+  delete reinterpret_cast<DirectoryBuffer*>(lister_);
+  if (fd_ != -1) {
+    VOID_NO_RETRY_EXPECTED(close(fd_));
   }
 }
 
@@ -0,0 +1,571 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/directory_walker.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bin/dartutils.h"
+#include "bin/directory.h"
+#include "bin/file.h"
+#include "bin/io_buffer.h"
+#include "bin/lockers.h"
+#include "include/dart_api.h"
+#include "include/dart_native_api.h"
+#include "platform/utils.h"
+
+namespace dart {
+namespace bin {
+
+static const intptr_t kInitialQueueCapacity = 64;
+
+// Returns the last component of |path|.
+static const char* EntryName(const char* path) {
+  const char separator = File::PathSeparator()[0];
+  const char* name = path;
+  for (const char* p = path; *p != '\0'; p++) {
+    if ((*p == '/') || (*p == separator)) {
+      name = p + 1;
+    }
+  }
+  return name;
+}
+
+// Matches |c| against the character class that starts at |pattern|, just
+// after its '['. Returns the end of the class, just after its ']', or NULL if
+// the class is not terminated.
+static const char* MatchClass(const char* pattern, uint8_t c, bool* matched) {
+  bool negated = false;
+  if (*pattern == '!') {
+    negated = true;
+    pattern++;
+  }
+  bool found = false;
+  // A ']' at the start of the class is part of it.
+  do {
+    if (*pattern == '\0') {
+      return NULL;
+    }
+    uint8_t low = static_cast<uint8_t>(*pattern++);
+    uint8_t high = low;
+    if ((pattern[0] == '-') && (pattern[1] != ']') && (pattern[1] != '\0')) {
+      high = static_cast<uint8_t>(pattern[1]);
+      pattern += 2;
+    }
+    if ((low <= c) && (c <= high)) {
+      found = true;
+    }
+  } while (*pattern != ']');
+  *matched = (found != negated);
+  return pattern + 1;
+}
+
+bool DirectoryWalker::MatchGlob(const char* pattern, const char* name) {
+  // On a mismatch, the last '*' is made to match one more character of the
+  // name, and matching starts over from just after it.
+  const char* star = NULL;
+  const char* star_name = NULL;
+  while (*name != '\0') {
+    if (*pattern == '*') {
+      star = ++pattern;
+      star_name = name;
+      continue;
+    }
+    if (*pattern != '\0') {
+      bool matched;
+      const char* next = pattern + 1;
+      if (*pattern == '?') {
+        matched = true;
+      } else if (*pattern == '[') {
+        const char* end =
+            MatchClass(pattern + 1, static_cast<uint8_t>(*name), &matched);
+        if (end != NULL) {
+          next = end;
+        } else {
+          // An unterminated '[' is matched literally.
+          matched = (*name == '[');
+        }
+      } else {
+        matched = (*pattern == *name);
+      }
+      if (matched) {
+        pattern = next;
+        name++;
+        continue;
+      }
+    }
+    if (star == NULL) {
+      return false;
+    }
+    pattern = star;
+    name = ++star_name;
+  }
+  while (*pattern == '*') {
+    pattern++;
+  }
+  return *pattern == '\0';
+}
+
+// The entries found by one worker that have not been posted yet.
+class DirectoryWalker::Batch {
+ public:
+  explicit Batch(Dart_Port reply_port)
+      : reply_port_(reply_port), data_(NULL), length_(0), capacity_(0) {}
+
+  ~Batch() {
+    if (data_ != NULL) {
+      IOBuffer::Free(data_);
+    }
+  }
+
+  bool IsEmpty() const { return length_ == 0; }
+
+  void Add(int32_t type, const char* path) {
+    const intptr_t path_length = strlen(path);
+    const intptr_t record_size =
+        Utils::RoundUp(kHeaderSize + path_length, kRecordAlignment);
+    if ((data_ != NULL) && (length_ + record_size > capacity_)) {
+      Post();
+    }
+    if (data_ == NULL) {
+      capacity_ = Utils::Maximum(kBatchSize, record_size);
+      // The buffer is zeroed, so the padding of the records is too.
+      data_ = IOBuffer::Allocate(capacity_);
+      if (data_ == NULL) {
+        OUT_OF_MEMORY();
+      }
+    }
+    int32_t header[2] = {type, static_cast<int32_t>(path_length)};
+    memmove(data_ + length_, header, sizeof(header));
+    memmove(data_ + length_ + kHeaderSize, path, path_length);
+    length_ += record_size;
+  }
+
+  void Post() {
+    if (length_ == 0) {
+      return;
+    }
+    Dart_CObject batch;
+    batch.type = Dart_CObject_kExternalTypedData;
+    batch.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    batch.value.as_external_typed_data.length = length_;
+    batch.value.as_external_typed_data.data = data_;
+    batch.value.as_external_typed_data.peer = data_;
+    batch.value.as_external_typed_data.callback = IOBuffer::Finalizer;
+    if (!Dart_PostCObject(reply_port_, &batch)) {
+      IOBuffer::Free(data_);
+    }
+    // Otherwise the receiving isolate now owns the buffer.
+    data_ = NULL;
+    length_ = 0;
+    capacity_ = 0;
+  }
+
+ private:
+  static const intptr_t kHeaderSize = 2 * sizeof(int32_t);
+  static const intptr_t kRecordAlignment = 8;
+
+  const Dart_Port reply_port_;
+  uint8_t* data_;
+  intptr_t length_;
+  intptr_t capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(Batch);
+};
+
+// Lists a single directory for a worker.
+class DirectoryWalker::Listing : public DirectoryListing {
+ public:
+  Listing(DirectoryWalker* walker, const char* path, Batch* batch)
+      : DirectoryListing(walker->namespc_, path, false, false),
+        walker_(walker),
+        batch_(batch) {}
+
+  virtual bool HandleDirectory(const char* dir_name) {
+    return walker_->HandleDirectory(batch_, dir_name);
+  }
+
+  virtual bool HandleFile(const char* file_name) {
+    return walker_->HandleEntry(batch_, kListFile, file_name);
+  }
+
+  virtual bool HandleLink(const char* link_name) {
+    return walker_->HandleEntry(batch_, kListLink, link_name);
+  }
+
+  virtual bool HandleError() {
+    // Create the OS error before calling CurrentPath(), which may change the
+    // OS error code.
+    CObject* os_error = CObject::NewOSError();
+    CObjectArray response(CObject::NewArray(3));
+    response.SetAt(0, new CObjectInt32(CObject::NewInt32(kListError)));
+    response.SetAt(1, error() ? CObject::Null()
+                              : new CObjectString(
+                                    CObject::NewString(CurrentPath())));
+    response.SetAt(2, os_error);
+    Dart_PostCObject(walker_->reply_port_, response.AsApiCObject());
+    return !walker_->stopped_;
+  }
+
+ private:
+  DirectoryWalker* walker_;
+  Batch* batch_;
+
+  DISALLOW_COPY_AND_ASSIGN(Listing);
+};
+
+Mutex* DirectoryWalker::mutex_ = NULL;
+Dart_Port DirectoryWalker::work_ports_[DirectoryWalker::kMaxConcurrency];
+intptr_t DirectoryWalker::next_work_port_ = 0;
+
+DirectoryWalker::DirectoryWalker(Namespace* namespc,
+                                 const char* root,
+                                 Dart_Port reply_port,
+                                 char** include,
+                                 intptr_t include_count,
+                                 char** exclude,
+                                 intptr_t exclude_count,
+                                 intptr_t concurrency)
+    : ReferenceCounted(),
+      namespc_(namespc),
+      reply_port_(reply_port),
+      include_(include),
+      include_count_(include_count),
+      exclude_(exclude),
+      exclude_count_(exclude_count),
+      concurrency_(concurrency),
+      queue_(NULL),
+      queue_length_(0),
+      queue_capacity_(kInitialQueueCapacity),
+      workers_(0),
+      paused_(false),
+      stopped_(false) {
+  namespc_->Retain();
+  queue_ = reinterpret_cast<char**>(malloc(queue_capacity_ * sizeof(char*)));
+  char* root_copy = strdup(root);
+  if ((queue_ == NULL) || (root_copy == NULL)) {
+    OUT_OF_MEMORY();
+  }
+  queue_[queue_length_++] = root_copy;
+}
+
+DirectoryWalker::~DirectoryWalker() {
+  for (intptr_t i = 0; i < queue_length_; i++) {
+    free(queue_[i]);
+  }
+  free(queue_);
+  for (intptr_t i = 0; i < include_count_; i++) {
+    free(include_[i]);
+  }
+  free(include_);
+  for (intptr_t i = 0; i < exclude_count_; i++) {
+    free(exclude_[i]);
+  }
+  free(exclude_);
+  namespc_->Release();
+}
+
+void DirectoryWalker::Initialize() {
+  ASSERT(mutex_ == NULL);
+  mutex_ = new Mutex();
+  for (intptr_t i = 0; i < kMaxConcurrency; i++) {
+    work_ports_[i] = ILLEGAL_PORT;
+  }
+  next_work_port_ = 0;
+}
+
+void DirectoryWalker::Cleanup() {
+  if (mutex_ == NULL) {
+    return;
+  }
+  // This is called after the VM has shut down, which closed the work ports.
+  for (intptr_t i = 0; i < kMaxConcurrency; i++) {
+    work_ports_[i] = ILLEGAL_PORT;
+  }
+  delete mutex_;
+  mutex_ = NULL;
+}
+
+bool DirectoryWalker::Start() {
+  {
+    MutexLocker ml(mutex_);
+    // Workers run as messages to native ports, so that the listings have an
+    // API scope to allocate in. Each port has its own thread while it has
+    // messages to handle.
+    for (intptr_t i = 0; i < kMaxConcurrency; i++) {
+      if (work_ports_[i] == ILLEGAL_PORT) {
+        work_ports_[i] =
+            Dart_NewNativePort("DirectoryWalker", WorkCallback, false);
+        if (work_ports_[i] == ILLEGAL_PORT) {
+          return false;
+        }
+      }
+    }
+  }
+  MutexLocker ml(&queue_mutex_);
+  return StartWorkersLocked();
+}
+
+Dart_Port DirectoryWalker::NextWorkPort() {
+  MutexLocker ml(mutex_);
+  Dart_Port port = work_ports_[next_work_port_];
+  next_work_port_ = (next_work_port_ + 1) % kMaxConcurrency;
+  return port;
+}
+
+bool DirectoryWalker::StartWorkersLocked() {
+  // A worker started for a directory another worker takes first finds the
+  // queue empty and stops again.
+  for (intptr_t i = 0;
+       !paused_ && !stopped_ && (i < queue_length_) && (workers_ < concurrency_);
+       i++) {
+    Dart_CObject message;
+    message.type = Dart_CObject_kInt64;
+    message.value.as_int64 = reinterpret_cast<intptr_t>(this);
+    // The reference is released when the worker stops.
+    Retain();
+    if (!Dart_PostCObject(NextWorkPort(), &message)) {
+      Release();
+      return false;
+    }
+    workers_++;
+  }
+  return true;
+}
+
+void DirectoryWalker::WorkCallback(Dart_Port dest_port_id,
+                                   Dart_CObject* message) {
+  CObjectIntptr pointer(message);
+  DirectoryWalker* walker = reinterpret_cast<DirectoryWalker*>(pointer.Value());
+  walker->Work();
+  walker->Release();
+}
+
+void DirectoryWalker::Work() {
+  Batch batch(reply_port_);
+  bool done = false;
+  while (true) {
+    char* path = NULL;
+    {
+      MutexLocker ml(&queue_mutex_);
+      if (!stopped_ && !paused_ && (queue_length_ > 0)) {
+        path = queue_[--queue_length_];
+      } else if (batch.IsEmpty() || stopped_) {
+        workers_--;
+        done = (workers_ == 0) && (queue_length_ == 0) && !stopped_;
+        break;
+      }
+    }
+    if (path == NULL) {
+      // Post the entries found so far before giving up on finding more, and
+      // check the queue again, as another worker may have added to it
+      // meanwhile.
+      batch.Post();
+      continue;
+    }
+    Listing listing(this, path, &batch);
+    Directory::List(&listing);
+    free(path);
+  }
+  // Every other worker has stopped, and has posted its entries.
+  if (done) {
+    PostDone();
+  }
+}
+
+void DirectoryWalker::Pause() {
+  MutexLocker ml(&queue_mutex_);
+  paused_ = true;
+}
+
+void DirectoryWalker::Resume() {
+  MutexLocker ml(&queue_mutex_);
+  paused_ = false;
+  StartWorkersLocked();
+}
+
+void DirectoryWalker::Stop() {
+  stopped_ = true;
+  MutexLocker ml(&queue_mutex_);
+  for (intptr_t i = 0; i < queue_length_; i++) {
+    free(queue_[i]);
+  }
+  queue_length_ = 0;
+}
+
+bool DirectoryWalker::IsExcluded(const char* name) const {
+  for (intptr_t i = 0; i < exclude_count_; i++) {
+    if (MatchGlob(exclude_[i], name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DirectoryWalker::IsIncluded(const char* name) const {
+  if (include_count_ == 0) {
+    return true;
+  }
+  for (intptr_t i = 0; i < include_count_; i++) {
+    if (MatchGlob(include_[i], name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DirectoryWalker::HandleDirectory(Batch* batch, const char* path) {
+  if (IsExcluded(EntryName(path))) {
+    return !stopped_;
+  }
+  if (include_count_ == 0) {
+    batch->Add(kListDirectory, path);
+  }
+  char* queued = Utils::SCreate("%s%s", path, File::PathSeparator());
+  MutexLocker ml(&queue_mutex_);
+  if (stopped_) {
+    free(queued);
+    return false;
+  }
+  if (queue_length_ == queue_capacity_) {
+    queue_capacity_ *= 2;
+    char** queue = reinterpret_cast<char**>(
+        realloc(queue_, queue_capacity_ * sizeof(char*)));
+    if (queue == NULL) {
+      OUT_OF_MEMORY();
+    }
+    queue_ = queue;
+  }
+  queue_[queue_length_++] = queued;
+  StartWorkersLocked();
+  return true;
+}
+
+bool DirectoryWalker::HandleEntry(Batch* batch,
+                                  int32_t type,
+                                  const char* path) {
+  const char* name = EntryName(path);
+  if (!IsExcluded(name) && IsIncluded(name)) {
+    batch->Add(type, path);
+  }
+  return !stopped_;
+}
+
+void DirectoryWalker::PostDone() {
+  Dart_CObject done;
+  done.type = Dart_CObject_kInt32;
+  done.value.as_int32 = kListDone;
+  Dart_PostCObject(reply_port_, &done);
+}
+
+// Returns the strings in |list|, which may be null, in scope allocated
+// memory.
+static const char** GetScopedPatterns(Dart_Handle list, intptr_t* count) {
+  *count = 0;
+  if (Dart_IsNull(list)) {
+    return NULL;
+  }
+  intptr_t length;
+  ThrowIfError(Dart_ListLength(list, &length));
+  const char** patterns = reinterpret_cast<const char**>(
+      Dart_ScopeAllocate(Utils::Maximum<intptr_t>(length, 1) * sizeof(char*)));
+  for (intptr_t i = 0; i < length; i++) {
+    patterns[i] =
+        DartUtils::GetStringValue(ThrowIfError(Dart_ListGetAt(list, i)));
+  }
+  *count = length;
+  return patterns;
+}
+
+// Returns a malloced copy of |patterns|.
+static char** CopyPatterns(const char** patterns, intptr_t count) {
+  if (count == 0) {
+    return NULL;
+  }
+  char** copy = reinterpret_cast<char**>(malloc(count * sizeof(char*)));
+  if (copy == NULL) {
+    OUT_OF_MEMORY();
+  }
+  for (intptr_t i = 0; i < count; i++) {
+    copy[i] = strdup(patterns[i]);
+    if (copy[i] == NULL) {
+      OUT_OF_MEMORY();
+    }
+  }
+  return copy;
+}
+
+static DirectoryWalker* GetWalker(Dart_NativeArguments args) {
+  DirectoryWalker* walker = reinterpret_cast<DirectoryWalker*>(
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 0)));
+  ASSERT(walker != NULL);
+  return walker;
+}
+
+void FUNCTION_NAME(Directory_StartWalk)(Dart_NativeArguments args) {
+  Namespace* namespc = Namespace::GetNamespace(args, 0);
+  Dart_Handle path_obj = Dart_GetNativeArgument(args, 1);
+  Dart_Port reply_port;
+  ThrowIfError(Dart_SendPortGetId(Dart_GetNativeArgument(args, 2), &reply_port));
+  int64_t concurrency = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 5), 1, DirectoryWalker::kMaxConcurrency);
+  const char* root = NULL;
+  {
+    Dart_TypedData_Type type;
+    uint8_t* data;
+    intptr_t length;
+    ThrowIfError(Dart_TypedDataAcquireData(
+        path_obj, &type, reinterpret_cast<void**>(&data), &length));
+    // The path from Dart is already null terminated.
+    root = DartUtils::ScopedCopyCString(reinterpret_cast<const char*>(data));
+    ThrowIfError(Dart_TypedDataReleaseData(path_obj));
+  }
+  // Convert all of the patterns before copying any, as a failed conversion
+  // does not return.
+  intptr_t include_count;
+  const char** include =
+      GetScopedPatterns(Dart_GetNativeArgument(args, 3), &include_count);
+  intptr_t exclude_count;
+  const char** exclude =
+      GetScopedPatterns(Dart_GetNativeArgument(args, 4), &exclude_count);
+  // The walker starts with one reference, which is owned by the Dart code
+  // and released by Directory_StopWalk.
+  DirectoryWalker* walker =
+      new DirectoryWalker(namespc, root, reply_port,
+                          CopyPatterns(include, include_count), include_count,
+                          CopyPatterns(exclude, exclude_count), exclude_count,
+                          concurrency);
+  if (!walker->Start()) {
+    walker->Stop();
+    walker->Release();
+    Dart_ThrowException(
+        DartUtils::NewInternalError("Failed to start directory walk"));
+  }
+  Dart_SetIntegerReturnValue(args, reinterpret_cast<intptr_t>(walker));
+}
+
+void FUNCTION_NAME(Directory_PauseWalk)(Dart_NativeArguments args) {
+  GetWalker(args)->Pause();
+}
+
+void FUNCTION_NAME(Directory_ResumeWalk)(Dart_NativeArguments args) {
+  GetWalker(args)->Resume();
+}
+
+void FUNCTION_NAME(Directory_StopWalk)(Dart_NativeArguments args) {
+  DirectoryWalker* walker = GetWalker(args);
+  walker->Stop();
+  walker->Release();
+}
+
+void FUNCTION_NAME(Directory_MatchGlob)(Dart_NativeArguments args) {
+  const char* pattern =
+      DartUtils::GetStringValue(Dart_GetNativeArgument(args, 0));
+  const char* name = DartUtils::GetStringValue(Dart_GetNativeArgument(args, 1));
+  Dart_SetBooleanReturnValue(args, DirectoryWalker::MatchGlob(pattern, name));
+}
+
+}  // namespace bin
+}  // namespace dart
@@ -0,0 +1,135 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_DIRECTORY_WALKER_H_
+#define RUNTIME_BIN_DIRECTORY_WALKER_H_
+
+#include "bin/builtin.h"
+#include "bin/namespace.h"
+#include "bin/reference_counting.h"
+#include "bin/thread.h"
+#include "include/dart_api.h"
+#include "platform/atomic.h"
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+// Walks a directory tree on several threads for Directory.walk.
+//
+// The directories still to be listed are kept on a queue shared by up to
+// |concurrency| workers. Each worker lists one directory at a time without
+// recursing into it, and puts the subdirectories it finds on the queue, so
+// sibling subtrees are listed in parallel and the entries are reported in no
+// particular order. Links are reported but never followed.
+//
+// Entries whose name matches one of the exclude patterns are skipped, and
+// excluded directories are not walked. When there are include patterns, only
+// the files and links whose name matches one of them are reported, and
+// directories are not. Patterns are matched against the name of the entry
+// only, see MatchGlob.
+//
+// Each worker packs the entries it finds into a batch, which is posted to the
+// reply port as a Uint8List when it is full or when the worker runs out of
+// directories to list. A record in a batch is the list type and the length of
+// the path as 32-bit integers, followed by the path, padded to a multiple of
+// 8. A directory that cannot be listed is reported as [kListError, path, OS
+// error], and the walk goes on. When the walk is complete, kListDone is posted
+// after the last batch. A stopped walk posts nothing more.
+class DirectoryWalker : public ReferenceCounted<DirectoryWalker> {
+ public:
+  // Keep in sync with _DirectoryWalker in directory_impl.dart.
+  static const intptr_t kBatchSize = 64 * KB;
+  static const intptr_t kMaxConcurrency = 8;
+
+  // The walker takes ownership of the malloced |include| and |exclude|
+  // patterns and of the arrays holding them. |root| must end with a path
+  // separator.
+  DirectoryWalker(Namespace* namespc,
+                  const char* root,
+                  Dart_Port reply_port,
+                  char** include,
+                  intptr_t include_count,
+                  char** exclude,
+                  intptr_t exclude_count,
+                  intptr_t concurrency);
+
+  static void Initialize();
+  static void Cleanup();
+
+  // Starts listing the root directory. Returns false if the walk could not be
+  // started.
+  bool Start();
+
+  // While the walk is paused, workers finish the directory they are listing
+  // but do not start on another one.
+  void Pause();
+  void Resume();
+
+  // Stops the walk. Workers give up on the directory they are listing.
+  void Stop();
+
+  // Returns whether |name| matches the glob |pattern|. '*' matches any
+  // sequence of characters, '?' matches any single character, and '[...]'
+  // and '[!...]' match any character in, or not in, a set of characters and
+  // ranges like 'a-z'. Characters are compared byte by byte. Walks under
+  // IOOverrides, which list in Dart, filter with this as well.
+  static bool MatchGlob(const char* pattern, const char* name);
+
+ private:
+  class Batch;
+  class Listing;
+
+  ~DirectoryWalker();
+
+  static void WorkCallback(Dart_Port dest_port_id, Dart_CObject* message);
+  static Dart_Port NextWorkPort();
+
+  void Work();
+  bool StartWorkersLocked();
+
+  bool IsExcluded(const char* name) const;
+  bool IsIncluded(const char* name) const;
+
+  bool HandleDirectory(Batch* batch, const char* path);
+  bool HandleEntry(Batch* batch, int32_t type, const char* path);
+  bool HandleError(const char* path);
+  void PostDone();
+
+  // Guards the ports below.
+  static Mutex* mutex_;
+  // A native port handles one message at a time, so workers are spread over
+  // a pool of ports, the way dart:io spreads requests over IO service ports.
+  static Dart_Port work_ports_[kMaxConcurrency];
+  static intptr_t next_work_port_;
+
+  Namespace* namespc_;
+  const Dart_Port reply_port_;
+  char** include_;
+  const intptr_t include_count_;
+  char** exclude_;
+  const intptr_t exclude_count_;
+  const intptr_t concurrency_;
+
+  // Guards the fields below.
+  Mutex queue_mutex_;
+  // The directories still to be listed, each ending with a path separator.
+  // They are taken from the end, so the walk goes depth first and the queue
+  // stays short.
+  char** queue_;
+  intptr_t queue_length_;
+  intptr_t queue_capacity_;
+  intptr_t workers_;
+  bool paused_;
+
+  RelaxedAtomic<bool> stopped_;
+
+  friend class ReferenceCounted<DirectoryWalker>;
+  DISALLOW_COPY_AND_ASSIGN(DirectoryWalker);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_DIRECTORY_WALKER_H_
@@ -6,8 +6,13 @@
 
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/directory_walker.h"
+#include "bin/file_io_engine.h"
+#include "bin/filter.h"
+#include "bin/host_lookup_cache.h"
 #include "bin/lockers.h"
 #include "bin/socket.h"
+#include "bin/stdio.h"
 #include "bin/thread.h"
 
 #include "include/dart_api.h"
@@ -61,6 +66,11 @@ static Monitor* shutdown_monitor = NULL;
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
+  FileIOEngine::Initialize();
+  DeflatePool::Initialize();
+  HostLookupCache::Initialize();
+  StdioBuffer::Initialize();
+  DirectoryWalker::Initialize();
 
   ASSERT(event_handler == NULL);
   shutdown_monitor = new Monitor();
@@ -99,6 +109,11 @@ void EventHandler::Stop() {
 
   // Destroy the global socket registry.
   ListeningSocketRegistry::Cleanup();
+  FileIOEngine::Cleanup();
+  DeflatePool::Cleanup();
+  HostLookupCache::Cleanup();
+  StdioBuffer::Cleanup();
+  DirectoryWalker::Cleanup();
 }
 
 EventHandlerImplementation* EventHandler::delegate() {
@@ -29,6 +29,18 @@
 namespace dart {
 namespace bin {
 
+DescriptorInfo::~DescriptorInfo() {
+  if (zero_copy_socket_ != nullptr) {
+    zero_copy_socket_->Release();
+  }
+}
+
+void DescriptorInfo::set_zero_copy_socket(Socket* socket) {
+  ASSERT(zero_copy_socket_ == nullptr);
+  socket->Retain();
+  zero_copy_socket_ = socket;
+}
+
 intptr_t DescriptorInfo::GetPollEvents() {
   // Do not ask for EPOLLERR and EPOLLHUP explicitly as they are
   // triggered anyway.
@@ -210,6 +222,9 @@ void EventHandlerImplementation::HandleInterruptFd() {
       }
       DescriptorInfo* di =
           GetDescriptorInfo(socket->fd(), IS_LISTENING_SOCKET(msg[i].data));
+      if (socket->zero_copy_enabled() && (di->zero_copy_socket() == nullptr)) {
+        di->set_zero_copy_socket(socket);
+      }
       if (IS_COMMAND(msg[i].data, kShutdownReadCommand)) {
         ASSERT(!di->IsListeningSocket());
         // Close the socket for reading.
@@ -325,6 +340,14 @@ intptr_t EventHandlerImplementation::GetPollEvents(intptr_t events,
 #ifdef DEBUG_POLL
   PrintEventMask(di->fd(), events);
 #endif
+  if (((events & EPOLLERR) != 0) && (di->zero_copy_socket() != nullptr) &&
+      di->zero_copy_socket()->ReapZeroCopyCompletions()) {
+    // Completions of zero-copy sends are queued on the error queue, which
+    // raises EPOLLERR without there being an error on the socket. Report them
+    // as a write event so the owner releases the sent buffers. A real error
+    // still pending shows up on the next read or write.
+    events = (events & ~EPOLLERR) | EPOLLOUT;
+  }
   if ((events & EPOLLERR) != 0) {
     // Return error only if EPOLLIN is present.
     return ((events & EPOLLIN) != 0) ? (1 << kErrorEvent) : 0;
@@ -20,20 +20,31 @@
 namespace dart {
 namespace bin {
 
+class Socket;
+
 class DescriptorInfo : public DescriptorInfoBase {
  public:
-  explicit DescriptorInfo(intptr_t fd) : DescriptorInfoBase(fd) {}
+  explicit DescriptorInfo(intptr_t fd)
+      : DescriptorInfoBase(fd), zero_copy_socket_(nullptr) {}
 
-  virtual ~DescriptorInfo() {}
+  virtual ~DescriptorInfo();
 
   intptr_t GetPollEvents();
 
+  // The socket whose zero-copy completions wake up this descriptor. Set once
+  // zero-copy sends are enabled on it, and retained until the descriptor is
+  // deleted.
+  Socket* zero_copy_socket() const { return zero_copy_socket_; }
+  void set_zero_copy_socket(Socket* socket);
+
   virtual void Close() {
     close(fd_);
     fd_ = -1;
   }
 
  private:
+  Socket* zero_copy_socket_;
+
   DISALLOW_COPY_AND_ASSIGN(DescriptorInfo);
 };
 
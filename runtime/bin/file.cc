@@ -22,6 +22,9 @@ namespace bin {
 
 static const int kFileNativeFieldIndex = 0;
 
+int64_t File::copy_chunk_size_ = File::kCopyChunkSize;
+intptr_t File::copy_methods_ = File::kCopyAllMethods;
+
 #if !defined(PRODUCT)
 static bool IsFile(Dart_Handle file_obj) {
   Dart_Handle file_type = ThrowIfError(
@@ -35,13 +38,18 @@ static bool IsFile(Dart_Handle file_obj) {
 // The file pointer has been passed into Dart as an intptr_t and it is safe
 // to pull it out of Dart as a 64-bit integer, cast it to an intptr_t and
 // from there to a File pointer.
-static File* GetFile(Dart_NativeArguments args) {
+File* File::FromDartObject(Dart_Handle file_obj) {
   File* file;
-  Dart_Handle dart_this = ThrowIfError(Dart_GetNativeArgument(args, 0));
-  DEBUG_ASSERT(IsFile(dart_this));
+  DEBUG_ASSERT(IsFile(file_obj));
   Dart_Handle result = Dart_GetNativeInstanceField(
-      dart_this, kFileNativeFieldIndex, reinterpret_cast<intptr_t*>(&file));
+      file_obj, kFileNativeFieldIndex, reinterpret_cast<intptr_t*>(&file));
   ASSERT(!Dart_IsError(result));
+  return file;
+}
+
+static File* GetFile(Dart_NativeArguments args) {
+  Dart_Handle dart_this = ThrowIfError(Dart_GetNativeArgument(args, 0));
+  File* file = File::FromDartObject(dart_this);
   if (file == NULL) {
     Dart_PropagateError(Dart_NewUnhandledExceptionError(
         DartUtils::NewInternalError("No native peer")));
@@ -500,6 +508,58 @@ void FUNCTION_NAME(File_Lock)(Dart_NativeArguments args) {
   Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
 }
 
+static void MappedMemoryFinalizer(void* isolate_callback_data,
+                                  Dart_WeakPersistentHandle handle,
+                                  void* peer) {
+  delete reinterpret_cast<MappedMemory*>(peer);
+}
+
+void FUNCTION_NAME(File_Map)(Dart_NativeArguments args) {
+  File* file = GetFile(args);
+  ASSERT(file != NULL);
+  int64_t position;
+  int64_t length;
+  int64_t advice;
+  if (!DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 1), &position) ||
+      !DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 2), &length) ||
+      !DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 3), &advice) ||
+      (position < 0) || (length <= 0) || (length > kIntptrMax) ||
+      (advice < MappedMemory::kNormal) || (advice > MappedMemory::kWillNeed)) {
+    OSError os_error(-1, "Invalid argument", OSError::kUnknown);
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+    return;
+  }
+  // Map from the enclosing aligned position and skip the bytes before
+  // 'position' in the returned typed data.
+  const int64_t offset = position % File::MapAlignment();
+  MappedMemory* mapping =
+      file->Map(File::kReadOnly, position - offset, length + offset);
+  if (mapping == NULL) {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+    return;
+  }
+  mapping->Advise(static_cast<MappedMemory::Advice>(advice));
+  uint8_t* data = reinterpret_cast<uint8_t*>(mapping->address()) + offset;
+#if defined(HOST_OS_WINDOWS)
+  // Windows reads the bytes into memory of its own.
+  const intptr_t external_size = length;
+#else
+  // The pages belong to the file cache and can be dropped by the OS at any
+  // time, so counting them as external memory would only trigger needless
+  // garbage collections.
+  const intptr_t external_size = sizeof(MappedMemory);
+#endif
+  // The mapping is removed by the finalizer once the typed data is collected.
+  Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kUint8, data, length, mapping, external_size,
+      MappedMemoryFinalizer);
+  if (Dart_IsError(result)) {
+    delete mapping;
+    Dart_PropagateError(result);
+  }
+  Dart_SetReturnValue(args, result);
+}
+
 void FUNCTION_NAME(File_Create)(Dart_NativeArguments args) {
   Namespace* namespc = Namespace::GetNamespace(args, 0);
   Dart_Handle path_handle = Dart_GetNativeArgument(args, 1);
@@ -962,24 +1022,76 @@ CObject* File::RenameRequest(const CObjectArray& request) {
              : CObject::NewOSError();
 }
 
-CObject* File::CopyRequest(const CObjectArray& request) {
+CObject* File::CopyChunkRequest(const CObjectArray& request) {
   if ((request.Length() < 1) || !request[0]->IsIntptr()) {
     return CObject::IllegalArgumentError();
   }
   Namespace* namespc = CObjectToNamespacePointer(request[0]);
   RefCntReleaseScope<Namespace> rs(namespc);
-  if ((request.Length() != 3) || !request[1]->IsUint8Array() ||
-      !request[2]->IsString()) {
+  // The request is [namespace, old path, new path, offset, identity...].
+  const intptr_t kIdentityStart = 4;
+  if ((request.Length() != kIdentityStart + kCopyIdentitySize) ||
+      !request[1]->IsUint8Array() || !request[2]->IsString() ||
+      !request[3]->IsInt32OrInt64()) {
     return CObject::IllegalArgumentError();
   }
+  int64_t identity[kCopyIdentitySize];
+  for (intptr_t i = 0; i < kCopyIdentitySize; i++) {
+    if (!request[kIdentityStart + i]->IsInt32OrInt64()) {
+      return CObject::IllegalArgumentError();
+    }
+    identity[i] = CObjectInt32OrInt64ToInt64(request[kIdentityStart + i]);
+  }
   CObjectUint8Array old_path(request[1]);
   CObjectString new_path(request[2]);
-  return File::Copy(namespc, reinterpret_cast<const char*>(old_path.Buffer()),
-                    new_path.CString())
-             ? CObject::True()
-             : CObject::NewOSError();
+  const int64_t offset = CObjectInt32OrInt64ToInt64(request[3]);
+  if (offset < 0) {
+    return CObject::IllegalArgumentError();
+  }
+  bool done = false;
+  const int64_t next_offset = File::CopyChunk(
+      namespc, reinterpret_cast<const char*>(old_path.Buffer()),
+      new_path.CString(), offset, identity, &done);
+  if (next_offset < 0) {
+    return CObject::NewOSError();
+  }
+  // The response is [kSuccess, next offset, done, identity...], and the
+  // identity is passed on to the request for the next chunk.
+  CObjectArray* result =
+      new CObjectArray(CObject::NewArray(3 + kCopyIdentitySize));
+  result->SetAt(0, new CObjectInt32(CObject::NewInt32(CObject::kSuccess)));
+  result->SetAt(1, new CObjectInt64(CObject::NewInt64(next_offset)));
+  result->SetAt(2, CObject::Bool(done));
+  for (intptr_t i = 0; i < kCopyIdentitySize; i++) {
+    result->SetAt(3 + i, new CObjectInt64(CObject::NewInt64(identity[i])));
+  }
+  return result;
 }
 
+#if !defined(HOST_OS_LINUX)
+int64_t File::CopyChunk(Namespace* namespc,
+                        const char* old_path,
+                        const char* new_path,
+                        int64_t offset,
+                        int64_t* identity,
+                        bool* done) {
+  // Other platforms copy the whole file in one go, so there is no later
+  // chunk that needs the identity of the files.
+  ASSERT(offset == 0);
+  if (!File::Copy(namespc, old_path, new_path)) {
+    return -1;
+  }
+  for (intptr_t i = 0; i < kCopyIdentitySize; i++) {
+    identity[i] = 0;
+  }
+  *done = true;
+  // The copy has succeeded even if the new file cannot be looked at now,
+  // and the offset is not used once the copy is done.
+  const int64_t length = File::LengthFromPath(namespc, new_path);
+  return (length < 0) ? 0 : length;
+}
+#endif  // !defined(HOST_OS_LINUX)
+
 CObject* File::ResolveSymbolicLinksRequest(const CObjectArray& request) {
   if ((request.Length() < 1) || !request[0]->IsIntptr()) {
     return CObject::IllegalArgumentError();
@@ -1487,6 +1599,38 @@ CObject* File::StatRequest(const CObjectArray& request) {
   return wrapper;
 }
 
+CObject* File::StatBatchRequest(const CObjectArray& request) {
+  if ((request.Length() < 1) || !request[0]->IsIntptr()) {
+    return CObject::IllegalArgumentError();
+  }
+  Namespace* namespc = CObjectToNamespacePointer(request[0]);
+  RefCntReleaseScope<Namespace> rs(namespc);
+  if ((request.Length() != 2) || !request[1]->IsArray()) {
+    return CObject::IllegalArgumentError();
+  }
+  CObjectArray paths(request[1]);
+  const intptr_t count = paths.Length();
+  for (intptr_t i = 0; i < count; i++) {
+    if (!paths[i]->IsString()) {
+      return CObject::IllegalArgumentError();
+    }
+  }
+  // The results are packed into a single typed data object of kStatSize
+  // int64s per path, rather than a nested array of boxed integers per path.
+  // A path that cannot be stat'ed reports a type of kDoesNotExist.
+  CObjectUint8Array* result = new CObjectUint8Array(
+      CObject::NewUint8Array(count * File::kStatSize * sizeof(int64_t)));
+  int64_t* data = reinterpret_cast<int64_t*>(result->Buffer());
+  for (intptr_t i = 0; i < count; i++) {
+    CObjectString path(paths[i]);
+    File::Stat(namespc, path.CString(), data + i * File::kStatSize);
+  }
+  CObjectArray* wrapper = new CObjectArray(CObject::NewArray(2));
+  wrapper->SetAt(0, new CObjectInt32(CObject::NewInt32(CObject::kSuccess)));
+  wrapper->SetAt(1, result);
+  return wrapper;
+}
+
 CObject* File::LockRequest(const CObjectArray& request) {
   if ((request.Length() < 1) || !request[0]->IsIntptr()) {
     return CObject::IllegalArgumentError();
@@ -34,6 +34,19 @@ class MappedMemory {
   intptr_t size() const { return size_; }
   uword start() const { return reinterpret_cast<uword>(address()); }
 
+  // These must agree with FileAccessPattern in file.dart.
+  enum Advice {
+    kNormal = 0,
+    kSequential = 1,
+    kRandom = 2,
+    kWillNeed = 3,
+  };
+
+  // Tells the OS how the mapping is going to be accessed, so that it can
+  // adjust read-ahead and page reclamation. This is only a hint, and it is
+  // ignored on platforms without madvise.
+  void Advise(Advice advice);
+
  private:
   void Unmap();
 
@@ -94,6 +107,15 @@ class File : public ReferenceCounted<File> {
     kStatSize = 6
   };
 
+  enum CopyIdentity {
+    // The device and inode numbers of the files of a copy made in chunks.
+    kCopyOldDevice = 0,
+    kCopyOldInode = 1,
+    kCopyNewDevice = 2,
+    kCopyNewInode = 3,
+    kCopyIdentitySize = 4
+  };
+
   enum LockType {
     // These match the constants in FileStat in file_impl.dart.
     kLockMin = 0,
@@ -135,10 +157,16 @@ class File : public ReferenceCounted<File> {
                     int64_t length,
                     void* start = nullptr);
 
+  // The alignment required of the 'position' passed to Map.
+  static intptr_t MapAlignment();
+
   // Read/Write attempt to transfer num_bytes to/from buffer. It returns
   // the number of bytes read/written.
   int64_t Read(void* buffer, int64_t num_bytes);
   int64_t Write(const void* buffer, int64_t num_bytes);
+  // Like Read, but reads from |position| and leaves the file position
+  // unchanged.
+  int64_t ReadAt(void* buffer, int64_t num_bytes, int64_t position);
 
   // ReadFully and WriteFully do attempt to transfer num_bytes to/from
   // the buffer. In the event of short accesses they will loop internally until
@@ -215,6 +243,10 @@ class File : public ReferenceCounted<File> {
   // (stdin, stout or stderr).
   static File* OpenStdio(int fd);
 
+  // Returns the file backing a _RandomAccessFileOpsImpl object, or NULL if
+  // the file has been closed.
+  static File* FromDartObject(Dart_Handle file_obj);
+
 #if defined(HOST_OS_FUCHSIA) || defined(HOST_OS_LINUX)
   static File* OpenFD(int fd);
 #endif
@@ -236,8 +268,50 @@ class File : public ReferenceCounted<File> {
   static bool Copy(Namespace* namespc,
                    const char* old_path,
                    const char* new_path);
+
+  // The asynchronous File.copy is made in steps of at most
+  // copy_chunk_size() bytes, so that copying a large file does not occupy
+  // an IO service thread for a long time.
+  static const int64_t kCopyChunkSize = 64 * MB;
+  static int64_t copy_chunk_size() { return copy_chunk_size_; }
+  static void set_copy_chunk_size(int64_t size) { copy_chunk_size_ = size; }
+
+  // The ways of copying data that Copy and CopyChunk try, in this order,
+  // where the platform has them. Tests restrict them to reach the
+  // fallbacks.
+  enum CopyMethod {
+    kCopyClone = 1 << 0,
+    kCopyFileRange = 1 << 1,
+    kCopySendFile = 1 << 2,
+    kCopyReadWrite = 1 << 3,
+    kCopyAllMethods = (1 << 4) - 1
+  };
+  static intptr_t copy_methods() { return copy_methods_; }
+  static void set_copy_methods(intptr_t methods) { copy_methods_ = methods; }
+
+  // Copies the part of 'old_path' starting at 'offset' to 'new_path', which
+  // is created or truncated when 'offset' is 0. At most copy_chunk_size()
+  // bytes are copied, unless the whole file can be copied at once. Returns
+  // the offset following the copied bytes, and sets 'done' if the end of
+  // the file was reached. Returns -1 on failure, in which case 'new_path'
+  // has been deleted if it was created by the copy.
+  //
+  // The first chunk stores the identity of both files in 'identity', which
+  // has kCopyIdentitySize entries. Later chunks fail with ESTALE unless the
+  // paths still name those files and 'new_path' is 'offset' bytes long, so
+  // that a file replaced between chunks is not spliced into the copy.
+  static int64_t CopyChunk(Namespace* namespc,
+                           const char* old_path,
+                           const char* new_path,
+                           int64_t offset,
+                           int64_t* identity,
+                           bool* done);
   static int64_t LengthFromPath(Namespace* namespc, const char* path);
   static void Stat(Namespace* namespc, const char* path, int64_t* data);
+#if defined(HOST_OS_LINUX)
+  // Like Stat, but |path| is resolved relative to the directory |dir_fd|.
+  static void StatAt(intptr_t dir_fd, const char* path, int64_t* data);
+#endif
   static time_t LastModified(Namespace* namespc, const char* path);
   static bool SetLastModified(Namespace* namespc,
                               const char* path,
@@ -285,7 +359,7 @@ class File : public ReferenceCounted<File> {
   static CObject* CreateRequest(const CObjectArray& request);
   static CObject* DeleteRequest(const CObjectArray& request);
   static CObject* RenameRequest(const CObjectArray& request);
-  static CObject* CopyRequest(const CObjectArray& request);
+  static CObject* CopyChunkRequest(const CObjectArray& request);
   static CObject* OpenRequest(const CObjectArray& request);
   static CObject* ResolveSymbolicLinksRequest(const CObjectArray& request);
   static CObject* CloseRequest(const CObjectArray& request);
@@ -311,6 +385,7 @@ class File : public ReferenceCounted<File> {
   static CObject* TypeRequest(const CObjectArray& request);
   static CObject* IdenticalRequest(const CObjectArray& request);
   static CObject* StatRequest(const CObjectArray& request);
+  static CObject* StatBatchRequest(const CObjectArray& request);
   static CObject* LockRequest(const CObjectArray& request);
 
  private:
@@ -323,6 +398,9 @@ class File : public ReferenceCounted<File> {
 
   static const int kClosedFd = -1;
 
+  static int64_t copy_chunk_size_;
+  static intptr_t copy_methods_;
+
   // FileHandle is an OS specific class which stores data about the file.
   FileHandle* handle_;  // OS specific handle for the file.
 
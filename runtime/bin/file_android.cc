@@ -109,11 +109,41 @@ void MappedMemory::Unmap() {
   size_ = 0;
 }
 
+void MappedMemory::Advise(Advice advice) {
+  int posix_advice = MADV_NORMAL;
+  switch (advice) {
+    case kNormal:
+      posix_advice = MADV_NORMAL;
+      break;
+    case kSequential:
+      posix_advice = MADV_SEQUENTIAL;
+      break;
+    case kRandom:
+      posix_advice = MADV_RANDOM;
+      break;
+    case kWillNeed:
+      posix_advice = MADV_WILLNEED;
+      break;
+  }
+  // Failing to apply the hint is harmless.
+  VOID_NO_RETRY_EXPECTED(madvise(address_, size_, posix_advice));
+}
+
+intptr_t File::MapAlignment() {
+  return sysconf(_SC_PAGESIZE);
+}
+
 int64_t File::Read(void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return TEMP_FAILURE_RETRY(read(handle_->fd(), buffer, num_bytes));
 }
 
+int64_t File::ReadAt(void* buffer, int64_t num_bytes, int64_t position) {
+  ASSERT(handle_->fd() >= 0);
+  return TEMP_FAILURE_RETRY(
+      pread64(handle_->fd(), buffer, num_bytes, position));
+}
+
 int64_t File::Write(const void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return TEMP_FAILURE_RETRY(write(handle_->fd(), buffer, num_bytes));
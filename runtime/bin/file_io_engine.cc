@@ -0,0 +1,377 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/file_io_engine.h"
+
+#include "bin/dartutils.h"
+#include "bin/io_buffer.h"
+#include "bin/lockers.h"
+#include "bin/utils.h"
+
+#include "include/dart_api.h"
+#include "include/dart_native_api.h"
+
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+Mutex* FileIOEngine::mutex_ = NULL;
+Monitor* FileIOEngine::worker_monitor_ = NULL;
+FileIORequest* FileIOEngine::queue_head_ = NULL;
+FileIORequest* FileIOEngine::queue_tail_ = NULL;
+FileIORequest* FileIOEngine::worker_head_ = NULL;
+FileIORequest* FileIOEngine::worker_tail_ = NULL;
+intptr_t FileIOEngine::workers_ = 0;
+bool FileIOEngine::started_ = false;
+bool FileIOEngine::platform_backend_ = false;
+bool FileIOEngine::shutting_down_ = false;
+
+FileIORequest::~FileIORequest() {
+  if (buffer_ != NULL) {
+    IOBuffer::Free(buffer_);
+  }
+  if (file_ != NULL) {
+    file_->Release();
+  }
+}
+
+void FileIORequest::Execute() {
+  int64_t result;
+  if (operation_ == kWrite) {
+    result = file_->WriteFully(buffer_ + transferred_, length_ - transferred_)
+                 ? length_
+                 : -1;
+  } else {
+    result = file_->Read(buffer_, length_);
+  }
+  if (result < 0) {
+    OSError os_error;
+    Complete(-1, os_error.code());
+  } else {
+    Complete(result, 0);
+  }
+}
+
+void FileIORequest::Complete(int64_t result, int error) {
+  // The response has the same shape as the one the IO service sends for the
+  // corresponding file request.
+  Dart_CObject success;
+  success.type = Dart_CObject_kInt32;
+  success.value.as_int32 = CObject::kSuccess;
+  Dart_CObject count;
+  count.type = Dart_CObject_kInt64;
+  count.value.as_int64 = result;
+  Dart_CObject data;
+  data.type = Dart_CObject_kExternalTypedData;
+  data.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  data.value.as_external_typed_data.length = result;
+  data.value.as_external_typed_data.data = buffer_;
+  data.value.as_external_typed_data.peer = buffer_;
+  data.value.as_external_typed_data.callback = IOBuffer::Finalizer;
+  Dart_CObject error_type;
+  error_type.type = Dart_CObject_kInt32;
+  error_type.value.as_int32 = CObject::kOSError;
+  Dart_CObject error_code;
+  error_code.type = Dart_CObject_kInt32;
+  error_code.value.as_int32 = error;
+  Dart_CObject error_message;
+  OSError os_error;
+
+  Dart_CObject* values[3];
+  intptr_t num_values = 0;
+  bool transfers_buffer = false;
+  if (result < 0) {
+    os_error.SetCodeAndMessage(OSError::kSystem, error);
+    error_message.type = Dart_CObject_kString;
+    error_message.value.as_string = const_cast<char*>(os_error.message());
+    values[num_values++] = &error_type;
+    values[num_values++] = &error_code;
+    values[num_values++] = &error_message;
+  } else if (operation_ == kRead) {
+    values[num_values++] = &success;
+    values[num_values++] = &data;
+    transfers_buffer = true;
+  } else if (operation_ == kReadInto) {
+    values[num_values++] = &success;
+    values[num_values++] = &count;
+    values[num_values++] = &data;
+    transfers_buffer = true;
+  }
+  Dart_CObject response;
+  if (num_values > 0) {
+    response.type = Dart_CObject_kArray;
+    response.value.as_array.length = num_values;
+    response.value.as_array.values = values;
+  } else {
+    // A successful write responds with the number of bytes written.
+    response = count;
+  }
+
+  Dart_CObject message_id;
+  message_id.type = Dart_CObject_kInt64;
+  message_id.value.as_int64 = id_;
+  Dart_CObject* message_values[2] = {&message_id, &response};
+  Dart_CObject message;
+  message.type = Dart_CObject_kArray;
+  message.value.as_array.length = 2;
+  message.value.as_array.values = message_values;
+  if (Dart_PostCObject(reply_port_, &message) && transfers_buffer) {
+    // The receiving isolate now owns the buffer.
+    buffer_ = NULL;
+  }
+  delete this;
+}
+
+void FileIOEngine::Initialize() {
+  ASSERT(mutex_ == NULL);
+  mutex_ = new Mutex();
+  worker_monitor_ = new Monitor();
+}
+
+void FileIOEngine::Cleanup() {
+  if (mutex_ == NULL) {
+    return;
+  }
+  bool stop_platform_backend;
+  {
+    MutexLocker ml(mutex_);
+    stop_platform_backend = started_ && platform_backend_;
+    // From here on requests go to the worker threads, including short writes
+    // the platform backend queues again while it is stopping.
+    platform_backend_ = false;
+  }
+  if (stop_platform_backend) {
+    StopPlatformBackend();
+  }
+  // Requests that were queued but never submitted are run rather than
+  // dropped, so that their isolates still get a response.
+  FileIORequest* requests;
+  {
+    MutexLocker ml(mutex_);
+    requests = queue_head_;
+    queue_head_ = NULL;
+    queue_tail_ = NULL;
+  }
+  if (requests != NULL) {
+    RunOnWorkers(requests);
+  }
+  {
+    MonitorLocker ml(worker_monitor_);
+    shutting_down_ = true;
+    ml.NotifyAll();
+    while (workers_ > 0) {
+      ml.Wait();
+    }
+  }
+  delete mutex_;
+  mutex_ = NULL;
+  delete worker_monitor_;
+  worker_monitor_ = NULL;
+  // The engine may be initialized again, e.g. when the embedder restarts the
+  // event handler.
+  started_ = false;
+  platform_backend_ = false;
+  shutting_down_ = false;
+}
+
+void FileIOEngine::Enqueue(FileIORequest* request) {
+  ASSERT(request->next() == NULL);
+  MutexLocker ml(mutex_);
+  if (queue_tail_ == NULL) {
+    queue_head_ = request;
+  } else {
+    queue_tail_->set_next(request);
+  }
+  queue_tail_ = request;
+}
+
+void FileIOEngine::Submit() {
+  FileIORequest* requests;
+  {
+    MutexLocker ml(mutex_);
+    requests = queue_head_;
+    queue_head_ = NULL;
+    queue_tail_ = NULL;
+    if (requests == NULL) {
+      return;
+    }
+    if (!started_) {
+      started_ = true;
+      platform_backend_ = StartPlatformBackend();
+    }
+    if (platform_backend_) {
+      requests = SubmitToPlatformBackend(requests);
+    }
+  }
+  if (requests != NULL) {
+    RunOnWorkers(requests);
+  }
+}
+
+void FileIOEngine::RunOnWorkers(FileIORequest* requests) {
+  MonitorLocker ml(worker_monitor_);
+  if (worker_tail_ == NULL) {
+    worker_head_ = requests;
+  } else {
+    worker_tail_->set_next(requests);
+  }
+  FileIORequest* tail = requests;
+  while (tail->next() != NULL) {
+    tail = tail->next();
+  }
+  worker_tail_ = tail;
+  if (workers_ == 0) {
+    StartWorkers();
+  }
+  ml.NotifyAll();
+}
+
+void FileIOEngine::StartWorkers() {
+  for (intptr_t i = 0; i < kWorkerThreads; i++) {
+    int result = Thread::Start("dart:io FileIOEngine", &WorkerMain, 0);
+    if (result != 0) {
+      FATAL1("Failed to start file I/O worker thread %d", result);
+    }
+    workers_++;
+  }
+}
+
+void FileIOEngine::WorkerMain(uword parameters) {
+  while (true) {
+    FileIORequest* request;
+    {
+      MonitorLocker ml(worker_monitor_);
+      while ((worker_head_ == NULL) && !shutting_down_) {
+        ml.Wait();
+      }
+      if (worker_head_ == NULL) {
+        workers_--;
+        ml.NotifyAll();
+        return;
+      }
+      request = worker_head_;
+      worker_head_ = request->next();
+      if (worker_head_ == NULL) {
+        worker_tail_ = NULL;
+      }
+    }
+    request->set_next(NULL);
+    request->Execute();
+  }
+}
+
+#if !defined(HOST_OS_LINUX)
+bool FileIOEngine::StartPlatformBackend() {
+  return false;
+}
+
+FileIORequest* FileIOEngine::SubmitToPlatformBackend(FileIORequest* requests) {
+  return requests;
+}
+
+void FileIOEngine::StopPlatformBackend() {}
+#endif  // !defined(HOST_OS_LINUX)
+
+static Dart_Port GetReplyPort(Dart_Handle send_port) {
+  Dart_Port port;
+  Dart_Handle result = Dart_SendPortGetId(send_port, &port);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  return port;
+}
+
+// Returns the file for a pointer obtained with File_GetPointer, or NULL if
+// the file is closed. In that case the closed error has already been posted.
+static File* GetOpenFile(Dart_Handle pointer_obj, Dart_Port port, intptr_t id) {
+  File* file = reinterpret_cast<File*>(DartUtils::GetIntptrValue(pointer_obj));
+  if ((file != NULL) && !file->IsClosed()) {
+    return file;
+  }
+  if (file != NULL) {
+    file->Release();
+  }
+  Dart_CObject error_type;
+  error_type.type = Dart_CObject_kInt32;
+  error_type.value.as_int32 = CObject::kFileClosedError;
+  Dart_CObject* response_values[1] = {&error_type};
+  Dart_CObject response;
+  response.type = Dart_CObject_kArray;
+  response.value.as_array.length = 1;
+  response.value.as_array.values = response_values;
+  Dart_CObject message_id;
+  message_id.type = Dart_CObject_kInt64;
+  message_id.value.as_int64 = id;
+  Dart_CObject* message_values[2] = {&message_id, &response};
+  Dart_CObject message;
+  message.type = Dart_CObject_kArray;
+  message.value.as_array.length = 2;
+  message.value.as_array.values = message_values;
+  Dart_PostCObject(port, &message);
+  return NULL;
+}
+
+void FUNCTION_NAME(FileIOEngine_Read)(Dart_NativeArguments args) {
+  Dart_Port port = GetReplyPort(Dart_GetNativeArgument(args, 1));
+  intptr_t id = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  int64_t length = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 3), 0, kIntptrMax);
+  bool into = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 4));
+  File* file = GetOpenFile(Dart_GetNativeArgument(args, 0), port, id);
+  if (file == NULL) {
+    return;
+  }
+  uint8_t* buffer = IOBuffer::Allocate(static_cast<intptr_t>(length));
+  if (buffer == NULL) {
+    file->Release();
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+  FileIOEngine::Enqueue(new FileIORequest(
+      into ? FileIORequest::kReadInto : FileIORequest::kRead, file, port, id,
+      buffer, length));
+}
+
+void FUNCTION_NAME(FileIOEngine_Write)(Dart_NativeArguments args) {
+  Dart_Port port = GetReplyPort(Dart_GetNativeArgument(args, 1));
+  intptr_t id = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  Dart_Handle buffer_obj = Dart_GetNativeArgument(args, 3);
+  intptr_t start = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 4));
+  intptr_t end = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 5));
+  File* file = GetOpenFile(Dart_GetNativeArgument(args, 0), port, id);
+  if (file == NULL) {
+    return;
+  }
+  // The data is copied, as it is when the request is sent to the IO service,
+  // so that the Dart buffer can be reused as soon as writeFrom returns.
+  intptr_t length = end - start;
+  uint8_t* buffer = IOBuffer::Allocate(length);
+  if (buffer == NULL) {
+    file->Release();
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+  Dart_TypedData_Type type;
+  void* data;
+  intptr_t len;
+  Dart_Handle result =
+      Dart_TypedDataAcquireData(buffer_obj, &type, &data, &len);
+  if (Dart_IsError(result)) {
+    IOBuffer::Free(buffer);
+    file->Release();
+    Dart_PropagateError(result);
+  }
+  ASSERT((type == Dart_TypedData_kUint8) || (type == Dart_TypedData_kInt8));
+  ASSERT(end <= len);
+  memmove(buffer, reinterpret_cast<uint8_t*>(data) + start, length);
+  Dart_TypedDataReleaseData(buffer_obj);
+  FileIOEngine::Enqueue(new FileIORequest(FileIORequest::kWrite, file, port,
+                                          id, buffer, length));
+}
+
+void FUNCTION_NAME(FileIOEngine_Submit)(Dart_NativeArguments args) {
+  FileIOEngine::Submit();
+}
+
+}  // namespace bin
+}  // namespace dart
@@ -0,0 +1,128 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_FILE_IO_ENGINE_H_
+#define RUNTIME_BIN_FILE_IO_ENGINE_H_
+
+#include "bin/builtin.h"
+#include "bin/file.h"
+#include "bin/thread.h"
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+// A request executed by the FileIOEngine. The engine owns the reference to
+// |file| and the |buffer| until the request is completed.
+class FileIORequest {
+ public:
+  // The response posted for each operation matches the IO service response
+  // for fileRead, fileReadInto and fileWriteFrom respectively.
+  enum Operation {
+    kRead = 0,
+    kReadInto = 1,
+    kWrite = 2,
+  };
+
+  FileIORequest(Operation operation,
+                File* file,
+                Dart_Port reply_port,
+                intptr_t id,
+                uint8_t* buffer,
+                int64_t length)
+      : operation_(operation),
+        file_(file),
+        reply_port_(reply_port),
+        id_(id),
+        buffer_(buffer),
+        length_(length),
+        transferred_(0),
+        next_(NULL) {}
+
+  Operation operation() const { return operation_; }
+  File* file() const { return file_; }
+  uint8_t* buffer() const { return buffer_; }
+  int64_t length() const { return length_; }
+
+  // The number of bytes a short write has already written. The request is
+  // continued from there when it is executed or submitted again.
+  int64_t transferred() const { return transferred_; }
+  void set_transferred(int64_t transferred) { transferred_ = transferred; }
+
+  FileIORequest* next() const { return next_; }
+  void set_next(FileIORequest* next) { next_ = next; }
+
+  // Runs the request on the calling thread with blocking file operations.
+  void Execute();
+
+  // Posts the result to the reply port and deletes the request. |result| is
+  // the number of bytes transferred, or -1 with |error| set to the OS error
+  // code.
+  void Complete(int64_t result, int error);
+
+ private:
+  ~FileIORequest();
+
+  const Operation operation_;
+  File* file_;
+  const Dart_Port reply_port_;
+  const intptr_t id_;
+  uint8_t* buffer_;
+  const int64_t length_;
+  int64_t transferred_;
+  FileIORequest* next_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileIORequest);
+};
+
+// Executes file reads and writes asynchronously and posts each result
+// directly to the requesting isolate's reply port, without the round trip
+// through an IO service port. Requests are queued with Enqueue and handed to
+// the backend in batches by Submit. On Linux the backend is an io_uring
+// instance when the kernel supports it; otherwise, and on all other
+// platforms, it is a small pool of worker threads.
+class FileIOEngine {
+ public:
+  static void Initialize();
+  // Completes all pending requests before stopping the backend and workers.
+  static void Cleanup();
+
+  // Queues |request|. It is not started before the next call to Submit.
+  static void Enqueue(FileIORequest* request);
+
+  // Starts all queued requests.
+  static void Submit();
+
+ private:
+  static const intptr_t kWorkerThreads = 4;
+
+  static void StartWorkers();
+  static void WorkerMain(uword parameters);
+  static void RunOnWorkers(FileIORequest* requests);
+
+  // Platform backend. StartPlatformBackend returns false if there is none,
+  // and SubmitToPlatformBackend returns the requests it did not take.
+  static bool StartPlatformBackend();
+  static FileIORequest* SubmitToPlatformBackend(FileIORequest* requests);
+  static void StopPlatformBackend();
+
+  static Mutex* mutex_;
+  static Monitor* worker_monitor_;
+  static FileIORequest* queue_head_;
+  static FileIORequest* queue_tail_;
+  static FileIORequest* worker_head_;
+  static FileIORequest* worker_tail_;
+  static intptr_t workers_;
+  static bool started_;
+  static bool platform_backend_;
+  static bool shutting_down_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(FileIOEngine);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_FILE_IO_ENGINE_H_
@@ -0,0 +1,399 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX)
+
+#include "bin/file_io_engine.h"
+
+#include <errno.h>         // NOLINT
+#include <sched.h>         // NOLINT
+#include <string.h>        // NOLINT
+#include <sys/mman.h>      // NOLINT
+#include <sys/syscall.h>   // NOLINT
+#include <unistd.h>        // NOLINT
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>  // NOLINT
+#endif
+#endif
+
+#include "bin/lockers.h"
+#include "bin/thread.h"
+#include "platform/syslog.h"
+
+// io_uring is only used when the kernel can read and write at the current
+// file position (IORING_FEAT_RW_CUR_POS, Linux 5.6), since that is what
+// RandomAccessFile.read and writeFrom do.
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup) &&        \
+    defined(__NR_io_uring_enter)
+#define USE_IO_URING 1
+#endif
+
+namespace dart {
+namespace bin {
+
+#if defined(USE_IO_URING)
+
+// Requests longer than this are left to the worker threads, as the length of
+// an io_uring read or write is 32 bits.
+static const int64_t kMaxRingRequestLength = 1 << 30;
+static const unsigned kRingEntries = 256;
+// How often a submission that fails with EAGAIN or EBUSY is retried before
+// its requests are left to the worker threads.
+static const intptr_t kMaxSubmitRetries = 16;
+
+// The submission and completion rings shared with the kernel. Submissions
+// are made with the FileIOEngine mutex held; completions are only consumed
+// by the completion thread.
+class IOURing {
+ public:
+  IOURing()
+      : fd_(-1),
+        sq_ring_(MAP_FAILED),
+        cq_ring_(MAP_FAILED),
+        sqes_(reinterpret_cast<struct io_uring_sqe*>(MAP_FAILED)),
+        in_flight_(0),
+        shutdown_(false),
+        thread_done_(false) {}
+
+  ~IOURing() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool Setup() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = syscall(__NR_io_uring_setup, kRingEntries, &params);
+    if (fd_ < 0) {
+      return false;
+    }
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    sq_ring_ = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    cq_ring_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    cq_ring_ = mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = reinterpret_cast<struct io_uring_sqe*>(
+        mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+    if ((sq_ring_ == MAP_FAILED) || (cq_ring_ == MAP_FAILED) ||
+        (sqes_ == MAP_FAILED)) {
+      return false;
+    }
+    uint8_t* sq = reinterpret_cast<uint8_t*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    uint8_t* cq = reinterpret_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+    cq_entries_ = params.cq_entries;
+    return true;
+  }
+
+  // Submits as many of |requests| as the rings have room for, and returns
+  // the rest, including any the kernel would not take.
+  FileIORequest* Submit(FileIORequest* requests) {
+    const unsigned old_tail = *sq_tail_;
+    unsigned tail = old_tail;
+    unsigned submitted = 0;
+    FileIORequest* rest = requests;
+    {
+      MonitorLocker ml(&in_flight_monitor_);
+      while ((rest != NULL) && (submitted < sq_entries_) &&
+             (in_flight_ < cq_entries_)) {
+        if ((rest->length() - rest->transferred()) > kMaxRingRequestLength) {
+          break;
+        }
+        FileIORequest* request = rest;
+        rest = request->next();
+        request->set_next(NULL);
+        unsigned index = tail & sq_mask_;
+        struct io_uring_sqe* sqe = &sqes_[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = (request->operation() == FileIORequest::kWrite)
+                          ? IORING_OP_WRITE
+                          : IORING_OP_READ;
+        sqe->fd = request->file()->GetFD();
+        // An offset of -1 reads or writes at the current file position.
+        sqe->off = static_cast<uint64_t>(-1);
+        sqe->addr = reinterpret_cast<uint64_t>(request->buffer() +
+                                               request->transferred());
+        sqe->len =
+            static_cast<uint32_t>(request->length() - request->transferred());
+        sqe->user_data = reinterpret_cast<uint64_t>(request);
+        sq_array_[index] = index;
+        tail++;
+        submitted++;
+        in_flight_++;
+      }
+    }
+    if (submitted == 0) {
+      return rest;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    unsigned consumed = 0;
+    intptr_t retries = 0;
+    while (consumed < submitted) {
+      int result = Enter(submitted - consumed, 0, 0);
+      if (result > 0) {
+        consumed += result;
+        continue;
+      }
+      // EAGAIN means the kernel is short of memory for the requests, and
+      // EBUSY that completions have to be consumed first. Both pass.
+      if (((result == 0) || (errno == EAGAIN) || (errno == EBUSY)) &&
+          (retries++ < kMaxSubmitRetries)) {
+        sched_yield();
+        continue;
+      }
+      break;
+    }
+    if (consumed == submitted) {
+      return rest;
+    }
+    // The kernel consumes entries in order and has not looked at the rest,
+    // so take them back and leave them to the worker threads.
+    unsigned unconsumed = submitted - consumed;
+    __atomic_store_n(sq_tail_, tail - unconsumed, __ATOMIC_RELEASE);
+    {
+      MonitorLocker ml(&in_flight_monitor_);
+      in_flight_ -= unconsumed;
+      if (in_flight_ == 0) {
+        ml.Notify();
+      }
+    }
+    for (unsigned i = 0; i < unconsumed; i++) {
+      struct io_uring_sqe* sqe = &sqes_[(tail - 1 - i) & sq_mask_];
+      FileIORequest* request = reinterpret_cast<FileIORequest*>(sqe->user_data);
+      request->set_next(rest);
+      rest = request;
+    }
+    ASSERT(tail - unconsumed == old_tail + consumed);
+    return rest;
+  }
+
+  // Waits for the requests in flight to complete, then asks the completion
+  // thread to exit and waits for it to do so. No new requests may be
+  // submitted once this is called.
+  void Shutdown() {
+    {
+      MonitorLocker ml(&in_flight_monitor_);
+      while (in_flight_ > 0) {
+        ml.Wait();
+      }
+    }
+    MonitorLocker ml(&thread_monitor_);
+    shutdown_ = true;
+    // The completion thread is blocked waiting for a completion, so wake it
+    // with a no-op. With nothing in flight the completion ring has room for
+    // it, but the submission ring has to be checked: entries are normally
+    // consumed by Submit, and any that are left have to go first.
+    unsigned tail = *sq_tail_;
+    while ((tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) >=
+           sq_entries_) {
+      if (Enter(sq_entries_, 0, 0) <= 0) {
+        sched_yield();
+      }
+    }
+    unsigned index = tail & sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = 0;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    while (Enter(1, 0, 0) <= 0) {
+      sched_yield();
+    }
+    while (!thread_done_) {
+      ml.Wait();
+    }
+  }
+
+  static void CompletionThreadMain(uword parameters) {
+    reinterpret_cast<IOURing*>(parameters)->ProcessCompletions();
+  }
+
+ private:
+  // Returns the number of submission entries consumed, or -1 with errno set.
+  int Enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    while (true) {
+      int result = syscall(__NR_io_uring_enter, fd_, to_submit, min_complete,
+                           flags, NULL, 0);
+      if ((result >= 0) || (errno != EINTR)) {
+        return result;
+      }
+    }
+  }
+
+  void ProcessCompletions() {
+    while (true) {
+      Enter(0, 1, IORING_ENTER_GETEVENTS);
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      bool exit = false;
+      bool resubmit = false;
+      while (head != tail) {
+        struct io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+        FileIORequest* request =
+            reinterpret_cast<FileIORequest*>(cqe->user_data);
+        int32_t result = cqe->res;
+        head++;
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        if (request == NULL) {
+          exit = true;
+          continue;
+        }
+        resubmit = Complete(request, result) || resubmit;
+        {
+          MonitorLocker ml(&in_flight_monitor_);
+          in_flight_--;
+          if (in_flight_ == 0) {
+            ml.Notify();
+          }
+        }
+      }
+      if (resubmit) {
+        FileIOEngine::Submit();
+      }
+      if (exit) {
+        MonitorLocker ml(&thread_monitor_);
+        if (shutdown_) {
+          thread_done_ = true;
+          ml.Notify();
+          return;
+        }
+      }
+    }
+  }
+
+  // Returns true if |request| was queued again instead of being completed.
+  static bool Complete(FileIORequest* request, int32_t result) {
+    if (result < 0) {
+      request->Complete(-1, -result);
+      return false;
+    }
+    if (request->operation() == FileIORequest::kWrite) {
+      // writeFrom writes the whole buffer, so a short write is queued again
+      // for the rest rather than finished here, which would hold up the
+      // completions behind it.
+      int64_t transferred = request->transferred() + result;
+      if ((result > 0) && (transferred < request->length())) {
+        request->set_transferred(transferred);
+        FileIOEngine::Enqueue(request);
+        return true;
+      }
+      request->Complete(transferred, 0);
+      return false;
+    }
+    request->Complete(result, 0);
+    return false;
+  }
+
+  int fd_;
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  struct io_uring_sqe* sqes_;
+  size_t sqes_size_;
+
+  unsigned* sq_head_;
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+  unsigned* sq_array_;
+  unsigned sq_entries_;
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  struct io_uring_cqe* cqes_;
+  unsigned cq_entries_;
+
+  // The number of submitted requests whose completions have not been
+  // consumed. Kept below the completion ring size so it cannot overflow.
+  // Shutdown waits on the monitor for it to drop to zero.
+  Monitor in_flight_monitor_;
+  unsigned in_flight_;
+
+  Monitor thread_monitor_;
+  bool shutdown_;
+  bool thread_done_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOURing);
+};
+
+static IOURing* ring = NULL;
+
+bool FileIOEngine::StartPlatformBackend() {
+  ASSERT(ring == NULL);
+  IOURing* new_ring = new IOURing();
+  if (!new_ring->Setup()) {
+    delete new_ring;
+    return false;
+  }
+  int result =
+      Thread::Start("dart:io FileIOEngine", IOURing::CompletionThreadMain,
+                    reinterpret_cast<uword>(new_ring));
+  if (result != 0) {
+    Syslog::PrintErr("Failed to start io_uring completion thread: %d\n",
+                     result);
+    delete new_ring;
+    return false;
+  }
+  ring = new_ring;
+  return true;
+}
+
+FileIORequest* FileIOEngine::SubmitToPlatformBackend(FileIORequest* requests) {
+  ASSERT(ring != NULL);
+  return ring->Submit(requests);
+}
+
+void FileIOEngine::StopPlatformBackend() {
+  ring->Shutdown();
+  delete ring;
+  ring = NULL;
+}
+
+#else  // defined(USE_IO_URING)
+
+bool FileIOEngine::StartPlatformBackend() {
+  return false;
+}
+
+FileIORequest* FileIOEngine::SubmitToPlatformBackend(FileIORequest* requests) {
+  return requests;
+}
+
+void FileIOEngine::StopPlatformBackend() {}
+
+#endif  // defined(USE_IO_URING)
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX)
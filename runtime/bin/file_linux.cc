@@ -10,9 +10,11 @@
 #include <errno.h>         // NOLINT
 #include <fcntl.h>         // NOLINT
 #include <libgen.h>        // NOLINT
+#include <sys/ioctl.h>     // NOLINT
 #include <sys/mman.h>      // NOLINT
 #include <sys/sendfile.h>  // NOLINT
 #include <sys/stat.h>      // NOLINT
+#include <sys/syscall.h>   // NOLINT
 #include <sys/types.h>     // NOLINT
 #include <unistd.h>        // NOLINT
 #include <utime.h>         // NOLINT
@@ -24,6 +26,11 @@
 #include "platform/syslog.h"
 #include "platform/utils.h"
 
+// Defined in linux/fs.h, which is missing it before Linux 4.5.
+#if !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
 namespace dart {
 namespace bin {
 
@@ -108,11 +115,41 @@ void MappedMemory::Unmap() {
   size_ = 0;
 }
 
+void MappedMemory::Advise(Advice advice) {
+  int posix_advice = MADV_NORMAL;
+  switch (advice) {
+    case kNormal:
+      posix_advice = MADV_NORMAL;
+      break;
+    case kSequential:
+      posix_advice = MADV_SEQUENTIAL;
+      break;
+    case kRandom:
+      posix_advice = MADV_RANDOM;
+      break;
+    case kWillNeed:
+      posix_advice = MADV_WILLNEED;
+      break;
+  }
+  // Failing to apply the hint is harmless.
+  VOID_NO_RETRY_EXPECTED(madvise(address_, size_, posix_advice));
+}
+
+intptr_t File::MapAlignment() {
+  return sysconf(_SC_PAGESIZE);
+}
+
 int64_t File::Read(void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return TEMP_FAILURE_RETRY(read(handle_->fd(), buffer, num_bytes));
 }
 
+int64_t File::ReadAt(void* buffer, int64_t num_bytes, int64_t position) {
+  ASSERT(handle_->fd() >= 0);
+  return TEMP_FAILURE_RETRY(
+      pread64(handle_->fd(), buffer, num_bytes, position));
+}
+
 int64_t File::Write(const void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return TEMP_FAILURE_RETRY(write(handle_->fd(), buffer, num_bytes));
@@ -400,61 +437,262 @@ bool File::RenameLink(Namespace* namespc,
                                      newns.path())) == 0);
 }
 
+// Copies up to 'length' bytes from 'old_fd' to 'new_fd', reading and
+// writing both at 'offset', and advances 'offset' past the copied bytes.
+// Returns the number of bytes copied, which is less than 'length' only if
+// the end of 'old_fd' was reached, or -1 on failure.
+static int64_t CopyRange(int old_fd,
+                         int new_fd,
+                         int64_t* offset,
+                         int64_t length) {
+  const int64_t start = *offset;
+  const int64_t end = start + length;
+  // At most this much is copied by a single system call.
+  const int64_t kMaxStep = 1 * GB;
+  const intptr_t methods = File::copy_methods();
+#if defined(__NR_copy_file_range)
+  // copy_file_range copies within the kernel, and lets file systems share
+  // or copy the data on the device. Fall back to sendfile if it is not
+  // supported for these files. It also does not work for files of pseudo
+  // file systems like procfs, which report a size of 0 and for which it
+  // returns 0 right away, so an end of file is confirmed with sendfile.
+  while (((methods & File::kCopyFileRange) != 0) && (*offset < end)) {
+    loff_t in_offset = *offset;
+    loff_t out_offset = *offset;
+    const int64_t result = NO_RETRY_EXPECTED(
+        syscall(__NR_copy_file_range, old_fd, &in_offset, new_fd, &out_offset,
+                Utils::Minimum(end - *offset, kMaxStep), 0));
+    if (result <= 0) {
+      if ((result < 0) && (errno != ENOSYS) && (errno != EXDEV) &&
+          (errno != EINVAL) && (errno != EOPNOTSUPP) && (errno != EBADF)) {
+        return -1;
+      }
+      break;
+    }
+    *offset += result;
+  }
+  if (*offset == end) {
+    return length;
+  }
+#endif  // defined(__NR_copy_file_range)
+  // sendfile writes at the position of 'new_fd'.
+  if (NO_RETRY_EXPECTED(lseek64(new_fd, *offset, SEEK_SET)) < 0) {
+    return -1;
+  }
+  while (((methods & File::kCopySendFile) != 0) && (*offset < end)) {
+    const int64_t result = NO_RETRY_EXPECTED(sendfile64(
+        new_fd, old_fd, offset, Utils::Minimum(end - *offset, kMaxStep)));
+    if (result == 0) {
+      return *offset - start;
+    }
+    if (result < 0) {
+      // From sendfile man pages:
+      //   Applications may wish to fall back to read(2)/write(2) in the case
+      //   where sendfile() fails with EINVAL or ENOSYS.
+      if ((errno != EINVAL) && (errno != ENOSYS)) {
+        return -1;
+      }
+      break;
+    }
+  }
+  if ((methods & File::kCopyReadWrite) == 0) {
+    errno = ENOTSUP;
+    return -1;
+  }
+  const int64_t kBufferSize = 8 * KB;
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(kBufferSize));
+  while (*offset < end) {
+    const intptr_t result = TEMP_FAILURE_RETRY(
+        pread64(old_fd, buffer, Utils::Minimum(end - *offset, kBufferSize),
+                *offset));
+    if (result <= 0) {
+      free(buffer);
+      return (result == 0) ? *offset - start : -1;
+    }
+    const intptr_t wrote =
+        TEMP_FAILURE_RETRY(pwrite64(new_fd, buffer, result, *offset));
+    if (wrote != result) {
+      free(buffer);
+      return -1;
+    }
+    *offset += result;
+  }
+  free(buffer);
+  return length;
+}
+
+// Returns whether 'st' describes the file recorded in 'identity'.
+static bool SameFile(const struct stat64& st,
+                     const int64_t* identity,
+                     intptr_t device_index,
+                     intptr_t inode_index) {
+  return (identity[device_index] == static_cast<int64_t>(st.st_dev)) &&
+         (identity[inode_index] == static_cast<int64_t>(st.st_ino));
+}
+
+// Closes 'fd' if it is open, keeping errno.
+static void CloseKeepingErrno(int fd) {
+  if (fd >= 0) {
+    FDUtils::SaveErrorAndClose(fd);
+  }
+}
+
+// Opens 'old_path' and 'new_path' for copying from 'offset', and tries to
+// clone the whole file when 'offset' is 0. Sets 'done' if the file was
+// cloned. When 'offset' is 0 the identity of the files is stored in
+// 'identity', otherwise they are checked against it. Sets 'owned' once
+// 'new_path' is known to be the file the copy writes to, also on failure.
+static bool OpenForCopy(Namespace* namespc,
+                        const char* old_path,
+                        const char* new_path,
+                        int64_t offset,
+                        int64_t* identity,
+                        int* old_fd,
+                        int* new_fd,
+                        bool* owned,
+                        bool* done) {
+  *owned = false;
+  *old_fd = -1;
+  *new_fd = -1;
+  NamespaceScope oldns(namespc, old_path);
+  NamespaceScope newns(namespc, new_path);
+  struct stat64 new_st;
+  if (offset > 0) {
+    // The new file is identified first, so that it is deleted if the old
+    // one has gone away. Another file now at 'new_path' is left alone.
+    *new_fd = TEMP_FAILURE_RETRY(
+        openat64(newns.fd(), newns.path(), O_WRONLY | O_CLOEXEC));
+    if ((*new_fd < 0) ||
+        (NO_RETRY_EXPECTED(fstat64(*new_fd, &new_st)) != 0)) {
+      CloseKeepingErrno(*new_fd);
+      return false;
+    }
+    *owned = SameFile(new_st, identity, File::kCopyNewDevice,
+                      File::kCopyNewInode);
+    if (!*owned || (new_st.st_size != offset)) {
+      close(*new_fd);
+      errno = ESTALE;
+      return false;
+    }
+  }
+  struct stat64 old_st;
+  *old_fd = TEMP_FAILURE_RETRY(
+      openat64(oldns.fd(), oldns.path(), O_RDONLY | O_CLOEXEC));
+  if ((*old_fd < 0) || (NO_RETRY_EXPECTED(fstat64(*old_fd, &old_st)) != 0)) {
+    CloseKeepingErrno(*old_fd);
+    CloseKeepingErrno(*new_fd);
+    return false;
+  }
+  if (offset > 0) {
+    if (!SameFile(old_st, identity, File::kCopyOldDevice,
+                  File::kCopyOldInode)) {
+      close(*old_fd);
+      close(*new_fd);
+      errno = ESTALE;
+      return false;
+    }
+    *done = false;
+    return true;
+  }
+  const int flags = O_WRONLY | O_CLOEXEC | O_TRUNC | O_CREAT;
+  *new_fd = TEMP_FAILURE_RETRY(
+      openat64(newns.fd(), newns.path(), flags, old_st.st_mode));
+  if ((*new_fd < 0) || (NO_RETRY_EXPECTED(fstat64(*new_fd, &new_st)) != 0)) {
+    CloseKeepingErrno(*new_fd);
+    CloseKeepingErrno(*old_fd);
+    return false;
+  }
+  *owned = true;
+  identity[File::kCopyOldDevice] = old_st.st_dev;
+  identity[File::kCopyOldInode] = old_st.st_ino;
+  identity[File::kCopyNewDevice] = new_st.st_dev;
+  identity[File::kCopyNewInode] = new_st.st_ino;
+  // On file systems that support it, FICLONE makes the new file share the
+  // data of the old one, so nothing is copied until either is written.
+  *done = ((File::copy_methods() & File::kCopyClone) != 0) &&
+          (NO_RETRY_EXPECTED(ioctl(*new_fd, FICLONE, *old_fd)) == 0);
+  return true;
+}
+
+static void RemoveCopy(Namespace* namespc, const char* new_path) {
+  int e = errno;
+  NamespaceScope newns(namespc, new_path);
+  VOID_NO_RETRY_EXPECTED(unlinkat(newns.fd(), newns.path(), 0));
+  errno = e;
+}
+
+static void RemoveFailedCopy(Namespace* namespc,
+                             const char* new_path,
+                             int old_fd,
+                             int new_fd) {
+  int e = errno;
+  close(old_fd);
+  close(new_fd);
+  errno = e;
+  RemoveCopy(namespc, new_path);
+}
+
 bool File::Copy(Namespace* namespc,
                 const char* old_path,
                 const char* new_path) {
   if (!CheckTypeAndSetErrno(namespc, old_path, kIsFile, true)) {
     return false;
   }
-  NamespaceScope oldns(namespc, old_path);
-  struct stat64 st;
-  if (TEMP_FAILURE_RETRY(fstatat64(oldns.fd(), oldns.path(), &st, 0)) != 0) {
+  int64_t identity[kCopyIdentitySize];
+  int old_fd;
+  int new_fd;
+  bool owned;
+  bool done;
+  if (!OpenForCopy(namespc, old_path, new_path, 0, identity, &old_fd,
+                   &new_fd, &owned, &done)) {
     return false;
   }
-  const int old_fd = TEMP_FAILURE_RETRY(
-      openat64(oldns.fd(), oldns.path(), O_RDONLY | O_CLOEXEC));
-  if (old_fd < 0) {
+  int64_t offset = 0;
+  if (!done && (CopyRange(old_fd, new_fd, &offset, kMaxInt64) < 0)) {
+    RemoveFailedCopy(namespc, new_path, old_fd, new_fd);
     return false;
   }
-  NamespaceScope newns(namespc, new_path);
-  const int new_fd = TEMP_FAILURE_RETRY(
-      openat64(newns.fd(), newns.path(),
-               O_WRONLY | O_TRUNC | O_CREAT | O_CLOEXEC, st.st_mode));
-  if (new_fd < 0) {
-    close(old_fd);
-    return false;
+  close(old_fd);
+  close(new_fd);
+  return true;
+}
+
+int64_t File::CopyChunk(Namespace* namespc,
+                        const char* old_path,
+                        const char* new_path,
+                        int64_t offset,
+                        int64_t* identity,
+                        bool* done) {
+  if ((offset == 0) &&
+      !CheckTypeAndSetErrno(namespc, old_path, kIsFile, true)) {
+    return -1;
   }
-  int64_t offset = 0;
-  intptr_t result = 1;
-  while (result > 0) {
-    // Loop to ensure we copy everything, and not only up to 2GB.
-    result = NO_RETRY_EXPECTED(sendfile64(new_fd, old_fd, &offset, kMaxUint32));
-  }
-  // From sendfile man pages:
-  //   Applications may wish to fall back to read(2)/write(2) in the case
-  //   where sendfile() fails with EINVAL or ENOSYS.
-  if ((result < 0) && ((errno == EINVAL) || (errno == ENOSYS))) {
-    const intptr_t kBufferSize = 8 * KB;
-    uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(kBufferSize));
-    while ((result = TEMP_FAILURE_RETRY(read(old_fd, buffer, kBufferSize))) >
-           0) {
-      int wrote = TEMP_FAILURE_RETRY(write(new_fd, buffer, result));
-      if (wrote != result) {
-        result = -1;
-        break;
-      }
+  int old_fd;
+  int new_fd;
+  bool owned;
+  if (!OpenForCopy(namespc, old_path, new_path, offset, identity, &old_fd,
+                   &new_fd, &owned, done)) {
+    if (owned) {
+      RemoveCopy(namespc, new_path);
     }
-    free(buffer);
+    return -1;
   }
-  int e = errno;
+  if (*done) {
+    // The file was cloned. The offset is not used once the copy is done.
+    close(old_fd);
+    close(new_fd);
+    return 0;
+  }
+  const int64_t chunk_size = copy_chunk_size();
+  const int64_t copied = CopyRange(old_fd, new_fd, &offset, chunk_size);
+  if (copied < 0) {
+    RemoveFailedCopy(namespc, new_path, old_fd, new_fd);
+    return -1;
+  }
+  *done = copied < chunk_size;
   close(old_fd);
   close(new_fd);
-  if (result < 0) {
-    VOID_NO_RETRY_EXPECTED(unlinkat(newns.fd(), newns.path(), 0));
-    errno = e;
-    return false;
-  }
-  return true;
+  return offset;
 }
 
 static bool StatHelper(Namespace* namespc,
@@ -494,8 +732,12 @@ static void MillisecondsToTimespec(int64_t millis, struct timespec* t) {
 
 void File::Stat(Namespace* namespc, const char* name, int64_t* data) {
   NamespaceScope ns(namespc, name);
+  StatAt(ns.fd(), ns.path(), data);
+}
+
+void File::StatAt(intptr_t dir_fd, const char* path, int64_t* data) {
   struct stat64 st;
-  if (TEMP_FAILURE_RETRY(fstatat64(ns.fd(), ns.path(), &st, 0)) == 0) {
+  if (TEMP_FAILURE_RETRY(fstatat64(dir_fd, path, &st, 0)) == 0) {
     if (S_ISREG(st.st_mode)) {
       data[kType] = kIsFile;
     } else if (S_ISDIR(st.st_mode)) {
@@ -14,6 +14,8 @@
 namespace dart {
 namespace bin {
 
+int64_t FileSystemWatcher::coalescing_window_millis_ = 0;
+
 void FUNCTION_NAME(FileSystemWatcher_IsSupported)(Dart_NativeArguments args) {
   Dart_SetBooleanReturnValue(args, FileSystemWatcher::IsSupported());
 }
@@ -48,7 +48,18 @@ class FileSystemWatcher {
   static intptr_t GetSocketId(intptr_t id, intptr_t path_id);
   static Dart_Handle ReadEvents(intptr_t id, intptr_t path_id);
 
+  // How long events are held back and merged before a watcher is notified of
+  // them. Only used on Linux.
+  static int64_t coalescing_window_millis() {
+    return coalescing_window_millis_;
+  }
+  static void set_coalescing_window_millis(int64_t millis) {
+    coalescing_window_millis_ = millis;
+  }
+
  private:
+  static int64_t coalescing_window_millis_;
+
   DISALLOW_COPY_AND_ASSIGN(FileSystemWatcher);
 };
 
@@ -7,71 +7,48 @@
 
 #include "bin/file_system_watcher.h"
 
+#include <dirent.h>       // NOLINT
 #include <errno.h>        // NOLINT
+#include <fcntl.h>        // NOLINT
+#include <poll.h>         // NOLINT
 #include <sys/inotify.h>  // NOLINT
+#include <sys/stat.h>     // NOLINT
+#include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
 #include "bin/file.h"
-#include "bin/socket.h"
+#include "bin/lockers.h"
+#include "bin/thread.h"
+#include "bin/utils.h"
+#include "platform/hashmap.h"
 #include "platform/signal_blocker.h"
+#include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
 
-bool FileSystemWatcher::IsSupported() {
-  return true;
-}
+static const int kDeleteOrMove = FileSystemWatcher::kDelete |
+                                 FileSystemWatcher::kMove |
+                                 FileSystemWatcher::kDeleteSelf;
 
-intptr_t FileSystemWatcher::Init() {
-  int id = NO_RETRY_EXPECTED(inotify_init1(IN_CLOEXEC));
-  if (id < 0) {
-    return -1;
+static char* StrDup(const char* s) {
+  char* result = strdup(s);
+  if (result == NULL) {
+    OUT_OF_MEMORY();
   }
-  // Some systems dosn't support setting this as non-blocking. Since watching
-  // internals are kept away from the user, we know it's possible to continue,
-  // even if setting non-blocking fails.
-  FDUtils::SetNonBlocking(id);
-  return id;
+  return result;
 }
 
-void FileSystemWatcher::Close(intptr_t id) {
-  USE(id);
-}
-
-intptr_t FileSystemWatcher::WatchPath(intptr_t id,
-                                      Namespace* namespc,
-                                      const char* path,
-                                      int events,
-                                      bool recursive) {
-  int list_events = IN_DELETE_SELF | IN_MOVE_SELF;
-  if ((events & kCreate) != 0) {
-    list_events |= IN_CREATE;
+// Returns |relative|/|name|, or a copy of the non-empty one of them.
+static char* JoinPath(const char* relative, const char* name) {
+  if (relative[0] == '\0') {
+    return StrDup(name);
   }
-  if ((events & kModifyContent) != 0) {
-    list_events |= IN_CLOSE_WRITE | IN_ATTRIB;
+  if (name[0] == '\0') {
+    return StrDup(relative);
   }
-  if ((events & kDelete) != 0) {
-    list_events |= IN_DELETE;
-  }
-  if ((events & kMove) != 0) {
-    list_events |= IN_MOVE;
-  }
-  const char* resolved_path = File::GetCanonicalPath(namespc, path);
-  path = resolved_path != NULL ? resolved_path : path;
-  int path_id = NO_RETRY_EXPECTED(inotify_add_watch(id, path, list_events));
-  if (path_id < 0) {
-    return -1;
-  }
-  return path_id;
-}
-
-void FileSystemWatcher::UnwatchPath(intptr_t id, intptr_t path_id) {
-  VOID_NO_RETRY_EXPECTED(inotify_rm_watch(id, path_id));
-}
-
-intptr_t FileSystemWatcher::GetSocketId(intptr_t id, intptr_t path_id) {
-  USE(path_id);
-  return id;
+  return Utils::SCreate("%s/%s", relative, name);
 }
 
 static int InotifyEventToMask(struct inotify_event* e) {
@@ -100,47 +77,749 @@ static int InotifyEventToMask(struct inotify_event* e) {
   return mask;
 }
 
-Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
-  USE(path_id);
-  const intptr_t kEventSize = sizeof(struct inotify_event);
-  const intptr_t kBufferSize = kEventSize + NAME_MAX + 1;
-  uint8_t buffer[kBufferSize];
-  intptr_t bytes =
-      SocketBase::Read(id, buffer, kBufferSize, SocketBase::kAsync);
-  if (bytes < 0) {
-    return DartUtils::NewDartOSError();
-  }
-  const intptr_t kMaxCount = bytes / kEventSize;
-  Dart_Handle events = Dart_NewList(kMaxCount);
-  intptr_t offset = 0;
-  intptr_t i = 0;
-  while (offset < bytes) {
-    struct inotify_event* e =
-        reinterpret_cast<struct inotify_event*>(buffer + offset);
-    if ((e->mask & IN_IGNORED) == 0) {
+// All the paths watched by one isolate share an inotify instance, which is
+// read by a background thread instead of by the isolate:
+//
+//  - Each watched path is a root, identified by the path id returned from
+//    WatchPath. The subdirectories of a recursive root get their own inotify
+//    watches, which the thread adds as it finds them.
+//  - Events are queued and the isolate is notified through a pipe, which is
+//    the socket the isolate listens on. Notifications are delayed by the
+//    coalescing window, and until the isolate reads the queue, further events
+//    for a path that only repeat or add modifications to its last queued
+//    event are merged into it. A merged event keeps the bits of all the
+//    events it stands for, so a create followed by a modification is still
+//    reported to Dart as a create event and then a modify event. Creates,
+//    deletes and moves are never reordered.
+class InotifyWatcher {
+ public:
+  InotifyWatcher()
+      : inotify_fd_(-1),
+        coalescing_window_(FileSystemWatcher::coalescing_window_millis()),
+        nodes_(&SimpleHashMap::SamePointerValue, 64),
+        pending_map_(&SamePendingEvent, 64),
+        roots_(NULL),
+        next_root_id_(1),
+        scans_(NULL),
+        pending_head_(NULL),
+        pending_tail_(NULL),
+        notify_deadline_(0),
+        notified_(false),
+        shutdown_(false),
+        thread_done_(false) {
+    notify_fds_[0] = notify_fds_[1] = -1;
+    control_fds_[0] = control_fds_[1] = -1;
+  }
+
+  ~InotifyWatcher() {
+    for (SimpleHashMap::Entry* entry = nodes_.Start(); entry != NULL;
+         entry = nodes_.Next(entry)) {
+      delete reinterpret_cast<Node*>(entry->value);
+    }
+    while (roots_ != NULL) {
+      Root* root = roots_;
+      roots_ = root->next;
+      delete root;
+    }
+    while (scans_ != NULL) {
+      Scan* scan = scans_;
+      scans_ = scan->next;
+      delete scan;
+    }
+    ClearPendingLocked(TakePendingLocked());
+    if (inotify_fd_ >= 0) {
+      FDUtils::SaveErrorAndClose(inotify_fd_);
+    }
+    // The read end of the notification pipe is owned by the socket the
+    // isolate listens on.
+    if (notify_fds_[1] >= 0) {
+      FDUtils::SaveErrorAndClose(notify_fds_[1]);
+    }
+    if (control_fds_[0] >= 0) {
+      FDUtils::SaveErrorAndClose(control_fds_[0]);
+      FDUtils::SaveErrorAndClose(control_fds_[1]);
+    }
+  }
+
+  bool Start() {
+    inotify_fd_ = NO_RETRY_EXPECTED(inotify_init1(IN_CLOEXEC | IN_NONBLOCK));
+    if (inotify_fd_ < 0) {
+      return false;
+    }
+    if ((NO_RETRY_EXPECTED(pipe2(notify_fds_, O_CLOEXEC | O_NONBLOCK)) != 0) ||
+        (NO_RETRY_EXPECTED(pipe2(control_fds_, O_CLOEXEC | O_NONBLOCK)) !=
+         0)) {
+      return false;
+    }
+    int result = Thread::Start("dart:io FileWatcher", &ThreadMain,
+                               reinterpret_cast<uword>(this));
+    if (result != 0) {
+      errno = result;
+      return false;
+    }
+    return true;
+  }
+
+  // Stops the thread. The watcher can be deleted afterwards.
+  void Stop() {
+    {
+      MutexLocker ml(&mutex_);
+      shutdown_ = true;
+    }
+    WakeThread();
+    MonitorLocker ml(&thread_monitor_);
+    while (!thread_done_) {
+      ml.Wait();
+    }
+  }
+
+  int read_fd() const { return notify_fds_[0]; }
+
+  intptr_t WatchPath(const char* path, int events, bool recursive) {
+    uint32_t mask = IN_DELETE_SELF | IN_MOVE_SELF;
+    if ((events & FileSystemWatcher::kCreate) != 0) {
+      mask |= IN_CREATE;
+    }
+    if ((events & FileSystemWatcher::kModifyContent) != 0) {
+      mask |= IN_CLOSE_WRITE | IN_ATTRIB;
+    }
+    if ((events & FileSystemWatcher::kDelete) != 0) {
+      mask |= IN_DELETE;
+    }
+    if ((events & FileSystemWatcher::kMove) != 0) {
+      mask |= IN_MOVE;
+    }
+    if (recursive) {
+      // New and moved subdirectories have to be watched as well.
+      mask |= IN_CREATE | IN_MOVE;
+    }
+    Root* root;
+    {
+      MutexLocker ml(&mutex_);
+      // Other roots may already watch the same inode, so the masks are
+      // combined.
+      int wd = NO_RETRY_EXPECTED(
+          inotify_add_watch(inotify_fd_, path, mask | IN_MASK_ADD));
+      if (wd < 0) {
+        return -1;
+      }
+      root = new Root(next_root_id_++, path, events, mask, recursive, roots_);
+      roots_ = root;
+      BindLocked(wd, root, "");
+      if (recursive) {
+        scans_ = new Scan(root->id, "", false, scans_);
+      }
+    }
+    if (recursive) {
+      WakeThread();
+    }
+    return root->id;
+  }
+
+  void UnwatchPath(intptr_t root_id) {
+    MutexLocker ml(&mutex_);
+    Root** link = &roots_;
+    while ((*link != NULL) && ((*link)->id != root_id)) {
+      link = &(*link)->next;
+    }
+    Root* root = *link;
+    if (root == NULL) {
+      return;
+    }
+    *link = root->next;
+    UnbindLocked(root, NULL);
+    delete root;
+  }
+
+  Dart_Handle ReadEvents() {
+    PendingEvent* events;
+    {
+      MutexLocker ml(&mutex_);
+      events = TakePendingLocked();
+      // Consume the notification. The next event queued sends a new one.
+      uint8_t buffer[16];
+      while (TEMP_FAILURE_RETRY(
+                 read(notify_fds_[0], buffer, sizeof(buffer))) > 0) {
+      }
+      notified_ = false;
+    }
+    intptr_t count = 0;
+    for (PendingEvent* e = events; e != NULL; e = e->next) {
+      count++;
+    }
+    Dart_Handle result = Dart_NewList(count);
+    intptr_t i = 0;
+    for (PendingEvent* e = events; e != NULL; e = e->next) {
       Dart_Handle event = Dart_NewList(5);
-      int mask = InotifyEventToMask(e);
-      Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
+      Dart_ListSetAt(event, 0, Dart_NewInteger(e->mask));
       Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
-      if (e->len > 0) {
+      if (e->name[0] != '\0') {
         Dart_Handle name = Dart_NewStringFromUTF8(
             reinterpret_cast<uint8_t*>(e->name), strlen(e->name));
         if (Dart_IsError(name)) {
+          ClearPendingLocked(events);
           return name;
         }
         Dart_ListSetAt(event, 2, name);
       } else {
         Dart_ListSetAt(event, 2, Dart_Null());
       }
-      Dart_ListSetAt(event, 3, Dart_NewBoolean((e->mask & IN_MOVED_TO) != 0u));
-      Dart_ListSetAt(event, 4, Dart_NewInteger(e->wd));
-      Dart_ListSetAt(events, i, event);
-      i++;
+      Dart_ListSetAt(event, 3, Dart_NewBoolean(e->moved_to));
+      Dart_ListSetAt(event, 4, Dart_NewInteger(e->root_id));
+      Dart_ListSetAt(result, i++, event);
+    }
+    ClearPendingLocked(events);
+    return result;
+  }
+
+ private:
+  struct Root {
+    Root(intptr_t id,
+         const char* path,
+         int events,
+         uint32_t mask,
+         bool recursive,
+         Root* next)
+        : id(id),
+          path(StrDup(path)),
+          events(events),
+          mask(mask),
+          recursive(recursive),
+          next(next) {}
+    ~Root() { free(path); }
+
+    const intptr_t id;
+    char* path;
+    const int events;
+    const uint32_t mask;
+    const bool recursive;
+    Root* next;
+  };
+
+  // A path below |root|, relative to it, that an inotify watch reports on.
+  struct Binding {
+    Binding(Root* root, const char* relative, Binding* next)
+        : root(root), relative(StrDup(relative)), next(next) {}
+    ~Binding() { free(relative); }
+
+    Root* root;
+    char* relative;
+    Binding* next;
+  };
+
+  // An inotify watch. Several roots can watch the same directory.
+  struct Node {
+    explicit Node(int wd) : wd(wd), bindings(NULL) {}
+    ~Node() {
+      while (bindings != NULL) {
+        Binding* binding = bindings;
+        bindings = binding->next;
+        delete binding;
+      }
+    }
+
+    const int wd;
+    Binding* bindings;
+  };
+
+  // A request for the thread to watch the directory |relative| below a
+  // recursive root and all directories below it. With |report|, the entries
+  // found are reported as created, since they may have been created before
+  // the directory was watched.
+  struct Scan {
+    Scan(intptr_t root_id, const char* relative, bool report, Scan* next)
+        : root_id(root_id),
+          relative(StrDup(relative)),
+          report(report),
+          next(next) {}
+    ~Scan() { free(relative); }
+
+    const intptr_t root_id;
+    char* relative;
+    const bool report;
+    Scan* next;
+  };
+
+  struct PendingEvent {
+    intptr_t root_id;
+    char* name;
+    int mask;
+    uint32_t cookie;
+    bool moved_to;
+    PendingEvent* next;
+  };
+
+  static bool SamePendingEvent(void* key1, void* key2) {
+    PendingEvent* a = reinterpret_cast<PendingEvent*>(key1);
+    PendingEvent* b = reinterpret_cast<PendingEvent*>(key2);
+    return (a->root_id == b->root_id) && (strcmp(a->name, b->name) == 0);
+  }
+
+  static uint32_t PendingEventHash(PendingEvent* e) {
+    return SimpleHashMap::StringHash(e->name) ^
+           static_cast<uint32_t>(e->root_id);
+  }
+
+  static void* NodeKey(int wd) {
+    return reinterpret_cast<void*>(static_cast<intptr_t>(wd));
+  }
+
+  static uint32_t NodeHash(int wd) { return static_cast<uint32_t>(wd); }
+
+  Node* FindNodeLocked(int wd) {
+    SimpleHashMap::Entry* entry = nodes_.Lookup(NodeKey(wd), NodeHash(wd),
+                                                false);
+    return (entry == NULL) ? NULL : reinterpret_cast<Node*>(entry->value);
+  }
+
+  Root* FindRootLocked(intptr_t id) {
+    for (Root* root = roots_; root != NULL; root = root->next) {
+      if (root->id == id) {
+        return root;
+      }
+    }
+    return NULL;
+  }
+
+  void BindLocked(int wd, Root* root, const char* relative) {
+    SimpleHashMap::Entry* entry =
+        nodes_.Lookup(NodeKey(wd), NodeHash(wd), true);
+    if (entry->value == NULL) {
+      entry->value = new Node(wd);
+    }
+    Node* node = reinterpret_cast<Node*>(entry->value);
+    for (Binding* b = node->bindings; b != NULL; b = b->next) {
+      if ((b->root == root) && (strcmp(b->relative, relative) == 0)) {
+        return;
+      }
     }
-    offset += kEventSize + e->len;
+    node->bindings = new Binding(root, relative, node->bindings);
   }
-  ASSERT(offset == bytes);
-  return events;
+
+  // Removes the bindings of |root| to |relative| and the directories below
+  // it, or all of them if |relative| is NULL. Watches left without bindings
+  // are removed.
+  void UnbindLocked(Root* root, const char* relative) {
+    intptr_t relative_length = (relative == NULL) ? 0 : strlen(relative);
+    intptr_t unused_count = 0;
+    Node** unused_nodes = NULL;
+    for (SimpleHashMap::Entry* entry = nodes_.Start(); entry != NULL;
+         entry = nodes_.Next(entry)) {
+      Node* node = reinterpret_cast<Node*>(entry->value);
+      Binding** link = &node->bindings;
+      while (*link != NULL) {
+        Binding* b = *link;
+        bool matches =
+            (b->root == root) &&
+            ((relative == NULL) ||
+             ((strncmp(b->relative, relative, relative_length) == 0) &&
+              ((b->relative[relative_length] == '\0') ||
+               (b->relative[relative_length] == '/'))));
+        if (matches) {
+          *link = b->next;
+          delete b;
+        } else {
+          link = &b->next;
+        }
+      }
+      if (node->bindings == NULL) {
+        unused_nodes = reinterpret_cast<Node**>(
+            realloc(unused_nodes, (unused_count + 1) * sizeof(Node*)));
+        if (unused_nodes == NULL) {
+          OUT_OF_MEMORY();
+        }
+        unused_nodes[unused_count++] = node;
+      }
+    }
+    // Entries cannot be removed while iterating the map.
+    for (intptr_t i = 0; i < unused_count; i++) {
+      Node* node = unused_nodes[i];
+      VOID_NO_RETRY_EXPECTED(inotify_rm_watch(inotify_fd_, node->wd));
+      RemoveNodeLocked(node);
+    }
+    free(unused_nodes);
+  }
+
+  void RemoveNodeLocked(Node* node) {
+    nodes_.Remove(NodeKey(node->wd), NodeHash(node->wd));
+    delete node;
+  }
+
+  void QueueEventLocked(Root* root,
+                        const char* name,
+                        int mask,
+                        uint32_t cookie,
+                        bool moved_to) {
+    int allowed = root->events | FileSystemWatcher::kDeleteSelf |
+                  FileSystemWatcher::kIsDir;
+    if ((root->events & FileSystemWatcher::kModifyContent) != 0) {
+      allowed |= FileSystemWatcher::kModefyAttribute;
+    }
+    mask &= allowed;
+    if ((mask & ~FileSystemWatcher::kIsDir) == 0) {
+      return;
+    }
+    PendingEvent key;
+    key.root_id = root->id;
+    key.name = const_cast<char*>(name);
+    uint32_t hash = PendingEventHash(&key);
+    SimpleHashMap::Entry* entry = pending_map_.Lookup(&key, hash, true);
+    PendingEvent* last = reinterpret_cast<PendingEvent*>(entry->value);
+    if ((last != NULL) && (cookie == 0) && (last->cookie == 0) &&
+        ((last->mask & kDeleteOrMove) == 0) && ((mask & kDeleteOrMove) == 0) &&
+        (((mask & FileSystemWatcher::kCreate) == 0) ||
+         ((last->mask & FileSystemWatcher::kCreate) != 0))) {
+      // A repeated event, or a modification of a path that was created or
+      // modified since the isolate last read the queue. The isolate turns
+      // each bit into its own event, so the modification is not lost.
+      last->mask |= mask;
+      return;
+    }
+    PendingEvent* e = new PendingEvent();
+    e->root_id = root->id;
+    e->name = StrDup(name);
+    e->mask = mask;
+    e->cookie = cookie;
+    e->moved_to = moved_to;
+    e->next = NULL;
+    // The map entry refers to the latest event for the path.
+    entry->key = e;
+    entry->value = e;
+    if (pending_tail_ == NULL) {
+      pending_head_ = e;
+      notify_deadline_ =
+          TimerUtils::GetCurrentMonotonicMillis() + coalescing_window_;
+    } else {
+      pending_tail_->next = e;
+    }
+    pending_tail_ = e;
+  }
+
+  PendingEvent* TakePendingLocked() {
+    PendingEvent* events = pending_head_;
+    pending_head_ = NULL;
+    pending_tail_ = NULL;
+    pending_map_.Clear();
+    return events;
+  }
+
+  static void ClearPendingLocked(PendingEvent* events) {
+    while (events != NULL) {
+      PendingEvent* e = events;
+      events = e->next;
+      free(e->name);
+      delete e;
+    }
+  }
+
+  // Returns the poll timeout until the isolate should be notified.
+  int NotifyLocked() {
+    if ((pending_head_ == NULL) || notified_) {
+      return -1;
+    }
+    int64_t delay =
+        notify_deadline_ - TimerUtils::GetCurrentMonotonicMillis();
+    if (delay > 0) {
+      return static_cast<int>(delay);
+    }
+    uint8_t byte = 1;
+    VOID_TEMP_FAILURE_RETRY(write(notify_fds_[1], &byte, 1));
+    notified_ = true;
+    return -1;
+  }
+
+  void WakeThread() {
+    uint8_t byte = 1;
+    VOID_TEMP_FAILURE_RETRY(write(control_fds_[1], &byte, 1));
+  }
+
+  void HandleEventLocked(struct inotify_event* e) {
+    Node* node = FindNodeLocked(e->wd);
+    if (node == NULL) {
+      return;
+    }
+    if ((e->mask & IN_IGNORED) != 0) {
+      // The watch is gone, because the directory was deleted or the watch
+      // removed.
+      RemoveNodeLocked(node);
+      return;
+    }
+    const char* name = (e->len > 0) ? e->name : "";
+    bool is_dir = (e->mask & IN_ISDIR) != 0;
+    int mask = InotifyEventToMask(e);
+    // Changes to the bindings below only affect other nodes, since a
+    // directory cannot contain itself.
+    for (Binding* b = node->bindings; b != NULL; b = b->next) {
+      Root* root = b->root;
+      if ((e->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0) {
+        // The parent of a subdirectory reports its deletion or move.
+        if (b->relative[0] == '\0') {
+          QueueEventLocked(root, "", mask, 0, false);
+        }
+        continue;
+      }
+      char* path = JoinPath(b->relative, name);
+      if (root->recursive && is_dir && (name[0] != '\0')) {
+        if ((e->mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+          UnbindLocked(root, path);
+        }
+        if ((e->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+          // Entries may be created in a new directory before it is watched.
+          // The entries of a directory moved in are reported with the move.
+          scans_ = new Scan(root->id, path, (e->mask & IN_CREATE) != 0,
+                            scans_);
+        }
+      }
+      QueueEventLocked(root, path, mask, e->cookie,
+                       (e->mask & IN_MOVED_TO) != 0);
+      free(path);
+    }
+  }
+
+  // Watches the directories of |scan|. Only the inotify calls are made with
+  // the lock held, so that the isolate is not blocked by a scan of a large
+  // tree. The scan stops early if the watcher is shut down or the root is
+  // removed while it runs.
+  void RunScan(Scan* scan) {
+    char* root_path;
+    {
+      MutexLocker ml(&mutex_);
+      Root* root = FindRootLocked(scan->root_id);
+      if (root == NULL) {
+        return;
+      }
+      root_path = StrDup(root->path);
+    }
+    intptr_t stack_length = 1;
+    intptr_t stack_capacity = 16;
+    char** stack =
+        reinterpret_cast<char**>(malloc(stack_capacity * sizeof(char*)));
+    if (stack == NULL) {
+      OUT_OF_MEMORY();
+    }
+    stack[0] = StrDup(scan->relative);
+    while (stack_length > 0) {
+      char* relative = stack[--stack_length];
+      char* path = (relative[0] == '\0')
+                       ? StrDup(root_path)
+                       : Utils::SCreate("%s/%s", root_path, relative);
+      bool watched = true;
+      {
+        MutexLocker ml(&mutex_);
+        Root* root = shutdown_ ? NULL : FindRootLocked(scan->root_id);
+        if (root == NULL) {
+          free(path);
+          free(relative);
+          break;
+        }
+        if (relative[0] != '\0') {
+          int wd = NO_RETRY_EXPECTED(
+              inotify_add_watch(inotify_fd_, path,
+                                root->mask | IN_ONLYDIR | IN_DONT_FOLLOW |
+                                    IN_MASK_ADD));
+          if (wd >= 0) {
+            BindLocked(wd, root, relative);
+          } else {
+            watched = false;
+          }
+        }
+      }
+      DIR* dir = watched ? opendir(path) : NULL;
+      if (dir != NULL) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+          if ((strcmp(entry->d_name, ".") == 0) ||
+              (strcmp(entry->d_name, "..") == 0)) {
+            continue;
+          }
+          bool is_dir = entry->d_type == DT_DIR;
+          if (entry->d_type == DT_UNKNOWN) {
+            char* child_path = Utils::SCreate("%s/%s", path, entry->d_name);
+            struct stat st;
+            is_dir = (NO_RETRY_EXPECTED(lstat(child_path, &st)) == 0) &&
+                     S_ISDIR(st.st_mode);
+            free(child_path);
+          }
+          char* child = JoinPath(relative, entry->d_name);
+          if (scan->report) {
+            MutexLocker ml(&mutex_);
+            Root* root = FindRootLocked(scan->root_id);
+            if (root != NULL) {
+              QueueEventLocked(
+                  root, child,
+                  FileSystemWatcher::kCreate |
+                      (is_dir ? FileSystemWatcher::kIsDir : 0),
+                  0, false);
+            }
+          }
+          if (is_dir) {
+            if (stack_length == stack_capacity) {
+              stack_capacity *= 2;
+              stack = reinterpret_cast<char**>(
+                  realloc(stack, stack_capacity * sizeof(char*)));
+              if (stack == NULL) {
+                OUT_OF_MEMORY();
+              }
+            }
+            stack[stack_length++] = child;
+          } else {
+            free(child);
+          }
+        }
+        closedir(dir);
+      }
+      free(path);
+      free(relative);
+    }
+    while (stack_length > 0) {
+      free(stack[--stack_length]);
+    }
+    free(stack);
+    free(root_path);
+  }
+
+  static void ThreadMain(uword parameters) {
+    InotifyWatcher* watcher = reinterpret_cast<InotifyWatcher*>(parameters);
+    watcher->Run();
+    MonitorLocker ml(&watcher->thread_monitor_);
+    watcher->thread_done_ = true;
+    ml.Notify();
+  }
+
+  void Run() {
+    // Large enough for many events, and aligned for struct inotify_event.
+    const intptr_t kBufferSize = 64 * KB;
+    uint64_t* buffer = reinterpret_cast<uint64_t*>(malloc(kBufferSize));
+    if (buffer == NULL) {
+      OUT_OF_MEMORY();
+    }
+    int timeout = -1;
+    while (true) {
+      struct pollfd fds[2];
+      fds[0].fd = inotify_fd_;
+      fds[0].events = POLLIN;
+      fds[1].fd = control_fds_[0];
+      fds[1].events = POLLIN;
+      int result = TEMP_FAILURE_RETRY(poll(fds, 2, timeout));
+      if (result < 0) {
+        Syslog::PrintErr("Failed to poll file system watcher: %d\n", errno);
+        break;
+      }
+      if ((fds[1].revents & POLLIN) != 0) {
+        uint8_t drain[16];
+        while (TEMP_FAILURE_RETRY(read(control_fds_[0], drain,
+                                       sizeof(drain))) > 0) {
+        }
+      }
+      if ((fds[0].revents & POLLIN) != 0) {
+        intptr_t bytes;
+        while ((bytes = TEMP_FAILURE_RETRY(
+                    read(inotify_fd_, buffer, kBufferSize))) > 0) {
+          MutexLocker ml(&mutex_);
+          uint8_t* data = reinterpret_cast<uint8_t*>(buffer);
+          intptr_t offset = 0;
+          while (offset < bytes) {
+            struct inotify_event* e =
+                reinterpret_cast<struct inotify_event*>(data + offset);
+            HandleEventLocked(e);
+            offset += sizeof(struct inotify_event) + e->len;
+          }
+          ASSERT(offset == bytes);
+        }
+      }
+      while (true) {
+        Scan* scan;
+        {
+          MutexLocker ml(&mutex_);
+          if (shutdown_) {
+            free(buffer);
+            return;
+          }
+          scan = scans_;
+          if (scan == NULL) {
+            timeout = NotifyLocked();
+            break;
+          }
+          scans_ = scan->next;
+        }
+        RunScan(scan);
+        delete scan;
+      }
+    }
+    free(buffer);
+  }
+
+  int inotify_fd_;
+  int notify_fds_[2];
+  int control_fds_[2];
+  const int64_t coalescing_window_;
+
+  // Protects everything below. Held by the thread while it handles events,
+  // and by the isolate while it changes the watched paths or reads events.
+  Mutex mutex_;
+  // The inotify watches, by watch descriptor.
+  SimpleHashMap nodes_;
+  // The latest queued event of each path.
+  SimpleHashMap pending_map_;
+  Root* roots_;
+  intptr_t next_root_id_;
+  Scan* scans_;
+  PendingEvent* pending_head_;
+  PendingEvent* pending_tail_;
+  int64_t notify_deadline_;
+  bool notified_;
+  bool shutdown_;
+
+  Monitor thread_monitor_;
+  bool thread_done_;
+
+  DISALLOW_COPY_AND_ASSIGN(InotifyWatcher);
+};
+
+bool FileSystemWatcher::IsSupported() {
+  return true;
+}
+
+intptr_t FileSystemWatcher::Init() {
+  InotifyWatcher* watcher = new InotifyWatcher();
+  if (!watcher->Start()) {
+    int error = errno;
+    delete watcher;
+    errno = error;
+    return -1;
+  }
+  return reinterpret_cast<intptr_t>(watcher);
+}
+
+void FileSystemWatcher::Close(intptr_t id) {
+  InotifyWatcher* watcher = reinterpret_cast<InotifyWatcher*>(id);
+  watcher->Stop();
+  delete watcher;
+}
+
+intptr_t FileSystemWatcher::WatchPath(intptr_t id,
+                                      Namespace* namespc,
+                                      const char* path,
+                                      int events,
+                                      bool recursive) {
+  InotifyWatcher* watcher = reinterpret_cast<InotifyWatcher*>(id);
+  const char* resolved_path = File::GetCanonicalPath(namespc, path);
+  path = resolved_path != NULL ? resolved_path : path;
+  return watcher->WatchPath(path, events, recursive);
+}
+
+void FileSystemWatcher::UnwatchPath(intptr_t id, intptr_t path_id) {
+  reinterpret_cast<InotifyWatcher*>(id)->UnwatchPath(path_id);
+}
+
+intptr_t FileSystemWatcher::GetSocketId(intptr_t id, intptr_t path_id) {
+  USE(path_id);
+  return reinterpret_cast<InotifyWatcher*>(id)->read_fd();
+}
+
+Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
+  USE(path_id);
+  return reinterpret_cast<InotifyWatcher*>(id)->ReadEvents();
 }
 
 }  // namespace bin
@@ -236,4 +236,143 @@ TEST_CASE(FilePosition) {
   file->Release();
 }
 
+#if defined(HOST_OS_LINUX)
+// Tests of the ways File::Copy and File::CopyChunk copy data. They restrict
+// the copy methods to go down the fallbacks, and lower the chunk size.
+
+static const char* CopyTestPath(const char* dir, const char* name) {
+  const intptr_t length = strlen(dir) + strlen(name) + 2;
+  char* path = reinterpret_cast<char*>(bin::DartUtils::ScopedCString(length));
+  snprintf(path, length, "%s/%s", dir, name);
+  return path;
+}
+
+static uint8_t CopyTestByte(intptr_t i) {
+  return static_cast<uint8_t>((i * 31) ^ (i >> 8));
+}
+
+static void WriteCopyTestFile(const char* path, intptr_t length) {
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(length));
+  for (intptr_t i = 0; i < length; i++) {
+    data[i] = CopyTestByte(i);
+  }
+  bin::File* file = bin::File::Open(NULL, path, bin::File::kWriteTruncate);
+  EXPECT(file != NULL);
+  EXPECT(file->WriteFully(data, length));
+  file->Release();
+  free(data);
+}
+
+static bool IsCopyOfTestFile(const char* path, intptr_t length) {
+  if (bin::File::LengthFromPath(NULL, path) != length) {
+    return false;
+  }
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(length));
+  bin::File* file = bin::File::Open(NULL, path, bin::File::kRead);
+  bool same = (file != NULL) && file->ReadFully(data, length);
+  for (intptr_t i = 0; same && (i < length); i++) {
+    same = data[i] == CopyTestByte(i);
+  }
+  if (file != NULL) {
+    file->Release();
+  }
+  free(data);
+  return same;
+}
+
+TEST_CASE(FileCopyFallbacks) {
+  const char* dir = bin::Directory::CreateTemp(
+      NULL, CopyTestPath(bin::Directory::SystemTemp(NULL), "file_copy"));
+  EXPECT_NOTNULL(dir);
+  const char* old_path = CopyTestPath(dir, "old");
+  const char* new_path = CopyTestPath(dir, "new");
+  const intptr_t kLength = 100 * KB + 7;
+  WriteCopyTestFile(old_path, kLength);
+
+  // Each step falls back to the next one when it is not allowed, the same
+  // way as when it is not supported for the files.
+  const intptr_t kMethods[] = {
+      bin::File::kCopyAllMethods,
+      bin::File::kCopyAllMethods & ~bin::File::kCopyClone,
+      bin::File::kCopySendFile | bin::File::kCopyReadWrite,
+      bin::File::kCopyReadWrite,
+  };
+  for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(kMethods)); i++) {
+    bin::File::set_copy_methods(kMethods[i]);
+    EXPECT(bin::File::Copy(NULL, old_path, new_path));
+    EXPECT(IsCopyOfTestFile(new_path, kLength));
+    EXPECT(bin::File::Delete(NULL, new_path));
+  }
+
+  // A copy that cannot be made leaves no new file behind.
+  bin::File::set_copy_methods(0);
+  EXPECT(!bin::File::Copy(NULL, old_path, new_path));
+  EXPECT(!bin::File::Exists(NULL, new_path));
+
+  bin::File::set_copy_methods(bin::File::kCopyAllMethods);
+  EXPECT(bin::Directory::Delete(NULL, dir, true));
+}
+
+TEST_CASE(FileCopyChunks) {
+  const char* dir = bin::Directory::CreateTemp(
+      NULL, CopyTestPath(bin::Directory::SystemTemp(NULL), "file_copy"));
+  EXPECT_NOTNULL(dir);
+  const char* old_path = CopyTestPath(dir, "old");
+  const char* new_path = CopyTestPath(dir, "new");
+  // Replacements are renamed into place, so that they cannot reuse the inode
+  // of the file they replace.
+  const char* other_path = CopyTestPath(dir, "other");
+  const intptr_t kChunkSize = 4 * KB;
+  const intptr_t kLength = 2 * kChunkSize + 123;
+  WriteCopyTestFile(old_path, kLength);
+  // A clone would copy the whole file in the first chunk.
+  bin::File::set_copy_methods(bin::File::kCopyAllMethods &
+                              ~bin::File::kCopyClone);
+  bin::File::set_copy_chunk_size(kChunkSize);
+
+  int64_t identity[bin::File::kCopyIdentitySize];
+  int64_t offset = 0;
+  intptr_t chunks = 0;
+  bool done = false;
+  while (!done) {
+    offset = bin::File::CopyChunk(NULL, old_path, new_path, offset, identity,
+                                  &done);
+    EXPECT(offset >= 0);
+    if (offset < 0) {
+      break;
+    }
+    chunks++;
+  }
+  EXPECT_EQ(kLength, offset);
+  EXPECT_EQ(3, chunks);
+  EXPECT(IsCopyOfTestFile(new_path, kLength));
+
+  // A chunk fails if the new file has been replaced since the last one, and
+  // leaves the replacement alone.
+  offset = bin::File::CopyChunk(NULL, old_path, new_path, 0, identity, &done);
+  EXPECT_EQ(kChunkSize, offset);
+  WriteCopyTestFile(other_path, kChunkSize);
+  EXPECT(bin::File::Rename(NULL, other_path, new_path));
+  EXPECT_EQ(-1, bin::File::CopyChunk(NULL, old_path, new_path, offset,
+                                     identity, &done));
+  EXPECT_EQ(ESTALE, errno);
+  EXPECT(IsCopyOfTestFile(new_path, kChunkSize));
+
+  // A chunk also fails if the old file has been replaced, and then deletes
+  // the partial copy.
+  offset = bin::File::CopyChunk(NULL, old_path, new_path, 0, identity, &done);
+  EXPECT_EQ(kChunkSize, offset);
+  WriteCopyTestFile(other_path, kLength);
+  EXPECT(bin::File::Rename(NULL, other_path, old_path));
+  EXPECT_EQ(-1, bin::File::CopyChunk(NULL, old_path, new_path, offset,
+                                     identity, &done));
+  EXPECT_EQ(ESTALE, errno);
+  EXPECT(!bin::File::Exists(NULL, new_path));
+
+  bin::File::set_copy_chunk_size(bin::File::kCopyChunkSize);
+  bin::File::set_copy_methods(bin::File::kCopyAllMethods);
+  EXPECT(bin::Directory::Delete(NULL, dir, true));
+}
+#endif  // defined(HOST_OS_LINUX)
+
 }  // namespace dart
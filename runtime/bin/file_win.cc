@@ -139,11 +139,50 @@ void MappedMemory::Unmap() {
   size_ = 0;
 }
 
+void MappedMemory::Advise(Advice advice) {
+  // The contents of the file are read into memory by Map, so there is nothing
+  // to advise.
+}
+
+intptr_t File::MapAlignment() {
+  // Map reads the file rather than mapping it, so any position will do.
+  return 1;
+}
+
 int64_t File::Read(void* buffer, int64_t num_bytes) {
   ASSERT(handle_->fd() >= 0);
   return read(handle_->fd(), buffer, num_bytes);
 }
 
+int64_t File::ReadAt(void* buffer, int64_t num_bytes, int64_t position) {
+  int fd = handle_->fd();
+  ASSERT(fd >= 0 && num_bytes <= MAXDWORD && num_bytes >= 0);
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  // A read at an offset still moves the file pointer of a handle opened for
+  // synchronous I/O, so it is put back afterwards.
+  LARGE_INTEGER zero;
+  zero.QuadPart = 0;
+  LARGE_INTEGER current;
+  if (!SetFilePointerEx(handle, zero, &current, FILE_CURRENT)) {
+    return -1;
+  }
+  OVERLAPPED overlapped;
+  ZeroMemory(&overlapped, sizeof(overlapped));
+  overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+  overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+  DWORD read = 0;
+  int64_t result;
+  if (ReadFile(handle, buffer, num_bytes, &read, &overlapped)) {
+    result = read;
+  } else {
+    result = (GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1;
+  }
+  if (!SetFilePointerEx(handle, current, NULL, FILE_BEGIN)) {
+    return -1;
+  }
+  return result;
+}
+
 int64_t File::Write(const void* buffer, int64_t num_bytes) {
   int fd = handle_->fd();
   // Avoid narrowing conversion
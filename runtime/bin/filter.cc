@@ -6,9 +6,13 @@
 
 #include "bin/dartutils.h"
 #include "bin/io_buffer.h"
+#include "bin/lockers.h"
+#include "bin/platform.h"
 
 #include "include/dart_api.h"
 
+#include "platform/utils.h"
+
 namespace dart {
 namespace bin {
 
@@ -127,6 +131,8 @@ void FUNCTION_NAME(Filter_CreateZLibDeflate)(Dart_NativeArguments args) {
   Dart_Handle dict_obj = Dart_GetNativeArgument(args, 6);
   Dart_Handle raw_obj = Dart_GetNativeArgument(args, 7);
   bool raw = DartUtils::GetBooleanValue(raw_obj);
+  Dart_Handle parallel_obj = Dart_GetNativeArgument(args, 8);
+  bool parallel = DartUtils::GetBooleanValue(parallel_obj);
 
   Dart_Handle err;
   uint8_t* dictionary = NULL;
@@ -148,7 +154,7 @@ void FUNCTION_NAME(Filter_CreateZLibDeflate)(Dart_NativeArguments args) {
   ZLibDeflateFilter* filter = new ZLibDeflateFilter(
       gzip, static_cast<int32_t>(level), static_cast<int32_t>(window_bits),
       static_cast<int32_t>(mem_level), static_cast<int32_t>(strategy),
-      dictionary, dictionary_length, raw);
+      dictionary, dictionary_length, raw, parallel);
   if (filter == NULL) {
     delete[] dictionary;
     Dart_PropagateError(
@@ -284,15 +290,290 @@ Dart_Handle Filter::GetFilterNativeField(Dart_Handle filter,
       reinterpret_cast<intptr_t*>(filter_pointer));
 }
 
+// The zlib options shared by the DeflateTasks of a parallel deflate filter.
+struct DeflateParameters {
+  enum Checksum { kNone, kCRC32, kAdler32 };
+
+  int32_t level;
+  int32_t window_bits;
+  int32_t mem_level;
+  int32_t strategy;
+  Checksum checksum;
+};
+
+// A block of input compressed by DeflatePool::Run. The output is a raw
+// deflate stream ending in a sync flush, or in a final block for the last
+// block of the input, so the outputs of consecutive blocks can be
+// concatenated.
+class DeflateTask {
+ public:
+  DeflateTask()
+      : parameters_(NULL),
+        dictionary_(NULL),
+        dictionary_length_(0),
+        input_(NULL),
+        length_(0),
+        last_(false),
+        output_(NULL),
+        output_length_(0),
+        check_(0),
+        success_(false) {}
+  ~DeflateTask() { free(output_); }
+
+  void Init(const DeflateParameters* parameters,
+            const uint8_t* dictionary,
+            intptr_t dictionary_length,
+            const uint8_t* input,
+            intptr_t length,
+            bool last) {
+    parameters_ = parameters;
+    dictionary_ = dictionary;
+    dictionary_length_ = dictionary_length;
+    input_ = input;
+    length_ = length;
+    last_ = last;
+  }
+
+  void Run();
+
+  intptr_t length() const { return length_; }
+  const uint8_t* output() const { return output_; }
+  intptr_t output_length() const { return output_length_; }
+  uLong check() const { return check_; }
+  bool success() const { return success_; }
+
+ private:
+  // Room for the sync flush marker, which deflateBound does not include.
+  static const intptr_t kFlushSlack = 16;
+
+  const DeflateParameters* parameters_;
+  const uint8_t* dictionary_;
+  intptr_t dictionary_length_;
+  const uint8_t* input_;
+  intptr_t length_;
+  bool last_;
+  uint8_t* output_;
+  intptr_t output_length_;
+  uLong check_;
+  bool success_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeflateTask);
+};
+
+void DeflateTask::Run() {
+  if (parameters_->checksum == DeflateParameters::kCRC32) {
+    check_ = crc32(crc32(0L, Z_NULL, 0), input_, length_);
+  } else if (parameters_->checksum == DeflateParameters::kAdler32) {
+    check_ = adler32(adler32(0L, Z_NULL, 0), input_, length_);
+  }
+  z_stream stream;
+  stream.next_in = Z_NULL;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  int result =
+      deflateInit2(&stream, parameters_->level, Z_DEFLATED,
+                   -parameters_->window_bits, parameters_->mem_level,
+                   parameters_->strategy);
+  if (result != Z_OK) {
+    return;
+  }
+  if (dictionary_length_ > 0) {
+    result = deflateSetDictionary(&stream, dictionary_, dictionary_length_);
+    if (result != Z_OK) {
+      deflateEnd(&stream);
+      return;
+    }
+  }
+  intptr_t capacity = deflateBound(&stream, length_) + kFlushSlack;
+  output_ = reinterpret_cast<uint8_t*>(malloc(capacity));
+  if (output_ == NULL) {
+    OUT_OF_MEMORY();
+  }
+  stream.next_in = const_cast<uint8_t*>(input_);
+  stream.avail_in = length_;
+  while (true) {
+    stream.next_out = output_ + output_length_;
+    stream.avail_out = capacity - output_length_;
+    result = deflate(&stream, last_ ? Z_FINISH : Z_SYNC_FLUSH);
+    output_length_ = capacity - stream.avail_out;
+    if ((result == Z_STREAM_END) ||
+        ((result == Z_OK) && (stream.avail_out > 0))) {
+      success_ = true;
+      break;
+    }
+    if ((result != Z_OK) && (result != Z_BUF_ERROR)) {
+      break;
+    }
+    // Out of output space, which the bound should make impossible.
+    capacity *= 2;
+    output_ = reinterpret_cast<uint8_t*>(realloc(output_, capacity));
+    if (output_ == NULL) {
+      OUT_OF_MEMORY();
+    }
+  }
+  deflateEnd(&stream);
+}
+
+// The tasks of one call to DeflatePool::Run. Batches are queued in
+// DeflatePool::batches_ until all of their tasks are claimed.
+struct DeflateBatch {
+  DeflateTask* tasks;
+  intptr_t count;
+  intptr_t claimed;
+  intptr_t remaining;
+  DeflateBatch* next;
+};
+
+Monitor* DeflatePool::monitor_ = NULL;
+DeflateBatch* DeflatePool::batches_ = NULL;
+intptr_t DeflatePool::workers_ = 0;
+bool DeflatePool::shutting_down_ = false;
+
+void DeflatePool::Initialize() {
+  ASSERT(monitor_ == NULL);
+  monitor_ = new Monitor();
+}
+
+void DeflatePool::Cleanup() {
+  if (monitor_ == NULL) {
+    return;
+  }
+  {
+    MonitorLocker ml(monitor_);
+    shutting_down_ = true;
+    ml.NotifyAll();
+    while (workers_ > 0) {
+      ml.Wait();
+    }
+  }
+  delete monitor_;
+  monitor_ = NULL;
+  // Initialize may be called again after this, and must find the workers
+  // allowed to run.
+  shutting_down_ = false;
+}
+
+intptr_t DeflatePool::Concurrency() {
+  if (monitor_ == NULL) {
+    return 1;
+  }
+  return Utils::Minimum<intptr_t>(Platform::NumberOfProcessors(),
+                                  kMaxThreads);
+}
+
+void DeflatePool::Run(DeflateTask* tasks, intptr_t count) {
+  ASSERT(count > 0);
+  if (count == 1) {
+    tasks[0].Run();
+    return;
+  }
+  DeflateBatch batch;
+  batch.tasks = tasks;
+  batch.count = count;
+  batch.claimed = 0;
+  batch.remaining = count;
+  batch.next = NULL;
+  {
+    MonitorLocker ml(monitor_);
+    DeflateBatch** last = &batches_;
+    while (*last != NULL) {
+      last = &(*last)->next;
+    }
+    *last = &batch;
+    // The calling thread runs tasks too. If a worker cannot be started, the
+    // tasks are left to the threads that are running.
+    intptr_t wanted = Utils::Minimum(count, Concurrency()) - 1;
+    while (workers_ < wanted) {
+      if (Thread::Start("dart:io DeflatePool", &WorkerMain, 0) != 0) {
+        break;
+      }
+      workers_++;
+    }
+    ml.NotifyAll();
+  }
+  while (true) {
+    DeflateTask* task;
+    {
+      MonitorLocker ml(monitor_);
+      if (batch.claimed == batch.count) {
+        while (batch.remaining > 0) {
+          ml.Wait();
+        }
+        return;
+      }
+      task = ClaimTaskLocked(&batch);
+    }
+    RunTask(task, &batch);
+  }
+}
+
+DeflateTask* DeflatePool::ClaimTaskLocked(DeflateBatch* batch) {
+  ASSERT(batch->claimed < batch->count);
+  DeflateTask* task = &batch->tasks[batch->claimed++];
+  if (batch->claimed == batch->count) {
+    DeflateBatch** link = &batches_;
+    while (*link != batch) {
+      link = &(*link)->next;
+    }
+    *link = batch->next;
+  }
+  return task;
+}
+
+void DeflatePool::RunTask(DeflateTask* task, DeflateBatch* batch) {
+  task->Run();
+  MonitorLocker ml(monitor_);
+  batch->remaining--;
+  if (batch->remaining == 0) {
+    // The batch may be gone as soon as the monitor is released.
+    ml.NotifyAll();
+  }
+}
+
+void DeflatePool::WorkerMain(uword parameters) {
+  while (true) {
+    DeflateBatch* batch;
+    DeflateTask* task;
+    {
+      MonitorLocker ml(monitor_);
+      while ((batches_ == NULL) && !shutting_down_) {
+        if (ml.Wait(kIdleTimeoutMillis) == Monitor::kTimedOut) {
+          break;
+        }
+      }
+      if (batches_ == NULL) {
+        workers_--;
+        ml.NotifyAll();
+        return;
+      }
+      batch = batches_;
+      task = ClaimTaskLocked(batch);
+    }
+    RunTask(task, batch);
+  }
+}
+
 ZLibDeflateFilter::~ZLibDeflateFilter() {
   delete[] dictionary_;
   delete[] current_buffer_;
-  if (initialized()) {
+  free(pending_);
+  free(output_);
+  if (initialized() && !parallel_) {
     deflateEnd(&stream_);
   }
 }
 
 bool ZLibDeflateFilter::Init() {
+  // Stored blocks gain nothing from threads, and a dictionary would have to
+  // be recorded in the zlib header, so those streams are always serial.
+  if (parallel_ && (level_ != 0) && (dictionary_ == NULL) &&
+      (DeflatePool::Concurrency() > 1)) {
+    InitParallel();
+    set_initialized(true);
+    return true;
+  }
+  parallel_ = false;
   int window_bits = window_bits_;
   if ((raw_ || gzip_) && (window_bits == 8)) {
     // zlib deflater does not work with windows size of 8 bits. Old versions
@@ -331,6 +612,14 @@ bool ZLibDeflateFilter::Init() {
 }
 
 bool ZLibDeflateFilter::Process(uint8_t* data, intptr_t length) {
+  if (parallel_) {
+    if (finished_) {
+      return false;
+    }
+    AppendPending(data, length);
+    delete[] data;
+    return true;
+  }
   if (current_buffer_ != NULL) {
     return false;
   }
@@ -343,6 +632,9 @@ intptr_t ZLibDeflateFilter::Processed(uint8_t* buffer,
                                       intptr_t length,
                                       bool flush,
                                       bool end) {
+  if (parallel_) {
+    return ProcessedParallel(buffer, length, flush, end);
+  }
   stream_.avail_out = length;
   stream_.next_out = buffer;
   bool error = false;
@@ -369,6 +661,217 @@ intptr_t ZLibDeflateFilter::Processed(uint8_t* buffer,
   return error ? -1 : 0;
 }
 
+void ZLibDeflateFilter::InitParallel() {
+  // Raw deflate does not support a window of 8 bits, see Init.
+  parallel_window_bits_ = Utils::Maximum(window_bits_, 9);
+  batch_blocks_ = DeflatePool::Concurrency() * kParallelBlocksPerThread;
+  if (raw_) {
+    check_ = 0;
+  } else if (gzip_) {
+    check_ = crc32(0L, Z_NULL, 0);
+  } else {
+    check_ = adler32(0L, Z_NULL, 0);
+  }
+}
+
+intptr_t ZLibDeflateFilter::ProcessedParallel(uint8_t* buffer,
+                                              intptr_t length,
+                                              bool flush,
+                                              bool end) {
+  if (output_start_ == output_end_) {
+    output_start_ = 0;
+    output_end_ = 0;
+    if (finished_) {
+      return 0;
+    }
+    if (!started_) {
+      WriteHeader();
+      started_ = true;
+    }
+    if (!CompressPending(flush, end)) {
+      return -1;
+    }
+    if (output_end_ == 0) {
+      return 0;
+    }
+  }
+  intptr_t count = Utils::Minimum(length, output_end_ - output_start_);
+  memmove(buffer, output_ + output_start_, count);
+  output_start_ += count;
+  return count;
+}
+
+// Compresses the next batch of pending input, if there is a full batch or
+// if the input is flushed, and appends the result to the output.
+bool ZLibDeflateFilter::CompressPending(bool flush, bool end) {
+  intptr_t available = pending_end_ - pending_start_;
+  intptr_t blocks;
+  bool last = false;
+  if (flush || end) {
+    blocks = (available + kParallelBlockSize - 1) / kParallelBlockSize;
+    if (blocks > batch_blocks_) {
+      blocks = batch_blocks_;
+    } else if (end) {
+      // The last block ends the stream, even when it is empty.
+      blocks = Utils::Maximum<intptr_t>(blocks, 1);
+      last = true;
+    }
+  } else {
+    blocks = (available >= batch_blocks_ * kParallelBlockSize) ? batch_blocks_
+                                                               : 0;
+  }
+  if (blocks == 0) {
+    return true;
+  }
+
+  DeflateParameters parameters;
+  parameters.level = level_;
+  parameters.window_bits = parallel_window_bits_;
+  parameters.mem_level = mem_level_;
+  parameters.strategy = strategy_;
+  if (raw_) {
+    parameters.checksum = DeflateParameters::kNone;
+  } else if (gzip_) {
+    parameters.checksum = DeflateParameters::kCRC32;
+  } else {
+    parameters.checksum = DeflateParameters::kAdler32;
+  }
+  // Each block is primed with the window of input before it, so that matches
+  // across block boundaries are found as they would be by a single stream.
+  const intptr_t window = static_cast<intptr_t>(1) << parallel_window_bits_;
+  DeflateTask* tasks = new DeflateTask[blocks];
+  intptr_t position = pending_start_;
+  for (intptr_t i = 0; i < blocks; i++) {
+    intptr_t block_length =
+        Utils::Minimum(kParallelBlockSize, pending_end_ - position);
+    intptr_t dictionary_length = Utils::Minimum(position, window);
+    tasks[i].Init(&parameters, pending_ + position - dictionary_length,
+                  dictionary_length, pending_ + position, block_length,
+                  last && (i == blocks - 1));
+    position += block_length;
+  }
+  DeflatePool::Run(tasks, blocks);
+
+  bool success = true;
+  for (intptr_t i = 0; i < blocks; i++) {
+    DeflateTask* task = &tasks[i];
+    if (!task->success()) {
+      success = false;
+      break;
+    }
+    AppendOutput(task->output(), task->output_length());
+    if (parameters.checksum == DeflateParameters::kCRC32) {
+      check_ = crc32_combine(check_, task->check(), task->length());
+    } else if (parameters.checksum == DeflateParameters::kAdler32) {
+      check_ = adler32_combine(check_, task->check(), task->length());
+    }
+    total_in_ += task->length();
+  }
+  delete[] tasks;
+  pending_start_ = position;
+  if (!success) {
+    return false;
+  }
+  if (last) {
+    WriteTrailer();
+    finished_ = true;
+  }
+  return true;
+}
+
+void ZLibDeflateFilter::WriteHeader() {
+  if (raw_) {
+    return;
+  }
+  // The fields that depend on the level are set as zlib sets them.
+  const int32_t level = (level_ == Z_DEFAULT_COMPRESSION) ? 6 : level_;
+  const bool fastest = (strategy_ >= Z_HUFFMAN_ONLY) || (level < 2);
+  if (gzip_) {
+    // No modification time, file name or extra fields, and a Unix OS code.
+    const uint8_t extra_flags = (level == 9) ? 2 : (fastest ? 4 : 0);
+    const uint8_t header[] = {0x1f, 0x8b, Z_DEFLATED, 0, 0, 0,
+                              0,    0,    extra_flags, 3};
+    AppendOutput(header, sizeof(header));
+    return;
+  }
+  uint32_t level_flags;
+  if (fastest) {
+    level_flags = 0;
+  } else if (level < 6) {
+    level_flags = 1;
+  } else if (level == 6) {
+    level_flags = 2;
+  } else {
+    level_flags = 3;
+  }
+  uint32_t value = (Z_DEFLATED + ((parallel_window_bits_ - 8) << 4)) << 8;
+  value |= level_flags << 6;
+  value += 31 - (value % 31);
+  const uint8_t header[] = {static_cast<uint8_t>(value >> 8),
+                            static_cast<uint8_t>(value & 0xff)};
+  AppendOutput(header, sizeof(header));
+}
+
+void ZLibDeflateFilter::WriteTrailer() {
+  if (raw_) {
+    return;
+  }
+  uint8_t trailer[8];
+  if (gzip_) {
+    // CRC-32 and input size modulo 2^32, little endian.
+    for (intptr_t i = 0; i < 4; i++) {
+      trailer[i] = static_cast<uint8_t>(check_ >> (8 * i));
+      trailer[4 + i] = static_cast<uint8_t>(total_in_ >> (8 * i));
+    }
+    AppendOutput(trailer, 8);
+  } else {
+    // Adler-32, big endian.
+    for (intptr_t i = 0; i < 4; i++) {
+      trailer[i] = static_cast<uint8_t>(check_ >> (8 * (3 - i)));
+    }
+    AppendOutput(trailer, 4);
+  }
+}
+
+void ZLibDeflateFilter::AppendPending(const uint8_t* data, intptr_t length) {
+  if (pending_end_ + length > pending_capacity_) {
+    // Drop the input that is compressed, except for the window that primes
+    // the next block.
+    const intptr_t window = static_cast<intptr_t>(1) << parallel_window_bits_;
+    intptr_t discard = pending_start_ - Utils::Minimum(pending_start_, window);
+    memmove(pending_, pending_ + discard, pending_end_ - discard);
+    pending_start_ -= discard;
+    pending_end_ -= discard;
+  }
+  if (pending_end_ + length > pending_capacity_) {
+    intptr_t capacity =
+        Utils::Maximum(pending_capacity_ * 2, pending_end_ + length);
+    uint8_t* pending = reinterpret_cast<uint8_t*>(realloc(pending_, capacity));
+    if (pending == NULL) {
+      OUT_OF_MEMORY();
+    }
+    pending_ = pending;
+    pending_capacity_ = capacity;
+  }
+  memmove(pending_ + pending_end_, data, length);
+  pending_end_ += length;
+}
+
+void ZLibDeflateFilter::AppendOutput(const uint8_t* data, intptr_t length) {
+  if (output_end_ + length > output_capacity_) {
+    intptr_t capacity =
+        Utils::Maximum(output_capacity_ * 2, output_end_ + length);
+    uint8_t* output = reinterpret_cast<uint8_t*>(realloc(output_, capacity));
+    if (output == NULL) {
+      OUT_OF_MEMORY();
+    }
+    output_ = output;
+    output_capacity_ = capacity;
+  }
+  memmove(output_ + output_end_, data, length);
+  output_end_ += length;
+}
+
 ZLibInflateFilter::~ZLibInflateFilter() {
   delete[] dictionary_;
   delete[] current_buffer_;
@@ -6,6 +6,7 @@
 #define RUNTIME_BIN_FILTER_H_
 
 #include "bin/builtin.h"
+#include "bin/thread.h"
 #include "bin/utils.h"
 
 #include "zlib/zlib.h"
@@ -52,6 +53,46 @@ class Filter {
   DISALLOW_COPY_AND_ASSIGN(Filter);
 };
 
+class DeflateTask;
+struct DeflateBatch;
+
+// Worker threads shared by all ZLibDeflateFilters compressing in parallel.
+// Workers are started on demand and exit after being idle for a while.
+class DeflatePool {
+ public:
+  static void Initialize();
+  static void Cleanup();
+
+  // The number of threads, including the calling thread, that Run uses.
+  static intptr_t Concurrency();
+
+  // Runs |tasks| on the calling thread and the workers, and returns when all
+  // of them are done.
+  static void Run(DeflateTask* tasks, intptr_t count);
+
+ private:
+  static const intptr_t kMaxThreads = 8;
+  static const int64_t kIdleTimeoutMillis = 5000;
+
+  static void WorkerMain(uword parameters);
+  static DeflateTask* ClaimTaskLocked(DeflateBatch* batch);
+  static void RunTask(DeflateTask* task, DeflateBatch* batch);
+
+  static Monitor* monitor_;
+  static DeflateBatch* batches_;
+  static intptr_t workers_;
+  static bool shutting_down_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(DeflatePool);
+};
+
+// When |parallel| is set and the stream has neither a dictionary nor a
+// compression level of 0, the input is split into blocks that are compressed
+// on a pool of worker threads, each block primed with the input preceding it
+// as dictionary. The blocks are raw deflate streams ending in a sync flush,
+// so they are joined into a single valid stream, and the zlib or gzip header
+// and trailer are written by the filter itself.
 class ZLibDeflateFilter : public Filter {
  public:
   ZLibDeflateFilter(bool gzip,
@@ -61,7 +102,8 @@ class ZLibDeflateFilter : public Filter {
                     int32_t strategy,
                     uint8_t* dictionary,
                     intptr_t dictionary_length,
-                    bool raw)
+                    bool raw,
+                    bool parallel)
       : gzip_(gzip),
         level_(level),
         window_bits_(window_bits),
@@ -70,7 +112,22 @@ class ZLibDeflateFilter : public Filter {
         dictionary_(dictionary),
         dictionary_length_(dictionary_length),
         raw_(raw),
-        current_buffer_(NULL) {}
+        parallel_(parallel),
+        current_buffer_(NULL),
+        parallel_window_bits_(0),
+        batch_blocks_(0),
+        pending_(NULL),
+        pending_start_(0),
+        pending_end_(0),
+        pending_capacity_(0),
+        output_(NULL),
+        output_start_(0),
+        output_end_(0),
+        output_capacity_(0),
+        check_(0),
+        total_in_(0),
+        started_(false),
+        finished_(false) {}
   virtual ~ZLibDeflateFilter();
 
   virtual bool Init();
@@ -89,9 +146,42 @@ class ZLibDeflateFilter : public Filter {
   uint8_t* dictionary_;
   const intptr_t dictionary_length_;
   const bool raw_;
+  bool parallel_;
   uint8_t* current_buffer_;
   z_stream stream_;
 
+  static const intptr_t kParallelBlockSize = 128 * KB;
+  static const intptr_t kParallelBlocksPerThread = 4;
+
+  void InitParallel();
+  intptr_t ProcessedParallel(uint8_t* buffer,
+                             intptr_t length,
+                             bool flush,
+                             bool end);
+  void WriteHeader();
+  void WriteTrailer();
+  bool CompressPending(bool flush, bool end);
+  void AppendPending(const uint8_t* data, intptr_t length);
+  void AppendOutput(const uint8_t* data, intptr_t length);
+
+  int32_t parallel_window_bits_;
+  intptr_t batch_blocks_;
+  // Input compressed in parallel mode is gathered in |pending_|. Up to a
+  // window of the bytes before |pending_start_| are kept, as dictionary for
+  // the next block.
+  uint8_t* pending_;
+  intptr_t pending_start_;
+  intptr_t pending_end_;
+  intptr_t pending_capacity_;
+  uint8_t* output_;
+  intptr_t output_start_;
+  intptr_t output_end_;
+  intptr_t output_capacity_;
+  uLong check_;
+  uint64_t total_in_;
+  bool started_;
+  bool finished_;
+
   DISALLOW_COPY_AND_ASSIGN(ZLibDeflateFilter);
 };
 
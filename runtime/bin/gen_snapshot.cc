@@ -173,6 +173,7 @@ static void PrintUsage() {
 "[--obfuscate]                                                               \n"
 "[--save-debugging-info=<debug-filename>]                                    \n"
 "[--save-obfuscation-map=<map-filename>]                                     \n"
+"[--load-type-feedback=<feedback-filename>]                                  \n"
 "<dart-kernel-file>                                                          \n"
 "                                                                            \n"
 "To create an AOT application snapshot as an ELF shared library:             \n"
@@ -182,8 +183,14 @@ static void PrintUsage() {
 "[--obfuscate]                                                               \n"
 "[--save-debugging-info=<debug-filename>]                                    \n"
 "[--save-obfuscation-map=<map-filename>]                                     \n"
+"[--load-type-feedback=<feedback-filename>]                                  \n"
 "<dart-kernel-file>                                                          \n"
 "                                                                            \n"
+"AOT compilation can be guided by the type feedback of a JIT run, saved with \n"
+"dart --save-type-feedback=<feedback-filename> --no-use-osr                  \n"
+"--no-use-field-guards --fields-may-be-reset. It is used to devirtualize hot \n"
+"call sites, to inline hot calls and to lay out hot code together.           \n"
+"                                                                            \n"
 "AOT snapshots can be obfuscated: that is all identifiers will be renamed    \n"
 "during compilation. This mode is enabled with --obfuscate flag. Mapping     \n"
 "between original and obfuscated names can be serialized as a JSON array     \n"
@@ -590,6 +597,16 @@ static void CreateAndWritePrecompiledSnapshot() {
   ASSERT(IsSnapshottingForPrecompilation());
   Dart_Handle result;
 
+  // Keep the type feedback of a JIT run for the precompiler.
+  if (load_type_feedback_filename != NULL) {
+    uint8_t* buffer = NULL;
+    intptr_t size = 0;
+    ReadFile(load_type_feedback_filename, &buffer, &size);
+    result = Dart_LoadTypeFeedback(buffer, size);
+    free(buffer);
+    CHECK_RESULT(result);
+  }
+
   // Precompile with specified embedder entry points
   result = Dart_Precompile();
   CHECK_RESULT(result);
@@ -0,0 +1,378 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/host_lookup_cache.h"
+
+#include "bin/dartutils.h"
+#include "bin/lockers.h"
+#include "bin/socket.h"
+#include "include/dart_api.h"
+#include "platform/utils.h"
+
+namespace dart {
+namespace bin {
+
+struct LookupKey {
+  const char* host;
+  int type;
+};
+
+static bool SameLookupKey(void* key1, void* key2) {
+  LookupKey* a = reinterpret_cast<LookupKey*>(key1);
+  LookupKey* b = reinterpret_cast<LookupKey*>(key2);
+  return (a->type == b->type) && (strcmp(a->host, b->host) == 0);
+}
+
+static uint32_t LookupKeyHash(const char* host, int type) {
+  return SimpleHashMap::StringHash(const_cast<char*>(host)) ^
+         static_cast<uint32_t>(type + 1);
+}
+
+static AddressList<SocketAddress>* CopyAddresses(
+    AddressList<SocketAddress>* addresses) {
+  AddressList<SocketAddress>* copy =
+      new AddressList<SocketAddress>(addresses->count());
+  for (intptr_t i = 0; i < addresses->count(); i++) {
+    RawAddr addr = addresses->GetAt(i)->addr();
+    copy->SetAt(i, new SocketAddress(&addr.addr));
+  }
+  return copy;
+}
+
+// A lookup that arrived while a lookup of the same host was in progress. It
+// is answered by the thread doing that lookup.
+class HostLookupCache::Waiter {
+ public:
+  Waiter(Dart_Port reply_port, int32_t message_id, Waiter* next)
+      : reply_port_(reply_port),
+        message_id_(message_id),
+        addresses_(NULL),
+        error_(NULL),
+        next_(next) {}
+
+  // Posts the response in the format used by IOServiceCallback.
+  void Reply() {
+    CObjectArray result(CObject::NewArray(2));
+    result.SetAt(0, new CObjectInt32(CObject::NewInt32(message_id_)));
+    result.SetAt(1, Socket::LookupResponse(addresses_, error_));
+    addresses_ = NULL;
+    error_ = NULL;
+    Dart_PostCObject(reply_port_, result.AsApiCObject());
+  }
+
+ private:
+  const Dart_Port reply_port_;
+  const int32_t message_id_;
+  AddressList<SocketAddress>* addresses_;
+  OSError* error_;
+  Waiter* next_;
+
+  friend class HostLookupCache;
+
+  DISALLOW_COPY_AND_ASSIGN(Waiter);
+};
+
+// The result of one lookup. While the lookup is in progress, other lookups
+// of the same host are queued on it instead of calling getaddrinfo.
+class HostLookupCache::Entry {
+ public:
+  Entry(const char* host, int type, uint32_t hash)
+      : hash_(hash),
+        addresses_(NULL),
+        error_(NULL),
+        expires_(0),
+        pending_(true),
+        cached_(false),
+        waiters_(NULL),
+        prev_(NULL),
+        next_(NULL) {
+    key_.host = strdup(host);
+    if (key_.host == NULL) {
+      OUT_OF_MEMORY();
+    }
+    key_.type = type;
+  }
+
+  ~Entry() {
+    ASSERT(waiters_ == NULL);
+    free(const_cast<char*>(key_.host));
+    delete addresses_;
+    delete error_;
+  }
+
+  LookupKey* key() { return &key_; }
+  uint32_t hash() const { return hash_; }
+
+  // Returns a copy of the result for one of the lookups sharing this entry.
+  AddressList<SocketAddress>* Result(OSError** os_error) {
+    if (addresses_ != NULL) {
+      return CopyAddresses(addresses_);
+    }
+    ASSERT(*os_error == NULL);
+    *os_error = new OSError(error_->code(), error_->message(),
+                            error_->sub_system());
+    return NULL;
+  }
+
+ private:
+  LookupKey key_;
+  const uint32_t hash_;
+  AddressList<SocketAddress>* addresses_;
+  OSError* error_;
+  int64_t expires_;
+  // The lookup is in progress.
+  bool pending_;
+  // The entry is in entries_. Entries with a lookup in progress always are,
+  // so that later lookups of the same host can find them.
+  bool cached_;
+  // The lookups to answer when the lookup in progress completes.
+  Waiter* waiters_;
+  Entry* prev_;
+  Entry* next_;
+
+  friend class HostLookupCache;
+
+  DISALLOW_COPY_AND_ASSIGN(Entry);
+};
+
+Mutex* HostLookupCache::mutex_ = NULL;
+SimpleHashMap* HostLookupCache::entries_ = NULL;
+HostLookupCache::Entry* HostLookupCache::lru_head_ = NULL;
+HostLookupCache::Entry* HostLookupCache::lru_tail_ = NULL;
+intptr_t HostLookupCache::count_ = 0;
+intptr_t HostLookupCache::max_entries_ = HostLookupCache::kDefaultMaxEntries;
+int64_t HostLookupCache::ttl_millis_ = HostLookupCache::kDefaultTtlMillis;
+int64_t HostLookupCache::negative_ttl_millis_ =
+    HostLookupCache::kDefaultNegativeTtlMillis;
+int64_t HostLookupCache::statistics_[HostLookupCache::kNumStatistics];
+
+void HostLookupCache::Initialize() {
+  ASSERT(mutex_ == NULL);
+  mutex_ = new Mutex();
+  entries_ = new SimpleHashMap(&SameLookupKey, 64);
+  for (intptr_t i = 0; i < kNumStatistics; i++) {
+    statistics_[i] = 0;
+  }
+}
+
+void HostLookupCache::Cleanup() {
+  if (mutex_ == NULL) {
+    return;
+  }
+  // This is only called at shutdown, when no lookups are in progress.
+  while (lru_head_ != NULL) {
+    DiscardLocked(lru_head_);
+  }
+  delete entries_;
+  entries_ = NULL;
+  delete mutex_;
+  mutex_ = NULL;
+}
+
+HostLookupCache::Entry* HostLookupCache::FindLocked(const char* host,
+                                                    int type,
+                                                    uint32_t hash) {
+  LookupKey key = {host, type};
+  SimpleHashMap::Entry* map_entry = entries_->Lookup(&key, hash, false);
+  return (map_entry == NULL) ? NULL
+                             : reinterpret_cast<Entry*>(map_entry->value);
+}
+
+void HostLookupCache::InsertLocked(Entry* entry) {
+  SimpleHashMap::Entry* map_entry =
+      entries_->Lookup(entry->key(), entry->hash(), true);
+  ASSERT(map_entry->value == NULL);
+  map_entry->value = entry;
+  entry->cached_ = true;
+  count_++;
+  statistics_[kEntries] = count_;
+}
+
+void HostLookupCache::RemoveLocked(Entry* entry) {
+  ASSERT(entry->cached_);
+  entries_->Remove(entry->key(), entry->hash());
+  entry->cached_ = false;
+  count_--;
+  statistics_[kEntries] = count_;
+  if ((entry->prev_ == NULL) && (lru_head_ != entry)) {
+    // The lookup is still in progress, so the entry is not on the list.
+    return;
+  }
+  if (entry->prev_ != NULL) {
+    entry->prev_->next_ = entry->next_;
+  } else {
+    lru_head_ = entry->next_;
+  }
+  if (entry->next_ != NULL) {
+    entry->next_->prev_ = entry->prev_;
+  } else {
+    lru_tail_ = entry->prev_;
+  }
+  entry->prev_ = NULL;
+  entry->next_ = NULL;
+}
+
+void HostLookupCache::DiscardLocked(Entry* entry) {
+  // Only completed entries are discarded. The lookup thread of a pending
+  // entry removes it itself if it is not to be kept.
+  ASSERT(!entry->pending_);
+  RemoveLocked(entry);
+  delete entry;
+}
+
+void HostLookupCache::TouchLocked(Entry* entry) {
+  if (entry == lru_head_) {
+    return;
+  }
+  if (entry->prev_ != NULL) {
+    entry->prev_->next_ = entry->next_;
+    if (entry->next_ != NULL) {
+      entry->next_->prev_ = entry->prev_;
+    } else {
+      lru_tail_ = entry->prev_;
+    }
+  }
+  entry->prev_ = NULL;
+  entry->next_ = lru_head_;
+  if (lru_head_ != NULL) {
+    lru_head_->prev_ = entry;
+  }
+  lru_head_ = entry;
+  if (lru_tail_ == NULL) {
+    lru_tail_ = entry;
+  }
+}
+
+void HostLookupCache::EvictLocked() {
+  // Lookups in progress are not on the list, so the cache can briefly hold
+  // more than max_entries_ of them.
+  while ((count_ > max_entries_) && (lru_tail_ != NULL)) {
+    DiscardLocked(lru_tail_);
+  }
+}
+
+AddressList<SocketAddress>* HostLookupCache::Lookup(const char* host,
+                                                    int type,
+                                                    Dart_Port reply_port,
+                                                    int32_t message_id,
+                                                    OSError** os_error) {
+  const uint32_t hash = LookupKeyHash(host, type);
+  Entry* entry;
+  {
+    MutexLocker ml(mutex_);
+    entry = FindLocked(host, type, hash);
+    if ((entry != NULL) && !entry->pending_ &&
+        (entry->expires_ <= TimerUtils::GetCurrentMonotonicMillis())) {
+      DiscardLocked(entry);
+      entry = NULL;
+    }
+    if (entry != NULL) {
+      if (entry->pending_) {
+        statistics_[kCoalesced]++;
+        entry->waiters_ = new Waiter(reply_port, message_id, entry->waiters_);
+        return NULL;
+      }
+      statistics_[(entry->addresses_ != NULL) ? kHits : kNegativeHits]++;
+      TouchLocked(entry);
+      return entry->Result(os_error);
+    }
+    statistics_[kMisses]++;
+    entry = new Entry(host, type, hash);
+    InsertLocked(entry);
+  }
+
+  OSError* error = NULL;
+  AddressList<SocketAddress>* addresses =
+      SocketBase::LookupAddress(host, type, &error);
+
+  AddressList<SocketAddress>* result;
+  Waiter* waiters;
+  {
+    MutexLocker ml(mutex_);
+    entry->pending_ = false;
+    entry->addresses_ = addresses;
+    entry->error_ = error;
+    result = entry->Result(os_error);
+    // No lookup can queue on the entry once it is no longer pending, so the
+    // waiters are answered outside the lock.
+    waiters = entry->waiters_;
+    entry->waiters_ = NULL;
+    for (Waiter* waiter = waiters; waiter != NULL; waiter = waiter->next_) {
+      waiter->addresses_ = entry->Result(&waiter->error_);
+    }
+    int64_t ttl = 0;
+    if (addresses != NULL) {
+      ttl = ttl_millis_;
+    } else if ((error->sub_system() == OSError::kGetAddressInfo) &&
+               (error->code() == EAI_NONAME)) {
+      ttl = negative_ttl_millis_;
+    }
+    if ((ttl > 0) && (max_entries_ > 0)) {
+      entry->expires_ = TimerUtils::GetCurrentMonotonicMillis() + ttl;
+      TouchLocked(entry);
+      // This may evict the entry itself, so it is not used after this.
+      EvictLocked();
+    } else {
+      RemoveLocked(entry);
+      delete entry;
+    }
+  }
+  while (waiters != NULL) {
+    Waiter* next = waiters->next_;
+    waiters->Reply();
+    delete waiters;
+    waiters = next;
+  }
+  return result;
+}
+
+void HostLookupCache::Configure(intptr_t max_entries,
+                                int64_t ttl_millis,
+                                int64_t negative_ttl_millis) {
+  MutexLocker ml(mutex_);
+  max_entries_ = max_entries;
+  ttl_millis_ = ttl_millis;
+  negative_ttl_millis_ = negative_ttl_millis;
+  while (lru_head_ != NULL) {
+    DiscardLocked(lru_head_);
+  }
+}
+
+void HostLookupCache::GetStatistics(int64_t statistics[kNumStatistics]) {
+  MutexLocker ml(mutex_);
+  for (intptr_t i = 0; i < kNumStatistics; i++) {
+    statistics[i] = statistics_[i];
+  }
+}
+
+void FUNCTION_NAME(Socket_ConfigureLookupCache)(Dart_NativeArguments args) {
+  int64_t max_entries = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 0), 0, kIntptrMax);
+  int64_t ttl_millis = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 1), 0, kMaxInt64);
+  int64_t negative_ttl_millis = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  HostLookupCache::Configure(static_cast<intptr_t>(max_entries), ttl_millis,
+                             negative_ttl_millis);
+}
+
+void FUNCTION_NAME(Socket_GetLookupCacheStatistics)(Dart_NativeArguments args) {
+  int64_t statistics[HostLookupCache::kNumStatistics];
+  HostLookupCache::GetStatistics(statistics);
+  Dart_Handle result = Dart_NewList(HostLookupCache::kNumStatistics);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  for (intptr_t i = 0; i < HostLookupCache::kNumStatistics; i++) {
+    Dart_Handle error =
+        Dart_ListSetAt(result, i, Dart_NewInteger(statistics[i]));
+    if (Dart_IsError(error)) {
+      Dart_PropagateError(error);
+    }
+  }
+  Dart_SetReturnValue(args, result);
+}
+
+}  // namespace bin
+}  // namespace dart
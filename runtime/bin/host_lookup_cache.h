@@ -0,0 +1,101 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_HOST_LOOKUP_CACHE_H_
+#define RUNTIME_BIN_HOST_LOOKUP_CACHE_H_
+
+#include "bin/builtin.h"
+#include "bin/socket_base.h"
+#include "bin/thread.h"
+#include "bin/utils.h"
+#include "platform/globals.h"
+#include "platform/hashmap.h"
+
+namespace dart {
+namespace bin {
+
+// Caches the results of SocketBase::LookupAddress for Socket::LookupRequest.
+//
+// Caching is off until InternetAddress.configureLookupCache enables it.
+// getaddrinfo does not report the TTL of the records it returns, so results
+// are kept for a fixed time: successful lookups for the TTL, and lookups of
+// hosts that do not exist for the negative TTL. Other failures are not
+// cached, as they are usually transient. When the cache is full, the least
+// recently used entry is evicted.
+//
+// Concurrent lookups of the same host and address type share a single
+// getaddrinfo call, whether caching is enabled or not. Only the first of them
+// occupies an IO service thread; the others are answered on their reply port
+// when it completes.
+class HostLookupCache {
+ public:
+  static const intptr_t kDefaultMaxEntries = 0;
+  static const int64_t kDefaultTtlMillis = 30 * kMillisecondsPerSecond;
+  static const int64_t kDefaultNegativeTtlMillis = 5 * kMillisecondsPerSecond;
+
+  // Keep in sync with _NativeSocket.lookupCacheStatistics in
+  // socket_patch.dart.
+  enum Statistic {
+    kHits = 0,
+    kNegativeHits,
+    kMisses,
+    kCoalesced,
+    kEntries,
+    kNumStatistics,
+  };
+
+  static void Initialize();
+  static void Cleanup();
+
+  // Returns a new list of the addresses of |host|, which the caller owns, or
+  // NULL with |os_error| set to a new OSError. If a lookup of |host| is
+  // already in progress, returns NULL without setting |os_error|, and the
+  // response to |message_id| is posted to |reply_port| once that lookup
+  // completes.
+  static AddressList<SocketAddress>* Lookup(const char* host,
+                                            int type,
+                                            Dart_Port reply_port,
+                                            int32_t message_id,
+                                            OSError** os_error);
+
+  // Empties the cache and changes its parameters. A |max_entries| of 0
+  // disables caching, but concurrent lookups are still shared.
+  static void Configure(intptr_t max_entries,
+                        int64_t ttl_millis,
+                        int64_t negative_ttl_millis);
+
+  // Fills |statistics| with the counters, indexed by Statistic.
+  static void GetStatistics(int64_t statistics[kNumStatistics]);
+
+ private:
+  class Entry;
+  class Waiter;
+
+  static Entry* FindLocked(const char* host, int type, uint32_t hash);
+  static void InsertLocked(Entry* entry);
+  static void RemoveLocked(Entry* entry);
+  static void DiscardLocked(Entry* entry);
+  static void TouchLocked(Entry* entry);
+  static void EvictLocked();
+
+  static Mutex* mutex_;
+  static SimpleHashMap* entries_;
+  // The doubly linked list of completed entries, from the most to the least
+  // recently used. Entries with a lookup in progress are not on it.
+  static Entry* lru_head_;
+  static Entry* lru_tail_;
+  static intptr_t count_;
+  static intptr_t max_entries_;
+  static int64_t ttl_millis_;
+  static int64_t negative_ttl_millis_;
+  static int64_t statistics_[kNumStatistics];
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(HostLookupCache);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_HOST_LOOKUP_CACHE_H_
@@ -29,9 +29,14 @@ namespace bin {
   V(Directory_Exists, 2)                                                       \
   V(Directory_FillWithDirectoryListing, 5)                                     \
   V(Directory_GetAsyncDirectoryListerPointer, 1)                               \
+  V(Directory_MatchGlob, 2)                                                    \
+  V(Directory_PauseWalk, 1)                                                    \
   V(Directory_Rename, 3)                                                       \
+  V(Directory_ResumeWalk, 1)                                                   \
   V(Directory_SetAsyncDirectoryListerPointer, 2)                               \
   V(Directory_SetCurrent, 2)                                                   \
+  V(Directory_StartWalk, 6)                                                    \
+  V(Directory_StopWalk, 1)                                                     \
   V(Directory_SystemTemp, 1)                                                   \
   V(EventHandler_SendData, 3)                                                  \
   V(EventHandler_TimerMillisecondClock, 0)                                     \
@@ -53,6 +58,7 @@ namespace bin {
   V(File_LengthFromPath, 2)                                                    \
   V(File_LinkTarget, 2)                                                        \
   V(File_Lock, 4)                                                              \
+  V(File_Map, 4)                                                               \
   V(File_Open, 3)                                                              \
   V(File_OpenStdio, 1)                                                         \
   V(File_Position, 1)                                                          \
@@ -70,6 +76,9 @@ namespace bin {
   V(File_Truncate, 2)                                                          \
   V(File_WriteByte, 2)                                                         \
   V(File_WriteFrom, 4)                                                         \
+  V(FileIOEngine_Read, 5)                                                      \
+  V(FileIOEngine_Submit, 0)                                                    \
+  V(FileIOEngine_Write, 6)                                                     \
   V(FileSystemWatcher_CloseWatcher, 1)                                         \
   V(FileSystemWatcher_GetSocketId, 2)                                          \
   V(FileSystemWatcher_InitWatcher, 0)                                          \
@@ -77,7 +86,7 @@ namespace bin {
   V(FileSystemWatcher_ReadEvents, 2)                                           \
   V(FileSystemWatcher_UnwatchPath, 2)                                          \
   V(FileSystemWatcher_WatchPath, 5)                                            \
-  V(Filter_CreateZLibDeflate, 8)                                               \
+  V(Filter_CreateZLibDeflate, 9)                                               \
   V(Filter_CreateZLibInflate, 4)                                               \
   V(Filter_Process, 4)                                                         \
   V(Filter_Processed, 3)                                                       \
@@ -122,6 +131,7 @@ namespace bin {
   V(SecureSocket_RegisterBadCertificateCallback, 2)                            \
   V(SecureSocket_RegisterHandshakeCompleteCallback, 2)                         \
   V(SecureSocket_Renegotiate, 4)                                               \
+  V(SecureSocket_SocketPointer, 2)                                             \
   V(SecurityContext_Allocate, 1)                                               \
   V(SecurityContext_UsePrivateKeyBytes, 3)                                     \
   V(SecurityContext_SetAlpnProtocols, 3)                                       \
@@ -130,19 +140,23 @@ namespace bin {
   V(SecurityContext_TrustBuiltinRoots, 1)                                      \
   V(SecurityContext_UseCertificateChainBytes, 3)                               \
   V(ServerSocket_Accept, 2)                                                    \
-  V(ServerSocket_CreateBindListen, 7)                                          \
+  V(ServerSocket_CreateBindListen, 8)                                          \
   V(ServerSocket_CreateUnixDomainBindListen, 5)                                \
   V(SocketBase_IsBindError, 2)                                                 \
   V(Socket_Available, 1)                                                       \
   V(Socket_AvailableDatagram, 1)                                               \
+  V(Socket_ConfigureLookupCache, 3)                                            \
   V(Socket_CreateBindConnect, 5)                                               \
   V(Socket_CreateUnixDomainBindConnect, 4)                                     \
   V(Socket_CreateBindDatagram, 6)                                              \
   V(Socket_CreateConnect, 4)                                                   \
   V(Socket_CreateUnixDomainConnect, 3)                                         \
+  V(Socket_EnableZeroCopy, 1)                                                  \
   V(Socket_GetPort, 1)                                                         \
   V(Socket_GetRemotePeer, 1)                                                   \
   V(Socket_GetError, 1)                                                        \
+  V(Socket_GetLookupCacheStatistics, 0)                                        \
+  V(Socket_GetMaxDatagramSize, 1)                                              \
   V(Socket_GetOption, 3)                                                       \
   V(Socket_GetRawOption, 4)                                                    \
   V(Socket_GetSocketId, 1)                                                     \
@@ -150,13 +164,20 @@ namespace bin {
   V(Socket_GetType, 1)                                                         \
   V(Socket_JoinMulticast, 4)                                                   \
   V(Socket_LeaveMulticast, 4)                                                  \
+  V(Socket_ReapZeroCopy, 2)                                                    \
   V(Socket_Read, 2)                                                            \
   V(Socket_RecvFrom, 1)                                                        \
+  V(Socket_RecvFromBatch, 5)                                                   \
+  V(Socket_SendFile, 4)                                                        \
+  V(Socket_SendFileSocketPointer, 1)                                           \
   V(Socket_SendTo, 6)                                                          \
+  V(Socket_SendToBatch, 5)                                                     \
   V(Socket_SetOption, 4)                                                       \
   V(Socket_SetRawOption, 4)                                                    \
   V(Socket_SetSocketId, 3)                                                     \
   V(Socket_WriteList, 4)                                                       \
+  V(Socket_WriteVector, 4)                                                     \
+  V(Socket_WriteZeroCopy, 4)                                                   \
   V(Stdin_ReadByte, 1)                                                         \
   V(Stdin_GetEchoMode, 1)                                                      \
   V(Stdin_SetEchoMode, 2)                                                      \
@@ -165,6 +186,10 @@ namespace bin {
   V(Stdin_AnsiSupported, 1)                                                    \
   V(Stdout_GetTerminalSize, 1)                                                 \
   V(Stdout_AnsiSupported, 1)                                                   \
+  V(Stdout_BufferedEnabled, 0)                                                 \
+  V(Stdout_BufferedFlush, 0)                                                   \
+  V(Stdout_BufferedWrite, 2)                                                   \
+  V(Stdout_GetBufferedStatistics, 0)                                           \
   V(StringToSystemEncoding, 1)                                                 \
   V(SynchronousSocket_Available, 1)                                            \
   V(SynchronousSocket_CloseSync, 1)                                            \
@@ -178,6 +203,12 @@ namespace bin {
   V(SynchronousSocket_ReadList, 4)                                             \
   V(SynchronousSocket_WriteList, 4)                                            \
   V(SystemEncodingToString, 1)                                                 \
+  V(TimerWheel_Add, 2)                                                         \
+  V(TimerWheel_Advance, 2)                                                     \
+  V(TimerWheel_Enabled, 0)                                                     \
+  V(TimerWheel_Init, 2)                                                        \
+  V(TimerWheel_NextExpiry, 1)                                                  \
+  V(TimerWheel_Remove, 2)                                                      \
   V(X509_Der, 1)                                                               \
   V(X509_Pem, 1)                                                               \
   V(X509_Sha1, 1)                                                              \
@@ -40,10 +40,18 @@ void IOServiceCallback(Dart_Port dest_port_id, Dart_CObject* message) {
     CObjectInt32 request_id(request[2]);
     CObjectArray data(request[3]);
     reply_port_id = reply_port.Value();
-    switch (request_id.Value()) {
-      IO_SERVICE_REQUEST_LIST(CASE_REQUEST);
-      default:
-        UNREACHABLE();
+    if (request_id.Value() == IOService::kSocketLookupRequest) {
+      response = Socket::LookupRequest(data, reply_port_id, message_id.Value());
+      if (response == NULL) {
+        // The thread doing the same lookup posts the response.
+        return;
+      }
+    } else {
+      switch (request_id.Value()) {
+        IO_SERVICE_REQUEST_LIST(CASE_REQUEST);
+        default:
+          UNREACHABLE();
+      }
     }
   }
 
@@ -21,7 +21,6 @@ namespace bin {
   V(File, Create, 1)                                                           \
   V(File, Delete, 2)                                                           \
   V(File, Rename, 3)                                                           \
-  V(File, Copy, 4)                                                             \
   V(File, Open, 5)                                                             \
   V(File, ResolveSymbolicLinks, 6)                                             \
   V(File, Close, 7)                                                            \
@@ -48,7 +47,6 @@ namespace bin {
   V(File, Identical, 28)                                                       \
   V(File, Stat, 29)                                                            \
   V(File, Lock, 30)                                                            \
-  V(Socket, Lookup, 31)                                                        \
   V(Socket, ListInterfaces, 32)                                                \
   V(Socket, ReverseLookup, 33)                                                 \
   V(Directory, Create, 34)                                                     \
@@ -59,13 +57,20 @@ namespace bin {
   V(Directory, ListNext, 39)                                                   \
   V(Directory, ListStop, 40)                                                   \
   V(Directory, Rename, 41)                                                     \
-  V(SSLFilter, ProcessFilter, 42)
+  V(SSLFilter, ProcessFilter, 42)                                              \
+  V(File, StatBatch, 43)                                                       \
+  V(File, CopyChunk, 44)                                                       \
+  V(Socket, SendFile, 45)
 
 #define DECLARE_REQUEST(type, method, id) k##type##method##Request = id,
 
 class IOService {
  public:
   enum { IO_SERVICE_REQUEST_LIST(DECLARE_REQUEST) };
+  // Not in the list above, as a lookup may be answered from another thread
+  // after IOServiceCallback returns. See HostLookupCache::Lookup.
+  static const int kSocketLookupRequest = 31;
+  // 4 was File.Copy, which File.copy replaced with File.CopyChunk requests.
 
   static Dart_Port GetServicePort();
 
@@ -11,6 +11,7 @@
 #include "bin/abi_version.h"
 #include "bin/dartdev_utils.h"
 #include "bin/error_exit.h"
+#include "bin/file_system_watcher.h"
 #include "bin/options.h"
 #include "bin/platform.h"
 #include "platform/syslog.h"
@@ -18,6 +19,8 @@
 #include "bin/security_context.h"
 #endif  // !defined(DART_IO_SECURE_SOCKET_DISABLED)
 #include "bin/socket.h"
+#include "bin/stdio.h"
+#include "bin/timer_wheel.h"
 #include "include/dart_api.h"
 #include "platform/assert.h"
 #include "platform/globals.h"
@@ -219,6 +222,26 @@ void Options::PrintUsage() {
 "  When the VM service is told to bind to a particular port, fallback to 0 if\n"
 "  it fails to bind instead of failing to start.\n"
 "\n"
+#if defined(HOST_OS_LINUX)
+"--reuse-port-cpu-affinity\n"
+"  Hand connections to ServerSockets bound with reusePort to the member of\n"
+"  the group selected by the CPU that received them.\n"
+"\n"
+#endif  // defined(HOST_OS_LINUX)
+"--timer-wheel\n"
+"  Keep timers of a second or more in a timer wheel with 10ms slots, which\n"
+"  makes creating and canceling them cheaper when there are many of them.\n"
+"  These timers may fire up to 10ms later than requested.\n"
+"\n"
+"--buffered-stdio\n"
+"  Write the output of print() and of stdout and stderr from a separate\n"
+"  thread, so that a slow reader does not block isolates. At most 1MB of\n"
+"  output is buffered, after which writers wait.\n"
+"\n"
+"--file-watcher-coalescing=<milliseconds>\n"
+"  On Linux, hold file system watcher events back for the given time and\n"
+"  merge repeated modifications of the same path into one event.\n"
+"\n"
 "--root-certs-file=<path>\n"
 "  The path to a file containing the trusted root certificates to use for\n"
 "  secure socket connections.\n"
@@ -352,6 +375,27 @@ bool Options::ProcessObserveOption(const char* arg,
   return true;
 }
 
+bool Options::ProcessFileWatcherCoalescingOption(
+    const char* arg,
+    CommandLineOptions* vm_options) {
+  const char* value =
+      OptionProcessor::ProcessOption(arg, "--file-watcher-coalescing=");
+  if (value == NULL) {
+    return false;
+  }
+  int64_t millis = 0;
+  for (int i = 0; value[i] != '\0'; ++i) {
+    if ((value[i] < '0') || (value[i] > '9') || (millis > kMaxInt32)) {
+      Syslog::PrintErr(
+          "--file-watcher-coalescing must be a number of milliseconds\n");
+      return false;
+    }
+    millis = (millis * 10) + value[i] - '0';
+  }
+  FileSystemWatcher::set_coalescing_window_millis(millis);
+  return true;
+}
+
 int Options::target_abi_version_ = Options::kAbiVersionUnset;
 bool Options::ProcessAbiVersionOption(const char* arg,
                                       CommandLineOptions* vm_options) {
@@ -482,6 +526,9 @@ int Options::ParseArguments(int argc,
 
   Socket::set_short_socket_read(Options::short_socket_read());
   Socket::set_short_socket_write(Options::short_socket_write());
+  Socket::set_reuse_port_cpu_affinity(Options::reuse_port_cpu_affinity());
+  TimerWheel::set_enabled(Options::timer_wheel());
+  StdioBuffer::set_enabled(Options::buffered_stdio());
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLCertContext::set_root_certs_file(Options::root_certs_file());
   SSLCertContext::set_root_certs_cache(Options::root_certs_cache());
@@ -17,6 +17,7 @@
 
 #include "bin/console.h"
 #include "bin/file.h"
+#include "bin/stdio.h"
 
 namespace dart {
 namespace bin {
@@ -27,6 +28,7 @@ int Platform::script_index_ = 1;
 char** Platform::argv_ = NULL;
 
 static void segv_handler(int signal, siginfo_t* siginfo, void* context) {
+  StdioBuffer::FlushOnCrash();
   Syslog::PrintErr(
       "\n===== CRASH =====\n"
       "si_signo=%s(%d), si_code=%d, si_addr=%p\n",
@@ -160,6 +162,7 @@ intptr_t Platform::ResolveExecutablePathInto(char* result, size_t result_size) {
 }
 
 void Platform::Exit(int exit_code) {
+  StdioBuffer::Flush();
   Console::RestoreConfig();
   Dart_PrepareToAbort();
   exit(exit_code);
@@ -18,6 +18,7 @@
 #include "bin/dartutils.h"
 #include "bin/fdutils.h"
 #include "bin/file.h"
+#include "bin/stdio.h"
 
 namespace dart {
 namespace bin {
@@ -152,6 +153,7 @@ intptr_t Platform::ResolveExecutablePathInto(char* result, size_t result_size) {
 }
 
 void Platform::Exit(int exit_code) {
+  StdioBuffer::Flush();
   Console::RestoreConfig();
   Dart_PrepareToAbort();
   exit(exit_code);
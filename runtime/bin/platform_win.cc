@@ -16,6 +16,7 @@
 #if !defined(PLATFORM_DISABLE_SOCKET)
 #include "bin/socket.h"
 #endif
+#include "bin/stdio.h"
 #include "bin/thread.h"
 #include "bin/utils.h"
 #include "bin/utils_win.h"
@@ -69,6 +70,7 @@ class PlatformWin {
          EXCEPTION_ACCESS_VIOLATION) ||
         (ExceptionInfo->ExceptionRecord->ExceptionCode ==
          EXCEPTION_ILLEGAL_INSTRUCTION)) {
+      StdioBuffer::FlushOnCrash();
       Syslog::PrintErr(
           "\n===== CRASH =====\n"
           "ExceptionCode=%d, ExceptionFlags=%d, ExceptionAddress=%p\n",
@@ -304,6 +306,7 @@ intptr_t Platform::ResolveExecutablePathInto(char* result, size_t result_size) {
 }
 
 void Platform::Exit(int exit_code) {
+  StdioBuffer::Flush();
   // Restore the console's output code page
   Console::RestoreConfig();
   // On Windows we use ExitProcess so that threads can't clobber the exit_code.
@@ -13,6 +13,9 @@
 #include <stdio.h>         // NOLINT
 #include <stdlib.h>        // NOLINT
 #include <string.h>        // NOLINT
+#include <sched.h>         // NOLINT
+#include <signal.h>        // NOLINT
+#include <sys/mman.h>      // NOLINT
 #include <sys/resource.h>  // NOLINT
 #include <sys/wait.h>      // NOLINT
 #include <unistd.h>        // NOLINT
@@ -73,11 +76,20 @@ class ProcessInfoList {
 
   static void AddProcess(pid_t pid, intptr_t fd) {
     MutexLocker locker(mutex_);
+    AddProcessLocked(pid, fd);
+  }
+
+  // Like AddProcess, but with mutex() already held. Holding the mutex while
+  // the process is started keeps the exit code handler from looking the
+  // process up before it has been added, even if it exits immediately.
+  static void AddProcessLocked(pid_t pid, intptr_t fd) {
     ProcessInfo* info = new ProcessInfo(pid, fd);
     info->set_next(active_processes_);
     active_processes_ = info;
   }
 
+  static Mutex* mutex() { return mutex_; }
+
   static intptr_t LookupProcessExitFd(pid_t pid) {
     MutexLocker locker(mutex_);
     ProcessInfo* current = active_processes_;
@@ -283,6 +295,8 @@ class ProcessStarter {
     write_out_[1] = -1;
     exec_control_[0] = -1;
     exec_control_[1] = -1;
+    working_directory_fd_ = -1;
+    spawn_errno_ = 0;
 
     program_arguments_ = reinterpret_cast<char**>(Dart_ScopeAllocate(
         (arguments_length + 2) * sizeof(*program_arguments_)));
@@ -310,7 +324,19 @@ class ProcessStarter {
       return err;
     }
 
-    // Fork to create the new process.
+    if (Process::ModeIsAttached(mode_)) {
+      pid_t pid;
+      err = Spawn(&pid);
+      if (err != 0) {
+        return err;
+      }
+      ConnectStdio();
+      *id_ = pid;
+      return 0;
+    }
+
+    // Detached processes are started with fork, as they need a second fork
+    // to detach from this process.
     pid_t pid = TEMP_FAILURE_RETRY(fork());
     if (pid < 0) {
       // Failed to fork.
@@ -322,20 +348,7 @@ class ProcessStarter {
 
     // This runs in the original process.
 
-    // If the child process is not started in detached mode, be sure to
-    // listen for exit-codes, now that we have a non detached child process
-    // and also Register this child process.
-    if (Process::ModeIsAttached(mode_)) {
-      ExitCodeHandler::ProcessStarted();
-      err = RegisterProcess(pid);
-      if (err != 0) {
-        return err;
-      }
-    }
-
-    // Notify child process to start. This is done to delay the call to exec
-    // until the process is registered above, and we are ready to receive the
-    // exit code.
+    // Notify child process to start.
     char msg = '1';
     int bytes_written =
         FDUtils::WriteToBlocking(read_in_[1], &msg, sizeof(msg));
@@ -346,29 +359,23 @@ class ProcessStarter {
     // Read the result of executing the child process.
     close(exec_control_[1]);
     exec_control_[1] = -1;
-    if (Process::ModeIsAttached(mode_)) {
-      err = ReadExecResult();
-    } else {
-      err = ReadDetachedExecResult(&pid);
-    }
+    err = ReadDetachedExecResult(&pid);
     close(exec_control_[0]);
     exec_control_[0] = -1;
 
     // Return error code if any failures.
     if (err != 0) {
-      if (Process::ModeIsAttached(mode_)) {
-        // Since exec() failed, we're not interested in the exit code.
-        // We close the reading side of the exit code pipe here.
-        // GetProcessExitCodes will get a broken pipe error when it
-        // tries to write to the writing side of the pipe and it will
-        // ignore the error.
-        close(*exit_event_);
-        *exit_event_ = -1;
-      }
       CloseAllPipes();
       return err;
     }
 
+    ConnectStdio();
+    *id_ = pid;
+    return 0;
+  }
+
+ private:
+  void ConnectStdio() {
     if (Process::ModeHasStdio(mode_)) {
       // Connect stdio, stdout and stderr.
       FDUtils::SetNonBlocking(read_in_[0]);
@@ -391,12 +398,220 @@ class ProcessStarter {
     }
     ASSERT(exec_control_[0] == -1);
     ASSERT(exec_control_[1] == -1);
+  }
 
-    *id_ = pid;
+  // Attached processes are started with clone(CLONE_VM | CLONE_VFORK)
+  // rather than fork. The child shares the memory of this process until it
+  // calls exec, so the cost of starting a process does not grow with the
+  // size of the heap, as it does when fork copies the page tables. This
+  // process is suspended until the child has called exec or exited.
+  //
+  // Everything that allocates memory or takes locks is done here, before
+  // the child is started. The child only makes system calls, and reports a
+  // failure by storing errno in spawn_errno_.
+  int Spawn(pid_t* pid) {
+    // The exec control pipe is not needed, as the child reports errors
+    // through the shared memory.
+    ClosePipe(exec_control_);
+
+    if (working_directory_ != NULL) {
+      NamespaceScope ns(namespc_, working_directory_);
+      working_directory_fd_ = TEMP_FAILURE_RETRY(
+          openat64(ns.fd(), ns.path(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+      if (working_directory_fd_ < 0) {
+        return CleanupAndReturnError();
+      }
+    }
+    // The child changes to the working directory before it calls exec, so
+    // a relative path is resolved against the working directory.
+    if (!FindPathInNamespace(realpath_, PATH_MAX)) {
+      return CleanupAndReturnError();
+    }
+    has_slash_ = strchr(realpath_, '/') != NULL;
+    exec_environment_ =
+        (program_environment_ != NULL) ? program_environment_ : environ;
+    // Like execvp, search the PATH of the environment the program is
+    // started with.
+    search_path_ = NULL;
+    for (char** entry = exec_environment_; *entry != NULL; entry++) {
+      if (strncmp(*entry, "PATH=", 5) == 0) {
+        search_path_ = *entry + 5;
+        break;
+      }
+    }
+    if (search_path_ == NULL) {
+      search_path_ = "/bin:/usr/bin";
+    }
+    // Arguments for running the program as a shell script, which execvp
+    // does when exec fails with ENOEXEC.
+    intptr_t arguments_length = 0;
+    while (program_arguments_[arguments_length] != NULL) {
+      arguments_length++;
+    }
+    shell_arguments_ = reinterpret_cast<char**>(Dart_ScopeAllocate(
+        (arguments_length + 2) * sizeof(*shell_arguments_)));
+    shell_arguments_[0] = const_cast<char*>("/bin/sh");
+    shell_arguments_[1] = realpath_;
+    for (intptr_t i = 1; i <= arguments_length; i++) {
+      shell_arguments_[i + 1] = program_arguments_[i];
+    }
+
+    int event_fds[2];
+    if (TEMP_FAILURE_RETRY(pipe2(event_fds, O_CLOEXEC)) < 0) {
+      return CleanupAndReturnError();
+    }
+
+    const intptr_t kStackSize = 64 * KB;
+    void* stack = mmap(NULL, kStackSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED) {
+      int actual_errno = errno;
+      close(event_fds[0]);
+      close(event_fds[1]);
+      errno = actual_errno;
+      return CleanupAndReturnError();
+    }
+
+    // Block all signals, so that no signal handler of this process runs on
+    // the child's stack. The child restores the mask before exec.
+    sigset_t all_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &signal_mask_);
+    int clone_errno = 0;
+    {
+      MutexLocker locker(ProcessInfoList::mutex());
+      *pid = clone(&SpawnChild, reinterpret_cast<uint8_t*>(stack) + kStackSize,
+                   CLONE_VM | CLONE_VFORK | SIGCHLD, this);
+      if (*pid < 0) {
+        clone_errno = errno;
+      } else {
+        ProcessInfoList::AddProcessLocked(*pid, event_fds[1]);
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &signal_mask_, NULL);
+    munmap(stack, kStackSize);
+    if (working_directory_fd_ != -1) {
+      close(working_directory_fd_);
+      working_directory_fd_ = -1;
+    }
+
+    if (*pid < 0) {
+      close(event_fds[0]);
+      close(event_fds[1]);
+      errno = clone_errno;
+      return CleanupAndReturnError();
+    }
+
+    ExitCodeHandler::ProcessStarted();
+    if (spawn_errno_ != 0) {
+      // The child has exited. Its exit code is still collected, but as exec
+      // failed nobody is interested in it.
+      close(event_fds[0]);
+      errno = spawn_errno_;
+      return CleanupAndReturnError();
+    }
+    *exit_event_ = event_fds[0];
+    FDUtils::SetNonBlocking(event_fds[0]);
     return 0;
   }
 
- private:
+  // Runs in the child started by Spawn, on its own stack but in the memory
+  // of the parent, until the call to exec.
+  static int SpawnChild(void* parameter) {
+    ProcessStarter* starter = reinterpret_cast<ProcessStarter*>(parameter);
+    // Signal handlers are not shared with the parent, so reset the ones
+    // installed by the parent before signals are unblocked.
+    for (int signal = 1; signal < NSIG; signal++) {
+      struct sigaction action;
+      if ((sigaction(signal, NULL, &action) == 0) &&
+          (action.sa_handler != SIG_DFL) && (action.sa_handler != SIG_IGN)) {
+        action.sa_handler = SIG_DFL;
+        action.sa_flags = 0;
+        sigaction(signal, &action, NULL);
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &starter->signal_mask_, NULL);
+
+    if (starter->mode_ == kNormal) {
+      if ((TEMP_FAILURE_RETRY(dup2(starter->write_out_[0], STDIN_FILENO)) ==
+           -1) ||
+          (TEMP_FAILURE_RETRY(dup2(starter->read_in_[1], STDOUT_FILENO)) ==
+           -1) ||
+          (TEMP_FAILURE_RETRY(dup2(starter->read_err_[1], STDERR_FILENO)) ==
+           -1)) {
+        starter->ReportSpawnError(errno);
+      }
+    } else {
+      ASSERT(starter->mode_ == kInheritStdio);
+    }
+
+    if ((starter->working_directory_fd_ != -1) &&
+        (fchdir(starter->working_directory_fd_) == -1)) {
+      starter->ReportSpawnError(errno);
+    }
+
+    if (starter->has_slash_) {
+      starter->Exec(starter->realpath_);
+      starter->ReportSpawnError(errno);
+    }
+    // Search the PATH like execvp. EACCES is reported if no match was found
+    // but an entry was not accessible.
+    int result_errno = ENOENT;
+    const intptr_t file_length = strlen(starter->realpath_);
+    const char* entry = starter->search_path_;
+    while (true) {
+      const char* end = strchr(entry, ':');
+      intptr_t length = (end == NULL) ? strlen(entry) : end - entry;
+      char candidate[PATH_MAX];
+      if (length + file_length + 2 <= PATH_MAX) {
+        // An empty entry is the current directory.
+        intptr_t position = 0;
+        if (length > 0) {
+          memmove(candidate, entry, length);
+          candidate[length] = '/';
+          position = length + 1;
+        }
+        memmove(candidate + position, starter->realpath_, file_length + 1);
+        starter->Exec(candidate);
+        switch (errno) {
+          case EACCES:
+            result_errno = EACCES;
+            break;
+          case ENOENT:
+          case ENOTDIR:
+          case ENODEV:
+          case ETIMEDOUT:
+          case ESTALE:
+            break;
+          default:
+            starter->ReportSpawnError(errno);
+        }
+      }
+      if (end == NULL) {
+        break;
+      }
+      entry = end + 1;
+    }
+    starter->ReportSpawnError(result_errno);
+    return 1;
+  }
+
+  // Executes the program at |file| in the child started by Spawn. Only
+  // returns if exec failed.
+  void Exec(char* file) {
+    execve(file, program_arguments_, exec_environment_);
+    if (errno == ENOEXEC) {
+      // Not a binary, so run it with the shell, as execvp does.
+      shell_arguments_[1] = file;
+      execve(shell_arguments_[0], shell_arguments_, exec_environment_);
+    }
+  }
+
+  void ReportSpawnError(int error) {
+    spawn_errno_ = error;
+    _exit(1);
+  }
+
   int CreatePipes() {
     int result;
     result = TEMP_FAILURE_RETRY(pipe2(exec_control_, O_CLOEXEC));
@@ -435,11 +650,7 @@ class ProcessStarter {
       perror("Failed receiving notification message");
       exit(1);
     }
-    if (Process::ModeIsAttached(mode_)) {
-      ExecProcess();
-    } else {
-      ExecDetachedProcess();
-    }
+    ExecDetachedProcess();
   }
 
   // Tries to find path_ relative to the current namespace unless it should be
@@ -457,8 +668,14 @@ class ProcessStarter {
       return true;
     }
     NamespaceScope ns(namespc_, path_);
+    intptr_t dir_fd = ns.fd();
+    const char* path = ns.path();
+    if ((path_[0] != '/') && (working_directory_fd_ != -1)) {
+      dir_fd = working_directory_fd_;
+      path = path_;
+    }
     const int fd =
-        TEMP_FAILURE_RETRY(openat64(ns.fd(), ns.path(), O_RDONLY | O_CLOEXEC));
+        TEMP_FAILURE_RETRY(openat64(dir_fd, path, O_RDONLY | O_CLOEXEC));
     if (fd == -1) {
       return false;
     }
@@ -475,41 +692,6 @@ class ProcessStarter {
     return true;
   }
 
-  void ExecProcess() {
-    if (mode_ == kNormal) {
-      if (TEMP_FAILURE_RETRY(dup2(write_out_[0], STDIN_FILENO)) == -1) {
-        ReportChildError();
-      }
-
-      if (TEMP_FAILURE_RETRY(dup2(read_in_[1], STDOUT_FILENO)) == -1) {
-        ReportChildError();
-      }
-
-      if (TEMP_FAILURE_RETRY(dup2(read_err_[1], STDERR_FILENO)) == -1) {
-        ReportChildError();
-      }
-    } else {
-      ASSERT(mode_ == kInheritStdio);
-    }
-
-    if (working_directory_ != NULL &&
-        !Directory::SetCurrent(namespc_, working_directory_)) {
-      ReportChildError();
-    }
-
-    if (program_environment_ != NULL) {
-      environ = program_environment_;
-    }
-
-    char realpath[PATH_MAX];
-    if (!FindPathInNamespace(realpath, PATH_MAX)) {
-      ReportChildError();
-    }
-    // TODO(dart:io) Test for the existence of execveat, and use it instead.
-    execvp(realpath, const_cast<char* const*>(program_arguments_));
-    ReportChildError();
-  }
-
   void ExecDetachedProcess() {
     if (mode_ == kDetached) {
       ASSERT(write_out_[0] == -1);
@@ -575,37 +757,6 @@ class ProcessStarter {
     }
   }
 
-  int RegisterProcess(pid_t pid) {
-    int result;
-    int event_fds[2];
-    result = TEMP_FAILURE_RETRY(pipe2(event_fds, O_CLOEXEC));
-    if (result < 0) {
-      return CleanupAndReturnError();
-    }
-
-    ProcessInfoList::AddProcess(pid, event_fds[1]);
-    *exit_event_ = event_fds[0];
-    FDUtils::SetNonBlocking(event_fds[0]);
-    return 0;
-  }
-
-  int ReadExecResult() {
-    int child_errno;
-    int bytes_read = -1;
-    // Read exec result from child. If no data is returned the exec was
-    // successful and the exec call closed the pipe. Otherwise the errno
-    // is written to the pipe.
-    bytes_read = FDUtils::ReadFromBlocking(exec_control_[0], &child_errno,
-                                           sizeof(child_errno));
-    if (bytes_read == sizeof(child_errno)) {
-      ReadChildError();
-      return child_errno;
-    } else if (bytes_read == -1) {
-      return errno;
-    }
-    return 0;
-  }
-
   int ReadDetachedExecResult(pid_t* pid) {
     int child_errno;
     int bytes_read = -1;
@@ -699,6 +850,10 @@ class ProcessStarter {
     }
     SetChildOsErrorMessage();
     CloseAllPipes();
+    if (working_directory_fd_ != -1) {
+      close(working_directory_fd_);
+      working_directory_fd_ = -1;
+    }
     return actual_errno;
   }
 
@@ -772,6 +927,16 @@ class ProcessStarter {
   int write_out_[2];     // Pipe for stdin to child process.
   int exec_control_[2];  // Pipe to get the result from exec.
 
+  // State shared with the child started by Spawn.
+  int working_directory_fd_;
+  char realpath_[PATH_MAX];
+  bool has_slash_;
+  const char* search_path_;
+  char** exec_environment_;
+  char** shell_arguments_;
+  sigset_t signal_mask_;
+  volatile int spawn_errno_;
+
   char** program_arguments_;
   char** program_environment_;
 
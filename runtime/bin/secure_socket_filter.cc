@@ -13,6 +13,7 @@
 #include "bin/lockers.h"
 #include "bin/secure_socket_utils.h"
 #include "bin/security_context.h"
+#include "bin/socket.h"
 #include "platform/syslog.h"
 #include "platform/text_buffer.h"
 
@@ -32,6 +33,7 @@ bool SSLFilter::library_initialized_ = false;
 // To protect library initialization.
 Mutex* SSLFilter::mutex_ = nullptr;
 int SSLFilter::filter_ssl_index;
+BIO_METHOD* SSLFilter::socket_bio_method_ = NULL;
 
 void SSLFilter::Init() {
   ASSERT(SSLFilter::mutex_ == nullptr);
@@ -199,6 +201,26 @@ void FUNCTION_NAME(SecureSocket_FilterPointer)(Dart_NativeArguments args) {
   Dart_SetReturnValue(args, Dart_NewInteger(filter_pointer));
 }
 
+void FUNCTION_NAME(SecureSocket_SocketPointer)(Dart_NativeArguments args) {
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID) || defined(HOST_OS_MACOS)
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 1));
+  if (socket->fd() < 0) {
+    Dart_SetReturnValue(args, Dart_NewInteger(0));
+    return;
+  }
+  // Like the filter pointer, the socket pointer is passed to the IO Service
+  // thread, which must Release() it when it is done with it.
+  socket->Retain();
+  intptr_t socket_pointer = reinterpret_cast<intptr_t>(socket);
+  Dart_SetReturnValue(args, Dart_NewInteger(socket_pointer));
+#else
+  // On the other platforms socket reads and writes have to go through the
+  // event handler, so the filter cannot use the socket itself.
+  Dart_SetReturnValue(args, Dart_NewInteger(0));
+#endif
+}
+
 /**
  * Pushes data through the SSL filter, reading and writing from circular
  * buffers shared with Dart.
@@ -219,6 +241,13 @@ void FUNCTION_NAME(SecureSocket_FilterPointer)(Dart_NativeArguments args) {
  * When ProcessFilter returns, the Dart thread is responsible for combining
  * the updated pointers from Dart and C++, to make the new valid state of
  * the circular buffer.
+ *
+ * The request also contains a pointer to the network socket, encoded as an
+ * int, or 0, and whether the filter may read from and write to it. When it
+ * may, the encrypted data is read from or written to the socket directly
+ * instead of being copied through the encrypted buffers, and the result
+ * additionally contains the number of bytes read from and written to the
+ * socket, and whether a write to the socket would have blocked.
  */
 CObject* SSLFilter::ProcessFilterRequest(const CObjectArray& request) {
   CObjectIntptr filter_object(request[0]);
@@ -232,14 +261,34 @@ CObject* SSLFilter::ProcessFilterRequest(const CObjectArray& request) {
     starts[i] = CObjectInt32(request[2 * i + 2]).Value();
     ends[i] = CObjectInt32(request[2 * i + 3]).Value();
   }
+  const intptr_t socket_index = 2 * SSLFilter::kNumBuffers + 2;
+  CObjectIntptr socket_object(request[socket_index]);
+  Socket* socket = reinterpret_cast<Socket*>(socket_object.Value());
+  bool read_socket = CObjectBool(request[socket_index + 1]).Value();
+  bool write_socket = CObjectBool(request[socket_index + 2]).Value();
+
+  filter->StartSocketIO(socket, read_socket, write_socket);
+  bool success = filter->ProcessAllBuffers(starts, ends, in_handshake);
+  intptr_t bytes_read = filter->direct_bytes_read_;
+  intptr_t bytes_written = filter->direct_bytes_written_;
+  bool write_blocked = filter->direct_write_blocked_;
+  filter->EndSocketIO();
+  if (socket != NULL) {
+    socket->Release();
+  }
 
-  if (filter->ProcessAllBuffers(starts, ends, in_handshake)) {
+  if (success) {
     CObjectArray* result =
-        new CObjectArray(CObject::NewArray(SSLFilter::kNumBuffers * 2));
+        new CObjectArray(CObject::NewArray(SSLFilter::kNumBuffers * 2 + 3));
     for (int i = 0; i < SSLFilter::kNumBuffers; ++i) {
       result->SetAt(2 * i, new CObjectInt32(CObject::NewInt32(starts[i])));
       result->SetAt(2 * i + 1, new CObjectInt32(CObject::NewInt32(ends[i])));
     }
+    const intptr_t index = SSLFilter::kNumBuffers * 2;
+    result->SetAt(index, new CObjectIntptr(CObject::NewIntptr(bytes_read)));
+    result->SetAt(index + 1,
+                  new CObjectIntptr(CObject::NewIntptr(bytes_written)));
+    result->SetAt(index + 2, CObject::Bool(write_blocked));
     return result;
   } else {
     int32_t error_code = static_cast<int32_t>(ERR_peek_error());
@@ -252,6 +301,83 @@ CObject* SSLFilter::ProcessFilterRequest(const CObjectArray& request) {
   }
 }
 
+void SSLFilter::StartSocketIO(Socket* socket, bool read, bool write) {
+  bool usable = (socket != NULL) && (socket->fd() >= 0);
+  direct_socket_ = usable ? socket : NULL;
+  direct_read_ = usable && read;
+  direct_write_ = usable && write;
+  direct_write_blocked_ = false;
+  direct_bytes_read_ = 0;
+  direct_bytes_written_ = 0;
+}
+
+void SSLFilter::EndSocketIO() {
+  direct_socket_ = NULL;
+  direct_read_ = false;
+  direct_write_ = false;
+}
+
+int SSLFilter::SocketBIORead(BIO* bio, char* data, int length) {
+  SSLFilter* filter = reinterpret_cast<SSLFilter*>(BIO_get_data(bio));
+  BIO_clear_retry_flags(bio);
+  if (!filter->direct_read_ || (BIO_ctrl_pending(filter->ssl_side_) > 0)) {
+    int result = BIO_read(filter->ssl_side_, data, length);
+    if ((result <= 0) && BIO_should_retry(filter->ssl_side_)) {
+      BIO_set_retry_read(bio);
+    }
+    return result;
+  }
+  intptr_t bytes = SocketBase::Read(filter->direct_socket_->fd(), data,
+                                    length, SocketBase::kAsync);
+  if (bytes > 0) {
+    filter->direct_bytes_read_ += bytes;
+    return static_cast<int>(bytes);
+  }
+  // The socket is drained, at its end or failed. The event handler reports
+  // the latter two through the socket's events, so just wait for more data,
+  // and do not try the socket again in this request.
+  filter->direct_read_ = false;
+  BIO_set_retry_read(bio);
+  return -1;
+}
+
+int SSLFilter::SocketBIOWrite(BIO* bio, const char* data, int length) {
+  SSLFilter* filter = reinterpret_cast<SSLFilter*>(BIO_get_data(bio));
+  BIO_clear_retry_flags(bio);
+  // Encrypted data that is waiting in the BIO pair has to go out first.
+  if (filter->direct_write_ && (BIO_ctrl_pending(filter->socket_side_) == 0)) {
+    intptr_t bytes = SocketBase::Write(filter->direct_socket_->fd(), data,
+                                       length, SocketBase::kAsync);
+    if (bytes > 0) {
+      filter->direct_bytes_written_ += bytes;
+      return static_cast<int>(bytes);
+    }
+    if (bytes == 0) {
+      // SSL keeps the rest of the record, and writes it when it is called
+      // again after the socket becomes writable.
+      filter->direct_write_blocked_ = true;
+      BIO_set_retry_write(bio);
+      return -1;
+    }
+    // Let the data take the usual path through the kWriteEncrypted buffer,
+    // so the error is reported when Dart writes it to the socket.
+    filter->direct_write_ = false;
+  }
+  int result = BIO_write(filter->ssl_side_, data, length);
+  if ((result <= 0) && BIO_should_retry(filter->ssl_side_)) {
+    BIO_set_retry_write(bio);
+  }
+  return result;
+}
+
+long SSLFilter::SocketBIOCtrl(BIO* bio,  // NOLINT
+                              int command,
+                              long argument,  // NOLINT
+                              void* pointer) {
+  SSLFilter* filter = reinterpret_cast<SSLFilter*>(BIO_get_data(bio));
+  return BIO_ctrl(filter->ssl_side_, command, argument, pointer);
+}
+
 bool SSLFilter::ProcessAllBuffers(int starts[kNumBuffers],
                                   int ends[kNumBuffers],
                                   bool in_handshake) {
@@ -448,6 +574,13 @@ void SSLFilter::InitializeLibrary() {
     SSL_library_init();
     filter_ssl_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
     ASSERT(filter_ssl_index >= 0);
+    socket_bio_method_ = BIO_meth_new(BIO_TYPE_SOURCE_SINK, "dart:io socket");
+    if (socket_bio_method_ == NULL) {
+      OUT_OF_MEMORY();
+    }
+    BIO_meth_set_read(socket_bio_method_, SocketBIORead);
+    BIO_meth_set_write(socket_bio_method_, SocketBIOWrite);
+    BIO_meth_set_ctrl(socket_bio_method_, SocketBIOCtrl);
     library_initialized_ = true;
   }
 }
@@ -465,16 +598,21 @@ void SSLFilter::Connect(const char* hostname,
 
   int status;
   int error;
-  BIO* ssl_side;
-  status = BIO_new_bio_pair(&ssl_side, kInternalBIOSize, &socket_side_,
+  status = BIO_new_bio_pair(&ssl_side_, kInternalBIOSize, &socket_side_,
                             kInternalBIOSize);
   SecureSocketUtils::CheckStatusSSL(status, "TlsException", "BIO_new_bio_pair",
                                     ssl_);
+  BIO* ssl_bio = BIO_new(socket_bio_method_);
+  if (ssl_bio == NULL) {
+    OUT_OF_MEMORY();
+  }
+  BIO_set_data(ssl_bio, this);
+  BIO_set_init(ssl_bio, 1);
 
   ASSERT(context != NULL);
   ASSERT(context->context() != NULL);
   ssl_ = SSL_new(context->context());
-  SSL_set_bio(ssl_, ssl_side, ssl_side);
+  SSL_set_bio(ssl_, ssl_bio, ssl_bio);
   SSL_set_mode(ssl_, SSL_MODE_AUTO_RETRY);  // TODO(whesse): Is this right?
   SSL_set_ex_data(ssl_, filter_ssl_index, this);
   context->RegisterCallbacks(ssl_);
@@ -602,6 +740,10 @@ void SSLFilter::FreeResources() {
     SSL_free(ssl_);
     ssl_ = NULL;
   }
+  if (ssl_side_ != NULL) {
+    BIO_free(ssl_side_);
+    ssl_side_ = NULL;
+  }
   if (socket_side_ != NULL) {
     BIO_free(socket_side_);
     socket_side_ = NULL;
@@ -21,6 +21,8 @@ namespace bin {
 extern const unsigned char* root_certificates_pem;
 extern unsigned int root_certificates_pem_length;
 
+class Socket;
+
 class SSLFilter : public ReferenceCounted<SSLFilter> {
  public:
   static void Init();
@@ -42,7 +44,14 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   SSLFilter()
       : callback_error(NULL),
         ssl_(NULL),
+        ssl_side_(NULL),
         socket_side_(NULL),
+        direct_socket_(NULL),
+        direct_read_(false),
+        direct_write_(false),
+        direct_write_blocked_(false),
+        direct_bytes_read_(0),
+        direct_bytes_written_(0),
         string_start_(NULL),
         string_length_(NULL),
         handshake_complete_(NULL),
@@ -82,6 +91,14 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   bool ProcessAllBuffers(int starts[kNumBuffers],
                          int ends[kNumBuffers],
                          bool in_handshake);
+
+  // While a filter request runs with a socket, SSL reads encrypted data
+  // directly from the socket, and writes it directly to the socket, instead
+  // of passing it through the kReadEncrypted and kWriteEncrypted buffers.
+  // |read| and |write| say which directions may use the socket. Data already
+  // in the BIO pair is always consumed first, so that it is not reordered.
+  void StartSocketIO(Socket* socket, bool read, bool write);
+  void EndSocketIO();
   Dart_Handle PeerCertificate();
   static void InitializeLibrary();
   Dart_Handle callback_error;
@@ -97,7 +114,16 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   static Mutex* mutex_;  // To protect library initialization.
 
   SSL* ssl_;
+  // SSL reads from and writes to a BIO of SocketBIOMethod, which passes the
+  // data through to the ssl_side_ of the BIO pair, or to direct_socket_.
+  BIO* ssl_side_;
   BIO* socket_side_;
+  Socket* direct_socket_;
+  bool direct_read_;
+  bool direct_write_;
+  bool direct_write_blocked_;
+  intptr_t direct_bytes_read_;
+  intptr_t direct_bytes_written_;
 
   uint8_t* buffers_[kNumBuffers];
   int buffer_size_;
@@ -117,6 +143,14 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   Dart_Handle InitializeBuffers(Dart_Handle dart_this);
   void InitializePlatformData();
 
+  static BIO_METHOD* socket_bio_method_;
+  static int SocketBIORead(BIO* bio, char* data, int length);
+  static int SocketBIOWrite(BIO* bio, const char* data, int length);
+  static long SocketBIOCtrl(BIO* bio,  // NOLINT
+                            int command,
+                            long argument,  // NOLINT
+                            void* pointer);
+
   DISALLOW_COPY_AND_ASSIGN(SSLFilter);
 };
 
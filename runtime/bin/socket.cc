@@ -7,6 +7,7 @@
 #include "bin/dartutils.h"
 #include "bin/eventhandler.h"
 #include "bin/file.h"
+#include "bin/host_lookup_cache.h"
 #include "bin/io_buffer.h"
 #include "bin/isolate_data.h"
 #include "bin/lockers.h"
@@ -28,6 +29,7 @@ ListeningSocketRegistry* globalTcpListeningSocketRegistry = NULL;
 
 bool Socket::short_socket_read_ = false;
 bool Socket::short_socket_write_ = false;
+bool Socket::reuse_port_cpu_affinity_ = false;
 
 void ListeningSocketRegistry::Initialize() {
   ASSERT(globalTcpListeningSocketRegistry == NULL);
@@ -90,13 +92,41 @@ void ListeningSocketRegistry::RemoveByFd(Socket* fd) {
       GetHashmapHashFromIntptr(reinterpret_cast<intptr_t>(fd)));
 }
 
+void ListeningSocketRegistry::UpdateReusePortGroup(OSSocket* first,
+                                                   const RawAddr& addr) {
+#if defined(HOST_OS_LINUX)
+  if (!Socket::reuse_port_cpu_affinity()) {
+    return;
+  }
+  OSSocket* member = FindOSSocketWithAddress(first, addr);
+  if ((member == NULL) || !member->reuse_port) {
+    return;
+  }
+  // The program belongs to the whole group and maps CPUs to indices below
+  // the group size, so it is replaced whenever the size changes. Failing to
+  // attach only loses the affinity; the group is still balanced by hash.
+  ServerSocket::SetReusePortCpuAffinity(
+      member->fd, CountOSSocketsWithAddress(first, addr));
+#endif  // defined(HOST_OS_LINUX)
+}
+
 Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
                                                       RawAddr addr,
                                                       intptr_t backlog,
                                                       bool v6_only,
-                                                      bool shared) {
+                                                      bool shared,
+                                                      bool reuse_port) {
   MutexLocker ml(&mutex_);
 
+#if !defined(HOST_OS_LINUX) && !defined(HOST_OS_ANDROID)
+  // Only Linux and Android balance incoming connections across a SO_REUSEPORT
+  // group, so elsewhere its members share one listening socket instead.
+  if (reuse_port) {
+    shared = true;
+    reuse_port = false;
+  }
+#endif
+
   OSSocket* first_os_socket = NULL;
   intptr_t port = SocketAddress::GetAddrPort(addr);
   if (port > 0) {
@@ -109,7 +139,15 @@ Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
       OSSocket* os_socket_same_addr = FindOSSocketWithAddress(os_socket, addr);
 
       if (os_socket_same_addr != NULL) {
-        if (!os_socket_same_addr->shared || !shared) {
+        if (os_socket_same_addr->reuse_port != reuse_port) {
+          OSError os_error(-1,
+                           "The reusePort flag to bind() needs to be the same "
+                           "if binding multiple times on the same (address, "
+                           "port) combination.",
+                           OSError::kUnknown);
+          return DartUtils::NewDartOSError(&os_error);
+        }
+        if (!reuse_port && (!os_socket_same_addr->shared || !shared)) {
           OSError os_error(-1,
                            "The shared flag to bind() needs to be `true` if "
                            "binding multiple times on the same (address, port) "
@@ -126,24 +164,31 @@ Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
           return DartUtils::NewDartOSError(&os_error);
         }
 
-        // This socket creation is the exact same as the one which originally
-        // created the socket. Feed same fd and store it into native field
-        // of dart socket_object. Sockets here will share same fd but contain a
-        // different port() through EventHandler_SendData.
-        Socket* socketfd = new Socket(os_socket->fd);
-        os_socket->ref_count++;
-        // We set as a side-effect the file descriptor on the dart
-        // socket_object.
-        Socket::ReuseSocketIdNativeField(socket_object, socketfd,
-                                         Socket::kFinalizerListening);
-        InsertByFd(socketfd, os_socket);
-        return Dart_True();
+        if (!reuse_port) {
+          // This socket creation is the exact same as the one which
+          // originally created the socket. Feed same fd and store it into
+          // native field of dart socket_object. Sockets here will share same
+          // fd but contain a different port() through EventHandler_SendData.
+          Socket* socketfd = new Socket(os_socket->fd);
+          os_socket->ref_count++;
+          // We set as a side-effect the file descriptor on the dart
+          // socket_object.
+          Socket::ReuseSocketIdNativeField(socket_object, socketfd,
+                                           Socket::kFinalizerListening);
+          InsertByFd(socketfd, os_socket);
+          return Dart_True();
+        }
+        // Otherwise fall through and add another socket to the SO_REUSEPORT
+        // group, so that the kernel distributes connections between the
+        // sockets instead of all accepts going through one fd.
       }
     }
   }
 
-  // There is no socket listening on that (address, port), so we create new one.
-  intptr_t fd = ServerSocket::CreateBindListen(addr, backlog, v6_only);
+  // There is no socket listening on that (address, port), or it is part of a
+  // SO_REUSEPORT group, so we create new one.
+  intptr_t fd =
+      ServerSocket::CreateBindListen(addr, backlog, v6_only, reuse_port);
   if (fd == -5) {
     OSError os_error(-1, "Invalid host", OSError::kUnknown);
     return DartUtils::NewDartOSError(&os_error);
@@ -178,14 +223,18 @@ Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
   }
 
   Socket* socketfd = new Socket(fd);
-  OSSocket* os_socket =
-      new OSSocket(addr, allocated_port, v6_only, shared, socketfd, NULL);
+  OSSocket* os_socket = new OSSocket(addr, allocated_port, v6_only, shared,
+                                     reuse_port, socketfd, NULL);
   os_socket->ref_count = 1;
   os_socket->next = first_os_socket;
 
   InsertByPort(allocated_port, os_socket);
   InsertByFd(socketfd, os_socket);
 
+  if (reuse_port) {
+    UpdateReusePortGroup(os_socket, addr);
+  }
+
   // We set as a side-effect the port on the dart socket_object.
   Socket::ReuseSocketIdNativeField(socket_object, socketfd,
                                    Socket::kFinalizerListening);
@@ -253,7 +302,7 @@ Dart_Handle ListeningSocketRegistry::CreateUnixDomainBindListen(
 
   Socket* socketfd = new Socket(fd);
   OSSocket* os_socket =
-      new OSSocket(addr, -1, false, shared, socketfd, namespc);
+      new OSSocket(addr, -1, false, shared, false, socketfd, namespc);
   os_socket->ref_count = 1;
   os_socket->next = unix_domain_sockets_;
   unix_domain_sockets_ = os_socket;
@@ -308,6 +357,10 @@ bool ListeningSocketRegistry::CloseOneSafe(OSSocket* os_socket,
     prev->next = os_socket->next;
   }
 
+  if (os_socket->reuse_port) {
+    UpdateReusePortGroup(LookupByPort(os_socket->port), os_socket->address);
+  }
+
   ASSERT(os_socket->ref_count == 0);
   delete os_socket;
   return true;
@@ -676,6 +729,330 @@ void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   }
 }
 
+static void ReleaseWriteVectorData(Dart_Handle* buffers,
+                                   intptr_t* aliases,
+                                   intptr_t count) {
+  for (intptr_t i = 0; i < count; i++) {
+    if (aliases[i] == -1) {
+      Dart_TypedDataReleaseData(buffers[i]);
+    }
+  }
+}
+
+void FUNCTION_NAME(Socket_WriteVector)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffers_obj = Dart_GetNativeArgument(args, 1);
+  Dart_Handle starts_obj = Dart_GetNativeArgument(args, 2);
+  Dart_Handle ends_obj = Dart_GetNativeArgument(args, 3);
+  ASSERT(Dart_IsList(buffers_obj));
+  ASSERT(Dart_IsList(starts_obj));
+  ASSERT(Dart_IsList(ends_obj));
+  intptr_t count = 0;
+  Dart_Handle result = Dart_ListLength(buffers_obj, &count);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  // Buffers beyond the limit are left for the next call, as with any other
+  // partial write.
+  count = Utils::Minimum(count, SocketBase::kMaxWriteVectors);
+  Dart_Handle buffers[SocketBase::kMaxWriteVectors];
+  intptr_t starts[SocketBase::kMaxWriteVectors];
+  // The index of an earlier entry holding the same buffer, or -1. Each buffer
+  // is only acquired once even if it occurs several times in the list.
+  intptr_t aliases[SocketBase::kMaxWriteVectors];
+  SocketIOVector vectors[SocketBase::kMaxWriteVectors];
+  // Collect all handles and ranges before acquiring any typed data, as no
+  // other API calls are allowed while the data is acquired.
+  for (intptr_t i = 0; i < count; i++) {
+    buffers[i] = Dart_ListGetAt(buffers_obj, i);
+    if (Dart_IsError(buffers[i])) {
+      Dart_PropagateError(buffers[i]);
+    }
+    aliases[i] = -1;
+    for (intptr_t j = 0; j < i; j++) {
+      if (Dart_IdentityEquals(buffers[i], buffers[j])) {
+        aliases[i] = j;
+        break;
+      }
+    }
+    starts[i] = DartUtils::GetIntptrValue(Dart_ListGetAt(starts_obj, i));
+    intptr_t end = DartUtils::GetIntptrValue(Dart_ListGetAt(ends_obj, i));
+    ASSERT(starts[i] <= end);
+    vectors[i].length = end - starts[i];
+  }
+  bool short_write = false;
+  if (Socket::short_socket_write() && (count > 0)) {
+    count = 1;
+    if (vectors[0].length > 1) {
+      short_write = true;
+    }
+    vectors[0].length = (vectors[0].length + 1) / 2;
+  }
+  if (count == 0) {
+    Dart_SetIntegerReturnValue(args, 0);
+    return;
+  }
+  uint8_t* data[SocketBase::kMaxWriteVectors];
+  for (intptr_t i = 0; i < count; i++) {
+    if (aliases[i] != -1) {
+      data[i] = data[aliases[i]];
+    } else {
+      Dart_TypedData_Type type;
+      intptr_t len;
+      result = Dart_TypedDataAcquireData(
+          buffers[i], &type, reinterpret_cast<void**>(&data[i]), &len);
+      if (Dart_IsError(result)) {
+        ReleaseWriteVectorData(buffers, aliases, i);
+        Dart_PropagateError(result);
+      }
+      ASSERT((starts[i] + vectors[i].length) <= len);
+    }
+    vectors[i].base = data[i] + starts[i];
+  }
+  intptr_t bytes_written = SocketBase::WriteVector(socket->fd(), vectors,
+                                                   count, SocketBase::kAsync);
+  if (bytes_written >= 0) {
+    ReleaseWriteVectorData(buffers, aliases, count);
+    if (short_write) {
+      // See Socket_WriteList.
+      Dart_SetIntegerReturnValue(args, -bytes_written);
+    } else {
+      Dart_SetIntegerReturnValue(args, bytes_written);
+    }
+  } else {
+    // Extract OSError before we release data, as it may override the error.
+    Dart_Handle error;
+    {
+      OSError os_error;
+      ReleaseWriteVectorData(buffers, aliases, count);
+      error = DartUtils::NewDartOSError(&os_error);
+    }
+    Dart_ThrowException(error);
+  }
+}
+
+// Layout of the side tables used by Socket_RecvFromBatch and
+// Socket_SendToBatch. These must match _NativeSocket in socket_patch.dart.
+// Each address entry is a length byte followed by room for an in6_addr, and
+// each receive metadata entry holds the length, port, GRO segment size and
+// whether the datagram was truncated.
+static const intptr_t kBatchAddressStride = 17;
+static const intptr_t kBatchMetadataStride = 4;
+
+// The largest UDP payload, that of an IPv6 datagram without jumbograms.
+static const intptr_t kMaxUdpPayload = 65535 - 8;
+
+void FUNCTION_NAME(Socket_GetMaxDatagramSize)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  // The kernel drops datagrams that do not fit the receive buffer, so no
+  // datagram received is larger than it.
+  intptr_t max_size = kMaxUdpPayload;
+  int receive_buffer_size = 0;
+  unsigned int length = sizeof(receive_buffer_size);
+  if (SocketBase::GetOption(socket->fd(), SOL_SOCKET, SO_RCVBUF,
+                            reinterpret_cast<char*>(&receive_buffer_size),
+                            &length) &&
+      (receive_buffer_size > 0)) {
+    max_size = Utils::Minimum<intptr_t>(max_size, receive_buffer_size);
+  }
+  Dart_SetIntegerReturnValue(args, max_size);
+}
+
+// Throws an ArgumentError unless the |count| objects are typed data of the
+// given |types|.
+static void CheckBatchDataTypes(Dart_Handle* objects,
+                                const Dart_TypedData_Type* types,
+                                intptr_t count) {
+  for (intptr_t i = 0; i < count; i++) {
+    if (Dart_GetTypeOfTypedData(objects[i]) != types[i]) {
+      Dart_ThrowException(
+          DartUtils::NewDartArgumentError("Invalid batch buffer"));
+    }
+  }
+}
+
+// Acquires the data of all |count| typed data objects. On failure the data
+// acquired so far is released and the error is returned.
+static Dart_Handle AcquireBatchData(Dart_Handle* objects,
+                                    void** data,
+                                    intptr_t* lengths,
+                                    intptr_t count) {
+  for (intptr_t i = 0; i < count; i++) {
+    Dart_TypedData_Type type;
+    Dart_Handle result =
+        Dart_TypedDataAcquireData(objects[i], &type, &data[i], &lengths[i]);
+    if (Dart_IsError(result)) {
+      for (intptr_t j = 0; j < i; j++) {
+        Dart_TypedDataReleaseData(objects[j]);
+      }
+      return result;
+    }
+  }
+  return Dart_Null();
+}
+
+static void ReleaseBatchData(Dart_Handle* objects, intptr_t count) {
+  for (intptr_t i = 0; i < count; i++) {
+    Dart_TypedDataReleaseData(objects[i]);
+  }
+}
+
+void FUNCTION_NAME(Socket_RecvFromBatch)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  intptr_t slot_size =
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  if (slot_size <= 0) {
+    Dart_ThrowException(DartUtils::NewDartArgumentError("Invalid slot size"));
+  }
+  enum { kBuffer, kMetadata, kAddresses, kNumObjects };
+  Dart_Handle objects[kNumObjects] = {Dart_GetNativeArgument(args, 1),
+                                      Dart_GetNativeArgument(args, 3),
+                                      Dart_GetNativeArgument(args, 4)};
+  const Dart_TypedData_Type types[kNumObjects] = {
+      Dart_TypedData_kUint8, Dart_TypedData_kInt32, Dart_TypedData_kUint8};
+  CheckBatchDataTypes(objects, types, kNumObjects);
+  void* data[kNumObjects];
+  intptr_t lengths[kNumObjects];
+  Dart_Handle result = AcquireBatchData(objects, data, lengths, kNumObjects);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(data[kBuffer]);
+  int32_t* metadata = reinterpret_cast<int32_t*>(data[kMetadata]);
+  uint8_t* addresses = reinterpret_cast<uint8_t*>(data[kAddresses]);
+  intptr_t count = lengths[kBuffer] / slot_size;
+  count = Utils::Minimum(count, lengths[kMetadata] / kBatchMetadataStride);
+  count = Utils::Minimum(count, lengths[kAddresses] / kBatchAddressStride);
+  count = Utils::Minimum(count, SocketBase::kMaxDatagramBatch);
+  SocketDatagram datagrams[SocketBase::kMaxDatagramBatch];
+  for (intptr_t i = 0; i < count; i++) {
+    datagrams[i].buffer = buffer + i * slot_size;
+    datagrams[i].length = slot_size;
+  }
+  intptr_t received = 0;
+  if (count > 0) {
+    received = SocketBase::RecvFromBatch(socket->fd(), datagrams, count,
+                                         SocketBase::kAsync);
+  }
+  if (received < 0) {
+    // Extract OSError before we release data, as it may override the error.
+    Dart_Handle error;
+    {
+      OSError os_error;
+      ReleaseBatchData(objects, kNumObjects);
+      error = DartUtils::NewDartOSError(&os_error);
+    }
+    Dart_ThrowException(error);
+  }
+  for (intptr_t i = 0; i < received; i++) {
+    // Memory Sanitizer does not see the addresses written by recvmmsg.
+    MSAN_UNPOISON(&datagrams[i].addr, sizeof(RawAddr));
+    const RawAddr& addr = datagrams[i].addr;
+    int32_t* entry = metadata + i * kBatchMetadataStride;
+    entry[0] = datagrams[i].length;
+    entry[1] = SocketAddress::GetAddrPort(addr);
+    entry[2] = datagrams[i].segment_size;
+    entry[3] = datagrams[i].truncated ? 1 : 0;
+    uint8_t* address = addresses + i * kBatchAddressStride;
+    intptr_t in_addr_len = SocketAddress::GetInAddrLength(addr);
+    address[0] = in_addr_len;
+    if (addr.addr.sa_family == AF_INET6) {
+      memmove(address + 1, &addr.in6.sin6_addr, in_addr_len);
+    } else {
+      memmove(address + 1, &addr.in.sin_addr, in_addr_len);
+    }
+  }
+  ReleaseBatchData(objects, kNumObjects);
+  Dart_SetIntegerReturnValue(args, received);
+}
+
+void FUNCTION_NAME(Socket_SendToBatch)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  enum { kBuffer, kOffsets, kAddresses, kPorts, kNumObjects };
+  Dart_Handle objects[kNumObjects] = {
+      Dart_GetNativeArgument(args, 1), Dart_GetNativeArgument(args, 2),
+      Dart_GetNativeArgument(args, 3), Dart_GetNativeArgument(args, 4)};
+  const Dart_TypedData_Type types[kNumObjects] = {
+      Dart_TypedData_kUint8, Dart_TypedData_kInt32, Dart_TypedData_kUint8,
+      Dart_TypedData_kInt32};
+  CheckBatchDataTypes(objects, types, kNumObjects);
+  void* data[kNumObjects];
+  intptr_t lengths[kNumObjects];
+  Dart_Handle result = AcquireBatchData(objects, data, lengths, kNumObjects);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(data[kBuffer]);
+  int32_t* offsets = reinterpret_cast<int32_t*>(data[kOffsets]);
+  uint8_t* addresses = reinterpret_cast<uint8_t*>(data[kAddresses]);
+  int32_t* ports = reinterpret_cast<int32_t*>(data[kPorts]);
+  // |offsets| holds one more entry than there are datagrams, so datagram i
+  // spans [offsets[i], offsets[i + 1]).
+  intptr_t count = Utils::Maximum<intptr_t>(lengths[kOffsets] - 1, 0);
+  count = Utils::Minimum(count, lengths[kAddresses] / kBatchAddressStride);
+  count = Utils::Minimum(count, lengths[kPorts]);
+  count = Utils::Minimum(count, SocketBase::kMaxDatagramBatch);
+  SocketDatagram datagrams[SocketBase::kMaxDatagramBatch];
+  // The side tables come from Dart code, so they are checked here rather
+  // than trusted. The error is thrown once the data is released, as no
+  // other API calls are allowed while it is acquired.
+  const char* invalid = NULL;
+  for (intptr_t i = 0; i < count; i++) {
+    const uint8_t* address = addresses + i * kBatchAddressStride;
+    if ((offsets[i] < 0) || (offsets[i] > offsets[i + 1]) ||
+        (offsets[i + 1] > lengths[kBuffer])) {
+      invalid = "Invalid datagram offsets";
+    } else if ((address[0] != sizeof(in_addr)) &&
+               (address[0] != sizeof(in6_addr))) {
+      invalid = "Invalid datagram address";
+    } else if ((ports[i] < 0) || (ports[i] > 65535)) {
+      invalid = "Invalid datagram port";
+    }
+    if (invalid != NULL) {
+      break;
+    }
+    datagrams[i].buffer = buffer + offsets[i];
+    datagrams[i].length = offsets[i + 1] - offsets[i];
+    datagrams[i].segment_size = 0;
+    RawAddr* addr = &datagrams[i].addr;
+    memset(addr, 0, sizeof(RawAddr));
+    if (address[0] == sizeof(in_addr)) {
+      addr->in.sin_family = AF_INET;
+      memmove(&addr->in.sin_addr, address + 1, sizeof(in_addr));
+    } else {
+      addr->in6.sin6_family = AF_INET6;
+      memmove(&addr->in6.sin6_addr, address + 1, sizeof(in6_addr));
+    }
+    SocketAddress::SetAddrPort(addr, ports[i]);
+  }
+  if (invalid != NULL) {
+    ReleaseBatchData(objects, kNumObjects);
+    Dart_ThrowException(DartUtils::NewDartArgumentError(invalid));
+  }
+  intptr_t sent = 0;
+  if (count > 0) {
+    sent = SocketBase::SendToBatch(socket->fd(), datagrams, count,
+                                   SocketBase::kAsync);
+  }
+  if (sent >= 0) {
+    ReleaseBatchData(objects, kNumObjects);
+    Dart_SetIntegerReturnValue(args, sent);
+  } else {
+    // Extract OSError before we release data, as it may override the error.
+    Dart_Handle error;
+    {
+      OSError os_error;
+      ReleaseBatchData(objects, kNumObjects);
+      error = DartUtils::NewDartOSError(&os_error);
+    }
+    Dart_ThrowException(error);
+  }
+}
+
 void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -716,6 +1093,107 @@ void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Socket_SendFile)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  File* file = File::FromDartObject(Dart_GetNativeArgument(args, 1));
+  int64_t offset = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  if (file == NULL) {
+    OSError os_error(-1, "File closed", OSError::kUnknown);
+    Dart_ThrowException(DartUtils::NewDartOSError(&os_error));
+  }
+  if (length < 0) {
+    Dart_ThrowException(DartUtils::NewDartArgumentError("Invalid length"));
+  }
+  // The file stays alive while its descriptor is used, even if it is closed
+  // and collected meanwhile. It is released before any exception is thrown,
+  // since throwing does not return.
+  file->Retain();
+  intptr_t bytes_written = SocketBase::SendFile(
+      socket->fd(), file, offset, length, socket->send_file_buffer());
+  file->Release();
+  if (bytes_written < 0) {
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+  Dart_SetIntegerReturnValue(args, bytes_written);
+}
+
+void FUNCTION_NAME(Socket_SendFileSocketPointer)(Dart_NativeArguments args) {
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID) || defined(HOST_OS_MACOS)
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  // The socket pointer is passed to the IO Service thread, which must
+  // Release() it when it is done with it.
+  socket->Retain();
+  Dart_SetIntegerReturnValue(args, reinterpret_cast<intptr_t>(socket));
+#else
+  // On the other platforms socket writes have to go through the event
+  // handler or the isolate, and there is no sendfile to offload.
+  Dart_SetIntegerReturnValue(args, 0);
+#endif
+}
+
+void FUNCTION_NAME(Socket_EnableZeroCopy)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  bool enabled = SocketBase::EnableZeroCopy(socket->fd());
+  if (enabled) {
+    socket->set_zero_copy_enabled();
+  }
+  Dart_SetBooleanReturnValue(args, enabled);
+}
+
+void FUNCTION_NAME(Socket_WriteZeroCopy)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffer_obj = Dart_GetNativeArgument(args, 1);
+  ASSERT(Dart_IsList(buffer_obj));
+  intptr_t offset = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  // Only external typed data has a fixed address; anything else may be moved
+  // by the GC while the kernel is still reading from it.
+  bool zero_copy =
+      Dart_GetTypeOfExternalTypedData(buffer_obj) == Dart_TypedData_kUint8;
+  Dart_TypedData_Type type;
+  uint8_t* buffer = NULL;
+  intptr_t len;
+  Dart_Handle result = Dart_TypedDataAcquireData(
+      buffer_obj, &type, reinterpret_cast<void**>(&buffer), &len);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT((offset + length) <= len);
+  buffer += offset;
+  intptr_t bytes_written =
+      zero_copy ? SocketBase::WriteZeroCopy(socket->fd(), buffer, length,
+                                            SocketBase::kAsync)
+                : SocketBase::Write(socket->fd(), buffer, length,
+                                    SocketBase::kAsync);
+  Dart_TypedDataReleaseData(buffer_obj);
+  if (bytes_written < 0) {
+    Dart_ThrowException(DartUtils::NewDartOSError());
+  }
+  if (zero_copy && (bytes_written > 0)) {
+    socket->AddZeroCopyPin(buffer_obj);
+  }
+  Dart_SetIntegerReturnValue(args, bytes_written);
+}
+
+void FUNCTION_NAME(Socket_ReapZeroCopy)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  // The event handler reads the completions when they wake it up. Polling the
+  // error queue here is only needed while the socket is not being watched.
+  bool poll = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 1));
+  if (poll) {
+    socket->ReapZeroCopyCompletions();
+  }
+  socket->ReleaseZeroCopyPins();
+  Dart_SetIntegerReturnValue(args, socket->zero_copy_pending());
+}
+
 void FUNCTION_NAME(Socket_GetPort)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -815,8 +1293,9 @@ void FUNCTION_NAME(ServerSocket_CreateBindListen)(Dart_NativeArguments args) {
       Dart_GetNativeArgument(args, 3), 0, 65535);
   bool v6_only = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 4));
   bool shared = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 5));
+  bool reuse_port = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 6));
   if (addr.addr.sa_family == AF_INET6) {
-    Dart_Handle scope_id_arg = Dart_GetNativeArgument(args, 6);
+    Dart_Handle scope_id_arg = Dart_GetNativeArgument(args, 7);
     int64_t scope_id =
         DartUtils::GetInt64ValueCheckRange(scope_id_arg, 0, 65535);
     SocketAddress::SetAddrScope(&addr, scope_id);
@@ -824,7 +1303,7 @@ void FUNCTION_NAME(ServerSocket_CreateBindListen)(Dart_NativeArguments args) {
 
   Dart_Handle socket_object = Dart_GetNativeArgument(args, 0);
   Dart_Handle result = ListeningSocketRegistry::Instance()->CreateBindListen(
-      socket_object, addr, backlog, v6_only, shared);
+      socket_object, addr, backlog, v6_only, shared, reuse_port);
   Dart_SetReturnValue(args, result);
 }
 
@@ -867,50 +1346,60 @@ void FUNCTION_NAME(ServerSocket_Accept)(Dart_NativeArguments args) {
   }
 }
 
-CObject* Socket::LookupRequest(const CObjectArray& request) {
+CObject* Socket::LookupRequest(const CObjectArray& request,
+                               Dart_Port reply_port,
+                               int32_t message_id) {
   if ((request.Length() == 2) && request[0]->IsString() &&
       request[1]->IsInt32()) {
     CObjectString host(request[0]);
     CObjectInt32 type(request[1]);
-    CObject* result = NULL;
     OSError* os_error = NULL;
-    AddressList<SocketAddress>* addresses =
-        SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
-    if (addresses != NULL) {
-      CObjectArray* array =
-          new CObjectArray(CObject::NewArray(addresses->count() + 1));
-      array->SetAt(0, new CObjectInt32(CObject::NewInt32(0)));
-      for (intptr_t i = 0; i < addresses->count(); i++) {
-        SocketAddress* addr = addresses->GetAt(i);
-        CObjectArray* entry = new CObjectArray(CObject::NewArray(4));
-
-        CObjectInt32* type =
-            new CObjectInt32(CObject::NewInt32(addr->GetType()));
-        entry->SetAt(0, type);
+    AddressList<SocketAddress>* addresses = HostLookupCache::Lookup(
+        host.CString(), type.Value(), reply_port, message_id, &os_error);
+    if ((addresses == NULL) && (os_error == NULL)) {
+      return NULL;
+    }
+    return LookupResponse(addresses, os_error);
+  }
+  return CObject::IllegalArgumentError();
+}
 
-        CObjectString* as_string =
-            new CObjectString(CObject::NewString(addr->as_string()));
-        entry->SetAt(1, as_string);
+CObject* Socket::LookupResponse(AddressList<SocketAddress>* addresses,
+                                OSError* os_error) {
+  CObject* result = NULL;
+  if (addresses != NULL) {
+    CObjectArray* array =
+        new CObjectArray(CObject::NewArray(addresses->count() + 1));
+    array->SetAt(0, new CObjectInt32(CObject::NewInt32(0)));
+    for (intptr_t i = 0; i < addresses->count(); i++) {
+      SocketAddress* addr = addresses->GetAt(i);
+      CObjectArray* entry = new CObjectArray(CObject::NewArray(4));
+
+      CObjectInt32* type =
+          new CObjectInt32(CObject::NewInt32(addr->GetType()));
+      entry->SetAt(0, type);
+
+      CObjectString* as_string =
+          new CObjectString(CObject::NewString(addr->as_string()));
+      entry->SetAt(1, as_string);
 
-        RawAddr raw = addr->addr();
-        CObjectUint8Array* data = SocketAddress::ToCObject(raw);
-        entry->SetAt(2, data);
+      RawAddr raw = addr->addr();
+      CObjectUint8Array* data = SocketAddress::ToCObject(raw);
+      entry->SetAt(2, data);
 
-        CObjectInt64* scope_id = new CObjectInt64(
-            CObject::NewInt64(SocketAddress::GetAddrScope(raw)));
-        entry->SetAt(3, scope_id);
+      CObjectInt64* scope_id = new CObjectInt64(
+          CObject::NewInt64(SocketAddress::GetAddrScope(raw)));
+      entry->SetAt(3, scope_id);
 
-        array->SetAt(i + 1, entry);
-      }
-      result = array;
-      delete addresses;
-    } else {
-      result = CObject::NewOSError(os_error);
-      delete os_error;
+      array->SetAt(i + 1, entry);
     }
-    return result;
+    result = array;
+    delete addresses;
+  } else {
+    result = CObject::NewOSError(os_error);
+    delete os_error;
   }
-  return CObject::IllegalArgumentError();
+  return result;
 }
 
 CObject* Socket::ReverseLookupRequest(const CObjectArray& request) {
@@ -944,6 +1433,50 @@ CObject* Socket::ReverseLookupRequest(const CObjectArray& request) {
   return CObject::IllegalArgumentError();
 }
 
+static int64_t CObjectToInt64(CObject* cobject) {
+  if (cobject->IsInt32()) {
+    CObjectInt32 value(cobject);
+    return value.Value();
+  }
+  CObjectInt64 value(cobject);
+  return value.Value();
+}
+
+CObject* Socket::SendFileRequest(const CObjectArray& request) {
+  if ((request.Length() < 1) || !request[0]->IsIntptr()) {
+    return CObject::IllegalArgumentError();
+  }
+  File* file = reinterpret_cast<File*>(CObjectIntptr(request[0]).Value());
+  RefCntReleaseScope<File> file_scope(file);
+  if ((request.Length() < 2) || !request[1]->IsIntptr()) {
+    return CObject::IllegalArgumentError();
+  }
+  Socket* socket = reinterpret_cast<Socket*>(CObjectIntptr(request[1]).Value());
+  RefCntReleaseScope<Socket> socket_scope(socket);
+  if ((request.Length() != 4) || !request[2]->IsInt32OrInt64() ||
+      !request[3]->IsInt32OrInt64()) {
+    return CObject::IllegalArgumentError();
+  }
+  if (file->IsClosed()) {
+    return CObject::FileClosedError();
+  }
+  const int64_t offset = CObjectToInt64(request[2]);
+  const int64_t length = CObjectToInt64(request[3]);
+  if ((offset < 0) || (length < 0) || (socket->fd() < 0)) {
+    return CObject::IllegalArgumentError();
+  }
+  // Socket_SendFileSocketPointer only hands out sockets on platforms with
+  // sendfile, so no buffer is needed.
+  const intptr_t sent = SocketBase::SendFile(
+      socket->fd(), file, offset,
+      static_cast<intptr_t>(Utils::Minimum<int64_t>(length, kIntptrMax)),
+      NULL);
+  if (sent < 0) {
+    return CObject::NewOSError();
+  }
+  return new CObjectIntptr(CObject::NewIntptr(sent));
+}
+
 CObject* Socket::ListInterfacesRequest(const CObjectArray& request) {
   if ((request.Length() == 1) && request[0]->IsInt32()) {
     CObjectInt32 type(request[0]);
@@ -1321,6 +1854,51 @@ void Socket::SetSocketIdNativeField(Dart_Handle handle,
   ReuseSocketIdNativeField(handle, socket, finalizer);
 }
 
+void Socket::AddZeroCopyPin(Dart_Handle buffer) {
+  ZeroCopyPin* pin = new ZeroCopyPin();
+  pin->id = zero_copy_next_id_++;
+  pin->buffer = Dart_NewPersistentHandle(buffer);
+  pin->next = nullptr;
+  if (zero_copy_tail_ == nullptr) {
+    zero_copy_head_ = pin;
+  } else {
+    zero_copy_tail_->next = pin;
+  }
+  zero_copy_tail_ = pin;
+  zero_copy_pending_++;
+}
+
+void Socket::ReleaseZeroCopyPins() {
+  uint32_t completed = zero_copy_completed_.load(std::memory_order_acquire);
+  // Sequence numbers wrap around, so compare them as a signed distance.
+  while ((zero_copy_head_ != nullptr) &&
+         (static_cast<int32_t>(completed - zero_copy_head_->id) > 0)) {
+    ZeroCopyPin* pin = zero_copy_head_;
+    zero_copy_head_ = pin->next;
+    Dart_DeletePersistentHandle(pin->buffer);
+    delete pin;
+    zero_copy_pending_--;
+  }
+  if (zero_copy_head_ == nullptr) {
+    zero_copy_tail_ = nullptr;
+  }
+}
+
+bool Socket::ReapZeroCopyCompletions() {
+  uint32_t completed;
+  if (!SocketBase::ReapZeroCopyCompletions(fd_, &completed)) {
+    return false;
+  }
+  // Both the event handler and the isolate may reap, so only ever move the
+  // completed sequence number forward.
+  uint32_t current = zero_copy_completed_.load(std::memory_order_relaxed);
+  while ((static_cast<int32_t>(completed - current) > 0) &&
+         !zero_copy_completed_.compare_exchange_weak(
+             current, completed, std::memory_order_acq_rel)) {
+  }
+  return true;
+}
+
 Socket* Socket::GetSocketIdNativeField(Dart_Handle socket_obj) {
   intptr_t id;
   Dart_Handle err =
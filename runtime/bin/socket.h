@@ -5,6 +5,8 @@
 #ifndef RUNTIME_BIN_SOCKET_H_
 #define RUNTIME_BIN_SOCKET_H_
 
+#include <atomic>
+
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
 #include "bin/file.h"
@@ -66,6 +68,36 @@ class Socket : public ReferenceCounted<Socket> {
   uint8_t* udp_receive_buffer() const { return udp_receive_buffer_; }
   void set_udp_receive_buffer(uint8_t* buffer) { udp_receive_buffer_ = buffer; }
 
+  // The buffer SocketBase::SendFile copies through on platforms without
+  // sendfile, allocated on first use. Only used by the owning isolate.
+  uint8_t* send_file_buffer() {
+    if (send_file_buffer_ == nullptr) {
+      send_file_buffer_ = reinterpret_cast<uint8_t*>(
+          malloc(SocketBase::kSendFileBufferSize));
+    }
+    return send_file_buffer_;
+  }
+
+  // Zero-copy writes hand the buffer itself to the kernel, so the Dart object
+  // backing it is kept alive by a persistent handle until the kernel reports
+  // the send as completed. These must be called on the owning isolate.
+  void AddZeroCopyPin(Dart_Handle buffer);
+  // Release the pins of all sends reported as completed so far.
+  void ReleaseZeroCopyPins();
+  intptr_t zero_copy_pending() const { return zero_copy_pending_; }
+
+  bool zero_copy_enabled() const {
+    return zero_copy_enabled_.load(std::memory_order_acquire);
+  }
+  void set_zero_copy_enabled() {
+    zero_copy_enabled_.store(true, std::memory_order_release);
+  }
+  // Reads the completion notifications queued on the error queue of fd_ and
+  // records them for ReleaseZeroCopyPins. Returns true if there were any.
+  // Called by the event handler when the notifications wake it up, and by the
+  // owning isolate when it has to wait for them.
+  bool ReapZeroCopyCompletions();
+
   static bool Initialize();
 
   // Creates a socket which is bound and connected. The port to connect to is
@@ -85,9 +117,19 @@ class Socket : public ReferenceCounted<Socket> {
                                      bool reusePort,
                                      int ttl = 1);
 
-  static CObject* LookupRequest(const CObjectArray& request);
+  // Returns NULL if the response is posted to |reply_port| later.
+  static CObject* LookupRequest(const CObjectArray& request,
+                                Dart_Port reply_port,
+                                int32_t message_id);
+  // Converts the result of a lookup to its response, and deletes it.
+  static CObject* LookupResponse(AddressList<SocketAddress>* addresses,
+                                 OSError* os_error);
   static CObject* ListInterfacesRequest(const CObjectArray& request);
   static CObject* ReverseLookupRequest(const CObjectArray& request);
+  // Sends part of a file on a socket handed out by
+  // Socket_SendFileSocketPointer, so that reading the file does not block the
+  // isolate.
+  static CObject* SendFileRequest(const CObjectArray& request);
 
   static Dart_Port GetServicePort();
 
@@ -107,27 +149,59 @@ class Socket : public ReferenceCounted<Socket> {
   static void set_short_socket_write(bool short_socket_write) {
     short_socket_write_ = short_socket_write;
   }
+  // When set, connections to a group of listening sockets bound with
+  // reusePort go to the member selected by the CPU that received them.
+  static bool reuse_port_cpu_affinity() { return reuse_port_cpu_affinity_; }
+  static void set_reuse_port_cpu_affinity(bool reuse_port_cpu_affinity) {
+    reuse_port_cpu_affinity_ = reuse_port_cpu_affinity;
+  }
 
   static bool IsSignalSocketFlag(intptr_t flag) {
     return ((flag & (0x1 << kInternalSignalSocket)) != 0);
   }
 
  private:
+  struct ZeroCopyPin {
+    uint32_t id;
+    Dart_PersistentHandle buffer;
+    ZeroCopyPin* next;
+  };
+
   ~Socket() {
     ASSERT(fd_ == kClosedFd);
     free(udp_receive_buffer_);
     udp_receive_buffer_ = NULL;
+    free(send_file_buffer_);
+    // Any persistent handles left here belong to an isolate that has shut
+    // down and were freed with it.
+    while (zero_copy_head_ != nullptr) {
+      ZeroCopyPin* next = zero_copy_head_->next;
+      delete zero_copy_head_;
+      zero_copy_head_ = next;
+    }
   }
 
   static const int kClosedFd = -1;
 
   static bool short_socket_read_;
   static bool short_socket_write_;
+  static bool reuse_port_cpu_affinity_;
 
   intptr_t fd_;
   Dart_Port isolate_port_;
   Dart_Port port_;
   uint8_t* udp_receive_buffer_;
+  uint8_t* send_file_buffer_ = nullptr;
+
+  // Pins for in-flight zero-copy sends, oldest first.
+  ZeroCopyPin* zero_copy_head_ = nullptr;
+  ZeroCopyPin* zero_copy_tail_ = nullptr;
+  intptr_t zero_copy_pending_ = 0;
+  // The sequence number the kernel will assign to the next zero-copy send.
+  uint32_t zero_copy_next_id_ = 0;
+  std::atomic<bool> zero_copy_enabled_ = {false};
+  // One past the highest sequence number reported as completed.
+  std::atomic<uint32_t> zero_copy_completed_ = {0};
 
   friend class ReferenceCounted<Socket>;
   DISALLOW_COPY_AND_ASSIGN(Socket);
@@ -147,9 +221,13 @@ class ServerSocket {
   //
   //   -1: system error (errno set)
   //   -5: invalid bindAddress
+  //
+  // If |reuse_port| is true the socket is created with SO_REUSEPORT so that
+  // several listening sockets can be bound to the same address and port.
   static intptr_t CreateBindListen(const RawAddr& addr,
                                    intptr_t backlog,
-                                   bool v6_only = false);
+                                   bool v6_only = false,
+                                   bool reuse_port = false);
   static intptr_t CreateUnixDomainBindListen(const RawAddr& addr,
                                              intptr_t backlog);
 
@@ -157,6 +235,13 @@ class ServerSocket {
   // start accepting incoming sockets, the fd is invalidated.
   static bool StartAccept(intptr_t fd);
 
+#if defined(HOST_OS_LINUX)
+  // Attaches a classic BPF program to the SO_REUSEPORT group of |fd| which
+  // hands each new connection to the listening socket with index
+  // (CPU handling the connection) % |group_size|.
+  static bool SetReusePortCpuAffinity(intptr_t fd, intptr_t group_size);
+#endif  // defined(HOST_OS_LINUX)
+
  private:
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(ServerSocket);
@@ -188,7 +273,8 @@ class ListeningSocketRegistry {
                                RawAddr addr,
                                intptr_t backlog,
                                bool v6_only,
-                               bool shared);
+                               bool shared,
+                               bool reuse_port);
   // Bind unix domain socket`socket_object` to `path`.
   // Return Dart_True() if succeed.
   // This function should be called from a dart runtime call in order to create
@@ -217,6 +303,9 @@ class ListeningSocketRegistry {
     int port;
     bool v6_only;
     bool shared;
+    // Whether this socket is one of a group of SO_REUSEPORT sockets bound to
+    // the same address and port, one per bind() call.
+    bool reuse_port;
     int ref_count;
     intptr_t fd;
 
@@ -232,12 +321,14 @@ class ListeningSocketRegistry {
              int port,
              bool v6_only,
              bool shared,
+             bool reuse_port,
              Socket* socketfd,
              Namespace* namespc)
         : address(address),
           port(port),
           v6_only(v6_only),
           shared(shared),
+          reuse_port(reuse_port),
           ref_count(0),
           namespc(namespc),
           next(NULL) {
@@ -247,6 +338,17 @@ class ListeningSocketRegistry {
 
   static const intptr_t kInitialSocketsCount = 8;
 
+  intptr_t CountOSSocketsWithAddress(OSSocket* current, const RawAddr& addr) {
+    intptr_t count = 0;
+    while (current != NULL) {
+      if (SocketAddress::AreAddressesEqual(current->address, addr)) {
+        count++;
+      }
+      current = current->next;
+    }
+    return count;
+  }
+
   OSSocket* FindOSSocketWithAddress(OSSocket* current, const RawAddr& addr) {
     while (current != NULL) {
       if (SocketAddress::AreAddressesEqual(current->address, addr)) {
@@ -307,6 +409,10 @@ class ListeningSocketRegistry {
   void RemoveByFd(Socket* fd);
 
   bool CloseOneSafe(OSSocket* os_socket, Socket* socket);
+  // Updates the program selecting the member of the SO_REUSEPORT group bound
+  // to |addr| after a socket joined or left it. |first| is the first socket
+  // listening on the port, if any.
+  void UpdateReusePortGroup(OSSocket* first, const RawAddr& addr);
   void CloseAllSafe();
 
   SimpleHashMap sockets_by_port_;
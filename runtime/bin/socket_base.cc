@@ -222,6 +222,73 @@ intptr_t SocketAddress::GetAddrScope(const RawAddr& addr) {
   }
 }
 
+#if !defined(HOST_OS_LINUX)
+// Platforms without recvmmsg and sendmmsg handle one datagram per call.
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   SocketDatagram* datagrams,
+                                   intptr_t count,
+                                   SocketOpKind sync) {
+  intptr_t received = 0;
+  while (received < count) {
+    SocketDatagram* datagram = &datagrams[received];
+    // RecvFrom returns 0 both for an empty datagram and when nothing is
+    // pending, so only read once a datagram is known to be pending.
+    if (!SocketBase::AvailableDatagram(fd, datagram->buffer, 1)) {
+      break;
+    }
+    intptr_t bytes_read = SocketBase::RecvFrom(
+        fd, datagram->buffer, datagram->length, &datagram->addr, sync);
+    if (bytes_read < 0) {
+      return (received > 0) ? received : -1;
+    }
+    datagram->length = bytes_read;
+    datagram->segment_size = 0;
+    // The buffers are as large as any datagram the socket accepts, see
+    // Socket_GetMaxDatagramSize, and recvfrom does not report truncation.
+    datagram->truncated = false;
+    received++;
+  }
+  return received;
+}
+
+intptr_t SocketBase::SendToBatch(intptr_t fd,
+                                 const SocketDatagram* datagrams,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  intptr_t sent = 0;
+  while (sent < count) {
+    const SocketDatagram& datagram = datagrams[sent];
+    intptr_t bytes_written = SocketBase::SendTo(
+        fd, datagram.buffer, datagram.length, datagram.addr, sync);
+    if (bytes_written < 0) {
+      return (sent > 0) ? sent : -1;
+    }
+    if ((bytes_written == 0) && (datagram.length > 0)) {
+      break;
+    }
+    sent++;
+  }
+  return sent;
+}
+
+// Zero-copy sends are only implemented on Linux.
+bool SocketBase::EnableZeroCopy(intptr_t fd) {
+  return false;
+}
+
+intptr_t SocketBase::WriteZeroCopy(intptr_t fd,
+                                   const void* buffer,
+                                   intptr_t num_bytes,
+                                   SocketOpKind sync) {
+  UNREACHABLE();
+  return -1;
+}
+
+bool SocketBase::ReapZeroCopyCompletions(intptr_t fd, uint32_t* completed) {
+  return false;
+}
+#endif  // !defined(HOST_OS_LINUX)
+
 void FUNCTION_NAME(InternetAddress_Parse)(Dart_NativeArguments args) {
   const char* address =
       DartUtils::GetStringValue(Dart_GetNativeArgument(args, 0));
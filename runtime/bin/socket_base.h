@@ -148,8 +148,40 @@ class AddressList {
   DISALLOW_COPY_AND_ASSIGN(AddressList);
 };
 
+// A platform independent description of one buffer in a gathering write.
+struct SocketIOVector {
+  const void* base;
+  intptr_t length;
+};
+
+// One datagram in a batched receive or send.
+struct SocketDatagram {
+  // The payload. On receive |length| is the capacity of |buffer| and is
+  // updated to the number of bytes received.
+  void* buffer;
+  intptr_t length;
+  // Source address on receive, destination address on send.
+  RawAddr addr;
+  // On receive, the segment size reported by UDP_GRO when several datagrams
+  // were coalesced into |buffer|, otherwise 0. Unused on send.
+  intptr_t segment_size;
+  // On receive, whether the datagram was longer than |buffer| and only its
+  // start was received. Unused on send.
+  bool truncated;
+};
+
 class SocketBase : public AllStatic {
  public:
+  // The maximum number of buffers passed to a single WriteVector call. This is
+  // well below IOV_MAX on all supported platforms.
+  static const intptr_t kMaxWriteVectors = 64;
+  // The maximum number of datagrams handled by a single RecvFromBatch or
+  // SendToBatch call.
+  static const intptr_t kMaxDatagramBatch = 64;
+  // The size of the buffer SendFile copies the file through on platforms
+  // without sendfile.
+  static const intptr_t kSendFileBufferSize = 64 * KB;
+
   enum SocketRequest {
     kLookupRequest = 0,
     kListInterfacesRequest = 1,
@@ -172,6 +204,41 @@ class SocketBase : public AllStatic {
                         const void* buffer,
                         intptr_t num_bytes,
                         SocketOpKind sync);
+  // Write the |count| buffers described by |vectors| in order. Where the
+  // platform supports it this is done with a single gathering system call.
+  // Returns the total number of bytes written, which may be less than the
+  // sum of the buffer lengths.
+  static intptr_t WriteVector(intptr_t fd,
+                              const SocketIOVector* vectors,
+                              intptr_t count,
+                              SocketOpKind sync);
+  // Send up to |length| bytes of |file| starting at |offset| on a stream
+  // socket without copying the data through user space where the platform
+  // allows it. Returns the number of bytes sent, 0 if the socket would block,
+  // or -1 on error. Trying to send from at or beyond the end of the file is
+  // reported as an error. Where there is no sendfile the data is copied
+  // through |buffer|, which holds kSendFileBufferSize bytes; elsewhere it may
+  // be NULL.
+  static intptr_t SendFile(intptr_t fd,
+                           File* file,
+                           int64_t offset,
+                           intptr_t length,
+                           uint8_t* buffer);
+  // Enable MSG_ZEROCOPY sends on the stream socket |fd|. Returns false when
+  // the platform or kernel does not support zero-copy sends.
+  static bool EnableZeroCopy(intptr_t fd);
+  // Like Write, but the kernel transmits directly from |buffer| instead of
+  // copying it. |buffer| must stay valid and unmodified until
+  // ReapZeroCopyCompletions reports the send as completed. Each successful
+  // call is assigned the next sequence number, starting at 0.
+  static intptr_t WriteZeroCopy(intptr_t fd,
+                                const void* buffer,
+                                intptr_t num_bytes,
+                                SocketOpKind sync);
+  // Drain the zero-copy completion notifications queued on |fd|. Returns true
+  // and sets |completed| to one past the highest completed sequence number if
+  // any notification was read.
+  static bool ReapZeroCopyCompletions(intptr_t fd, uint32_t* completed);
   // Send data on a socket. The port to send to is specified in the port
   // component of the passed RawAddr structure. The RawAddr structure is only
   // used for datagram sockets.
@@ -185,6 +252,19 @@ class SocketBase : public AllStatic {
                            intptr_t num_bytes,
                            RawAddr* addr,
                            SocketOpKind sync);
+  // Receive up to |count| datagrams. On Linux this uses a single recvmmsg
+  // call, elsewhere RecvFrom is called until it would block. Returns the
+  // number of datagrams received, 0 if none are available or -1 on error.
+  static intptr_t RecvFromBatch(intptr_t fd,
+                                SocketDatagram* datagrams,
+                                intptr_t count,
+                                SocketOpKind sync);
+  // Send up to |count| datagrams, using sendmmsg on Linux. Returns the number
+  // of datagrams sent or -1 on error.
+  static intptr_t SendToBatch(intptr_t fd,
+                              const SocketDatagram* datagrams,
+                              intptr_t count,
+                              SocketOpKind sync);
   static bool AvailableDatagram(intptr_t fd, void* buffer, intptr_t num_bytes);
   // Returns true if the given error-number is because the system was not able
   // to bind the socket to a specific IP.
@@ -25,6 +25,7 @@
 #include "bin/file.h"
 #include "bin/socket_base_fuchsia.h"
 #include "platform/signal_blocker.h"
+#include "platform/utils.h"
 
 // #define SOCKET_LOG_INFO 1
 // #define SOCKET_LOG_ERROR 1
@@ -167,6 +168,49 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteVector(intptr_t fd,
+                                 const SocketIOVector* vectors,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  // There is no gathering write on IOHandle, so write the buffers one at a
+  // time and stop at the first short write.
+  intptr_t total = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t written =
+        SocketBase::Write(fd, vectors[i].base, vectors[i].length, sync);
+    if (written < 0) {
+      return (total > 0) ? total : written;
+    }
+    total += written;
+    if (written < vectors[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t length,
+                              uint8_t* buffer) {
+  // There is no sendfile, so copy a chunk of the file through |buffer|. Bytes
+  // the socket does not accept are read again by the next call, since the
+  // caller advances |offset| by the number of bytes sent.
+  ASSERT(buffer != NULL);
+  length = Utils::Minimum(length, kSendFileBufferSize);
+  int64_t bytes_read = file->ReadAt(buffer, length, offset);
+  if (bytes_read < 0) {
+    return -1;
+  }
+  if ((bytes_read == 0) && (length > 0)) {
+    // The offset is at or beyond the end of the file.
+    errno = EINVAL;
+    return -1;
+  }
+  return SocketBase::Write(fd, buffer, bytes_read, kAsync);
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -9,12 +9,16 @@
 
 #include <errno.h>        // NOLINT
 #include <ifaddrs.h>      // NOLINT
+#include <linux/errqueue.h>  // NOLINT
 #include <net/if.h>       // NOLINT
 #include <netinet/tcp.h>  // NOLINT
+#include <netinet/udp.h>  // NOLINT
 #include <stdio.h>        // NOLINT
 #include <stdlib.h>       // NOLINT
 #include <string.h>       // NOLINT
+#include <sys/sendfile.h>  // NOLINT
 #include <sys/stat.h>     // NOLINT
+#include <sys/uio.h>      // NOLINT
 #include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
@@ -23,6 +27,17 @@
 #include "bin/thread.h"
 #include "platform/signal_blocker.h"
 
+// Zero-copy send support was added in Linux 4.14; older headers lack these.
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
 namespace dart {
 namespace bin {
 
@@ -98,6 +113,89 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+// Older kernel headers do not define the UDP generic receive offload option.
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+
+intptr_t SocketBase::RecvFromBatch(intptr_t fd,
+                                   SocketDatagram* datagrams,
+                                   intptr_t count,
+                                   SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxDatagramBatch));
+  struct mmsghdr messages[kMaxDatagramBatch];
+  struct iovec iov[kMaxDatagramBatch];
+  // Room for the UDP_GRO segment size control message of each datagram.
+  union {
+    char buffer[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+  } control[kMaxDatagramBatch];
+  memset(messages, 0, sizeof(messages[0]) * count);
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = datagrams[i].buffer;
+    iov[i].iov_len = datagrams[i].length;
+    messages[i].msg_hdr.msg_iov = &iov[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    messages[i].msg_hdr.msg_name = &datagrams[i].addr.addr;
+    messages[i].msg_hdr.msg_namelen = sizeof(datagrams[i].addr.ss);
+    messages[i].msg_hdr.msg_control = control[i].buffer;
+    messages[i].msg_hdr.msg_controllen = sizeof(control[i].buffer);
+  }
+  int received =
+      TEMP_FAILURE_RETRY(recvmmsg(fd, messages, count, 0, NULL));
+  if (received == -1) {
+    if ((sync == kAsync) && (errno == EWOULDBLOCK)) {
+      // Nothing to read; report no datagrams received.
+      return 0;
+    }
+    return -1;
+  }
+  for (intptr_t i = 0; i < received; i++) {
+    datagrams[i].length = messages[i].msg_len;
+    datagrams[i].segment_size = 0;
+    struct msghdr* header = &messages[i].msg_hdr;
+    datagrams[i].truncated = (header->msg_flags & MSG_TRUNC) != 0;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(header); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(header, cmsg)) {
+      if ((cmsg->cmsg_level == IPPROTO_UDP) && (cmsg->cmsg_type == UDP_GRO)) {
+        int segment_size;
+        memmove(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+        datagrams[i].segment_size = segment_size;
+      }
+    }
+  }
+  return received;
+}
+
+intptr_t SocketBase::SendToBatch(intptr_t fd,
+                                 const SocketDatagram* datagrams,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxDatagramBatch));
+  struct mmsghdr messages[kMaxDatagramBatch];
+  struct iovec iov[kMaxDatagramBatch];
+  memset(messages, 0, sizeof(messages[0]) * count);
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = datagrams[i].buffer;
+    iov[i].iov_len = datagrams[i].length;
+    messages[i].msg_hdr.msg_iov = &iov[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    messages[i].msg_hdr.msg_name =
+        const_cast<struct sockaddr*>(&datagrams[i].addr.addr);
+    messages[i].msg_hdr.msg_namelen =
+        SocketAddress::GetAddrLength(datagrams[i].addr);
+  }
+  int sent = TEMP_FAILURE_RETRY(sendmmsg(fd, messages, count, 0));
+  if ((sync == kAsync) && (sent == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of datagrams sent.
+    sent = 0;
+  }
+  return sent;
+}
+
 bool SocketBase::AvailableDatagram(intptr_t fd,
                                    void* buffer,
                                    intptr_t num_bytes) {
@@ -122,6 +220,109 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteVector(intptr_t fd,
+                                 const SocketIOVector* vectors,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxWriteVectors));
+  struct iovec iov[kMaxWriteVectors];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(vectors[i].base);
+    iov[i].iov_len = vectors[i].length;
+  }
+  ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, count));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t length,
+                              uint8_t* buffer) {
+  ASSERT(fd >= 0);
+  off64_t file_offset = offset;
+  ssize_t sent = TEMP_FAILURE_RETRY(
+      sendfile64(fd, file->GetFD(), &file_offset, length));
+  if ((sent == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    return 0;
+  }
+  if ((sent == 0) && (length > 0)) {
+    // The offset is at or beyond the end of the file.
+    errno = EINVAL;
+    return -1;
+  }
+  return sent;
+}
+
+bool SocketBase::EnableZeroCopy(intptr_t fd) {
+  ASSERT(fd >= 0);
+  int on = 1;
+  return NO_RETRY_EXPECTED(setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY,
+                                      reinterpret_cast<char*>(&on),
+                                      sizeof(on))) == 0;
+}
+
+intptr_t SocketBase::WriteZeroCopy(intptr_t fd,
+                                   const void* buffer,
+                                   intptr_t num_bytes,
+                                   SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ssize_t written_bytes =
+      TEMP_FAILURE_RETRY(send(fd, buffer, num_bytes, MSG_ZEROCOPY));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) &&
+      ((errno == EWOULDBLOCK) || (errno == ENOBUFS))) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written. ENOBUFS means the socket ran out of
+    // option memory for pinned pages and clears as completions are reaped.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+bool SocketBase::ReapZeroCopyCompletions(intptr_t fd, uint32_t* completed) {
+  ASSERT(fd >= 0);
+  bool found = false;
+  while (true) {
+    union {
+      struct cmsghdr align;
+      char buffer[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+    if (TEMP_FAILURE_RETRY(recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT)) <
+        0) {
+      break;
+    }
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      const struct sock_extended_err* err =
+          reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cmsg));
+      if ((err->ee_errno != 0) || (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)) {
+        continue;
+      }
+      // The notification covers the inclusive range [ee_info, ee_data].
+      uint32_t end = err->ee_data + 1;
+      if (!found || (static_cast<int32_t>(end - *completed) > 0)) {
+        *completed = end;
+      }
+      found = true;
+    }
+  }
+  return found;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -15,6 +15,7 @@
 #include <stdlib.h>       // NOLINT
 #include <string.h>       // NOLINT
 #include <sys/stat.h>     // NOLINT
+#include <sys/uio.h>      // NOLINT
 #include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
@@ -121,6 +122,51 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteVector(intptr_t fd,
+                                 const SocketIOVector* vectors,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxWriteVectors));
+  struct iovec iov[kMaxWriteVectors];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(vectors[i].base);
+    iov[i].iov_len = vectors[i].length;
+  }
+  ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, count));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t length,
+                              uint8_t* buffer) {
+  ASSERT(fd >= 0);
+  // On input |len| is the number of bytes to send, on output the number of
+  // bytes sent, even when sendfile fails with EAGAIN or EINTR.
+  off_t len = length;
+  int result = sendfile(file->GetFD(), fd, offset, &len, NULL, 0);
+  if ((result == -1) && ((errno == EWOULDBLOCK) || (errno == EINTR))) {
+    return len;
+  }
+  if (result == -1) {
+    return -1;
+  }
+  if ((len == 0) && (length > 0)) {
+    // The offset is at or beyond the end of the file.
+    errno = EINVAL;
+    return -1;
+  }
+  return len;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
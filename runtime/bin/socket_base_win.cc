@@ -16,6 +16,7 @@
 #include "bin/utils.h"
 #include "bin/utils_win.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 namespace bin {
@@ -106,6 +107,50 @@ intptr_t SocketBase::Write(intptr_t fd,
   return handle->Write(buffer, num_bytes);
 }
 
+intptr_t SocketBase::WriteVector(intptr_t fd,
+                                 const SocketIOVector* vectors,
+                                 intptr_t count,
+                                 SocketOpKind sync) {
+  // A Handle has at most one pending overlapped write, so in practice this
+  // only issues a write for the first buffer. Later buffers report 0 bytes
+  // written and are retried on the next write event.
+  intptr_t total = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t written =
+        SocketBase::Write(fd, vectors[i].base, vectors[i].length, sync);
+    if (written < 0) {
+      return (total > 0) ? total : written;
+    }
+    total += written;
+    if (written < vectors[i].length) {
+      break;
+    }
+  }
+  return total;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              File* file,
+                              int64_t offset,
+                              intptr_t length,
+                              uint8_t* buffer) {
+  // There is no sendfile, so copy a chunk of the file through |buffer|. Bytes
+  // the socket does not accept are read again by the next call, since the
+  // caller advances |offset| by the number of bytes sent.
+  ASSERT(buffer != NULL);
+  length = Utils::Minimum(length, kSendFileBufferSize);
+  int64_t bytes_read = file->ReadAt(buffer, length, offset);
+  if (bytes_read < 0) {
+    return -1;
+  }
+  if ((bytes_read == 0) && (length > 0)) {
+    // The offset is at or beyond the end of the file.
+    SetLastError(ERROR_HANDLE_EOF);
+    return -1;
+  }
+  return SocketBase::Write(fd, buffer, bytes_read, kAsync);
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
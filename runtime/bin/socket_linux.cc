@@ -7,7 +7,8 @@
 
 #include "bin/socket.h"
 
-#include <errno.h>  // NOLINT
+#include <errno.h>         // NOLINT
+#include <linux/filter.h>  // NOLINT
 
 #include "bin/fdutils.h"
 #include "platform/signal_blocker.h"
@@ -176,7 +177,8 @@ intptr_t Socket::CreateBindDatagram(const RawAddr& addr,
 
 intptr_t ServerSocket::CreateBindListen(const RawAddr& addr,
                                         intptr_t backlog,
-                                        bool v6_only) {
+                                        bool v6_only,
+                                        bool reuse_port) {
   intptr_t fd;
 
   fd = NO_RETRY_EXPECTED(
@@ -189,6 +191,15 @@ intptr_t ServerSocket::CreateBindListen(const RawAddr& addr,
   VOID_NO_RETRY_EXPECTED(
       setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)));
 
+  if (reuse_port) {
+    optval = 1;
+    if (NO_RETRY_EXPECTED(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval,
+                                     sizeof(optval))) != 0) {
+      FDUtils::SaveErrorAndClose(fd);
+      return -1;
+    }
+  }
+
   if (addr.ss.ss_family == AF_INET6) {
     optval = v6_only ? 1 : 0;
     VOID_NO_RETRY_EXPECTED(
@@ -206,7 +217,7 @@ intptr_t ServerSocket::CreateBindListen(const RawAddr& addr,
       (SocketBase::GetPort(fd) == 65535)) {
     // Don't close the socket until we have created a new socket, ensuring
     // that we do not get the bad port number again.
-    intptr_t new_fd = CreateBindListen(addr, backlog, v6_only);
+    intptr_t new_fd = CreateBindListen(addr, backlog, v6_only, reuse_port);
     FDUtils::SaveErrorAndClose(fd);
     return new_fd;
   }
@@ -234,6 +245,37 @@ intptr_t ServerSocket::CreateUnixDomainBindListen(const RawAddr& addr,
   return fd;
 }
 
+// Older kernel headers do not define the option for attaching a classic BPF
+// program to a SO_REUSEPORT group.
+#if !defined(SO_ATTACH_REUSEPORT_CBPF)
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+bool ServerSocket::SetReusePortCpuAffinity(intptr_t fd, intptr_t group_size) {
+  ASSERT(group_size > 0);
+  struct sock_filter code[] = {
+      // A = id of the CPU handling the incoming connection.
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0,
+       static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+      // A = A % group_size.
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(group_size)},
+      // Return A as the index of the socket in the group.
+      {BPF_RET | BPF_A, 0, 0, 0},
+  };
+  struct sock_fprog program;
+  program.len = sizeof(code) / sizeof(code[0]);
+  program.filter = code;
+  if (NO_RETRY_EXPECTED(setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+                                   &program, sizeof(program))) != 0) {
+    const int kBufferSize = 1024;
+    char error_buf[kBufferSize];
+    Syslog::PrintErr("Dart Socket ERROR: %s:%d: %s.", __FILE__, __LINE__,
+                     Utils::StrError(errno, error_buf, kBufferSize));
+    return false;
+  }
+  return true;
+}
+
 bool ServerSocket::StartAccept(intptr_t fd) {
   USE(fd);
   return true;
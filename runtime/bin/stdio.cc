@@ -6,6 +6,8 @@
 
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
+#include "bin/file.h"
+#include "bin/lockers.h"
 #include "bin/utils.h"
 
 #include "include/dart_api.h"
@@ -16,6 +18,232 @@
 namespace dart {
 namespace bin {
 
+struct StdioBuffer::Block {
+  intptr_t fd;
+  intptr_t length;
+  Block* next;
+  uint8_t data[kBlockSize];
+};
+
+bool StdioBuffer::enabled_ = false;
+Monitor* StdioBuffer::monitor_ = NULL;
+File* StdioBuffer::files_[2] = {NULL, NULL};
+StdioBuffer::Block* StdioBuffer::head_ = NULL;
+StdioBuffer::Block* StdioBuffer::tail_ = NULL;
+StdioBuffer::Block* StdioBuffer::free_ = NULL;
+intptr_t StdioBuffer::buffered_ = 0;
+bool StdioBuffer::writing_ = false;
+StdioBuffer::Block* StdioBuffer::writing_block_ = NULL;
+bool StdioBuffer::running_ = false;
+bool StdioBuffer::shutting_down_ = false;
+int64_t StdioBuffer::statistics_[StdioBuffer::kNumStatistics];
+
+void StdioBuffer::Initialize() {
+  if (!enabled_) {
+    return;
+  }
+  ASSERT(monitor_ == NULL);
+  monitor_ = new Monitor();
+  files_[0] = File::OpenStdio(1);
+  files_[1] = File::OpenStdio(2);
+  for (intptr_t i = 0; i < kNumStatistics; i++) {
+    statistics_[i] = 0;
+  }
+  int result = Thread::Start("dart:io Stdio", &ThreadMain, 0);
+  if (result != 0) {
+    FATAL1("Failed to start stdio thread %d", result);
+  }
+  running_ = true;
+}
+
+void StdioBuffer::Cleanup() {
+  if (monitor_ == NULL) {
+    return;
+  }
+  {
+    MonitorLocker ml(monitor_);
+    shutting_down_ = true;
+    ml.NotifyAll();
+    // The thread writes out what is queued before it exits.
+    while (running_) {
+      ml.Wait();
+    }
+  }
+  while (free_ != NULL) {
+    Block* block = free_;
+    free_ = block->next;
+    delete block;
+  }
+  files_[0]->Release();
+  files_[1]->Release();
+  files_[0] = files_[1] = NULL;
+  delete monitor_;
+  monitor_ = NULL;
+  shutting_down_ = false;
+}
+
+void StdioBuffer::WriteDirectly(intptr_t fd,
+                                const uint8_t* data,
+                                intptr_t length) {
+  File* file = File::OpenStdio(fd);
+  file->WriteFully(data, length);
+  file->Release();
+}
+
+void StdioBuffer::Write(intptr_t fd, const uint8_t* data, intptr_t length) {
+  ASSERT((fd == 1) || (fd == 2));
+  if (monitor_ == NULL) {
+    WriteDirectly(fd, data, length);
+    return;
+  }
+  MonitorLocker ml(monitor_);
+  if (!running_) {
+    WriteDirectly(fd, data, length);
+    return;
+  }
+  Queue(&ml, fd, data, length, true);
+}
+
+intptr_t StdioBuffer::TryWrite(intptr_t fd,
+                               const uint8_t* data,
+                               intptr_t length) {
+  ASSERT((fd == 1) || (fd == 2));
+  if (monitor_ == NULL) {
+    return 0;
+  }
+  MonitorLocker ml(monitor_);
+  if (!running_) {
+    return 0;
+  }
+  return Queue(&ml, fd, data, length, false);
+}
+
+intptr_t StdioBuffer::Queue(MonitorLocker* ml,
+                            intptr_t fd,
+                            const uint8_t* data,
+                            intptr_t length,
+                            bool wait) {
+  intptr_t queued = 0;
+  while (queued < length) {
+    if (buffered_ >= kMaxBufferedBytes) {
+      if (!wait) {
+        break;
+      }
+      // The reader is not keeping up. Wait for the thread to make room.
+      ScopedBlockingCall blocker;
+      int64_t start = TimerUtils::GetCurrentMonotonicMicros();
+      while (buffered_ >= kMaxBufferedBytes) {
+        ml->Wait();
+      }
+      statistics_[kBlockedMicros] +=
+          TimerUtils::GetCurrentMonotonicMicros() - start;
+    }
+    Block* block = tail_;
+    if ((block == NULL) || (block->fd != fd) ||
+        (block->length == kBlockSize)) {
+      block = free_;
+      if (block != NULL) {
+        free_ = block->next;
+      } else {
+        block = new Block();
+      }
+      block->fd = fd;
+      block->length = 0;
+      block->next = NULL;
+      if (tail_ == NULL) {
+        head_ = block;
+        ml->NotifyAll();
+      } else {
+        tail_->next = block;
+      }
+      tail_ = block;
+    }
+    intptr_t count =
+        Utils::Minimum(length - queued, kBlockSize - block->length);
+    count = Utils::Minimum(count, kMaxBufferedBytes - buffered_);
+    memmove(block->data + block->length, data + queued, count);
+    block->length += count;
+    buffered_ += count;
+    queued += count;
+  }
+  return queued;
+}
+
+void StdioBuffer::WriteBlock(Block* block) {
+  File* file = files_[block->fd - 1];
+  bool success = file->WriteFully(block->data, block->length);
+  MonitorLocker ml(monitor_);
+  statistics_[success ? kBytesWritten : kBytesDropped] += block->length;
+  statistics_[kWrites]++;
+}
+
+void StdioBuffer::ThreadMain(uword parameters) {
+  MonitorLocker ml(monitor_);
+  while (true) {
+    while ((head_ == NULL) && !shutting_down_) {
+      ml.Wait();
+    }
+    Block* block = head_;
+    if (block == NULL) {
+      break;
+    }
+    // Marked as being written before it is unlinked, so that FlushOnCrash
+    // cannot write it too.
+    writing_block_ = block;
+    writing_ = true;
+    head_ = block->next;
+    if (head_ == NULL) {
+      tail_ = NULL;
+    }
+    monitor_->Exit();
+    WriteBlock(block);
+    monitor_->Enter();
+    writing_ = false;
+    writing_block_ = NULL;
+    buffered_ -= block->length;
+    block->next = free_;
+    free_ = block;
+    ml.NotifyAll();
+  }
+  running_ = false;
+  ml.NotifyAll();
+}
+
+void StdioBuffer::Flush() {
+  if (monitor_ == NULL) {
+    return;
+  }
+  MonitorLocker ml(monitor_);
+  while ((head_ != NULL) || writing_) {
+    ml.Wait();
+  }
+}
+
+void StdioBuffer::FlushOnCrash() {
+  if (monitor_ == NULL) {
+    return;
+  }
+  for (Block* block = head_; block != NULL; block = block->next) {
+    if (writing_ && (block == writing_block_)) {
+      continue;
+    }
+    files_[block->fd - 1]->WriteFully(block->data, block->length);
+  }
+}
+
+void StdioBuffer::GetStatistics(int64_t statistics[kNumStatistics]) {
+  if (monitor_ == NULL) {
+    for (intptr_t i = 0; i < kNumStatistics; i++) {
+      statistics[i] = 0;
+    }
+    return;
+  }
+  MonitorLocker ml(monitor_);
+  for (intptr_t i = 0; i < kNumStatistics; i++) {
+    statistics[i] = statistics_[i];
+  }
+}
+
 static bool GetIntptrArgument(Dart_NativeArguments args,
                               intptr_t idx,
                               intptr_t* value) {
@@ -160,5 +388,70 @@ void FUNCTION_NAME(Stdout_AnsiSupported)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Stdout_BufferedEnabled)(Dart_NativeArguments args) {
+  Dart_SetBooleanReturnValue(args, StdioBuffer::enabled());
+}
+
+void FUNCTION_NAME(Stdout_BufferedWrite)(Dart_NativeArguments args) {
+  intptr_t fd = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 0));
+  if ((fd != 1) && (fd != 2)) {
+    Dart_ThrowException(DartUtils::NewDartArgumentError("Invalid fd"));
+  }
+  Dart_Handle data = Dart_GetNativeArgument(args, 1);
+  Dart_TypedData_Type type;
+  uint8_t* buffer = NULL;
+  intptr_t length = 0;
+  Dart_Handle result = Dart_TypedDataAcquireData(
+      data, &type, reinterpret_cast<void**>(&buffer), &length);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT(type == Dart_TypedData_kUint8);
+  // The data is copied straight into the buffer while there is room for it.
+  // Waiting for the buffer to drain must not happen while the data is
+  // acquired, so only what does not fit is copied out first.
+  intptr_t queued = StdioBuffer::TryWrite(fd, buffer, length);
+  uint8_t* rest = NULL;
+  if (queued < length) {
+    rest = reinterpret_cast<uint8_t*>(malloc(length - queued));
+    if (rest == NULL) {
+      Dart_TypedDataReleaseData(data);
+      OUT_OF_MEMORY();
+    }
+    memmove(rest, buffer + queued, length - queued);
+  }
+  result = Dart_TypedDataReleaseData(data);
+  if (Dart_IsError(result)) {
+    free(rest);
+    Dart_PropagateError(result);
+  }
+  if (rest != NULL) {
+    StdioBuffer::Write(fd, rest, length - queued);
+    free(rest);
+  }
+}
+
+void FUNCTION_NAME(Stdout_BufferedFlush)(Dart_NativeArguments args) {
+  ScopedBlockingCall blocker;
+  StdioBuffer::Flush();
+}
+
+void FUNCTION_NAME(Stdout_GetBufferedStatistics)(Dart_NativeArguments args) {
+  int64_t statistics[StdioBuffer::kNumStatistics];
+  StdioBuffer::GetStatistics(statistics);
+  Dart_Handle result = Dart_NewList(StdioBuffer::kNumStatistics);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  for (intptr_t i = 0; i < StdioBuffer::kNumStatistics; i++) {
+    Dart_Handle error =
+        Dart_ListSetAt(result, i, Dart_NewInteger(statistics[i]));
+    if (Dart_IsError(error)) {
+      Dart_PropagateError(error);
+    }
+  }
+  Dart_SetReturnValue(args, result);
+}
+
 }  // namespace bin
 }  // namespace dart
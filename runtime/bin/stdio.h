@@ -6,6 +6,7 @@
 #define RUNTIME_BIN_STDIO_H_
 
 #include "bin/builtin.h"
+#include "bin/thread.h"
 #include "bin/utils.h"
 
 #include "platform/globals.h"
@@ -13,6 +14,9 @@
 namespace dart {
 namespace bin {
 
+class File;
+class MonitorLocker;
+
 class Stdin {
  public:
   static bool ReadByte(intptr_t fd, int* byte);
@@ -40,6 +44,91 @@ class Stdout {
   DISALLOW_IMPLICIT_CONSTRUCTORS(Stdout);
 };
 
+// Buffers the writes to stdout and stderr of print() and of the stdout and
+// stderr sinks of dart:io when the VM runs with --buffered-stdio.
+//
+// Writes are copied into blocks, which a thread writes out, so that a slow
+// reader of stdout or stderr does not block isolates, and consecutive writes
+// are written with one system call. At most kMaxBufferedBytes are buffered,
+// after which writers wait for the thread. Output that fails to be written,
+// for instance because the reader closed a pipe, is dropped.
+class StdioBuffer {
+ public:
+  static const intptr_t kBlockSize = 64 * KB;
+  static const intptr_t kMaxBufferedBytes = 1 * MB;
+
+  // Keep in sync with _BufferedStdConsumer.statistics in stdio_patch.dart.
+  enum Statistic {
+    kBytesWritten = 0,
+    kBytesDropped,
+    kWrites,
+    kBlockedMicros,
+    kNumStatistics,
+  };
+
+  static void Initialize();
+  static void Cleanup();
+
+  static bool enabled() { return enabled_; }
+  static void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  // Queues |length| bytes for stdout or stderr. Writes them directly if the
+  // buffer is not running.
+  static void Write(intptr_t fd, const uint8_t* data, intptr_t length);
+
+  // Queues as much of |data| as fits without waiting for the thread, and
+  // returns how many bytes that was. Does nothing and returns 0 if the
+  // buffer is not running.
+  static intptr_t TryWrite(intptr_t fd, const uint8_t* data, intptr_t length);
+
+  // Waits until everything queued has been written.
+  static void Flush();
+
+  // Writes what is queued from a crash handler, without locking. The block
+  // the thread is writing at the time is skipped, and may be cut short.
+  static void FlushOnCrash();
+
+  // Fills |statistics| with the counters, indexed by Statistic.
+  static void GetStatistics(int64_t statistics[kNumStatistics]);
+
+ private:
+  struct Block;
+
+  static void ThreadMain(uword parameters);
+  static void WriteBlock(Block* block);
+  static void WriteDirectly(intptr_t fd, const uint8_t* data, intptr_t length);
+  // Queues |data| with the monitor held. Returns the number of bytes queued,
+  // which is less than |length| only if |wait| is false and the buffer is
+  // full.
+  static intptr_t Queue(MonitorLocker* ml,
+                        intptr_t fd,
+                        const uint8_t* data,
+                        intptr_t length,
+                        bool wait);
+
+  static bool enabled_;
+  static Monitor* monitor_;
+  // stdout and stderr, by fd - 1.
+  static File* files_[2];
+  // The queued blocks, oldest first. Writers append to the last one.
+  static Block* head_;
+  static Block* tail_;
+  // Blocks written out, kept for reuse.
+  static Block* free_;
+  // The bytes queued or being written.
+  static intptr_t buffered_;
+  // Whether the thread is writing out |writing_block_|, which is no longer
+  // queued.
+  static bool writing_;
+  static Block* writing_block_;
+  static bool running_;
+  static bool shutting_down_;
+  static int64_t statistics_[kNumStatistics];
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(StdioBuffer);
+};
+
 }  // namespace bin
 }  // namespace dart
 
@@ -0,0 +1,305 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/timer_wheel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bin/dartutils.h"
+#include "include/dart_api.h"
+#include "platform/assert.h"
+#include "platform/utils.h"
+
+namespace dart {
+namespace bin {
+
+static const int kTimerWheelNativeField = 0;
+static const intptr_t kInitialCapacity = 64;
+
+bool TimerWheel::enabled_ = false;
+
+template <typename T>
+static T* GrowArray(T* array, intptr_t new_capacity) {
+  T* result = reinterpret_cast<T*>(realloc(array, new_capacity * sizeof(T)));
+  if (result == NULL) {
+    OUT_OF_MEMORY();
+  }
+  return result;
+}
+
+TimerWheel::TimerWheel(int64_t now)
+    : current_tick_(now / kSlotMillis),
+      count_(0),
+      earliest_tick_(kUnknownTick),
+      ticks_(NULL),
+      next_(NULL),
+      prev_(NULL),
+      capacity_(0),
+      used_(0),
+      free_(kNoHandle),
+      expired_(NULL),
+      expired_capacity_(0) {
+  for (intptr_t i = 0; i < kNumSlots; i++) {
+    slots_[i] = kNoHandle;
+  }
+  for (intptr_t i = 0; i < kNumWords; i++) {
+    occupied_[i] = 0;
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  free(ticks_);
+  free(next_);
+  free(prev_);
+  free(expired_);
+}
+
+void TimerWheel::Grow() {
+  intptr_t new_capacity =
+      (capacity_ == 0) ? kInitialCapacity : (capacity_ * 2);
+  if (new_capacity > kMaxInt32) {
+    OUT_OF_MEMORY();
+  }
+  ticks_ = GrowArray(ticks_, new_capacity);
+  next_ = GrowArray(next_, new_capacity);
+  prev_ = GrowArray(prev_, new_capacity);
+  capacity_ = new_capacity;
+}
+
+intptr_t TimerWheel::Add(int64_t wakeup_time) {
+  int32_t handle;
+  if (free_ != kNoHandle) {
+    handle = free_;
+    free_ = next_[handle];
+  } else {
+    if (used_ == capacity_) {
+      Grow();
+    }
+    handle = static_cast<int32_t>(used_++);
+  }
+  // A timer fires at the end of the tick it is due in, and never in the tick
+  // the wheel is currently at, which has already been processed.
+  int64_t tick = (wakeup_time + kSlotMillis - 1) / kSlotMillis;
+  if (tick <= current_tick_) {
+    tick = current_tick_ + 1;
+  }
+  const intptr_t slot = tick & kSlotMask;
+  int32_t* head = &slots_[slot];
+  ticks_[handle] = tick;
+  prev_[handle] = kNoHandle;
+  next_[handle] = *head;
+  if (*head != kNoHandle) {
+    prev_[*head] = handle;
+  }
+  *head = handle;
+  occupied_[slot / kBitsPerWord] |= static_cast<uint64_t>(1)
+                                    << (slot % kBitsPerWord);
+  if (earliest_tick_ != kUnknownTick) {
+    // A timer more than a turn ahead is found at its slot's next visit.
+    int64_t visit =
+        current_tick_ + 1 + ((slot - current_tick_ - 1) & kSlotMask);
+    if (visit < earliest_tick_) {
+      earliest_tick_ = visit;
+    }
+  }
+  count_++;
+  return handle;
+}
+
+void TimerWheel::Unlink(int32_t handle) {
+  if (prev_[handle] != kNoHandle) {
+    next_[prev_[handle]] = next_[handle];
+  } else {
+    const intptr_t slot = ticks_[handle] & kSlotMask;
+    slots_[slot] = next_[handle];
+    if (slots_[slot] == kNoHandle) {
+      occupied_[slot / kBitsPerWord] &=
+          ~(static_cast<uint64_t>(1) << (slot % kBitsPerWord));
+      if ((earliest_tick_ & kSlotMask) == slot) {
+        earliest_tick_ = kUnknownTick;
+      }
+    }
+  }
+  if (next_[handle] != kNoHandle) {
+    prev_[next_[handle]] = prev_[handle];
+  }
+  ticks_[handle] = -1;
+  next_[handle] = free_;
+  free_ = handle;
+  count_--;
+}
+
+bool TimerWheel::Remove(intptr_t handle) {
+  if ((handle < 0) || (handle >= used_) || (ticks_[handle] < 0)) {
+    return false;
+  }
+  Unlink(static_cast<int32_t>(handle));
+  return true;
+}
+
+intptr_t TimerWheel::Advance(int64_t now) {
+  int64_t target = now / kSlotMillis;
+  if (target <= current_tick_) {
+    return 0;
+  }
+  // After a full turn every slot has been visited, so a longer pause only
+  // needs to look at each slot once.
+  int64_t ticks = target - current_tick_;
+  intptr_t slots = (ticks < kNumSlots) ? static_cast<intptr_t>(ticks)
+                                       : kNumSlots;
+  intptr_t expired = 0;
+  for (intptr_t i = 1; i <= slots; i++) {
+    int32_t handle = slots_[(current_tick_ + i) & kSlotMask];
+    while (handle != kNoHandle) {
+      int32_t next = next_[handle];
+      if (ticks_[handle] <= target) {
+        if (expired == expired_capacity_) {
+          expired_capacity_ =
+              (expired_capacity_ == 0) ? kInitialCapacity
+                                       : (expired_capacity_ * 2);
+          expired_ = GrowArray(expired_, expired_capacity_);
+        }
+        expired_[expired++] = handle;
+        Unlink(handle);
+      }
+      handle = next;
+    }
+  }
+  current_tick_ = target;
+  if (earliest_tick_ <= target) {
+    earliest_tick_ = kUnknownTick;
+  }
+  return expired;
+}
+
+int64_t TimerWheel::FindEarliestTick() const {
+  // Scans the occupancy bits from the slot after current_tick_, wrapping
+  // around to the bits before it in the same word last.
+  const intptr_t start = (current_tick_ + 1) & kSlotMask;
+  const intptr_t start_word = start / kBitsPerWord;
+  const uint64_t start_mask = ~static_cast<uint64_t>(0)
+                              << (start % kBitsPerWord);
+  for (intptr_t i = 0; i <= kNumWords; i++) {
+    const intptr_t index = (start_word + i) % kNumWords;
+    uint64_t word = occupied_[index];
+    if (i == 0) {
+      word &= start_mask;
+    } else if (i == kNumWords) {
+      word &= ~start_mask;
+    }
+    if (word != 0) {
+      const intptr_t slot =
+          index * kBitsPerWord + Utils::CountTrailingZeros64(word);
+      return current_tick_ + 1 + ((slot - start) & kSlotMask);
+    }
+  }
+  UNREACHABLE();
+  return kUnknownTick;
+}
+
+int64_t TimerWheel::NextExpiry() {
+  if (count_ == 0) {
+    return -1;
+  }
+  // The timers in the slot i ticks ahead are due at tick current_tick_ + i at
+  // the earliest, so the first non-empty slot bounds the earliest of them.
+  if (earliest_tick_ == kUnknownTick) {
+    earliest_tick_ = FindEarliestTick();
+  }
+  return earliest_tick_ * kSlotMillis;
+}
+
+intptr_t TimerWheel::Size() const {
+  return sizeof(*this) +
+         capacity_ * (sizeof(*ticks_) + sizeof(*next_) + sizeof(*prev_)) +
+         expired_capacity_ * sizeof(*expired_);
+}
+
+static void DeleteTimerWheel(void* isolate_data,
+                             Dart_WeakPersistentHandle handle,
+                             void* wheel_pointer) {
+  delete reinterpret_cast<TimerWheel*>(wheel_pointer);
+}
+
+static TimerWheel* GetTimerWheel(Dart_NativeArguments args) {
+  TimerWheel* wheel;
+  Dart_Handle result = Dart_GetNativeInstanceField(
+      Dart_GetNativeArgument(args, 0), kTimerWheelNativeField,
+      reinterpret_cast<intptr_t*>(&wheel));
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  if (wheel == NULL) {
+    Dart_PropagateError(Dart_NewApiError("Timer wheel not initialized"));
+  }
+  return wheel;
+}
+
+void FUNCTION_NAME(TimerWheel_Enabled)(Dart_NativeArguments args) {
+  Dart_SetBooleanReturnValue(args, TimerWheel::enabled());
+}
+
+void FUNCTION_NAME(TimerWheel_Init)(Dart_NativeArguments args) {
+  Dart_Handle wheel_obj = Dart_GetNativeArgument(args, 0);
+  int64_t now = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 1), 0, kMaxInt64);
+  TimerWheel* wheel = new TimerWheel(now);
+  Dart_Handle result = Dart_SetNativeInstanceField(
+      wheel_obj, kTimerWheelNativeField, reinterpret_cast<intptr_t>(wheel));
+  if (Dart_IsError(result)) {
+    delete wheel;
+    Dart_PropagateError(result);
+  }
+  Dart_NewWeakPersistentHandle(wheel_obj, reinterpret_cast<void*>(wheel),
+                               wheel->Size(), DeleteTimerWheel);
+}
+
+void FUNCTION_NAME(TimerWheel_Add)(Dart_NativeArguments args) {
+  TimerWheel* wheel = GetTimerWheel(args);
+  int64_t wakeup_time =
+      DartUtils::GetInt64ValueCheckRange(Dart_GetNativeArgument(args, 1), 0,
+                                         kMaxInt64 - TimerWheel::kSlotMillis);
+  Dart_SetIntegerReturnValue(args, wheel->Add(wakeup_time));
+}
+
+void FUNCTION_NAME(TimerWheel_Remove)(Dart_NativeArguments args) {
+  TimerWheel* wheel = GetTimerWheel(args);
+  intptr_t handle = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 1));
+  if (!wheel->Remove(handle)) {
+    Dart_ThrowException(
+        DartUtils::NewDartArgumentError("Invalid timer wheel handle"));
+  }
+}
+
+void FUNCTION_NAME(TimerWheel_Advance)(Dart_NativeArguments args) {
+  TimerWheel* wheel = GetTimerWheel(args);
+  int64_t now = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 1), 0, kMaxInt64);
+  intptr_t count = wheel->Advance(now);
+  Dart_Handle result = Dart_NewTypedData(Dart_TypedData_kInt32, count);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  if (count > 0) {
+    Dart_TypedData_Type type;
+    void* data;
+    intptr_t length;
+    Dart_Handle error = Dart_TypedDataAcquireData(result, &type, &data, &length);
+    if (Dart_IsError(error)) {
+      Dart_PropagateError(error);
+    }
+    memmove(data, wheel->expired(), count * sizeof(int32_t));
+    Dart_TypedDataReleaseData(result);
+  }
+  Dart_SetReturnValue(args, result);
+}
+
+void FUNCTION_NAME(TimerWheel_NextExpiry)(Dart_NativeArguments args) {
+  TimerWheel* wheel = GetTimerWheel(args);
+  Dart_SetIntegerReturnValue(args, wheel->NextExpiry());
+}
+
+}  // namespace bin
+}  // namespace dart
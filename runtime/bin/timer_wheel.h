@@ -0,0 +1,101 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_TIMER_WHEEL_H_
+#define RUNTIME_BIN_TIMER_WHEEL_H_
+
+#include "bin/builtin.h"
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+// A hashed timer wheel holding the long running timers of one isolate when
+// the VM runs with --timer-wheel.
+//
+// Time is divided into ticks of kSlotMillis, and a timer due at tick T is
+// kept in slot T % kNumSlots. Adding and removing a timer take constant time
+// regardless of the number of timers, at the cost of timers firing at the
+// end of the tick they are due in rather than at their exact wakeup time.
+// Each timer is identified by a handle, a small integer that is reused once
+// the timer is removed or has expired.
+//
+// A wheel is only used by the isolate that created it, so it is not
+// synchronized.
+class TimerWheel {
+ public:
+  static const int64_t kSlotMillis = 10;
+  static const intptr_t kNumSlots = 4096;
+
+  explicit TimerWheel(int64_t now);
+  ~TimerWheel();
+
+  // Adds a timer due at |wakeup_time| and returns its handle.
+  intptr_t Add(int64_t wakeup_time);
+
+  // Removes the timer with |handle|. Returns false if there is no such timer.
+  bool Remove(intptr_t handle);
+
+  // Removes the timers due at |now|, and returns the number of them. Their
+  // handles are left in expired().
+  intptr_t Advance(int64_t now);
+  const int32_t* expired() const { return expired_; }
+
+  // Returns a time at or before the earliest wakeup time of the timers in the
+  // wheel, rounded up to the end of its tick, or -1 if the wheel is empty.
+  int64_t NextExpiry();
+
+  // The approximate number of bytes of native memory used by the wheel.
+  intptr_t Size() const;
+
+  static bool enabled() { return enabled_; }
+  static void set_enabled(bool enabled) { enabled_ = enabled; }
+
+ private:
+  static const intptr_t kSlotMask = kNumSlots - 1;
+  static const intptr_t kBitsPerWord = 64;
+  static const intptr_t kNumWords = kNumSlots / kBitsPerWord;
+  static const int32_t kNoHandle = -1;
+  static const int64_t kUnknownTick = -1;
+
+  void Grow();
+  void Unlink(int32_t handle);
+  // The first tick after current_tick_ whose slot holds a timer. The wheel
+  // must not be empty.
+  int64_t FindEarliestTick() const;
+
+  // The tick up to which the wheel has advanced. Every timer in the wheel is
+  // due at a later tick.
+  int64_t current_tick_;
+  intptr_t count_;
+
+  // The first timer of each slot, and a bit per slot that is set when the
+  // slot is not empty.
+  int32_t slots_[kNumSlots];
+  uint64_t occupied_[kNumWords];
+  // The result of FindEarliestTick, or kUnknownTick if it must be searched
+  // for again.
+  int64_t earliest_tick_;
+
+  // The timers, indexed by handle. A timer that is not in use has a tick of
+  // -1, and its next_ links it to the next free handle.
+  int64_t* ticks_;
+  int32_t* next_;
+  int32_t* prev_;
+  intptr_t capacity_;
+  intptr_t used_;
+  int32_t free_;
+
+  int32_t* expired_;
+  intptr_t expired_capacity_;
+
+  static bool enabled_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_TIMER_WHEEL_H_
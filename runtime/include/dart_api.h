@@ -3448,6 +3448,12 @@ Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length);
  * Compile functions using data from Dart_SaveTypeFeedback. The data must from a
  * VM with the same version and compiler flags.
  *
+ * With --precompilation, the data is kept for Dart_Precompile instead, which
+ * uses it to guide speculative devirtualization, inlining and block layout.
+ * The version and compiler flags are then checked by Dart_Precompile, and the
+ * data must come from a VM run with the flags --precompilation implies, that
+ * is with --no-use-osr, --no-use-field-guards and --fields-may-be-reset.
+ *
  * \return Returns an error handle if a compilation error was encountered or a
  *   version mismatch is detected.
  */
@@ -0,0 +1,43 @@
+// Copyright (c) 2020, the Dart project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:observatory/service_io.dart';
+import 'package:test/test.dart';
+
+import 'test_helper.dart';
+
+const String kGetStdioBufferStatisticsRPC =
+    'ext.dart.io.getStdioBufferStatistics';
+const String kGetVersionRPC = 'ext.dart.io.getVersion';
+
+void setup() {
+  print('written through the stdio buffer');
+}
+
+var tests = <IsolateTest>[
+  (Isolate isolate) async {
+    await isolate.load();
+    expect(
+        isolate.extensionRPCs.contains(kGetStdioBufferStatisticsRPC), isTrue);
+
+    var response = await isolate.invokeRpcNoUpgrade(kGetVersionRPC, {});
+    expect(response['major'], 1);
+    expect(response['minor'], greaterThanOrEqualTo(2));
+  },
+  (Isolate isolate) async {
+    var response =
+        await isolate.invokeRpcNoUpgrade(kGetStdioBufferStatisticsRPC, {});
+    expect(response['type'], 'StdioBufferStatistics');
+    expect(response['enabled'], isTrue);
+    // The testee's output, including the line printed by setup, goes
+    // through the buffer.
+    expect(response['bytesWritten'], greaterThan(0));
+    expect(response['writes'], greaterThan(0));
+    expect(response['bytesDropped'], 0);
+    expect(response['blockedMicroseconds'], greaterThanOrEqualTo(0));
+  },
+];
+
+main(args) async => runIsolateTests(args, tests,
+    testeeBefore: setup, extraArgs: ['--buffered-stdio']);
@@ -0,0 +1,65 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that an app-jit snapshot trained with AVX loads with --no-use-avx
+// and the other way round.
+
+import 'dart:async';
+import 'dart:io' show Platform;
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as p;
+
+import 'snapshot_test_helper.dart';
+
+double sum(List<double> values) {
+  double result = 0.0;
+  for (var i = 0; i < values.length; i++) {
+    result += values[i] * 2.0;
+  }
+  return result;
+}
+
+void child(List<String> args) {
+  final values = List<double>.generate(1000, (i) => i * 0.25);
+  double total = 0.0;
+  for (var i = 0; i < 1000; i++) {
+    total += sum(values);
+  }
+  Expect.equals(249750000.0, total);
+  print(args.contains('--train') ? 'OK(Trained)' : 'OK(Run)');
+}
+
+Future<void> roundTrip(List<String> trainFlags, List<String> runFlags) async {
+  await withTempDir((String temp) async {
+    final snapshotPath = p.join(temp, 'app.jit');
+    final testPath = Platform.script.toFilePath();
+
+    final trainingResult = await runDart('TRAINING RUN', [
+      ...trainFlags,
+      '--snapshot=$snapshotPath',
+      '--snapshot-kind=app-jit',
+      testPath,
+      '--child',
+      '--train',
+    ]);
+    expectOutput('OK(Trained)', trainingResult);
+    final runResult = await runDart('RUN FROM SNAPSHOT', [
+      ...runFlags,
+      snapshotPath,
+      '--child',
+    ]);
+    expectOutput('OK(Run)', runResult);
+  });
+}
+
+Future<void> main(List<String> args) async {
+  if (args.contains('--child')) {
+    child(args);
+    return;
+  }
+
+  await roundTrip(<String>[], <String>['--no-use-avx']);
+  await roundTrip(<String>['--no-use-avx'], <String>[]);
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Each dynamic call below uses a selector that is only sent by the code of
+// the previous target, so the precompiler can only find the targets one
+// fixpoint round after another. The last call goes through a closure held in
+// a field, which is only found by the scan for callback fields. Decoy
+// implements every step as well, so that type flow analysis cannot turn the
+// calls into direct ones.
+
+import "package:expect/expect.dart";
+
+class Step1 {
+  @pragma('vm:never-inline')
+  dynamic step1(dynamic next) => next.step2(objects[2]);
+}
+
+class Step2 {
+  @pragma('vm:never-inline')
+  dynamic step2(dynamic next) => next.step3(objects[3]);
+}
+
+class Step3 {
+  @pragma('vm:never-inline')
+  dynamic step3(dynamic next) => next.step4();
+}
+
+class Step4 {
+  final dynamic step4 = () => 'reached step 4';
+}
+
+class Decoy {
+  dynamic step1(dynamic next) => 'decoy';
+  dynamic step2(dynamic next) => 'decoy';
+  dynamic step3(dynamic next) => 'decoy';
+  final dynamic step4 = () => 'decoy';
+}
+
+final List<dynamic> objects = <dynamic>[
+  new Decoy(),
+  new Step1(),
+  new Step2(),
+  new Step3(),
+  new Step4(),
+];
+
+main(List<String> args) {
+  // The index is not a constant, so that the receiver is not known statically.
+  dynamic first = objects[args.length + 1];
+  Expect.equals('reached step 4', first.step1(objects[2]));
+  print('reached step 4');
+}
@@ -13,6 +13,7 @@
 #include "vm/code_observers.h"
 #include "vm/compiler/api/print_filter.h"
 #include "vm/compiler/assembler/disassembler.h"
+#include "vm/cpu.h"
 #include "vm/dart.h"
 #include "vm/dispatch_table.h"
 #include "vm/flag_list.h"
@@ -5981,6 +5982,52 @@ char* SnapshotHeaderReader::VerifyVersion() {
   return nullptr;
 }
 
+#if defined(TARGET_ARCH_X64)
+static const char kAvxFeature[] = " avx";
+
+// Returns a copy of [features] without the " avx" feature, and whether the
+// feature was there.
+static char* RemoveAvxFeature(const char* features,
+                              intptr_t length,
+                              bool* found) {
+  const intptr_t feature_length = strlen(kAvxFeature);
+  char* result = Utils::StrNDup(features, length);
+  *found = false;
+  for (char* cursor = strstr(result, kAvxFeature); cursor != nullptr;
+       cursor = strstr(cursor + 1, kAvxFeature)) {
+    const char next = cursor[feature_length];
+    if ((next == ' ') || (next == '\0')) {
+      memmove(cursor, cursor + feature_length,
+              strlen(cursor + feature_length) + 1);
+      *found = true;
+      break;
+    }
+  }
+  return result;
+}
+
+// " avx" only records that the snapshot's code may use AVX. That is a
+// requirement on the CPU rather than on the VM configuration: a snapshot
+// without AVX code loads into a VM that would emit AVX, and a snapshot with
+// AVX code loads into a VM running with --no-use-avx if the CPU has AVX.
+static bool AvxFeaturesCompatible(const char* features,
+                                  intptr_t features_length,
+                                  const char* expected_features,
+                                  intptr_t expected_length) {
+  bool snapshot_avx = false;
+  bool vm_avx = false;
+  char* actual = RemoveAvxFeature(features, features_length, &snapshot_avx);
+  char* expected =
+      RemoveAvxFeature(expected_features, expected_length, &vm_avx);
+  const bool compatible =
+      (strcmp(actual, expected) == 0) &&
+      (!snapshot_avx || HostCPUFeatures::avx_hardware_supported());
+  free(actual);
+  free(expected);
+  return compatible;
+}
+#endif  // defined(TARGET_ARCH_X64)
+
 char* SnapshotHeaderReader::VerifyFeatures(Isolate* isolate) {
   const char* expected_features =
       Dart::FeaturesString(isolate, (isolate == NULL), kind_);
@@ -5995,8 +6042,16 @@ char* SnapshotHeaderReader::VerifyFeatures(Isolate* isolate) {
     return error;
   }
 
-  if (features_length != expected_len ||
-      (strncmp(features, expected_features, expected_len) != 0)) {
+  bool compatible =
+      (features_length == expected_len) &&
+      (strncmp(features, expected_features, expected_len) == 0);
+#if defined(TARGET_ARCH_X64)
+  if (!compatible) {
+    compatible = AvxFeaturesCompatible(features, features_length,
+                                       expected_features, expected_len);
+  }
+#endif
+  if (!compatible) {
     const intptr_t kMessageBufferSize = 1024;
     char message_buffer[kMessageBufferSize];
     char* actual_features = Utils::StrNDup(
@@ -438,7 +438,8 @@ TypeFeedbackSaver::TypeFeedbackSaver(WriteStream* stream)
       field_(Field::Handle()),
       code_(Code::Handle()),
       call_sites_(Array::Handle()),
-      call_site_(ICData::Handle()) {}
+      call_site_(ICData::Handle()),
+      edge_counters_(Array::Handle()) {}
 
 // These flags affect deopt ids.
 static char* CompilerFlags() {
@@ -455,7 +456,17 @@ static char* CompilerFlags() {
   return buffer.Steal();
 }
 
+// The snapshot version does not change with the layout of the feedback, so
+// the feedback starts with its own marker and format version. Bump the
+// version whenever the saver writes something new.
+static const char kTypeFeedbackMarker[] = "dart-type-feedback";
+static const intptr_t kTypeFeedbackFormatVersion = 2;
+
 void TypeFeedbackSaver::WriteHeader() {
+  stream_->WriteBytes(reinterpret_cast<const uint8_t*>(kTypeFeedbackMarker),
+                      sizeof(kTypeFeedbackMarker));
+  WriteInt(kTypeFeedbackFormatVersion);
+
   const char* expected_version = Version::SnapshotString();
   ASSERT(expected_version != NULL);
   const intptr_t version_len = strlen(expected_version);
@@ -538,6 +549,20 @@ void TypeFeedbackSaver::VisitFunction(const Function& function) {
   }
 
   // First element is edge counters.
+  if (call_sites_.Length() > 0) {
+    edge_counters_ ^= call_sites_.At(0);
+  } else {
+    edge_counters_ = Array::null();
+  }
+  if (edge_counters_.IsNull()) {
+    WriteInt(0);
+  } else {
+    WriteInt(edge_counters_.Length());
+    for (intptr_t i = 0; i < edge_counters_.Length(); i++) {
+      WriteInt(Smi::Value(Smi::RawCast(edge_counters_.At(i))));
+    }
+  }
+
   WriteInt(call_sites_.Length() - 1);
   for (intptr_t i = 1; i < call_sites_.Length(); i++) {
     call_site_ ^= call_sites_.At(i);
@@ -600,12 +625,14 @@ TypeFeedbackLoader::TypeFeedbackLoader(Thread* thread)
       func_(Function::Handle(zone_)),
       call_sites_(Array::Handle(zone_)),
       call_site_(ICData::Handle(zone_)),
+      edge_counters_(Array::Handle(zone_)),
       target_name_(String::Handle(zone_)),
       target_(Function::Handle(zone_)),
       args_desc_(Array::Handle(zone_)),
       functions_to_compile_(
           GrowableObjectArray::Handle(zone_, GrowableObjectArray::New())),
-      error_(Error::Handle(zone_)) {}
+      error_(Error::Handle(zone_)),
+      profile_(nullptr) {}
 
 TypeFeedbackLoader::~TypeFeedbackLoader() {
   delete[] cid_map_;
@@ -655,7 +682,173 @@ ObjectPtr TypeFeedbackLoader::LoadFeedback(ReadStream* stream) {
   return Error::null();
 }
 
+#if defined(DART_PRECOMPILER)
+intptr_t TypeFeedbackProfile::CallSite::AggregateCount() const {
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < counts.length(); i++) {
+    count += counts[i];
+  }
+  return count;
+}
+
+const TypeFeedbackProfile::CallSite*
+TypeFeedbackProfile::FunctionFeedback::CallSiteAt(intptr_t deopt_id) const {
+  intptr_t lo = 0;
+  intptr_t hi = call_sites.length() - 1;
+  while (lo <= hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    const CallSite* site = call_sites[mid];
+    if (site->deopt_id == deopt_id) {
+      return site;
+    } else if (site->deopt_id < deopt_id) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return nullptr;
+}
+
+ObjectPtr TypeFeedbackLoader::LoadProfile(ReadStream* stream,
+                                          TypeFeedbackProfile* profile) {
+  stream_ = stream;
+  profile_ = profile;
+
+  error_ = CheckHeader();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  error_ = LoadClasses();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  error_ = LoadFields();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  while (stream_->PendingBytes() > 0) {
+    error_ = LoadFunctionProfile();
+    if (error_.IsError()) {
+      return error_.raw();
+    }
+  }
+
+  if (FLAG_trace_compilation_trace) {
+    THR_Print("Done loading profile\n");
+  }
+
+  return Error::null();
+}
+
+ObjectPtr TypeFeedbackLoader::LoadFunctionProfile() {
+  cls_ = ReadClassByName();
+  bool skip = cls_.IsNull();
+
+  func_name_ = ReadString();  // Without private mangling.
+  FunctionLayout::Kind kind = static_cast<FunctionLayout::Kind>(ReadInt());
+  intptr_t token_pos = ReadInt();
+  intptr_t usage = ReadInt();
+  ReadInt();  // Inlining depth.
+  edge_counters_ = ReadEdgeCounters();
+  intptr_t num_call_sites = ReadInt();
+
+  // Looking these up would create them, and the precompiler creates its own.
+  if ((kind == FunctionLayout::kMethodExtractor) ||
+      (kind == FunctionLayout::kDynamicInvocationForwarder)) {
+    skip = true;
+  }
+
+  if (!skip) {
+    func_ = FindFunction(kind, token_pos);
+    if (func_.IsNull()) {
+      skip = true;
+      if (FLAG_trace_compilation_trace) {
+        THR_Print("Missing function %s %s\n", func_name_.ToCString(),
+                  Function::KindToCString(kind));
+      }
+    }
+  }
+
+  TypeFeedbackProfile::FunctionFeedback* feedback = nullptr;
+  if (!skip) {
+    feedback = new (zone_) TypeFeedbackProfile::FunctionFeedback(
+        zone_, Function::ZoneHandle(zone_, func_.raw()), usage);
+    feedback->edge_counters = edge_counters_.raw();
+  }
+
+  for (intptr_t i = 0; i < num_call_sites; i++) {
+    intptr_t deopt_id = ReadInt();
+    intptr_t rebind_rule = ReadInt();
+    target_name_ = ReadString();
+    intptr_t num_checked_arguments = ReadInt();
+    intptr_t num_entries = ReadInt();
+
+    TypeFeedbackProfile::CallSite* site = nullptr;
+    if (feedback != nullptr) {
+      site = new (zone_) TypeFeedbackProfile::CallSite(
+          zone_, deopt_id, rebind_rule,
+          String::ZoneHandle(zone_, target_name_.raw()),
+          num_checked_arguments);
+      feedback->call_sites.Add(site);
+    }
+
+    for (intptr_t entry_index = 0; entry_index < num_entries; entry_index++) {
+      intptr_t entry_usage = ReadInt();
+      bool skip_entry = (site == nullptr);
+      const intptr_t first_cid = (site == nullptr) ? 0 : site->cids.length();
+
+      for (intptr_t argument_index = 0; argument_index < num_checked_arguments;
+           argument_index++) {
+        intptr_t cid = cid_map_[ReadInt()];
+        if (cid == kIllegalCid) {
+          // The class is not in the current program.
+          skip_entry = true;
+        }
+        if (!skip_entry) {
+          site->cids.Add(cid);
+        }
+      }
+
+      if (skip_entry) {
+        if (site != nullptr) {
+          site->cids.TruncateTo(first_cid);
+        }
+        continue;
+      }
+      site->counts.Add(entry_usage);
+    }
+  }
+
+  if (feedback != nullptr) {
+    profile_->Add(feedback);
+  }
+
+  return Error::null();
+}
+#endif  // defined(DART_PRECOMPILER)
+
 ObjectPtr TypeFeedbackLoader::CheckHeader() {
+  const intptr_t marker_len = sizeof(kTypeFeedbackMarker);
+  if ((stream_->PendingBytes() < marker_len) ||
+      (memcmp(stream_->AddressOfCurrentPosition(), kTypeFeedbackMarker,
+              marker_len) != 0)) {
+    return ApiError::New(
+        String::Handle(String::New("Not a type feedback file", Heap::kOld)),
+        Heap::kOld);
+  }
+  stream_->Advance(marker_len);
+  const intptr_t format_version = ReadInt();
+  if (format_version != kTypeFeedbackFormatVersion) {
+    const String& msg = String::Handle(String::NewFormatted(
+        Heap::kOld,
+        "Wrong type feedback format version, expected %" Pd " found %" Pd,
+        kTypeFeedbackFormatVersion, format_version));
+    return ApiError::New(msg, Heap::kOld);
+  }
+
   const char* expected_version = Version::SnapshotString();
   ASSERT(expected_version != NULL);
   const intptr_t version_len = strlen(expected_version);
@@ -733,7 +926,8 @@ ObjectPtr TypeFeedbackLoader::LoadClasses() {
 ObjectPtr TypeFeedbackLoader::LoadFields() {
   for (intptr_t cid = kNumPredefinedCids; cid < num_cids_; cid++) {
     cls_ = ReadClassByName();
-    bool skip = cls_.IsNull();
+    // AOT compilation does not use field guards.
+    bool skip = cls_.IsNull() || (profile_ != nullptr);
 
     intptr_t num_fields = ReadInt();
     if (!skip && (num_fields > 0)) {
@@ -816,6 +1010,9 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
   intptr_t token_pos = ReadInt();
   intptr_t usage = ReadInt();
   intptr_t inlining_depth = ReadInt();
+  // The recorded edge counts only guide the AOT block layout. The JIT counts
+  // the edges of the code it compiles here itself.
+  SkipEdgeCounters();
   intptr_t num_call_sites = ReadInt();
 
   if (!skip) {
@@ -994,6 +1191,26 @@ FunctionPtr TypeFeedbackLoader::FindFunction(FunctionLayout::Kind kind,
   return func_.raw();
 }
 
+ArrayPtr TypeFeedbackLoader::ReadEdgeCounters() {
+  const intptr_t num_edge_counters = ReadInt();
+  if (num_edge_counters == 0) {
+    return Array::null();
+  }
+  const Array& edge_counters =
+      Array::Handle(zone_, Array::New(num_edge_counters, Heap::kOld));
+  for (intptr_t i = 0; i < num_edge_counters; i++) {
+    edge_counters.SetAt(i, Smi::Handle(zone_, Smi::New(ReadInt())));
+  }
+  return edge_counters.raw();
+}
+
+void TypeFeedbackLoader::SkipEdgeCounters() {
+  const intptr_t num_edge_counters = ReadInt();
+  for (intptr_t i = 0; i < num_edge_counters; i++) {
+    ReadInt();
+  }
+}
+
 ClassPtr TypeFeedbackLoader::ReadClassByName() {
   uri_ = ReadString();
   cls_name_ = ReadString();
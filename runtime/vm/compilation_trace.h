@@ -6,12 +6,15 @@
 #define RUNTIME_VM_COMPILATION_TRACE_H_
 
 #include "platform/assert.h"
+#include "vm/hash_map.h"
 #include "vm/object.h"
 #include "vm/program_visitor.h"
 #include "vm/zone_text_buffer.h"
 
 namespace dart {
 
+class TypeFeedbackProfile;
+
 class CompilationTraceSaver : public FunctionVisitor {
  public:
   explicit CompilationTraceSaver(Zone* zone);
@@ -88,7 +91,92 @@ class TypeFeedbackSaver : public FunctionVisitor {
   Code& code_;
   Array& call_sites_;
   ICData& call_site_;
+  Array& edge_counters_;
+};
+
+#if defined(DART_PRECOMPILER)
+// Type feedback from Dart_SaveTypeFeedback, read by the precompiler to guide
+// AOT compilation with the behavior of a JIT run.
+class TypeFeedbackProfile : public ZoneAllocated {
+ public:
+  // The feedback of one call site. For an instance call, the classes of the
+  // checked arguments of each entry are in |cids|, NumArgsTested per entry.
+  struct CallSite : public ZoneAllocated {
+    CallSite(Zone* zone,
+             intptr_t deopt_id,
+             intptr_t rebind_rule,
+             const String& target_name,
+             intptr_t num_checked_arguments)
+        : deopt_id(deopt_id),
+          rebind_rule(rebind_rule),
+          target_name(target_name),
+          num_checked_arguments(num_checked_arguments),
+          cids(zone, 0),
+          counts(zone, 0) {}
+
+    intptr_t num_entries() const { return counts.length(); }
+    intptr_t AggregateCount() const;
+
+    const intptr_t deopt_id;
+    const intptr_t rebind_rule;
+    // Without private mangling.
+    const String& target_name;
+    const intptr_t num_checked_arguments;
+    ZoneGrowableArray<intptr_t> cids;
+    ZoneGrowableArray<intptr_t> counts;
+  };
+
+  // The feedback of one function. The call sites are sorted by deopt id, and
+  // the edge counters are indexed by block preorder number, like the
+  // ic_data_array of the function's unoptimized code.
+  struct FunctionFeedback : public ZoneAllocated {
+    FunctionFeedback(Zone* zone, const Function& function, intptr_t usage)
+        : function(function),
+          usage(usage),
+          edge_counters(Array::ZoneHandle(zone)),
+          call_sites(zone, 0) {}
+
+    // Returns the call site with |deopt_id|, or nullptr.
+    const CallSite* CallSiteAt(intptr_t deopt_id) const;
+
+    const Function& function;
+    const intptr_t usage;
+    Array& edge_counters;
+    ZoneGrowableArray<CallSite*> call_sites;
+  };
+
+  explicit TypeFeedbackProfile(Zone* zone) : zone_(zone), map_(zone) {}
+
+  void Add(FunctionFeedback* feedback) { map_.Insert(feedback); }
+
+  // Returns the feedback of |function|, or nullptr if it did not run.
+  const FunctionFeedback* Lookup(const Function& function) const {
+    return map_.LookupValue(&function);
+  }
+
+  Zone* zone() const { return zone_; }
+
+ private:
+  class FunctionFeedbackTrait {
+   public:
+    typedef const Function* Key;
+    typedef FunctionFeedback* Value;
+    typedef FunctionFeedback* Pair;
+
+    static Key KeyOf(Pair kv) { return &kv->function; }
+    static Value ValueOf(Pair kv) { return kv; }
+    static inline intptr_t Hashcode(Key key) { return key->Hash(); }
+    static inline bool IsKeyEqual(Pair kv, Key key) {
+      return kv->function.raw() == key->raw();
+    }
+  };
+
+  Zone* zone_;
+  DirectChainedHashMap<FunctionFeedbackTrait> map_;
+
+  DISALLOW_COPY_AND_ASSIGN(TypeFeedbackProfile);
 };
+#endif  // defined(DART_PRECOMPILER)
 
 class TypeFeedbackLoader : public ValueObject {
  public:
@@ -97,11 +185,23 @@ class TypeFeedbackLoader : public ValueObject {
 
   ObjectPtr LoadFeedback(ReadStream* stream);
 
+#if defined(DART_PRECOMPILER)
+  // Reads the feedback into |profile| instead of compiling the functions it
+  // mentions. Classes must be sorted already, as the profile refers to them
+  // by class id.
+  ObjectPtr LoadProfile(ReadStream* stream, TypeFeedbackProfile* profile);
+#endif
+
  private:
   ObjectPtr CheckHeader();
   ObjectPtr LoadClasses();
   ObjectPtr LoadFields();
   ObjectPtr LoadFunction();
+  ArrayPtr ReadEdgeCounters();
+  void SkipEdgeCounters();
+#if defined(DART_PRECOMPILER)
+  ObjectPtr LoadFunctionProfile();
+#endif
   FunctionPtr FindFunction(FunctionLayout::Kind kind, intptr_t token_pos);
 
   ClassPtr ReadClassByName();
@@ -124,11 +224,13 @@ class TypeFeedbackLoader : public ValueObject {
   Function& func_;
   Array& call_sites_;
   ICData& call_site_;
+  Array& edge_counters_;
   String& target_name_;
   Function& target_;
   Array& args_desc_;
   GrowableObjectArray& functions_to_compile_;
   Object& error_;
+  TypeFeedbackProfile* profile_;
 };
 
 }  // namespace dart
@@ -7,9 +7,11 @@
 #include "platform/unicode.h"
 #include "vm/class_finalizer.h"
 #include "vm/code_patcher.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
+#include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
 #include "vm/compiler/backend/flow_graph.h"
@@ -28,6 +30,7 @@
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/dart_entry.h"
+#include "vm/datastream.h"
 #include "vm/exceptions.h"
 #include "vm/flags.h"
 #include "vm/hash_table.h"
@@ -60,6 +63,11 @@ namespace dart {
 DEFINE_FLAG(bool, print_unique_targets, false, "Print unique dynamic targets");
 DEFINE_FLAG(bool, print_gop, false, "Print global object pool");
 DEFINE_FLAG(bool, trace_precompiler, false, "Trace precompiler.");
+DEFINE_FLAG(bool,
+            print_precompiler_timings,
+            false,
+            "Print the time spent in each phase of precompilation and the "
+            "slowest functions to compile.");
 DEFINE_FLAG(
     int,
     max_speculative_inlining_attempts,
@@ -134,6 +142,31 @@ static void Jump(const Error& error) {
   Thread::Current()->long_jump_base()->Jump(1, error);
 }
 
+// Records the time spent in a phase of precompilation for
+// --print_precompiler_timings.
+class Precompiler::PhaseTimer : public ValueObject {
+ public:
+  PhaseTimer(Precompiler* precompiler, const char* name)
+      : precompiler_(precompiler),
+        name_(name),
+        start_(FLAG_print_precompiler_timings ? OS::GetCurrentMonotonicMicros()
+                                              : 0) {}
+
+  ~PhaseTimer() {
+    if (FLAG_print_precompiler_timings) {
+      Timing timing = {name_, OS::GetCurrentMonotonicMicros() - start_};
+      precompiler_->phase_timings_.Add(timing);
+    }
+  }
+
+ private:
+  Precompiler* precompiler_;
+  const char* name_;
+  const int64_t start_;
+
+  DISALLOW_COPY_AND_ASSIGN(PhaseTimer);
+};
+
 ErrorPtr Precompiler::CompileAll() {
   LongJumpScope jump;
   if (setjmp(*jump.Set()) == 0) {
@@ -160,6 +193,16 @@ Precompiler::Precompiler(Thread* thread)
       dropped_typearg_count_(0),
       dropped_type_count_(0),
       dropped_library_count_(0),
+      table_selector_count_(0),
+      scanned_selector_count_(-1),
+      scanned_table_selector_count_(-1),
+      scanned_class_count_(-1),
+      scanned_function_count_(-1),
+      fixpoint_round_count_(0),
+      skipped_scan_count_(0),
+      pool_commit_retry_count_(0),
+      compile_micros_(0),
+      phase_timings_(),
       libraries_(GrowableObjectArray::Handle(I->object_store()->libraries())),
       pending_functions_(
           GrowableObjectArray::Handle(GrowableObjectArray::New())),
@@ -177,9 +220,14 @@ Precompiler::Precompiler(Thread* thread)
       seen_table_selectors_(),
       error_(Error::Handle()),
       get_runtime_type_is_unique_(false),
-      il_serialization_stream_(nullptr) {
+      il_serialization_stream_(nullptr),
+      type_feedback_(nullptr) {
   ASSERT(Precompiler::singleton_ == NULL);
   Precompiler::singleton_ = this;
+  for (intptr_t i = 0; i < kNumSlowestFunctions; i++) {
+    slowest_functions_[i].name = nullptr;
+    slowest_functions_[i].micros = -1;
+  }
 }
 
 Precompiler::~Precompiler() {
@@ -188,6 +236,10 @@ Precompiler::~Precompiler() {
   possibly_retained_functions_.Release();
   functions_to_retain_.Release();
 
+  for (intptr_t i = 0; i < kNumSlowestFunctions; i++) {
+    free(const_cast<char*>(slowest_functions_[i].name));
+  }
+
   ASSERT(Precompiler::singleton_ == this);
   Precompiler::singleton_ = NULL;
 }
@@ -210,11 +262,17 @@ void Precompiler::DoCompileAll() {
       // Make sure class hierarchy is stable before compilation so that CHA
       // can be used. Also ensures lookup of entry points won't miss functions
       // because their class hasn't been finalized yet.
-      FinalizeAllClasses();
+      {
+        PhaseTimer timer(this, "FinalizeAllClasses");
+        FinalizeAllClasses();
+      }
       ASSERT(Error::Handle(Z, T->sticky_error()).IsNull());
 
       ClassFinalizer::SortClasses();
 
+      // The profile refers to classes by their sorted class ids.
+      LoadTypeFeedback();
+
       // Collects type usage information which allows us to decide when/how to
       // optimize runtime type tests.
       TypeUsageInfo type_usage_info(T);
@@ -234,6 +292,7 @@ void Precompiler::DoCompileAll() {
           /*including_nonchanging_cids=*/FLAG_use_bare_instructions);
 
       {
+        PhaseTimer timer(this, "PrecompileConstructors");
         CompilerState state(thread_, /*is_aot=*/true);
         PrecompileConstructors();
       }
@@ -316,11 +375,17 @@ void Precompiler::DoCompileAll() {
 
       // Compile newly found targets and add their callees until we reach a
       // fixed point.
-      Iterate();
+      {
+        PhaseTimer timer(this, "Iterate");
+        Iterate();
+      }
 
       // Replace the default type testing stubs installed on [Type]s with new
       // [Type]-specialized stubs.
-      AttachOptimizedTypeTestingStub();
+      {
+        PhaseTimer timer(this, "AttachOptimizedTypeTestingStub");
+        AttachOptimizedTypeTestingStub();
+      }
 
       if (FLAG_use_bare_instructions) {
         // Now we generate the actual object pool instance and attach it to the
@@ -376,15 +441,18 @@ void Precompiler::DoCompileAll() {
         }
       }
 
-      TraceForRetainedFunctions();
-      FinalizeDispatchTable();
-      ReplaceFunctionPCRelativeCallEntries();
-
-      DropFunctions();
-      DropFields();
-      TraceTypesFromRetainedClasses();
-      DropTypes();
-      DropTypeArguments();
+      {
+        PhaseTimer timer(this, "TreeShaking");
+        TraceForRetainedFunctions();
+        FinalizeDispatchTable();
+        ReplaceFunctionPCRelativeCallEntries();
+
+        DropFunctions();
+        DropFields();
+        TraceTypesFromRetainedClasses();
+        DropTypes();
+        DropTypeArguments();
+      }
 
       // Clear these before dropping classes as they may hold onto otherwise
       // dead instances of classes we will remove or otherwise unused symbols.
@@ -410,10 +478,16 @@ void Precompiler::DoCompileAll() {
       DropMetadata();
       DropLibraryEntries();
     }
-    DropClasses();
-    DropLibraries();
+    {
+      PhaseTimer timer(this, "DropClasses");
+      DropClasses();
+      DropLibraries();
+    }
 
-    Obfuscate();
+    {
+      PhaseTimer timer(this, "Obfuscate");
+      Obfuscate();
+    }
 
 #if defined(DEBUG)
     const auto& non_visited =
@@ -423,7 +497,10 @@ void Precompiler::DoCompileAll() {
              non_visited.ToFullyQualifiedCString());
     }
 #endif
-    ProgramVisitor::Dedup(T);
+    {
+      PhaseTimer timer(this, "Dedup");
+      ProgramVisitor::Dedup(T);
+    }
 
     zone_ = NULL;
   }
@@ -435,7 +512,10 @@ void Precompiler::DoCompileAll() {
     Symbols::GetStats(I, &symbols_before, &capacity);
   }
 
-  Symbols::Compact();
+  {
+    PhaseTimer timer(this, "CompactSymbols");
+    Symbols::Compact();
+  }
 
   if (FLAG_trace_precompiler) {
     Symbols::GetStats(I, &symbols_after, &capacity);
@@ -451,6 +531,35 @@ void Precompiler::DoCompileAll() {
     THR_Print(" %" Pd " classes,", dropped_class_count_);
     THR_Print(" %" Pd " libraries.\n", dropped_library_count_);
   }
+
+  if (FLAG_print_precompiler_timings) {
+    PrintTimings();
+  }
+}
+
+void Precompiler::PrintTimings() {
+  int64_t total_micros = 0;
+  THR_Print("Precompiler timings:\n");
+  for (intptr_t i = 0; i < phase_timings_.length(); i++) {
+    const Timing& timing = phase_timings_[i];
+    THR_Print("  %-32s %10" Pd64 " us\n", timing.name, timing.micros);
+    total_micros += timing.micros;
+  }
+  THR_Print("  %-32s %10" Pd64 " us\n", "Total", total_micros);
+
+  THR_Print("Compiled %" Pd " functions in %" Pd64 " us,", function_count_,
+            compile_micros_);
+  THR_Print(" %" Pd " retried for the global object pool.\n",
+            pool_commit_retry_count_);
+  THR_Print("Reached the fixed point in %" Pd " rounds,", fixpoint_round_count_);
+  THR_Print(" skipped %" Pd " redundant scans.\n", skipped_scan_count_);
+
+  THR_Print("Slowest functions to compile:\n");
+  for (intptr_t i = 0; i < kNumSlowestFunctions; i++) {
+    const Timing& timing = slowest_functions_[i];
+    if (timing.name == nullptr) break;
+    THR_Print("  %10" Pd64 " us %s\n", timing.micros, timing.name);
+  }
 }
 
 void Precompiler::PrecompileConstructors() {
@@ -527,18 +636,56 @@ void Precompiler::Iterate() {
   phase_ = Phase::kFixpointCodeGeneration;
   while (changed_) {
     changed_ = false;
+    fixpoint_round_count_++;
 
     while (pending_functions_.Length() > 0) {
       function ^= pending_functions_.RemoveLast();
       ProcessFunction(function);
     }
 
+    // The scans below only depend on the sent selectors, the allocated
+    // classes and their functions. If none of these changed since the last
+    // scan, the scans would not find anything new. The state is recorded
+    // before scanning, so that the functions added by a scan are looked at
+    // again by the next one.
+    const intptr_t function_count = CountFunctionsOfAllocatedClasses();
+    if ((selector_count_ == scanned_selector_count_) &&
+        (table_selector_count_ == scanned_table_selector_count_) &&
+        (class_count_ == scanned_class_count_) &&
+        (function_count == scanned_function_count_)) {
+      skipped_scan_count_++;
+      continue;
+    }
+    scanned_selector_count_ = selector_count_;
+    scanned_table_selector_count_ = table_selector_count_;
+    scanned_class_count_ = class_count_;
+    scanned_function_count_ = function_count;
+
     CheckForNewDynamicFunctions();
     CollectCallbackFields();
   }
   phase_ = Phase::kDone;
 }
 
+intptr_t Precompiler::CountFunctionsOfAllocatedClasses() {
+  Library& lib = Library::Handle(Z);
+  Class& cls = Class::Handle(Z);
+  Array& functions = Array::Handle(Z);
+  intptr_t count = 0;
+
+  for (intptr_t i = 0; i < libraries_.Length(); i++) {
+    lib ^= libraries_.At(i);
+    ClassDictionaryIterator it(lib, ClassDictionaryIterator::kIteratePrivate);
+    while (it.HasNext()) {
+      cls = it.GetNextClass();
+      if (!cls.is_allocated()) continue;
+      functions = cls.functions();
+      count += functions.Length();
+    }
+  }
+  return count;
+}
+
 void Precompiler::CollectCallbackFields() {
   Library& lib = Library::Handle(Z);
   Class& cls = Class::Handle(Z);
@@ -623,10 +770,15 @@ void Precompiler::ProcessFunction(const Function& function) {
     ASSERT(!function.is_abstract());
     ASSERT(!function.IsRedirectingFactory());
 
+    const int64_t start =
+        FLAG_print_precompiler_timings ? OS::GetCurrentMonotonicMicros() : 0;
     error_ = CompileFunction(this, thread_, zone_, function);
     if (!error_.IsNull()) {
       Jump(error_);
     }
+    if (FLAG_print_precompiler_timings) {
+      RecordCompileTime(function, OS::GetCurrentMonotonicMicros() - start);
+    }
     // Used in the JIT to save type-feedback across compilations.
     function.ClearICDataArray();
   } else {
@@ -644,6 +796,24 @@ void Precompiler::ProcessFunction(const Function& function) {
   AddCalleesOf(function, gop_offset);
 }
 
+void Precompiler::RecordCompileTime(const Function& function, int64_t micros) {
+  compile_micros_ += micros;
+
+  // Keep the slowest functions sorted by inserting this one in place.
+  intptr_t i = kNumSlowestFunctions;
+  while ((i > 0) && (micros > slowest_functions_[i - 1].micros)) {
+    i--;
+  }
+  if (i == kNumSlowestFunctions) return;
+  free(const_cast<char*>(slowest_functions_[kNumSlowestFunctions - 1].name));
+  for (intptr_t j = kNumSlowestFunctions - 1; j > i; j--) {
+    slowest_functions_[j] = slowest_functions_[j - 1];
+  }
+  slowest_functions_[i].name =
+      strdup(function.ToLibNamePrefixedQualifiedCString());
+  slowest_functions_[i].micros = micros;
+}
+
 void Precompiler::AddCalleesOf(const Function& function, intptr_t gop_offset) {
   ASSERT(function.HasCode());
 
@@ -1047,6 +1217,7 @@ void Precompiler::AddTableSelector(const compiler::TableSelector* selector) {
   if (seen_table_selectors_.HasKey(selector->id)) return;
 
   seen_table_selectors_.Insert(selector->id);
+  table_selector_count_++;
   changed_ = true;
 }
 
@@ -2258,6 +2429,132 @@ void Precompiler::FinalizeAllClasses() {
   I->set_all_classes_finalized(true);
 }
 
+void Precompiler::LoadTypeFeedback() {
+  const TypedData& feedback =
+      TypedData::Handle(Z, I->object_store()->aot_type_feedback());
+  if (feedback.IsNull()) {
+    return;
+  }
+  PhaseTimer timer(this, "LoadTypeFeedback");
+
+  // Loading allocates, so read from a copy outside the heap.
+  const intptr_t length = feedback.LengthInBytes();
+  uint8_t* buffer = Z->Alloc<uint8_t>(length);
+  {
+    NoSafepointScope no_safepoint;
+    memmove(buffer, feedback.DataAddr(0), length);
+  }
+  I->object_store()->set_aot_type_feedback(TypedData::Handle(Z));
+
+  ReadStream stream(buffer, length);
+  type_feedback_ = new (Z) TypeFeedbackProfile(Z);
+  error_ ^= TypeFeedbackLoader(T).LoadProfile(&stream, type_feedback_);
+  if (!error_.IsNull()) {
+    Jump(error_);
+  }
+}
+
+void Precompiler::ApplyTypeFeedback(FlowGraph* flow_graph) {
+  if (type_feedback_ != nullptr) {
+    ApplyTypeFeedback(*type_feedback_, flow_graph);
+  }
+}
+
+void Precompiler::ApplyTypeFeedback(const TypeFeedbackProfile& type_feedback,
+                                    FlowGraph* flow_graph) {
+  const Function& function = flow_graph->function();
+  const TypeFeedbackProfile::FunctionFeedback* feedback =
+      type_feedback.Lookup(function);
+  if (feedback == nullptr) {
+    return;
+  }
+
+  // The edge counters are indexed by the preorder numbers of the graph the
+  // JIT built for the function. Use them only if this graph has the same
+  // shape.
+  if (!feedback->edge_counters.IsNull() &&
+      (feedback->edge_counters.Length() == flow_graph->preorder().length())) {
+    BlockScheduler::AssignEdgeWeights(flow_graph, feedback->edge_counters);
+  }
+
+  Zone* zone = flow_graph->zone();
+  ClassTable* class_table = flow_graph->isolate()->class_table();
+  Class& cls = Class::Handle(zone);
+  Function& target = Function::Handle(zone);
+  GrowableArray<intptr_t> cids;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      Instruction* instr = it.Current();
+      if (instr->IsInstanceCall()) {
+        InstanceCallInstr* call = instr->AsInstanceCall();
+        const TypeFeedbackProfile::CallSite* site =
+            feedback->CallSiteAt(call->deopt_id());
+        // Deopt ids are only stable as long as the function is unchanged, so
+        // check that the site is still the same call.
+        if (call->HasICData() || (site == nullptr) ||
+            (site->rebind_rule != ICData::kInstance) ||
+            (site->num_checked_arguments != call->checked_argument_count()) ||
+            !String::EqualsIgnoringPrivateKey(call->function_name(),
+                                              site->target_name)) {
+          continue;
+        }
+        const Array& arguments_descriptor =
+            Array::Handle(zone, call->GetArgumentsDescriptor());
+        const ICData& ic_data = ICData::ZoneHandle(
+            zone, ICData::New(function, call->function_name(),
+                              arguments_descriptor, call->deopt_id(),
+                              call->checked_argument_count(),
+                              ICData::kInstance));
+        const intptr_t num_checked = site->num_checked_arguments;
+        for (intptr_t i = 0; i < site->num_entries(); i++) {
+          cls = class_table->At(site->cids[i * num_checked]);
+          target = call->ResolveForReceiverClass(cls, /*allow_add=*/false);
+          if (target.IsNull()) {
+            continue;
+          }
+          if (num_checked == 1) {
+            ic_data.AddReceiverCheck(cls.id(), target, site->counts[i]);
+          } else {
+            cids.Clear();
+            for (intptr_t j = 0; j < num_checked; j++) {
+              cids.Add(site->cids[i * num_checked + j]);
+            }
+            ic_data.AddCheck(cids, target, site->counts[i]);
+          }
+        }
+        if (ic_data.NumberOfChecks() > 0) {
+          call->set_ic_data(&ic_data);
+        }
+      } else if (instr->IsStaticCall()) {
+        StaticCallInstr* call = instr->AsStaticCall();
+        const TypeFeedbackProfile::CallSite* site =
+            feedback->CallSiteAt(call->deopt_id());
+        const Function& callee = call->function();
+        if (call->HasICData() || (site == nullptr) ||
+            (site->rebind_rule == ICData::kInstance) ||
+            !String::EqualsIgnoringPrivateKey(
+                String::Handle(zone, callee.name()), site->target_name)) {
+          continue;
+        }
+        const Array& arguments_descriptor =
+            Array::Handle(zone, call->GetArgumentsDescriptor());
+        const ICData& ic_data = ICData::ZoneHandle(
+            zone,
+            ICData::New(function, String::Handle(zone, callee.name()),
+                        arguments_descriptor, call->deopt_id(),
+                        MethodRecognizer::NumArgsCheckedForStaticCall(callee),
+                        ICData::kStatic));
+        ic_data.AddTarget(callee);
+        ic_data.SetCountAt(0, Utils::Minimum<intptr_t>(site->AggregateCount(),
+                                                       Smi::kMaxValue));
+        call->set_ic_data(&ic_data);
+      }
+    }
+  }
+}
+
 void PrecompileParsedFunctionHelper::FinalizeCompilation(
     compiler::Assembler* assembler,
     FlowGraphCompiler* graph_compiler,
@@ -2363,6 +2660,9 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       }
 
       if (optimized()) {
+        if (precompiler_ != nullptr) {
+          precompiler_->ApplyTypeFeedback(flow_graph);
+        }
         flow_graph->PopulateWithICData(function);
       }
 
@@ -2498,6 +2798,7 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       // more aggressively on the second attempt).
       if (FLAG_use_bare_instructions &&
           !object_pool_builder.TryCommitToParent()) {
+        precompiler_->RecordPoolCommitRetry();
         done = false;
         continue;
       }
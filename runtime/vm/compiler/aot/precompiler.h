@@ -12,6 +12,7 @@
 #include "vm/allocation.h"
 #include "vm/compiler/aot/dispatch_table_generator.h"
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/growable_array.h"
 #include "vm/hash_map.h"
 #include "vm/hash_table.h"
 #include "vm/object.h"
@@ -32,6 +33,7 @@ class ParsedJSONArray;
 class Precompiler;
 class FlowGraph;
 class PrecompilerEntryPointsPrinter;
+class TypeFeedbackProfile;
 
 class TableSelectorKeyValueTrait {
  public:
@@ -229,7 +231,32 @@ class Precompiler : public ValueObject {
 
   Phase phase() const { return phase_; }
 
+  // Called when a compilation is retried because its object pool could not
+  // be committed to the global object pool.
+  void RecordPoolCommitRetry() { pool_commit_retry_count_++; }
+
+  // The type feedback loaded with Dart_LoadTypeFeedback, or nullptr.
+  const TypeFeedbackProfile* type_feedback() const { return type_feedback_; }
+
+  // Attaches the recorded type feedback of the function of [flow_graph] to
+  // its calls that have no ICData yet, and weighs its edges with the recorded
+  // edge counts.
+  void ApplyTypeFeedback(FlowGraph* flow_graph);
+  static void ApplyTypeFeedback(const TypeFeedbackProfile& type_feedback,
+                                FlowGraph* flow_graph);
+
  private:
+  class PhaseTimer;
+
+  // The time spent in a phase of precompilation or compiling a function, for
+  // --print_precompiler_timings.
+  struct Timing {
+    const char* name;
+    int64_t micros;
+  };
+
+  static const intptr_t kNumSlowestFunctions = 10;
+
   static Precompiler* singleton_;
 
   explicit Precompiler(Thread* thread);
@@ -258,6 +285,8 @@ class Precompiler : public ValueObject {
   bool MustRetainFunction(const Function& function);
 
   void ProcessFunction(const Function& function);
+  void RecordCompileTime(const Function& function, int64_t micros);
+  intptr_t CountFunctionsOfAllocatedClasses();
   void CheckForNewDynamicFunctions();
   void CollectCallbackFields();
 
@@ -287,6 +316,10 @@ class Precompiler : public ValueObject {
 
   void FinalizeAllClasses();
 
+  void LoadTypeFeedback();
+
+  void PrintTimings();
+
   void set_il_serialization_stream(void* file) {
     il_serialization_stream_ = file;
   }
@@ -310,6 +343,23 @@ class Precompiler : public ValueObject {
   intptr_t dropped_typearg_count_;
   intptr_t dropped_type_count_;
   intptr_t dropped_library_count_;
+  intptr_t table_selector_count_;
+
+  // The state of the program when CheckForNewDynamicFunctions and
+  // CollectCallbackFields last ran. Unless it changed, running them again
+  // finds nothing new.
+  intptr_t scanned_selector_count_;
+  intptr_t scanned_table_selector_count_;
+  intptr_t scanned_class_count_;
+  intptr_t scanned_function_count_;
+
+  intptr_t fixpoint_round_count_;
+  intptr_t skipped_scan_count_;
+  intptr_t pool_commit_retry_count_;
+  int64_t compile_micros_;
+  MallocGrowableArray<Timing> phase_timings_;
+  // Sorted from the slowest, with malloced names.
+  Timing slowest_functions_[kNumSlowestFunctions];
 
   compiler::ObjectPoolBuilder global_object_pool_builder_;
   GrowableObjectArray& libraries_;
@@ -330,6 +380,7 @@ class Precompiler : public ValueObject {
 
   bool get_runtime_type_is_unique_;
   void* il_serialization_stream_;
+  TypeFeedbackProfile* type_feedback_;
 
   Phase phase_ = Phase::kPreparation;
 };
@@ -10,6 +10,7 @@
 #include "vm/class_id.h"
 #include "vm/compiler/asm_intrinsifier.h"
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/cpu.h"
 
 namespace dart {
 namespace compiler {
@@ -2252,7 +2253,7 @@ static void StringEquality(Assembler* assembler,
 
   // Are identical?
   __ cmpq(RAX, RCX);
-  __ j(EQUAL, &is_true, Assembler::kNearJump);
+  __ j(EQUAL, &is_true);
 
   // Is other target::OneByteString?
   __ testq(RCX, Immediate(kSmiTagMask));
@@ -2263,27 +2264,49 @@ static void StringEquality(Assembler* assembler,
   // Have same length?
   __ movq(RDI, FieldAddress(RAX, target::String::length_offset()));
   __ cmpq(RDI, FieldAddress(RCX, target::String::length_offset()));
-  __ j(NOT_EQUAL, &is_false, Assembler::kNearJump);
+  __ j(NOT_EQUAL, &is_false);
+
+  ASSERT((string_cid == kOneByteStringCid) ||
+         (string_cid == kTwoByteStringCid));
+  const bool is_one_byte = string_cid == kOneByteStringCid;
+  const ScaleFactor scale = is_one_byte ? TIMES_1 : TIMES_2;
+  const intptr_t data_offset = is_one_byte
+                                   ? target::OneByteString::data_offset()
+                                   : target::TwoByteString::data_offset();
 
   // Check contents, no fall-through possible.
-  // TODO(srdjan): write a faster check.
   __ SmiUntag(RDI);
+  if (TargetCPUFeatures::avx2_supported()) {
+    // Compare 32 bytes at a time from the end, while there are enough
+    // characters left. The loop below compares the remaining ones.
+    const intptr_t kChunkSize = 32;
+    const intptr_t chars_per_chunk = kChunkSize >> scale;
+    Label chunk_loop, chunks_done;
+    __ Bind(&chunk_loop);
+    __ cmpq(RDI, Immediate(chars_per_chunk));
+    __ j(LESS, &chunks_done, Assembler::kNearJump);
+    __ subq(RDI, Immediate(chars_per_chunk));
+    __ vmovdqu(YMM0, FieldAddress(RAX, RDI, scale, data_offset));
+    __ vpcmpeqb(YMM0, YMM0, FieldAddress(RCX, RDI, scale, data_offset));
+    // All the 32 bits of the mask are set if all the bytes are equal.
+    __ vpmovmskb(RBX, YMM0);
+    __ cmpl(RBX, Immediate(-1));
+    __ j(EQUAL, &chunk_loop, Assembler::kNearJump);
+    __ vzeroupper();
+    __ jmp(&is_false);
+    __ Bind(&chunks_done);
+    __ vzeroupper();
+  }
   __ Bind(&loop);
   __ decq(RDI);
   __ cmpq(RDI, Immediate(0));
   __ j(LESS, &is_true, Assembler::kNearJump);
-  if (string_cid == kOneByteStringCid) {
-    __ movzxb(RBX, FieldAddress(RAX, RDI, TIMES_1,
-                                target::OneByteString::data_offset()));
-    __ movzxb(RDX, FieldAddress(RCX, RDI, TIMES_1,
-                                target::OneByteString::data_offset()));
-  } else if (string_cid == kTwoByteStringCid) {
-    __ movzxw(RBX, FieldAddress(RAX, RDI, TIMES_2,
-                                target::TwoByteString::data_offset()));
-    __ movzxw(RDX, FieldAddress(RCX, RDI, TIMES_2,
-                                target::TwoByteString::data_offset()));
+  if (is_one_byte) {
+    __ movzxb(RBX, FieldAddress(RAX, RDI, scale, data_offset));
+    __ movzxb(RDX, FieldAddress(RCX, RDI, scale, data_offset));
   } else {
-    UNIMPLEMENTED();
+    __ movzxw(RBX, FieldAddress(RAX, RDI, scale, data_offset));
+    __ movzxw(RDX, FieldAddress(RCX, RDI, scale, data_offset));
   }
   __ cmpq(RBX, RDX);
   __ j(NOT_EQUAL, &is_false, Assembler::kNearJump);
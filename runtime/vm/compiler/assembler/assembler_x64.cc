@@ -481,6 +481,42 @@ void Assembler::CmpPS(XmmRegister dst, XmmRegister src, int condition) {
   EmitUint8(condition);
 }
 
+void Assembler::EmitVex(int reg,
+                        int vvvv,
+                        const Operand& operand,
+                        int opcode,
+                        VexPrefix prefix,
+                        VexOpcodeMap map,
+                        VexLength length) {
+  ASSERT(reg <= XMM15);
+  ASSERT(vvvv <= XMM15);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The R, X, B and vvvv fields are stored inverted.
+  const uint8_t r = (reg > 7) ? 0 : 0x80;
+  const uint8_t x = ((operand.rex() & REX_X) != 0) ? 0 : 0x40;
+  const uint8_t b = ((operand.rex() & REX_B) != 0) ? 0 : 0x20;
+  const uint8_t last = ((~vvvv & 0xF) << 3) | (length << 2) | prefix;
+  if ((map == kVex0F) && (x != 0) && (b != 0)) {
+    // The two byte form implies the 0F map, W = 0, X and B.
+    EmitUint8(0xC5);
+    EmitUint8(r | last);
+  } else {
+    // W is always 0 for the instructions we emit.
+    EmitUint8(0xC4);
+    EmitUint8(r | x | b | map);
+    EmitUint8(last);
+  }
+  EmitUint8(opcode);
+  EmitOperand(reg & 7, operand);
+}
+
+void Assembler::vzeroupper() {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0xC5);
+  EmitUint8(0xF8);
+  EmitUint8(0x77);
+}
+
 void Assembler::set1ps(XmmRegister dst, Register tmp1, const Immediate& imm) {
   // Load 32-bit immediate value into tmp1.
   movl(tmp1, imm);
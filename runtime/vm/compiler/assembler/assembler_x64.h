@@ -455,6 +455,46 @@ class Assembler : public AssemblerBase {
   XMM_CONDITIONAL_CODES(DECLARE_CMPPS)
 #undef DECLARE_CMPPS
 
+  // AVX instructions, in their VEX encoding. The three operand forms compute
+  // dst = src1 op src2 and leave both sources unchanged. Instructions on XMM
+  // registers clear the upper half of the YMM register. Code using the upper
+  // halves of the YMM registers must call vzeroupper before returning to SSE
+  // code, which would otherwise be slowed down by transition penalties.
+  // Callers must check TargetCPUFeatures::avx_supported() (resp.
+  // avx2_supported() for the integer operations on YMM registers).
+#define DECLARE_VEX_ALU(name, code)                                            \
+  void v##name##ps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexNoPrefix, kVex0F, kVex128);      \
+  }                                                                            \
+  void v##name##pd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVex66, kVex0F, kVex128);            \
+  }                                                                            \
+  void v##name##ps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexNoPrefix, kVex0F, kVex256);      \
+  }                                                                            \
+  void v##name##pd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVex66, kVex0F, kVex256);            \
+  }
+  XMM_VEX_ALU_CODES(DECLARE_VEX_ALU)
+#undef DECLARE_VEX_ALU
+
+  void vmovdqu(YmmRegister dst, const Address& src) {
+    EmitVex(dst, 0, src, 0x6F, kVexF3, kVex0F, kVex256);
+  }
+  void vmovdqu(const Address& dst, YmmRegister src) {
+    EmitVex(src, 0, dst, 0x7F, kVexF3, kVex0F, kVex256);
+  }
+  void vpcmpeqb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+    EmitVex(dst, src1, src2, 0x74, kVex66, kVex0F, kVex256);
+  }
+  void vpcmpeqb(YmmRegister dst, YmmRegister src1, const Address& src2) {
+    EmitVex(dst, src1, src2, 0x74, kVex66, kVex0F, kVex256);
+  }
+  void vpmovmskb(Register dst, YmmRegister src) {
+    EmitVex(dst, 0, src, 0xD7, kVex66, kVex0F, kVex256);
+  }
+  void vzeroupper();
+
 #define DECLARE_SIMPLE(name, opcode)                                           \
   void name() { EmitSimple(opcode); }
   X86_ZERO_OPERAND_1_BYTE_INSTRUCTIONS(DECLARE_SIMPLE)
@@ -1058,6 +1098,32 @@ class Assembler : public AssemblerBase {
              int prefix1 = -1);
   void CmpPS(XmmRegister dst, XmmRegister src, int condition);
 
+  // The implied legacy prefix (pp), opcode map (m-mmmm) and vector length
+  // (L) fields of the VEX prefix.
+  enum VexPrefix { kVexNoPrefix = 0, kVex66 = 1, kVexF3 = 2, kVexF2 = 3 };
+  enum VexOpcodeMap { kVex0F = 1, kVex0F38 = 2, kVex0F3A = 3 };
+  enum VexLength { kVex128 = 0, kVex256 = 1 };
+
+  // Emits a VEX encoded instruction with [reg] in ModRM.reg, [vvvv] as the
+  // additional source register and [operand] in ModRM.rm.
+  void EmitVex(int reg,
+               int vvvv,
+               const Operand& operand,
+               int opcode,
+               VexPrefix prefix,
+               VexOpcodeMap map,
+               VexLength length);
+  void EmitVex(int reg,
+               int vvvv,
+               int rm,
+               int opcode,
+               VexPrefix prefix,
+               VexOpcodeMap map,
+               VexLength length) {
+    EmitVex(reg, vvvv, Operand(static_cast<Register>(rm)), opcode, prefix, map,
+            length);
+  }
+
   inline void EmitUint8(uint8_t value);
   inline void EmitInt32(int32_t value);
   inline void EmitUInt32(uint32_t value);
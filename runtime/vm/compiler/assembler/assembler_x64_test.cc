@@ -3344,6 +3344,100 @@ ASSEMBLER_TEST_RUN(PackedDoubleSub, test) {
       "ret\n");
 }
 
+ASSEMBLER_TEST_GENERATE(VexPackedDoubleAdd, assembler) {
+  static const struct ALIGN16 {
+    double a;
+    double b;
+  } constant0 = {1.0, 2.0};
+  static const struct ALIGN16 {
+    double a;
+    double b;
+  } constant1 = {3.0, 4.0};
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&constant0)));
+  __ movups(XMM10, Address(RAX, 0));
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&constant1)));
+  __ movups(XMM11, Address(RAX, 0));
+  __ vaddpd(XMM0, XMM10, XMM11);
+  __ vmulpd(XMM1, XMM0, XMM10);
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(VexPackedDoubleAdd, test) {
+  if (!HostCPUFeatures::avx_supported()) {
+    return;
+  }
+  typedef double (*VexPackedDoubleAdd)();
+  double res = reinterpret_cast<VexPackedDoubleAdd>(test->entry())();
+  EXPECT_FLOAT_EQ(4.0, res, 0.000001f);
+  EXPECT_DISASSEMBLY_ENDS_WITH(
+      "movups xmm11,[rax]\n"
+      "vaddpd xmm0,xmm10,xmm11\n"
+      "vmulpd xmm1,xmm0,xmm10\n"
+      "ret\n");
+}
+
+static float vex_packed_float_result[8];
+
+ASSEMBLER_TEST_GENERATE(VexPackedFloatMul256, assembler) {
+  static const float constant0[8] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+  static const float constant1[8] = {2.0, 2.0, 2.0, 2.0, 3.0, 3.0, 3.0, 3.0};
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&constant0)));
+  __ movq(R8, Immediate(reinterpret_cast<uword>(&constant1)));
+  __ vmovdqu(YMM1, Address(RAX, 0));
+  __ vmovdqu(YMM9, Address(R8, 0));
+  __ vmulps(YMM0, YMM1, YMM9);
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&vex_packed_float_result)));
+  __ vmovdqu(Address(RAX, 0), YMM0);
+  __ vzeroupper();
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(VexPackedFloatMul256, test) {
+  if (!HostCPUFeatures::avx_supported()) {
+    return;
+  }
+  typedef float (*VexPackedFloatMul256)();
+  float res = reinterpret_cast<VexPackedFloatMul256>(test->entry())();
+  EXPECT_FLOAT_EQ(2.0f, res, 0.000001f);
+  EXPECT_FLOAT_EQ(15.0f, vex_packed_float_result[4], 0.000001f);
+  EXPECT_FLOAT_EQ(24.0f, vex_packed_float_result[7], 0.000001f);
+  EXPECT_DISASSEMBLY_ENDS_WITH(
+      "vmovdqu ymm1,[rax]\n"
+      "vmovdqu ymm9,[r8]\n"
+      "vmulps ymm0,ymm1,ymm9\n"
+      "movq rax,0x...\n"
+      "vmovdqu [rax],ymm0\n"
+      "vzeroupper\n"
+      "ret\n");
+}
+
+ASSEMBLER_TEST_GENERATE(VexCompareBytes, assembler) {
+  static const char kBytes0[] = "abcdefghijklmnopqrstuvwxyz012345";
+  static const char kBytes1[] = "abcdeFghijklmnopqrstuvwxyz012345";
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&kBytes0)));
+  __ movq(R8, Immediate(reinterpret_cast<uword>(&kBytes1)));
+  __ vmovdqu(YMM0, Address(RAX, 0));
+  __ vpcmpeqb(YMM0, YMM0, Address(R8, 0));
+  __ vpmovmskb(RAX, YMM0);
+  __ vzeroupper();
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(VexCompareBytes, test) {
+  if (!HostCPUFeatures::avx2_supported()) {
+    return;
+  }
+  typedef int64_t (*VexCompareBytes)();
+  // Only the bit of the sixth byte is cleared.
+  EXPECT_EQ(0xFFFFFFDF, reinterpret_cast<VexCompareBytes>(test->entry())());
+  EXPECT_DISASSEMBLY_ENDS_WITH(
+      "vmovdqu ymm0,[rax]\n"
+      "vpcmpeqb ymm0,ymm0,[r8]\n"
+      "vpmovmskb rax,ymm0\n"
+      "vzeroupper\n"
+      "ret\n");
+}
+
 static void EnterTestFrame(Assembler* assembler) {
   COMPILE_ASSERT(THR != CallingConventions::kArg1Reg);
   COMPILE_ASSERT(CODE_REG != CallingConventions::kArg2Reg);
@@ -235,6 +235,12 @@ static const char* xmm_regs[kMaxXmmRegisters] = {
     "xmm0", "xmm1", "xmm2",  "xmm3",  "xmm4",  "xmm5",  "xmm6",  "xmm7",
     "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15"};
 
+#if defined(TARGET_ARCH_X64)
+static const char* ymm_regs[kMaxXmmRegisters] = {
+    "ymm0", "ymm1", "ymm2",  "ymm3",  "ymm4",  "ymm5",  "ymm6",  "ymm7",
+    "ymm8", "ymm9", "ymm10", "ymm11", "ymm12", "ymm13", "ymm14", "ymm15"};
+#endif
+
 class DisassemblerX64 : public ValueObject {
  public:
   DisassemblerX64(char* buffer, intptr_t buffer_size)
@@ -325,6 +331,13 @@ class DisassemblerX64 : public ValueObject {
     return xmm_regs[reg];
   }
 
+#if defined(TARGET_ARCH_X64)
+  const char* NameOfYMMRegister(int reg) const {
+    ASSERT((0 <= reg) && (reg < kMaxXmmRegisters));
+    return ymm_regs[reg];
+  }
+#endif
+
   void Print(const char* format, ...) PRINTF_ATTRIBUTE(2, 3);
   void PrintJump(uint8_t* pc, int32_t disp);
   void PrintAddress(uint8_t* addr);
@@ -347,6 +360,9 @@ class DisassemblerX64 : public ValueObject {
   const char* TwoByteMnemonic(uint8_t opcode);
   int TwoByteOpcodeInstruction(uint8_t* data);
   int Print660F38Instruction(uint8_t* data);
+#if defined(TARGET_ARCH_X64)
+  int VexInstruction(uint8_t* data);
+#endif
 
   int F6F7Instruction(uint8_t* data);
   int ShiftInstruction(uint8_t* data);
@@ -1243,6 +1259,104 @@ int DisassemblerX64::Print660F38Instruction(uint8_t* current) {
   }
 }
 
+#if defined(TARGET_ARCH_X64)
+// Handle the AVX instructions, which start with a 0xC4 or 0xC5 VEX prefix.
+// Only the instructions emitted by the assembler are decoded.
+int DisassemblerX64::VexInstruction(uint8_t* data) {
+  uint8_t* current = data;
+  // The R, X, B and vvvv fields of the prefix are stored inverted.
+  int map, vvvv, length, prefix;
+  if (*current == 0xC5) {
+    const uint8_t byte1 = *(current + 1);
+    setRex(0x40 | ((~byte1 >> 5) & 0x04));
+    map = 1;  // 0x0F.
+    vvvv = (~byte1 >> 3) & 0xF;
+    length = (byte1 >> 2) & 1;
+    prefix = byte1 & 3;
+    current += 2;
+  } else {
+    ASSERT(*current == 0xC4);
+    const uint8_t byte1 = *(current + 1);
+    const uint8_t byte2 = *(current + 2);
+    setRex(0x40 | ((~byte1 >> 5) & 0x07) | ((byte2 >> 4) & 0x08));
+    map = byte1 & 0x1F;
+    vvvv = (~byte2 >> 3) & 0xF;
+    length = (byte2 >> 2) & 1;
+    prefix = byte2 & 3;
+    current += 3;
+  }
+  const uint8_t opcode = *current++;
+  if (map != 1) {
+    UnimplementedInstruction();
+    return current - data;
+  }
+  if (opcode == 0x77 && prefix == 0) {
+    Print("%s", length == 1 ? "vzeroall" : "vzeroupper");
+    return current - data;
+  }
+  const RegisterNameMapping register_name =
+      (length == 1) ? &DisassemblerX64::NameOfYMMRegister
+                    : &DisassemblerX64::NameOfXMMRegister;
+  int mod, regop, rm;
+  get_modrm(*current, &mod, &regop, &rm);
+  const char* mnemonic = NULL;
+  if ((opcode & 0xF0) == 0x50 && prefix <= 1) {
+    switch (opcode & 0xF) {
+      case 0x4:
+        mnemonic = "and";
+        break;
+      case 0x6:
+        mnemonic = "or";
+        break;
+      case 0x7:
+        mnemonic = "xor";
+        break;
+      case 0x8:
+        mnemonic = "add";
+        break;
+      case 0x9:
+        mnemonic = "mul";
+        break;
+      case 0xC:
+        mnemonic = "sub";
+        break;
+      case 0xD:
+        mnemonic = "min";
+        break;
+      case 0xE:
+        mnemonic = "div";
+        break;
+      case 0xF:
+        mnemonic = "max";
+        break;
+      default:
+        UnimplementedInstruction();
+    }
+    Print("v%s%s %s,%s,", mnemonic, (prefix == 1) ? "pd" : "ps",
+          (this->*register_name)(regop), (this->*register_name)(vvvv));
+    current += PrintRightOperandHelper(current, register_name);
+  } else if (opcode == 0x6F && prefix == 2) {
+    Print("vmovdqu %s,", (this->*register_name)(regop));
+    current += PrintRightOperandHelper(current, register_name);
+  } else if (opcode == 0x7F && prefix == 2) {
+    Print("vmovdqu ");
+    current += PrintRightOperandHelper(current, register_name);
+    Print(",%s", (this->*register_name)(regop));
+  } else if (opcode == 0x74 && prefix == 1) {
+    Print("vpcmpeqb %s,%s,", (this->*register_name)(regop),
+          (this->*register_name)(vvvv));
+    current += PrintRightOperandHelper(current, register_name);
+  } else if (opcode == 0xD7 && prefix == 1) {
+    Print("vpmovmskb %s,%s", NameOfCPURegister(regop),
+          (this->*register_name)(rm));
+    current++;
+  } else {
+    UnimplementedInstruction();
+  }
+  return current - data;
+}
+#endif  // defined(TARGET_ARCH_X64)
+
 // Handle all two-byte opcodes, which start with 0x0F.
 // These instructions may be affected by an 0x66, 0xF2, or 0xF3 prefix.
 // We do not use any three-byte opcodes, which start with 0x0F38 or 0x0F3A.
@@ -1659,6 +1773,14 @@ int DisassemblerX64::InstructionDecode(uword pc) {
         data += TwoByteOpcodeInstruction(data);
         break;
 
+#if defined(TARGET_ARCH_X64)
+      case 0xC4:
+        FALL_THROUGH;
+      case 0xC5:
+        data += VexInstruction(data);
+        break;
+#endif
+
       case 0x8F: {
         data++;
         int mod, regop, rm;
@@ -10,7 +10,9 @@
 #include "vm/compiler/backend/il.h"
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/backend/loops.h"
 #include "vm/compiler/compiler_pass.h"
+#include "vm/dart_entry.h"
 #include "vm/object.h"
 #include "vm/unit_test.h"
 
@@ -294,4 +296,158 @@ ISOLATE_UNIT_TEST_CASE(BCEListNamedAndPlainLength) {
   TestScriptJIT(kScriptChars, 2, 0);
 }
 
+#if defined(DART_PRECOMPILER)
+
+DECLARE_FLAG(bool, hoist_bounds_checks);
+DECLARE_FLAG(bool, unroll_loops);
+
+// Helper method to count number of bounds checks inside loops.
+static intptr_t CountBoundChecksInLoops(FlowGraph* flow_graph) {
+  flow_graph->ResetLoopHierarchy();
+  flow_graph->GetLoopHierarchy();
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    if (block_it.Current()->loop_info() == nullptr) {
+      continue;
+    }
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsCheckBoundBase()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// Helper method to compile foo with the AOT pipeline, with or without
+// bounds check hoisting, and count bounds checks inside and outside loops.
+// Loops are not unrolled, so that each check appears once.
+static std::pair<intptr_t, intptr_t> ApplyHoisting(const char* script_chars,
+                                                   bool hoist) {
+  SetFlagScope<bool> sfs(&FLAG_hoist_bounds_checks, hoist);
+  SetFlagScope<bool> sfs_unroll(&FLAG_unroll_loops, false);
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  const intptr_t num_bc = CountBoundChecks(flow_graph);
+  const intptr_t num_bc_in_loops = CountBoundChecksInLoops(flow_graph);
+  return {num_bc_in_loops, num_bc - num_bc_in_loops};
+}
+
+static void TestScriptAOTHoisting(const char* script_chars,
+                                  intptr_t expected_in_loops,
+                                  intptr_t expected_outside_loops) {
+  auto no_hoisting = ApplyHoisting(script_chars, /*hoist=*/false);
+  EXPECT_EQ(expected_in_loops + expected_outside_loops, no_hoisting.first);
+  EXPECT_EQ(0, no_hoisting.second);
+  auto hoisting = ApplyHoisting(script_chars, /*hoist=*/true);
+  EXPECT_EQ(expected_in_loops, hoisting.first);
+  EXPECT_EQ(expected_outside_loops, hoisting.second);
+}
+
+ISOLATE_UNIT_TEST_CASE(BCEHoistOtherLength) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      int foo(Uint8List a, Uint8List b) {
+        if (b.length == 0) return 0;
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+          sum += a[i] + b[i] + b[i + 1];
+        }
+        return sum;
+      }
+      main() {
+        foo(new Uint8List(10), new Uint8List(11));
+      }
+    )";
+  // The check of a[i] is redundant, and those of b[i] and b[i + 1] are
+  // performed after the loop instead.
+  TestScriptAOTHoisting(kScriptChars, 0, 2);
+}
+
+ISOLATE_UNIT_TEST_CASE(BCEHoistNotPastStore) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      void foo(Uint8List a, Uint8List b, Uint8List c) {
+        if (b.length == 0 || c.length == 0) return;
+        for (int i = 0; i < a.length; i++) {
+          b[i] = a[i];
+          c[i] = a[i];
+        }
+      }
+      main() {
+        foo(new Uint8List(10), new Uint8List(10), new Uint8List(10));
+      }
+    )";
+  // The check of c[i] must not be performed before the store to b[i].
+  TestScriptAOTHoisting(kScriptChars, 1, 1);
+}
+
+// Helper method to compile foo with the AOT pipeline, with or without bounds
+// check hoisting, call it with Uint8Lists of the given lengths and return
+// describe() of the error it throws.
+static const char* DescribeHoistingError(const char* script_chars,
+                                         const char* uri,
+                                         bool hoist,
+                                         intptr_t a_length,
+                                         intptr_t b_length) {
+  SetFlagScope<bool> sfs(&FLAG_hoist_bounds_checks, hoist);
+  const auto& root_library =
+      Library::Handle(LoadTestScript(script_chars, nullptr, uri));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  pipeline.RunPasses({});
+  pipeline.CompileGraphAndAttachFunction();
+
+  const auto& arguments = Array::Handle(Array::New(2));
+  arguments.SetAt(0, TypedData::Handle(TypedData::New(kTypedDataUint8ArrayCid,
+                                                      a_length)));
+  arguments.SetAt(1, TypedData::Handle(TypedData::New(kTypedDataUint8ArrayCid,
+                                                      b_length)));
+  auto& result = Object::Handle(DartEntry::InvokeFunction(function, arguments));
+  EXPECT(result.IsUnhandledException());
+  if (!result.IsUnhandledException()) {
+    return "";
+  }
+  const auto& describe_arguments = Array::Handle(Array::New(1));
+  describe_arguments.SetAt(
+      0, Instance::Handle(UnhandledException::Cast(result).exception()));
+  result = DartEntry::InvokeFunction(
+      Function::Handle(GetFunction(root_library, "describe")),
+      describe_arguments);
+  EXPECT(result.IsString());
+  return result.ToCString();
+}
+
+ISOLATE_UNIT_TEST_CASE(BCEHoistSameRangeError) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      int foo(Uint8List a, Uint8List b) {
+        if (b.length == 0) return 0;
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+          sum += a[i] + b[i] + b[i + 1];
+        }
+        return sum;
+      }
+      String describe(RangeError e) => '${e.invalidValue} ${e.end}';
+    )";
+  // b is one element too short, so b[i + 1] fails in the last iteration,
+  // which the hoisted checks run after the loop instead.
+  EXPECT_STREQ("10 9",
+               DescribeHoistingError(kScriptChars, "file:///no-hoisting.dart",
+                                     /*hoist=*/false, 10, 10));
+  EXPECT_STREQ("10 9",
+               DescribeHoistingError(kScriptChars, "file:///hoisting.dart",
+                                     /*hoist=*/true, 10, 10));
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
 }  // namespace dart
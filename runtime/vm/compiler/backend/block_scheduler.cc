@@ -72,6 +72,14 @@ void BlockScheduler::AssignEdgeWeights(FlowGraph* flow_graph) {
   }
   Array& edge_counters = Array::Handle();
   edge_counters ^= ic_data_array.At(0);
+  AssignEdgeWeights(flow_graph, edge_counters);
+}
+
+void BlockScheduler::AssignEdgeWeights(FlowGraph* flow_graph,
+                                       const Array& edge_counters) {
+  if (!FLAG_reorder_basic_blocks) {
+    return;
+  }
 
   auto graph_entry = flow_graph->graph_entry();
   BlockEntryInstr* entry = graph_entry->normal_entry();
@@ -282,18 +290,29 @@ void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
     }
   }
 
-  // Emit code in reverse postorder but move any throwing blocks (except the
-  // function entry, which needs to come first) to the very end.
+  // If type feedback gave the edges weights, chain the blocks along the
+  // hottest edges as in JIT mode. Otherwise keep the reverse postorder.
   auto codegen_order = flow_graph->CodegenBlockOrder(true);
+  GrowableArray<BlockEntryInstr*> order(block_count);
+  if (flow_graph->graph_entry()->entry_count() > 0) {
+    ReorderBlocksJIT(flow_graph);
+    order.AddArray(*codegen_order);
+    codegen_order->Clear();
+  } else {
+    order.AddArray(reverse_postorder);
+  }
+
+  // Emit code in that order but move any throwing blocks (except the
+  // function entry, which needs to come first) to the very end.
   for (intptr_t i = 0; i < block_count; ++i) {
-    auto block = reverse_postorder[i];
+    auto block = order[i];
     const intptr_t preorder_nr = block->preorder_number();
     if (!is_terminating[preorder_nr] || block->IsFunctionEntry()) {
       codegen_order->Add(block);
     }
   }
   for (intptr_t i = 0; i < block_count; ++i) {
-    auto block = reverse_postorder[i];
+    auto block = order[i];
     const intptr_t preorder_nr = block->preorder_number();
     if (is_terminating[preorder_nr] && !block->IsFunctionEntry()) {
       codegen_order->Add(block);
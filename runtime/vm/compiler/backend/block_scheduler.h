@@ -13,11 +13,16 @@
 
 namespace dart {
 
+class Array;
 class FlowGraph;
 
 class BlockScheduler : public AllStatic {
  public:
   static void AssignEdgeWeights(FlowGraph* flow_graph);
+  // Assigns edge weights from |edge_counters|, which are indexed by block
+  // preorder number like those in a function's ic_data_array.
+  static void AssignEdgeWeights(FlowGraph* flow_graph,
+                                const Array& edge_counters);
   static void ReorderBlocks(FlowGraph* flow_graph);
 
  private:
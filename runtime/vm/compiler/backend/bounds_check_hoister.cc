@@ -0,0 +1,362 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/bounds_check_hoister.h"
+
+#include "vm/compiler/backend/branch_optimizer.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            hoist_bounds_checks,
+            true,
+            "Hoist the bounds checks of counted loops in AOT code.");
+DEFINE_FLAG(bool,
+            trace_bounds_check_hoisting,
+            false,
+            "Trace bounds check hoisting.");
+
+// The largest distance between the index of a hoisted check and the loop
+// counter. Keeps length - offset well within the Smi range.
+static const int64_t kMaxOffset = 64;
+
+BoundsCheckHoister::BoundsCheckHoister(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph),
+      zone_(flow_graph->zone()),
+      counter_(nullptr),
+      bound_(nullptr),
+      adjust_(0),
+      pre_header_goto_(nullptr) {}
+
+bool BoundsCheckHoister::Optimize() {
+  if (!FLAG_hoist_bounds_checks) {
+    return false;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph_->GetLoopHierarchy();
+  loop_hierarchy.ComputeInduction();
+
+  // Hoisting adds blocks after a loop but does not change the blocks of the
+  // other loops, so all loops are handled before the block order is
+  // recomputed.
+  bool changed = false;
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    LoopInfo* loop = headers[i]->loop_info();
+    if (CanHoist(loop)) {
+      Hoist(loop);
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    flow_graph_->DiscoverBlocks();
+    GrowableArray<BitVector*> dominance_frontier;
+    flow_graph_->ComputeDominators(&dominance_frontier);
+  }
+  return changed;
+}
+
+static bool IsInvariant(LoopInfo* loop, Definition* def) {
+  return !loop->Contains(def->GetBlock());
+}
+
+// Returns true if [instr] can be executed in an iteration that ends up
+// throwing at one of its bounds checks without any visible difference.
+static bool IsEffectFree(Instruction* instr) {
+  if ((instr->AsDefinition() == nullptr) || instr->MayThrow() ||
+      instr->HasUnknownSideEffects()) {
+    return false;
+  }
+  return instr->AllowsCSE() || instr->IsLoadIndexed() ||
+         instr->IsLoadField() || instr->IsLoadUntagged() ||
+         instr->IsLoadCodeUnits() || instr->IsRedefinition();
+}
+
+// Returns true if the index of [check] is [counter_start] + [offset] when the
+// counter of [loop] is [counter_start], and can be checked after the loop.
+static bool IsHoistable(LoopInfo* loop,
+                        GenericCheckBoundInstr* check,
+                        int64_t counter_start,
+                        int64_t* offset) {
+  if (!IsInvariant(loop, check->length()->definition())) {
+    return false;
+  }
+  int64_t stride = 0;
+  int64_t initial = 0;
+  InductionVar* index = loop->LookupInduction(
+      check->index()
+          ->definition()
+          ->OriginalDefinitionIgnoreBoxingAndConstraints());
+  if (!InductionVar::IsLinear(index, &stride) || (stride != 1) ||
+      !InductionVar::IsConstant(index->initial(), &initial)) {
+    return false;
+  }
+  *offset = initial - counter_start;
+  return (*offset >= -kMaxOffset) && (*offset <= kMaxOffset) &&
+         (counter_start + *offset >= 0);
+}
+
+Definition* BoundsCheckHoister::TaggedBound(Definition* def) {
+  // A tagged bound is compared as a Smi.
+  if (def->representation() == kTagged) {
+    return def;
+  }
+  if (ConstantInstr* constant = def->AsConstant()) {
+    if (constant->value().IsSmi()) {
+      return flow_graph_->GetConstant(constant->value());
+    }
+    return nullptr;
+  }
+  // Lengths are unboxed from Smis.
+  if (UnboxInt64Instr* unbox = def->AsUnboxInt64()) {
+    Definition* value = unbox->value()->definition();
+    if (value->Type()->ToCid() == kSmiCid) {
+      return value;
+    }
+  }
+  return nullptr;
+}
+
+bool BoundsCheckHoister::CanHoist(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if ((header == nullptr) || header->InsideTryBlock() ||
+      (header->PredecessorCount() != 2) || (loop->back_edges().length() != 1)) {
+    return false;
+  }
+
+  // The loop consists of the header and a single body block.
+  TargetEntryInstr* body = loop->back_edges()[0]->AsTargetEntry();
+  if ((body == nullptr) || (body->PredecessorAt(0) != header)) {
+    return false;
+  }
+  const intptr_t back_index = header->IndexOfPredecessor(body);
+  pre_header_goto_ =
+      header->PredecessorAt(1 - back_index)->last_instruction()->AsGoto();
+  if (pre_header_goto_ == nullptr) {
+    return false;
+  }
+
+  // The header only tests counter < n or counter <= n, and stays in the loop
+  // when it holds.
+  for (Instruction* instr = header->next(); instr != header->last_instruction();
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow()) {
+      return false;
+    }
+  }
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if ((branch == nullptr) || (branch->true_successor() != body)) {
+    return false;
+  }
+  RelationalOpInstr* test = branch->comparison()->AsRelationalOp();
+  if ((test == nullptr) || ((test->operation_cid() != kSmiCid) &&
+                            (test->operation_cid() != kMintCid))) {
+    return false;
+  }
+  switch (test->kind()) {
+    case Token::kLT:
+      adjust_ = 0;
+      break;
+    case Token::kLTE:
+      adjust_ = 1;
+      break;
+    default:
+      return false;
+  }
+  if (!IsInvariant(loop, test->right()->definition())) {
+    return false;
+  }
+  bound_ = TaggedBound(test->right()->definition());
+  if (bound_ == nullptr) {
+    return false;
+  }
+
+  // The counter counts up by one from a non-negative constant, so that an
+  // index close to it is valid as long as it is below a length.
+  counter_ = test->left()->definition()->AsPhi();
+  if ((counter_ == nullptr) || (counter_->block() != header)) {
+    return false;
+  }
+  int64_t stride = 0;
+  int64_t start = 0;
+  InductionVar* induction = loop->LookupInduction(counter_);
+  if (!InductionVar::IsLinear(induction, &stride) || (stride != 1) ||
+      !InductionVar::IsConstant(induction->initial(), &start) || (start < 0)) {
+    return false;
+  }
+
+  // Collect the checks of indices i + offset that the body performs before
+  // anything with a visible effect. Checks that the loop test already
+  // proves redundant are collected as well: they are removed here, as range
+  // analysis would, since the stronger loop test no longer proves them.
+  candidates_.Clear();
+  redundant_.Clear();
+  bool is_prefix = true;
+  for (Instruction* instr = body->next(); instr != body->last_instruction();
+       instr = instr->next()) {
+    GenericCheckBoundInstr* check = instr->AsGenericCheckBound();
+    if (check == nullptr) {
+      is_prefix = is_prefix && IsEffectFree(instr);
+      continue;
+    }
+    if (loop->IsInRange(check, check->index(), check->length())) {
+      redundant_.Add(check);
+      continue;
+    }
+    if (!is_prefix) {
+      continue;
+    }
+    int64_t offset = 0;
+    if (IsHoistable(loop, check, start, &offset)) {
+      Candidate candidate = {check, offset};
+      candidates_.Add(candidate);
+    } else {
+      is_prefix = false;
+    }
+  }
+  return !candidates_.is_empty();
+}
+
+void BoundsCheckHoister::CopyEnvironment(Instruction* from,
+                                         Instruction* to) const {
+  if (from->env() == nullptr) {
+    to->CopyDeoptIdFrom(*from);
+    return;
+  }
+  to->InheritDeoptTarget(zone_, from);
+}
+
+TargetEntryInstr* BoundsCheckHoister::NewExit(JoinEntryInstr* join) {
+  TargetEntryInstr* target = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), join->try_index(), DeoptId::kNone);
+  CopyEnvironment(join, target);
+  GotoInstr* jump = new (zone_) GotoInstr(join, DeoptId::kNone);
+  CopyEnvironment(join, jump);
+  target->LinkTo(jump);
+  target->set_last_instruction(jump);
+  return target;
+}
+
+void BoundsCheckHoister::Hoist(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  RelationalOpInstr* test = branch->comparison()->AsRelationalOp();
+
+  if (FLAG_trace_bounds_check_hoisting) {
+    THR_Print("Hoisting %" Pd " bounds checks of loop B%" Pd " in %s\n",
+              candidates_.length(), header->block_id(),
+              flow_graph_->function().ToFullyQualifiedCString());
+  }
+
+  // The loop runs while the counter is below the bound of the loop and
+  // below length - offset for all the checks, computed in the pre-header.
+  Definition* limit = bound_;
+  for (intptr_t i = 0; i < candidates_.length(); ++i) {
+    Definition* length = candidates_[i].check->length()->definition();
+    const int64_t delta = candidates_[i].offset + adjust_;
+    if (delta != 0) {
+      BinarySmiOpInstr* sub = new (zone_) BinarySmiOpInstr(
+          Token::kSUB, new (zone_) Value(length),
+          new (zone_) Value(flow_graph_->GetConstant(
+              Smi::ZoneHandle(zone_, Smi::New(delta)))),
+          DeoptId::kNone);
+      sub->set_can_overflow(false);
+      flow_graph_->InsertBefore(pre_header_goto_, sub, nullptr,
+                                FlowGraph::kValue);
+      length = sub;
+    }
+    MathMinMaxInstr* min = new (zone_)
+        MathMinMaxInstr(MethodRecognizer::kMathMin, new (zone_) Value(limit),
+                        new (zone_) Value(length), DeoptId::kNone, kSmiCid);
+    flow_graph_->InsertBefore(pre_header_goto_, min, nullptr,
+                              FlowGraph::kValue);
+    limit = min;
+  }
+  if (test->operation_cid() == kMintCid) {
+    UnboxInstr* unbox =
+        UnboxInstr::Create(kUnboxedInt64, new (zone_) Value(limit),
+                           DeoptId::kNone, Instruction::kNotSpeculative);
+    flow_graph_->InsertBefore(pre_header_goto_, unbox, nullptr,
+                              FlowGraph::kValue);
+    limit = unbox;
+  }
+
+  // After the loop, the original test tells whether it left early.
+  ComparisonInstr* exit_test = test->CopyWithNewOperands(
+      new (zone_) Value(counter_),
+      new (zone_) Value(test->right()->definition()));
+  test->right()->BindTo(limit);
+
+  JoinEntryInstr* join =
+      BranchSimplifier::ToJoinEntry(zone_, branch->false_successor());
+  TargetEntryInstr* test_entry = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), join->try_index(), DeoptId::kNone);
+  CopyEnvironment(join, test_entry);
+  BranchInstr* exit_branch = new (zone_) BranchInstr(exit_test, DeoptId::kNone);
+  CopyEnvironment(branch, exit_branch);
+  flow_graph_->AppendTo(test_entry, exit_branch, nullptr, FlowGraph::kEffect);
+  test_entry->set_last_instruction(exit_branch);
+  *branch->false_successor_address() = test_entry;
+
+  // If it did, one of the checks fails: perform them in their original
+  // order, with their original index.
+  TargetEntryInstr* check_exit = NewExit(join);
+  Instruction* jump = check_exit->last_instruction();
+  for (intptr_t i = 0; i < candidates_.length(); ++i) {
+    GenericCheckBoundInstr* check = candidates_[i].check;
+    Definition* index = counter_;
+    if ((candidates_[i].offset != 0) ||
+        (counter_->representation() != kTagged)) {
+      if (index->representation() == kTagged) {
+        index = UnboxInstr::Create(kUnboxedInt64, new (zone_) Value(index),
+                                   DeoptId::kNone,
+                                   Instruction::kNotSpeculative);
+        flow_graph_->InsertBefore(jump, index, nullptr, FlowGraph::kValue);
+      }
+      if (candidates_[i].offset != 0) {
+        Definition* offset = UnboxInstr::Create(
+            kUnboxedInt64,
+            new (zone_) Value(flow_graph_->GetConstant(
+                Smi::ZoneHandle(zone_, Smi::New(candidates_[i].offset)))),
+            DeoptId::kNone, Instruction::kNotSpeculative);
+        flow_graph_->InsertBefore(jump, offset, nullptr, FlowGraph::kValue);
+        index = new (zone_) BinaryInt64OpInstr(
+            Token::kADD, new (zone_) Value(index), new (zone_) Value(offset),
+            DeoptId::kNone, Instruction::kNotSpeculative);
+        flow_graph_->InsertBefore(jump, index, nullptr, FlowGraph::kValue);
+      }
+      index = BoxInstr::Create(kUnboxedInt64, new (zone_) Value(index));
+      flow_graph_->InsertBefore(jump, index, nullptr, FlowGraph::kValue);
+    }
+    GenericCheckBoundInstr* exit_check = new (zone_) GenericCheckBoundInstr(
+        new (zone_) Value(check->length()->definition()),
+        new (zone_) Value(index), check->deopt_id());
+    if (check->has_inlining_id()) {
+      exit_check->set_inlining_id(check->inlining_id());
+    }
+    flow_graph_->InsertBefore(jump, exit_check, join->env(),
+                              FlowGraph::kValue);
+  }
+  *exit_branch->true_successor_address() = check_exit;
+  *exit_branch->false_successor_address() = NewExit(join);
+
+  // The checks of the body now always pass.
+  for (intptr_t i = 0; i < candidates_.length(); ++i) {
+    GenericCheckBoundInstr* check = candidates_[i].check;
+    check->ReplaceUsesWith(check->index()->definition());
+    check->RemoveFromGraph();
+  }
+  for (intptr_t i = 0; i < redundant_.length(); ++i) {
+    GenericCheckBoundInstr* check = redundant_[i];
+    check->ReplaceUsesWith(check->index()->definition());
+    check->RemoveFromGraph();
+  }
+}
+
+}  // namespace dart
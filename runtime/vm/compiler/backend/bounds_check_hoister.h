@@ -0,0 +1,89 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_BOUNDS_CHECK_HOISTER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_BOUNDS_CHECK_HOISTER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/compiler/backend/il.h"
+
+namespace dart {
+
+class FlowGraph;
+class LoopInfo;
+
+// Hoists the bounds checks of counted loops out of the loop in AOT code,
+// where they cannot deoptimize and so cannot be generalized by range
+// analysis. In a loop such as
+//
+//   for (int i = 0; i < n; i++) sum += a[i + 1];
+//
+// the check of i + 1 against the length of a always passes as long as
+// i < length - 1. The loop test is strengthened to
+//
+//   i < min(n, length - 1)
+//
+// computed in the pre-header, and the check is removed from the body. When
+// the loop leaves early, the original test still holds, and the check that
+// failed in the next iteration is performed at the exit instead:
+//
+//          header: i = phi(i0, i'), CheckStackOverflow, i < limit --> exit'
+//          body without the checks
+//
+//          exit': i < n ? check(length, i + 1) : (nothing) --> exit
+//
+// Only checks that the body performs before anything with a visible effect
+// are hoisted, so that throwing at the exit is not observably different
+// from throwing in the next iteration. They are performed at the exit in
+// their original order, with the same index and length, and so report
+// exactly the same error.
+class BoundsCheckHoister : public ValueObject {
+ public:
+  explicit BoundsCheckHoister(FlowGraph* flow_graph);
+
+  // Returns true if the bounds checks of any loop were hoisted.
+  bool Optimize();
+
+ private:
+  // A bounds check of the body with index i + offset, where i is the loop
+  // counter.
+  struct Candidate {
+    GenericCheckBoundInstr* check;
+    int64_t offset;
+  };
+
+  bool CanHoist(LoopInfo* loop);
+  void Hoist(LoopInfo* loop);
+
+  // Returns the tagged Smi value of the bound [def] of the loop test, or
+  // nullptr if it is not known to be a Smi.
+  Definition* TaggedBound(Definition* def);
+
+  // Gives [to] the deopt id of [from] and a copy of its environment.
+  void CopyEnvironment(Instruction* from, Instruction* to) const;
+
+  // Returns a new block jumping to [join], with the environment of [join].
+  TargetEntryInstr* NewExit(JoinEntryInstr* join);
+
+  FlowGraph* const flow_graph_;
+  Zone* const zone_;
+
+  // The state of the loop being hoisted, collected by CanHoist.
+  GrowableArray<Candidate> candidates_;
+  GrowableArray<GenericCheckBoundInstr*> redundant_;
+  PhiInstr* counter_;
+  Definition* bound_;
+  int64_t adjust_;
+  GotoInstr* pre_header_goto_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoundsCheckHoister);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_BOUNDS_CHECK_HOISTER_H_
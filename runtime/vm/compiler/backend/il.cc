@@ -917,6 +917,25 @@ AllocateUninitializedContextInstr::AllocateUninitializedContextInstr(
   ASSERT(!CompilerState::Current().is_aot());
 }
 
+MaterializeObjectInstr::MaterializeObjectInstr(
+    AllocateContextInstr* allocation,
+    const ZoneGrowableArray<const Slot*>& slots,
+    ZoneGrowableArray<Value*>* values)
+    : allocation_(allocation),
+      cls_(Class::ZoneHandle(Object::context_class())),
+      num_variables_(allocation->num_context_variables()),
+      slots_(slots),
+      values_(values),
+      locations_(NULL),
+      visited_for_liveness_(false),
+      registers_remapped_(false) {
+  ASSERT(slots_.length() == values_->length());
+  for (intptr_t i = 0; i < InputCount(); i++) {
+    InputAt(i)->set_instruction(this);
+    InputAt(i)->set_use_index(i);
+  }
+}
+
 bool StoreInstanceFieldInstr::IsUnboxedStore() const {
   return slot().IsDartField() &&
          FlowGraphCompiler::IsUnboxedField(slot().field());
@@ -1033,12 +1052,37 @@ bool BinaryIntegerOpInstr::AttributesEqual(Instruction* other) const {
          (is_truncating() == other_op->is_truncating());
 }
 
+Instruction* BinaryIntegerOpInstr::Clone(Zone* zone) const {
+  // The range of the copy depends on its inputs, so it is left to range
+  // analysis.
+  return BinaryIntegerOpInstr::Make(
+      representation(), op_kind(), left()->Copy(zone), right()->Copy(zone),
+      GetDeoptId(), can_overflow(), is_truncating(), /*range=*/nullptr,
+      SpeculativeModeOfInputs());
+}
+
+Instruction* BinaryInt64OpInstr::Clone(Zone* zone) const {
+  return new (zone) BinaryInt64OpInstr(op_kind(), left()->Copy(zone),
+                                       right()->Copy(zone), GetDeoptId(),
+                                       speculative_mode_);
+}
+
 bool LoadFieldInstr::AttributesEqual(Instruction* other) const {
   LoadFieldInstr* other_load = other->AsLoadField();
   ASSERT(other_load != NULL);
   return &this->slot_ == &other_load->slot_;
 }
 
+Instruction* LoadFieldInstr::Clone(Zone* zone) const {
+  ASSERT(CanClone());
+  return new (zone) LoadFieldInstr(instance()->Copy(zone), slot(), token_pos(),
+                                   /*calls_initializer=*/false, GetDeoptId());
+}
+
+Instruction* LoadUntaggedInstr::Clone(Zone* zone) const {
+  return new (zone) LoadUntaggedInstr(object()->Copy(zone), offset());
+}
+
 bool LoadStaticFieldInstr::AttributesEqual(Instruction* other) const {
   ASSERT(IsFieldInitialized());
   return field().raw() == other->AsLoadStaticField()->field().raw();
@@ -2146,6 +2190,12 @@ Definition* BinaryDoubleOpInstr::Canonicalize(FlowGraph* flow_graph) {
   return this;
 }
 
+Instruction* BinaryDoubleOpInstr::Clone(Zone* zone) const {
+  return new (zone)
+      BinaryDoubleOpInstr(op_kind(), left()->Copy(zone), right()->Copy(zone),
+                          GetDeoptId(), token_pos(), speculative_mode_);
+}
+
 Definition* DoubleTestOpInstr::Canonicalize(FlowGraph* flow_graph) {
   return HasUses() ? this : NULL;
 }
@@ -3151,6 +3201,15 @@ Definition* UnboxInt64Instr::Canonicalize(FlowGraph* flow_graph) {
   return this;
 }
 
+Instruction* IntConverterInstr::Clone(Zone* zone) const {
+  IntConverterInstr* converter = new (zone)
+      IntConverterInstr(from(), to(), value()->Copy(zone), GetDeoptId());
+  if (is_truncating()) {
+    converter->mark_truncating();
+  }
+  return converter;
+}
+
 Definition* IntConverterInstr::Canonicalize(FlowGraph* flow_graph) {
   if (!HasUses()) return NULL;
 
@@ -3648,6 +3707,20 @@ UnboxInstr* UnboxInstr::Create(Representation to,
   }
 }
 
+Instruction* BoxInstr::Clone(Zone* zone) const {
+  return BoxInstr::Create(from_representation(), value()->Copy(zone));
+}
+
+Instruction* UnboxInstr::Clone(Zone* zone) const {
+  UnboxInstr* unbox = UnboxInstr::Create(representation(), value()->Copy(zone),
+                                         GetDeoptId(), speculative_mode_);
+  const UnboxIntegerInstr* unbox_integer = AsUnboxInteger();
+  if ((unbox_integer != nullptr) && unbox_integer->is_truncating()) {
+    unbox->AsUnboxInteger()->mark_truncating();
+  }
+  return unbox;
+}
+
 bool UnboxInstr::CanConvertSmi() const {
   switch (representation()) {
     case kUnboxedDouble:
@@ -5546,6 +5619,16 @@ bool CheckArrayBoundInstr::IsFixedLengthArrayType(intptr_t cid) {
   return LoadFieldInstr::IsFixedLengthArrayCid(cid);
 }
 
+Instruction* CheckArrayBoundInstr::Clone(Zone* zone) const {
+  return new (zone) CheckArrayBoundInstr(length()->Copy(zone),
+                                         index()->Copy(zone), GetDeoptId());
+}
+
+Instruction* GenericCheckBoundInstr::Clone(Zone* zone) const {
+  return new (zone) GenericCheckBoundInstr(length()->Copy(zone),
+                                           index()->Copy(zone), GetDeoptId());
+}
+
 Definition* CheckArrayBoundInstr::Canonicalize(FlowGraph* flow_graph) {
   return IsRedundant() ? index()->definition() : this;
 }
@@ -5708,6 +5791,12 @@ LoadIndexedInstr::LoadIndexedInstr(Value* array,
   SetInputAt(1, index);
 }
 
+Instruction* LoadIndexedInstr::Clone(Zone* zone) const {
+  return new (zone) LoadIndexedInstr(
+      array()->Copy(zone), index()->Copy(zone), index_unboxed_, index_scale(),
+      class_id(), alignment_, GetDeoptId(), token_pos(), result_type_);
+}
+
 StoreIndexedInstr::StoreIndexedInstr(Value* array,
                                      Value* index,
                                      Value* value,
@@ -5732,6 +5821,13 @@ StoreIndexedInstr::StoreIndexedInstr(Value* array,
   SetInputAt(kValuePos, value);
 }
 
+Instruction* StoreIndexedInstr::Clone(Zone* zone) const {
+  return new (zone) StoreIndexedInstr(
+      array()->Copy(zone), index()->Copy(zone), value()->Copy(zone),
+      emit_store_barrier_, index_unboxed_, index_scale(), class_id(),
+      alignment_, GetDeoptId(), token_pos(), speculative_mode_);
+}
+
 InvokeMathCFunctionInstr::InvokeMathCFunctionInstr(
     ZoneGrowableArray<Value*>* inputs,
     intptr_t deopt_id,
@@ -1020,6 +1020,18 @@ class Instruction : public ZoneAllocated {
   // change.
   virtual Instruction* Canonicalize(FlowGraph* flow_graph);
 
+  // Returns true if Clone can copy this instruction.
+  virtual bool CanClone() const { return false; }
+
+  // Returns a copy of this instruction with the same deopt id and inputs
+  // bound to the same definitions. Only valid if CanClone() is true. The copy
+  // is not linked into the graph, its inputs are not on any use list and it
+  // has no environment.
+  virtual Instruction* Clone(Zone* zone) const {
+    UNREACHABLE();
+    return NULL;
+  }
+
   // Insert this instruction before 'next' after use lists are computed.
   // Instructions cannot be inserted before a block entry or any other
   // instruction without a previous instruction.
@@ -1128,8 +1140,11 @@ class Instruction : public ZoneAllocated {
 
  protected:
   // GetDeoptId and/or CopyDeoptIdFrom.
+  friend class BoundsCheckHoister;
   friend class CallSiteInliner;
   friend class LICM;
+  friend class LoopUnroller;
+  friend class LoopVectorizer;
   friend class ComparisonInstr;
   friend class Scheduler;
   friend class BlockEntryInstr;
@@ -5395,6 +5410,9 @@ class LoadIndexedInstr : public TemplateDefinition<2, NoThrow> {
 
   virtual bool HasUnknownSideEffects() const { return false; }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   ADD_EXTRA_INFO_TO_S_EXPRESSION_SUPPORT
 
  private:
@@ -5623,6 +5641,9 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
 
   virtual bool HasUnknownSideEffects() const { return false; }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   void PrintOperandsTo(BufferFormatter* f) const;
 
   ADD_EXTRA_INFO_TO_S_EXPRESSION_SUPPORT
@@ -5892,6 +5913,12 @@ class MaterializeObjectInstr : public Definition {
     }
   }
 
+  // Fields of the context that are not in [slots] are materialized as null,
+  // as [allocation] would have initialized them.
+  MaterializeObjectInstr(AllocateContextInstr* allocation,
+                         const ZoneGrowableArray<const Slot*>& slots,
+                         ZoneGrowableArray<Value*>* values);
+
   Definition* allocation() const { return allocation_; }
   const Class& cls() const { return cls_; }
 
@@ -6032,6 +6059,9 @@ class LoadUntaggedInstr : public TemplateDefinition<1, NoThrow> {
     return other->AsLoadUntagged()->offset_ == offset_;
   }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   PRINT_OPERANDS_TO_SUPPORT
 
  private:
@@ -6196,6 +6226,9 @@ class LoadFieldInstr : public TemplateDefinition<1, Throws> {
 
   virtual bool AttributesEqual(Instruction* other) const;
 
+  virtual bool CanClone() const { return !calls_initializer(); }
+  virtual Instruction* Clone(Zone* zone) const;
+
   PRINT_OPERANDS_TO_SUPPORT
   ADD_OPERANDS_TO_S_EXPRESSION_SUPPORT
   ADD_EXTRA_INFO_TO_S_EXPRESSION_SUPPORT
@@ -6318,7 +6351,9 @@ class AllocateContextInstr : public TemplateAllocation<0, NoThrow> {
  public:
   AllocateContextInstr(TokenPosition token_pos,
                        const ZoneGrowableArray<const Slot*>& context_slots)
-      : token_pos_(token_pos), context_slots_(context_slots) {}
+      : token_pos_(token_pos),
+        context_slots_(context_slots),
+        identity_(AliasIdentity::Unknown()) {}
 
   DECLARE_INSTRUCTION(AllocateContext)
   virtual CompileType ComputeType() const;
@@ -6339,11 +6374,15 @@ class AllocateContextInstr : public TemplateAllocation<0, NoThrow> {
         context_slots().length());
   }
 
+  virtual AliasIdentity Identity() const { return identity_; }
+  virtual void SetIdentity(AliasIdentity identity) { identity_ = identity; }
+
   PRINT_OPERANDS_TO_SUPPORT
 
  private:
   const TokenPosition token_pos_;
   const ZoneGrowableArray<const Slot*>& context_slots_;
+  AliasIdentity identity_;
 
   DISALLOW_COPY_AND_ASSIGN(AllocateContextInstr);
 };
@@ -6497,6 +6536,9 @@ class BoxInstr : public TemplateDefinition<1, NoThrow, Pure> {
 
   Definition* Canonicalize(FlowGraph* flow_graph);
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   virtual TokenPosition token_pos() const { return TokenPosition::kBox; }
 
   virtual SpeculativeMode SpeculativeModeOfInput(intptr_t index) const {
@@ -6630,6 +6672,9 @@ class UnboxInstr : public TemplateDefinition<1, NoThrow, Pure> {
 
   Definition* Canonicalize(FlowGraph* flow_graph);
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   virtual intptr_t DeoptimizationTarget() const { return GetDeoptId(); }
 
   virtual TokenPosition token_pos() const { return TokenPosition::kBox; }
@@ -7008,6 +7053,9 @@ class BinaryDoubleOpInstr : public TemplateDefinition<2, NoThrow, Pure> {
            (speculative_mode_ == other_bin_op->speculative_mode_);
   }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
  private:
   const Token::Kind op_kind_;
   const TokenPosition token_pos_;
@@ -7323,6 +7371,9 @@ class BinaryIntegerOpInstr : public TemplateDefinition<2, NoThrow, Pure> {
 
   virtual bool AttributesEqual(Instruction* other) const;
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   virtual intptr_t DeoptimizationTarget() const { return GetDeoptId(); }
 
   PRINT_OPERANDS_TO_SUPPORT
@@ -7505,6 +7556,9 @@ class BinaryInt64OpInstr : public BinaryIntegerOpInstr {
            (speculative_mode_ == other->AsBinaryInt64Op()->speculative_mode_);
   }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   virtual void InferRange(RangeAnalysis* analysis, Range* range);
   virtual CompileType ComputeType() const;
 
@@ -8442,6 +8496,9 @@ class CheckArrayBoundInstr : public CheckBoundBase {
 
   virtual bool AttributesEqual(Instruction* other) const { return true; }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   void set_licm_hoisted(bool value) { licm_hoisted_ = value; }
 
  private:
@@ -8463,6 +8520,9 @@ class GenericCheckBoundInstr : public CheckBoundBase {
 
   virtual bool AttributesEqual(Instruction* other) const { return true; }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   DECLARE_INSTRUCTION(GenericCheckBound)
 
   virtual CompileType ComputeType() const;
@@ -8578,6 +8638,9 @@ class IntConverterInstr : public TemplateDefinition<1, NoThrow, Pure> {
            (converter->is_truncating() == is_truncating());
   }
 
+  virtual bool CanClone() const { return true; }
+  virtual Instruction* Clone(Zone* zone) const;
+
   virtual intptr_t DeoptimizationTarget() const { return GetDeoptId(); }
 
   virtual void InferRange(RangeAnalysis* analysis, Range* range);
@@ -5,6 +5,7 @@
 #include "vm/compiler/backend/il_test_helper.h"
 
 #include "vm/compiler/aot/aot_call_specializer.h"
+#include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/flow_graph.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
@@ -117,6 +118,11 @@ FlowGraph* TestPipeline::RunPasses(
                                          osr_id, optimized);
 
   if (mode_ == CompilerPass::kAOT) {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+    if (type_feedback_ != nullptr) {
+      Precompiler::ApplyTypeFeedback(*type_feedback_, flow_graph_);
+    }
+#endif
     flow_graph_->PopulateWithICData(function_);
   }
 
@@ -50,6 +50,7 @@ namespace dart {
 class FlowGraph;
 class Function;
 class Library;
+class TypeFeedbackProfile;
 
 LibraryPtr LoadTestScript(const char* script,
                           Dart_NativeEntryResolver resolver = nullptr,
@@ -84,6 +85,12 @@ class TestPipeline : public ValueObject {
 
   void CompileGraphAndAttachFunction();
 
+  // In AOT mode, attaches [type_feedback] to the graph before the passes run,
+  // like the precompiler does.
+  void set_type_feedback(const TypeFeedbackProfile* type_feedback) {
+    type_feedback_ = type_feedback;
+  }
+
  private:
   const Function& function_;
   Thread* thread_;
@@ -93,6 +100,7 @@ class TestPipeline : public ValueObject {
   ParsedFunction* parsed_function_ = nullptr;
   CompilerPassState* pass_state_ = nullptr;
   FlowGraph* flow_graph_ = nullptr;
+  const TypeFeedbackProfile* type_feedback_ = nullptr;
 };
 
 // Match opcodes used for [ILMatcher], see below.
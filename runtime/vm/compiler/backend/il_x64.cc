@@ -4298,6 +4298,47 @@ Condition DoubleTestOpInstr::EmitComparisonCode(FlowGraphCompiler* compiler,
   V(Float32x4LessThan, cmppslt)                                                \
   V(Float32x4LessThanOrEqual, cmppsle)
 
+// The operations of SIMD_OP_SIMPLE_BINARY which have a three-operand AVX
+// form. With AVX they do not need the result in the register of [left].
+#define SIMD_OP_VEX_BINARY(V)                                                  \
+  SIMD_OP_FLOAT_ARITH(V, Add, vadd)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Sub, vsub)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Mul, vmul)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Div, vdiv)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Min, vmin)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Max, vmax)                                            \
+  V(Int32x4BitAnd, vandps)                                                     \
+  V(Int32x4BitOr, vorps)                                                       \
+  V(Int32x4BitXor, vxorps)
+
+static bool HasVexForm(SimdOpInstr::Kind kind) {
+  if (!TargetCPUFeatures::avx_supported()) {
+    return false;
+  }
+  switch (kind) {
+#define CASE(Name, op) case SimdOpInstr::k##Name:
+    SIMD_OP_VEX_BINARY(CASE)
+#undef CASE
+      return true;
+    default:
+      return false;
+  }
+}
+
+DEFINE_EMIT(SimdVexBinaryOp,
+            (XmmRegister out, XmmRegister left, XmmRegister right)) {
+  switch (instr->kind()) {
+#define EMIT(Name, op)                                                         \
+  case SimdOpInstr::k##Name:                                                   \
+    __ op(out, left, right);                                                   \
+    break;
+    SIMD_OP_VEX_BINARY(EMIT)
+#undef EMIT
+    default:
+      UNREACHABLE();
+  }
+}
+
 DEFINE_EMIT(SimdBinaryOp,
             (SameAsFirstInput, XmmRegister left, XmmRegister right)) {
   switch (instr->kind()) {
@@ -4646,6 +4687,9 @@ DEFINE_EMIT(Int32x4Select,
   SIMPLE(Int32x4Select)
 
 LocationSummary* SimdOpInstr::MakeLocationSummary(Zone* zone, bool opt) const {
+  if (HasVexForm(kind())) {
+    return MakeLocationSummaryFromEmitter(zone, this, &EmitSimdVexBinaryOp);
+  }
   switch (kind()) {
 #define CASE(Name, ...) case k##Name:
 #define EMIT(Name)                                                             \
@@ -4663,6 +4707,10 @@ LocationSummary* SimdOpInstr::MakeLocationSummary(Zone* zone, bool opt) const {
 }
 
 void SimdOpInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (HasVexForm(kind())) {
+    InvokeEmitter(compiler, this, &EmitSimdVexBinaryOp);
+    return;
+  }
   switch (kind()) {
 #define CASE(Name, ...) case k##Name:
 #define EMIT(Name)                                                             \
@@ -4,6 +4,7 @@
 
 #include "vm/compiler/backend/inliner.h"
 
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/block_scheduler.h"
@@ -75,6 +76,20 @@ DEFINE_FLAG(int,
             max_inlined_per_depth,
             500,
             "Max. number of inlined calls per depth");
+DEFINE_FLAG(int,
+            max_hot_polymorphic_checks,
+            8,
+            "Max. number of targets inlined at a hot polymorphic call site.");
+DEFINE_FLAG(int,
+            polymorphic_inlining_hotness,
+            50,
+            "Polymorphic calls above-equal this percentage of max-count may "
+            "inline up to --max-hot-polymorphic-checks targets.");
+DEFINE_FLAG(int,
+            polymorphic_inlining_budget,
+            400,
+            "Max. number of instructions inlined per function at polymorphic "
+            "calls with more than --max-polymorphic-checks targets.");
 DEFINE_FLAG(bool, print_inlining_tree, false, "Print inlining tree");
 
 DECLARE_FLAG(int, max_deoptimization_counter_threshold);
@@ -348,16 +363,33 @@ class CallSites : public ValueObject {
     }
   }
 
+  // Returns whether the call counts in |graph| were recorded in a training
+  // run, see Precompiler::ApplyTypeFeedback.
+  static bool HasRecordedCallCounts(FlowGraph* graph) {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+    Precompiler* precompiler = Precompiler::Instance();
+    return (precompiler != nullptr) &&
+           (precompiler->type_feedback() != nullptr) &&
+           (precompiler->type_feedback()->Lookup(graph->function()) != nullptr);
+#else
+    return false;
+#endif
+  }
+
   // Computes the ratio for each call site in a method, defined as the
   // number of times a call site is executed over the maximum number of
   // times any call site is executed in the method. JIT uses actual call
-  // counts whereas AOT uses a static estimate based on nesting depth.
-  void ComputeCallSiteRatio(intptr_t static_call_start_ix,
+  // counts whereas AOT uses a static estimate based on nesting depth, unless
+  // the counts of a training run were loaded.
+  void ComputeCallSiteRatio(FlowGraph* graph,
+                            intptr_t static_call_start_ix,
                             intptr_t instance_call_start_ix) {
     const intptr_t num_static_calls =
         static_calls_.length() - static_call_start_ix;
     const intptr_t num_instance_calls =
         instance_calls_.length() - instance_call_start_ix;
+    const bool use_static_estimate =
+        CompilerState::Current().is_aot() && !HasRecordedCallCounts(graph);
 
     intptr_t max_count = 0;
     GrowableArray<intptr_t> instance_call_counts(num_instance_calls);
@@ -365,9 +397,8 @@ class CallSites : public ValueObject {
       const InstanceCallInfo& info =
           instance_calls_[i + instance_call_start_ix];
       intptr_t aggregate_count =
-          CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
-              : info.call->CallCount();
+          use_static_estimate ? AotCallCountApproximation(info.nesting_depth)
+                              : info.call->CallCount();
       instance_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -376,9 +407,8 @@ class CallSites : public ValueObject {
     for (intptr_t i = 0; i < num_static_calls; ++i) {
       const StaticCallInfo& info = static_calls_[i + static_call_start_ix];
       intptr_t aggregate_count =
-          CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
-              : info.call->CallCount();
+          use_static_estimate ? AotCallCountApproximation(info.nesting_depth)
+                              : info.call->CallCount();
       static_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -511,7 +541,7 @@ class CallSites : public ValueObject {
         }
       }
     }
-    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix);
+    ComputeCallSiteRatio(graph, static_call_start_ix, instance_call_start_ix);
   }
 
  private:
@@ -593,7 +623,8 @@ class PolymorphicInliner : public ValueObject {
   PolymorphicInliner(CallSiteInliner* owner,
                      PolymorphicInstanceCallInstr* call,
                      const Function& caller_function,
-                     intptr_t caller_inlining_id);
+                     intptr_t caller_inlining_id,
+                     double ratio);
 
   bool Inline();
 
@@ -625,6 +656,9 @@ class PolymorphicInliner : public ValueObject {
 
   const Function& caller_function_;
   const intptr_t caller_inlining_id_;
+
+  // Hotness of the call relative to the hottest call of the caller.
+  const double ratio_;
 };
 
 static void ReplaceParameterStubs(Zone* zone,
@@ -749,6 +783,7 @@ class CallSiteInliner : public ValueObject {
         inlined_(false),
         initial_size_(inliner->flow_graph()->InstructionCount()),
         inlined_size_(0),
+        polymorphic_budget_(FLAG_polymorphic_inlining_budget),
         inlined_recursive_call_(false),
         inlining_depth_(1),
         inlining_recursion_depth_(0),
@@ -1052,6 +1087,9 @@ class CallSiteInliner : public ValueObject {
         }
 #if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
         if (CompilerState::Current().is_aot()) {
+          if (inliner_->precompiler_ != nullptr) {
+            inliner_->precompiler_->ApplyTypeFeedback(callee_graph);
+          }
           callee_graph->PopulateWithICData(parsed_function->function());
         }
 #endif
@@ -1516,23 +1554,44 @@ class CallSiteInliner : public ValueObject {
         inlining_call_sites_->instance_calls();
     TRACE_INLINING(THR_Print("  Polymorphic Instance Calls (%" Pd ")\n",
                              call_info.length()));
+    // Visit the hottest calls first, so that they get the inlining budget.
+    GrowableArray<const CallSites::InstanceCallInfo*> sorted_info(
+        call_info.length());
     for (intptr_t call_idx = 0; call_idx < call_info.length(); ++call_idx) {
-      PolymorphicInstanceCallInstr* call = call_info[call_idx].call;
+      sorted_info.Add(&call_info[call_idx]);
+    }
+    sorted_info.Sort(CompareByRatio);
+    for (intptr_t call_idx = 0; call_idx < sorted_info.length(); ++call_idx) {
+      const CallSites::InstanceCallInfo& info = *sorted_info[call_idx];
+      PolymorphicInstanceCallInstr* call = info.call;
       // PolymorphicInliner introduces deoptimization paths.
       if (!call->complete() && !FLAG_polymorphic_with_deopt) {
         TRACE_INLINING(THR_Print("  => %s\n     Bailout: call with checks\n",
                                  call->function_name().ToCString()));
         continue;
       }
-      const Function& cl = call_info[call_idx].caller();
-      intptr_t caller_inlining_id =
-          call_info[call_idx].caller_graph->inlining_id();
-      PolymorphicInliner inliner(this, call, cl, caller_inlining_id);
+      TRACE_INLINING(THR_Print("  => %s (ratio %.2f, %" Pd
+                               " targets, budget %" Pd ")\n",
+                               call->function_name().ToCString(), info.ratio,
+                               call->NumberOfChecks(), polymorphic_budget_));
+      const Function& cl = info.caller();
+      intptr_t caller_inlining_id = info.caller_graph->inlining_id();
+      PolymorphicInliner inliner(this, call, cl, caller_inlining_id,
+                                 info.ratio);
       if (inliner.Inline()) inlined = true;
     }
     return inlined;
   }
 
+  // Orders calls by decreasing ratio, and then by their order in the graph.
+  static int CompareByRatio(const CallSites::InstanceCallInfo* const* a,
+                            const CallSites::InstanceCallInfo* const* b) {
+    if ((*a)->ratio != (*b)->ratio) {
+      return (*a)->ratio > (*b)->ratio ? -1 : 1;
+    }
+    return *a < *b ? -1 : (*a > *b ? 1 : 0);
+  }
+
   bool AdjustForOptionalParameters(const ParsedFunction& parsed_function,
                                    intptr_t first_arg_index,
                                    const Array& argument_names,
@@ -1633,6 +1692,9 @@ class CallSiteInliner : public ValueObject {
   bool inlined_;
   const intptr_t initial_size_;
   intptr_t inlined_size_;
+  // Instructions left for inlining at polymorphic calls with more than
+  // --max-polymorphic-checks targets.
+  intptr_t polymorphic_budget_;
   bool inlined_recursive_call_;
   intptr_t inlining_depth_;
   intptr_t inlining_recursion_depth_;
@@ -1648,7 +1710,8 @@ class CallSiteInliner : public ValueObject {
 PolymorphicInliner::PolymorphicInliner(CallSiteInliner* owner,
                                        PolymorphicInstanceCallInstr* call,
                                        const Function& caller_function,
-                                       intptr_t caller_inlining_id)
+                                       intptr_t caller_inlining_id,
+                                       double ratio)
     : owner_(owner),
       call_(call),
       num_variants_(call->NumberOfChecks()),
@@ -1658,7 +1721,8 @@ PolymorphicInliner::PolymorphicInliner(CallSiteInliner* owner,
       inlined_entries_(num_variants_),
       exit_collector_(new (Z) InlineExitCollector(owner->caller_graph(), call)),
       caller_function_(caller_function),
-      caller_inlining_id_(caller_inlining_id) {}
+      caller_inlining_id_(caller_inlining_id),
+      ratio_(ratio) {}
 
 Isolate* PolymorphicInliner::isolate() const {
   return owner_->caller_graph()->isolate();
@@ -2107,10 +2171,40 @@ bool PolymorphicInliner::trace_inlining() const {
 bool PolymorphicInliner::Inline() {
   ASSERT(&variants_ == &call_->targets_);
 
+  // Hot calls with more than --max-polymorphic-checks targets inline their
+  // most frequent targets, as long as the inlining budget of the caller
+  // lasts. Other calls with that many targets are not inlined at all.
+  //
+  // Such calls usually come from a megamorphic ICData, which stopped recording
+  // receivers once it had more than --max-polymorphic-checks of them. The
+  // later targets come from the megamorphic cache and their counts are only
+  // estimates (see CallTargets::CreateHelper), which at worst delays them in
+  // the most-frequent-first order. Every target in the cache was seen at this
+  // call site, so inlining one is as safe as for a recorded target.
+  const bool is_hot = ratio_ * 100 >= FLAG_polymorphic_inlining_hotness;
+  const bool over_checks = variants_.length() > FLAG_max_polymorphic_checks;
+  const intptr_t num_candidates =
+      over_checks ? Utils::Minimum(variants_.length(),
+                                   static_cast<intptr_t>(
+                                       FLAG_max_hot_polymorphic_checks))
+                  : variants_.length();
+
   intptr_t total = call_->total_call_count();
   for (intptr_t var_idx = 0; var_idx < variants_.length(); ++var_idx) {
     TargetInfo* info = variants_.TargetAt(var_idx);
-    if (variants_.length() > FLAG_max_polymorphic_checks) {
+    if (over_checks && !is_hot) {
+      if (trace_inlining()) {
+        char message[64];
+        Utils::SNPrint(message, sizeof(message), "not hot (ratio %.2f)",
+                       ratio_);
+        TracePolyInlining(variants_, var_idx, total, message);
+      }
+      non_inlined_variants_->Add(info);
+      continue;
+    }
+    if (var_idx >= num_candidates) {
+      TRACE_INLINING(TracePolyInlining(variants_, var_idx, total,
+                                       "over --max-hot-polymorphic-checks"));
       non_inlined_variants_->Add(info);
       continue;
     }
@@ -2165,10 +2259,25 @@ bool PolymorphicInliner::Inline() {
       continue;
     }
 
+    // Calls with more than --max-polymorphic-checks targets pay for what
+    // they inline out of the budget of the caller.
+    if (over_checks && (owner_->polymorphic_budget_ <= 0 ||
+                        size > owner_->polymorphic_budget_)) {
+      TRACE_INLINING(TracePolyInlining(variants_, var_idx, total,
+                                       "over --polymorphic-inlining-budget"));
+      non_inlined_variants_->Add(&variants_[var_idx]);
+      continue;
+    }
+
     // Make an inlining decision.
+    const intptr_t inlined_size = owner_->inlined_size_;
     if (TryInliningPoly(*info)) {
       TRACE_INLINING(TracePolyInlining(variants_, var_idx, total, "inlined"));
       inlined_variants_.Add(&variants_[var_idx]);
+      if (over_checks) {
+        owner_->polymorphic_budget_ -=
+            Utils::Maximum(owner_->inlined_size_ - inlined_size, size);
+      }
     } else {
       TRACE_INLINING(
           TracePolyInlining(variants_, var_idx, total, "not inlined"));
@@ -194,4 +194,154 @@ ISOLATE_UNIT_TEST_CASE(Inliner_TypedData_Regress7551) {
   RELEASE_ASSERT(unbox_instr->is_truncating());
 }
 
+DECLARE_FLAG(int, polymorphic_inlining_budget);
+DECLARE_FLAG(int, polymorphic_inlining_hotness);
+DECLARE_FLAG(bool, unopt_megamorphic_calls);
+
+// Runs the inliner on [function] and returns the polymorphic call that is left
+// for the targets that were not inlined, or nullptr if all were inlined.
+static PolymorphicInstanceCallInstr* InlineAndFindPolymorphicCall(
+    const Function& function) {
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({
+      CompilerPass::kComputeSSA,
+      CompilerPass::kApplyICData,
+      CompilerPass::kTryOptimizePatterns,
+      CompilerPass::kSetOuterInliningId,
+      CompilerPass::kTypePropagation,
+      CompilerPass::kApplyClassIds,
+      CompilerPass::kInlining,
+  });
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsPolymorphicInstanceCall()) {
+        return it.Current()->AsPolymorphicInstanceCall();
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Calls testInlining with six receiver classes, the most frequent first.
+static const char* kMegamorphicScript = R"(
+    abstract class Shape {
+      int sides();
+    }
+
+    class S0 implements Shape { int sides() => 0; }
+    class S1 implements Shape { int sides() => 1; }
+    class S2 implements Shape { int sides() => 2; }
+    class S3 implements Shape { int sides() => 3; }
+    class S4 implements Shape { int sides() => 4; }
+    class S5 implements Shape { int sides() => 5; }
+
+    testInlining(Shape shape) {
+      return shape.sides();
+    }
+
+    main() {
+      final shapes = <Shape>[S0(), S1(), S2(), S3(), S4(), S5()];
+      final counts = <int>[20, 18, 17, 16, 15, 14];
+      for (int i = 0; i < shapes.length; i++) {
+        for (int j = 0; j < counts[i]; j++) {
+          testInlining(shapes[i]);
+        }
+      }
+    }
+  )";
+
+// Test that a hot call with more than --max-polymorphic-checks targets inlines
+// its most frequent targets until --polymorphic-inlining-budget runs out.
+ISOLATE_UNIT_TEST_CASE(Inliner_HotMegamorphicCall) {
+  const auto& root_library =
+      Library::Handle(LoadTestScript(kMegamorphicScript));
+  const auto& function =
+      Function::Handle(GetFunction(root_library, "testInlining"));
+  {
+    // Keep recording receivers after the call site goes megamorphic.
+    SetFlagScope<bool> sfs(&FLAG_unopt_megamorphic_calls, false);
+    Invoke(root_library, "main");
+  }
+  const intptr_t s0_cid = Class::Handle(GetClass(root_library, "S0")).id();
+
+  // The only call of the function is its hottest, and all of its small
+  // targets fit in the default budget.
+  EXPECT(InlineAndFindPolymorphicCall(function) == nullptr);
+
+  // With room for a single target, only the most frequent one is inlined and
+  // the others are left to the fallback call.
+  {
+    SetFlagScope<int> sfs(&FLAG_polymorphic_inlining_budget, 1);
+    PolymorphicInstanceCallInstr* call = InlineAndFindPolymorphicCall(function);
+    RELEASE_ASSERT(call != nullptr);
+    EXPECT_EQ(5, call->NumberOfChecks());
+    for (intptr_t i = 0; i < call->NumberOfChecks(); i++) {
+      EXPECT(!call->targets()[i].Contains(s0_cid));
+    }
+  }
+
+  // A call that is not hot enough inlines none of its targets.
+  {
+    SetFlagScope<int> sfs(&FLAG_polymorphic_inlining_hotness, 101);
+    PolymorphicInstanceCallInstr* call = InlineAndFindPolymorphicCall(function);
+    RELEASE_ASSERT(call != nullptr);
+    EXPECT_EQ(6, call->NumberOfChecks());
+  }
+}
+
+// Test the same call with default flags, where the call site goes megamorphic
+// after five receiver classes. The ICData then stops recording receivers, and
+// the sixth target only comes from the megamorphic cache, with an estimated
+// count.
+ISOLATE_UNIT_TEST_CASE(Inliner_HotMegamorphicCallFromCache) {
+  const auto& root_library =
+      Library::Handle(LoadTestScript(kMegamorphicScript));
+  const auto& function =
+      Function::Handle(GetFunction(root_library, "testInlining"));
+  Invoke(root_library, "main");
+  const intptr_t s0_cid = Class::Handle(GetClass(root_library, "S0")).id();
+  const intptr_t s5_cid = Class::Handle(GetClass(root_library, "S5")).id();
+
+  {
+    SetFlagScope<int> sfs(&FLAG_polymorphic_inlining_hotness, 101);
+    PolymorphicInstanceCallInstr* call = InlineAndFindPolymorphicCall(function);
+    RELEASE_ASSERT(call != nullptr);
+    // S5 is missing from the ICData, but the call still targets it.
+    EXPECT_EQ(5, call->ic_data()->NumberOfChecks());
+    EXPECT_EQ(6, call->NumberOfChecks());
+    intptr_t s0_count = -1;
+    intptr_t s5_count = -1;
+    for (intptr_t i = 0; i < call->NumberOfChecks(); i++) {
+      if (call->targets()[i].Contains(s0_cid)) {
+        s0_count = call->targets().TargetAt(i)->count;
+      } else if (call->targets()[i].Contains(s5_cid)) {
+        s5_count = call->targets().TargetAt(i)->count;
+      }
+    }
+    EXPECT_EQ(20, s0_count);
+    EXPECT(s5_count > 0);
+    EXPECT(s5_count < s0_count);
+  }
+
+  // Targets from the cache are inlined like the others.
+  EXPECT(InlineAndFindPolymorphicCall(function) == nullptr);
+
+  // The estimated counts only order the targets: the most frequent target
+  // recorded in the ICData is still inlined first.
+  {
+    SetFlagScope<int> sfs(&FLAG_polymorphic_inlining_budget, 1);
+    PolymorphicInstanceCallInstr* call = InlineAndFindPolymorphicCall(function);
+    RELEASE_ASSERT(call != nullptr);
+    EXPECT_EQ(5, call->NumberOfChecks());
+    bool has_s5 = false;
+    for (intptr_t i = 0; i < call->NumberOfChecks(); i++) {
+      EXPECT(!call->targets()[i].Contains(s0_cid));
+      has_s5 = has_s5 || call->targets()[i].Contains(s5_cid);
+    }
+    EXPECT(has_s5);
+  }
+}
+
 }  // namespace dart
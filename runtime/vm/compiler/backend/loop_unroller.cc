@@ -0,0 +1,310 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/branch_optimizer.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool, unroll_loops, true, "Unroll small counted loops.");
+DEFINE_FLAG(int,
+            max_unrolled_loop_body_size,
+            16,
+            "Maximum number of instructions in the body of an unrolled loop.");
+DEFINE_FLAG(bool, trace_loop_unrolling, false, "Trace loop unrolling.");
+
+LoopUnroller::LoopUnroller(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph), zone_(flow_graph->zone()), map_(zone_) {}
+
+bool LoopUnroller::Optimize() {
+  if (!FLAG_unroll_loops) {
+    return false;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph_->GetLoopHierarchy();
+  loop_hierarchy.ComputeInduction();
+
+  // Unrolling a loop adds blocks but does not change the blocks of the other
+  // loops, so all loops are unrolled before the block order is recomputed.
+  bool changed = false;
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    LoopInfo* loop = headers[i]->loop_info();
+    if (CanUnroll(loop)) {
+      Unroll(loop);
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    flow_graph_->DiscoverBlocks();
+    GrowableArray<BitVector*> dominance_frontier;
+    flow_graph_->ComputeDominators(&dominance_frontier);
+  }
+  return changed;
+}
+
+// Returns true if [def] is only used in the [header] and [body] of a loop.
+static bool IsOnlyUsedIn(Definition* def,
+                         BlockEntryInstr* header,
+                         BlockEntryInstr* body) {
+  for (Value::Iterator it(def->input_use_list()); !it.Done(); it.Advance()) {
+    BlockEntryInstr* block = it.Current()->instruction()->GetBlock();
+    if ((block != header) && (block != body)) {
+      return false;
+    }
+  }
+  for (Value::Iterator it(def->env_use_list()); !it.Done(); it.Advance()) {
+    BlockEntryInstr* block = it.Current()->instruction()->GetBlock();
+    if ((block != header) && (block != body)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoopUnroller::CanUnroll(LoopInfo* loop) const {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if ((header == nullptr) || header->InsideTryBlock() ||
+      (header->PredecessorCount() != 2) || (loop->back_edges().length() != 1)) {
+    return false;
+  }
+
+  // Only counted loops are unrolled: the loop test compares a unit stride
+  // induction variable with a bound.
+  if (!InductionVar::IsLinear(loop->control())) {
+    return false;
+  }
+
+  // The loop consists of the header and a single body block.
+  TargetEntryInstr* body = loop->back_edges()[0]->AsTargetEntry();
+  if ((body == nullptr) || (body->PredecessorAt(0) != header)) {
+    return false;
+  }
+
+  // The header only tests the loop condition, with a comparison that can be
+  // copied after the body.
+  for (Instruction* instr = header->next(); instr != header->last_instruction();
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow()) {
+      return false;
+    }
+  }
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if (branch == nullptr) {
+    return false;
+  }
+  ComparisonInstr* comparison = branch->comparison();
+  if (!(comparison->IsRelationalOp() || comparison->IsEqualityCompare() ||
+        comparison->IsStrictCompare() || comparison->IsTestSmi()) ||
+      comparison->CanDeoptimize()) {
+    return false;
+  }
+
+  // The body is small, accesses an array or typed data, and only has
+  // instructions which can be copied and whose values do not escape the loop.
+  intptr_t size = 0;
+  bool accesses_array = false;
+  for (Instruction* instr = body->next(); instr != body->last_instruction();
+       instr = instr->next()) {
+    if (++size > FLAG_max_unrolled_loop_body_size) {
+      return false;
+    }
+    if (instr->IsLoadIndexed() || instr->IsStoreIndexed()) {
+      accesses_array = true;
+    }
+    Definition* def = instr->AsDefinition();
+    if ((def != nullptr) && !IsOnlyUsedIn(def, header, body)) {
+      return false;
+    }
+    if (!instr->CanClone()) {
+      return false;
+    }
+  }
+  return accesses_array;
+}
+
+Definition* LoopUnroller::Map(Definition* def) const {
+  Definition* mapped = map_.LookupValue(def);
+  return (mapped != nullptr) ? mapped : def;
+}
+
+void LoopUnroller::CopyEnvironment(Instruction* from,
+                                   Instruction* to,
+                                   bool map) const {
+  if (from->env() == nullptr) {
+    to->CopyDeoptIdFrom(*from);
+    return;
+  }
+  to->InheritDeoptTarget(zone_, from);
+  if (map) {
+    for (Environment::DeepIterator it(to->env()); !it.Done(); it.Advance()) {
+      Value* value = it.CurrentValue();
+      Definition* mapped = Map(value->definition());
+      if (mapped != value->definition()) {
+        value->BindToEnvironment(mapped);
+      }
+    }
+  }
+}
+
+TargetEntryInstr* LoopUnroller::NewExit(JoinEntryInstr* join, bool map) {
+  TargetEntryInstr* target = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), join->try_index(), DeoptId::kNone);
+  CopyEnvironment(join, target, map);
+  GotoInstr* jump = new (zone_) GotoInstr(join, DeoptId::kNone);
+  CopyEnvironment(join, jump, map);
+  target->LinkTo(jump);
+  target->set_last_instruction(jump);
+  return target;
+}
+
+void LoopUnroller::Unroll(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  TargetEntryInstr* body = loop->back_edges()[0]->AsTargetEntry();
+  GotoInstr* back_edge = body->last_instruction()->AsGoto();
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  ComparisonInstr* comparison = branch->comparison();
+  const bool body_is_true = (branch->true_successor() == body);
+
+  if (FLAG_trace_loop_unrolling) {
+    THR_Print("Unrolling loop B%" Pd " in %s\n", header->block_id(),
+              flow_graph_->function().ToFullyQualifiedCString());
+  }
+
+  // Where the copy of the body starts, a header phi has the value of its
+  // back edge input.
+  map_.Clear();
+  const intptr_t back_index = header->IndexOfPredecessor(body);
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    map_.Insert(DefinitionKV::Pair(phi, phi->InputAt(back_index)->definition()));
+  }
+
+  // Both copies of the loop test leave the loop to a new join, which merges
+  // the values of the header phis that are used after the loop.
+  BlockEntryInstr* exit =
+      body_is_true ? branch->false_successor() : branch->true_successor();
+  JoinEntryInstr* join = BranchSimplifier::ToJoinEntry(zone_, exit);
+  TargetEntryInstr* header_exit = NewExit(join, /*map=*/false);
+  TargetEntryInstr* body_exit = NewExit(join, /*map=*/true);
+  if (body_is_true) {
+    *branch->false_successor_address() = header_exit;
+  } else {
+    *branch->true_successor_address() = header_exit;
+  }
+
+  // Copy the body into a new block that jumps back to the header.
+  TargetEntryInstr* copy_entry = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), body->try_index(), DeoptId::kNone);
+  CopyEnvironment(body, copy_entry, /*map=*/true);
+  Instruction* last = copy_entry;
+  for (Instruction* instr = body->next(); instr != back_edge;
+       instr = instr->next()) {
+    Instruction* copy = instr->Clone(zone_);
+    ASSERT(copy != nullptr);
+    for (intptr_t i = 0; i < copy->InputCount(); ++i) {
+      Value* input = copy->InputAt(i);
+      input->set_definition(Map(input->definition()));
+    }
+    if (instr->has_inlining_id()) {
+      copy->set_inlining_id(instr->inlining_id());
+    }
+    Definition* def = instr->AsDefinition();
+    const bool is_value = (def != nullptr) && def->HasSSATemp();
+    last = flow_graph_->AppendTo(last, copy, nullptr,
+                                 is_value ? FlowGraph::kValue
+                                          : FlowGraph::kEffect);
+    CopyEnvironment(instr, copy, /*map=*/true);
+    if (def != nullptr) {
+      map_.Insert(DefinitionKV::Pair(def, copy->AsDefinition()));
+    }
+  }
+  GotoInstr* copy_back_edge = new (zone_) GotoInstr(header, DeoptId::kNone);
+  CopyEnvironment(back_edge, copy_back_edge, /*map=*/true);
+  last->AppendInstruction(copy_back_edge);
+  copy_entry->set_last_instruction(copy_back_edge);
+
+  // Replace the back edge of the body with a copy of the loop test.
+  ComparisonInstr* test_comparison = comparison->CopyWithNewOperands(
+      new (zone_) Value(Map(comparison->InputAt(0)->definition())),
+      new (zone_) Value(Map(comparison->InputAt(1)->definition())));
+  BranchInstr* test = new (zone_) BranchInstr(test_comparison, DeoptId::kNone);
+  if (branch->env() != nullptr) {
+    CopyEnvironment(branch, test, /*map=*/true);
+    test->comparison()->SetDeoptId(*comparison);
+  } else {
+    CopyEnvironment(back_edge, test, /*map=*/false);
+  }
+  test->InsertBefore(back_edge);
+  test->set_next(nullptr);
+  back_edge->UnuseAllInputs();
+  body->set_last_instruction(test);
+  *test->true_successor_address() = body_is_true ? copy_entry : body_exit;
+  *test->false_successor_address() = body_is_true ? body_exit : copy_entry;
+
+  // The header is now entered from the pre-header and the copy of the body,
+  // which has the larger block id. Phi inputs follow the order of the
+  // predecessors.
+  GrowableArray<Definition*> back_values;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    back_values.Add(Map(it.Current()->InputAt(back_index)->definition()));
+  }
+  intptr_t index = 0;
+  for (PhiIterator it(header); !it.Done(); it.Advance(), ++index) {
+    PhiInstr* phi = it.Current();
+    Value* entry_value = phi->InputAt(1 - back_index);
+    phi->InputAt(back_index)->RemoveFromUseList();
+    Value* back_value = new (zone_) Value(back_values[index]);
+    phi->SetInputAt(0, entry_value);
+    phi->SetInputAt(1, back_value);
+    back_value->definition()->AddInputUse(back_value);
+  }
+
+  // Uses of the header phis after the loop now see the value from the exit
+  // that was taken.
+  auto is_after_loop = [&](Value* use) {
+    BlockEntryInstr* block = use->instruction()->GetBlock();
+    return (block != header) && (block != body) && (block != copy_entry) &&
+           (block != header_exit) && (block != body_exit);
+  };
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    PhiInstr* exit_phi = nullptr;
+    for (Value::Iterator use_it(phi->input_use_list()); !use_it.Done();
+         use_it.Advance()) {
+      Value* use = use_it.Current();
+      if (is_after_loop(use) && (use->instruction() != exit_phi)) {
+        if (exit_phi == nullptr) {
+          exit_phi = AddExitPhi(join, phi);
+        }
+        use->BindTo(exit_phi);
+      }
+    }
+    for (Value::Iterator use_it(phi->env_use_list()); !use_it.Done();
+         use_it.Advance()) {
+      Value* use = use_it.Current();
+      if (is_after_loop(use)) {
+        if (exit_phi == nullptr) {
+          exit_phi = AddExitPhi(join, phi);
+        }
+        use->BindToEnvironment(exit_phi);
+      }
+    }
+  }
+}
+
+PhiInstr* LoopUnroller::AddExitPhi(JoinEntryInstr* join, PhiInstr* phi) {
+  // The exit from the header is the first predecessor of the join.
+  PhiInstr* exit_phi = flow_graph_->AddPhi(join, phi, Map(phi));
+  exit_phi->set_representation(phi->representation());
+  return exit_phi;
+}
+
+}  // namespace dart
@@ -0,0 +1,74 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+class FlowGraph;
+class LoopInfo;
+
+// Unrolls small counted loops over arrays and typed data twice.
+//
+// Only loops made of a header, holding nothing but the phis, the stack
+// overflow check and the loop test, and of a single body block are
+// unrolled. The body is copied after itself, with a copy of the loop test
+// in between, so that no remainder loop is needed:
+//
+//          header: phis, CheckStackOverflow, test --> exit
+//          body
+//          test' --> exit'
+//          body'
+//          goto header
+//
+// The header, and its stack overflow check, then runs once every two
+// iterations, and the two copies of the body are a single straight-line
+// block for the optimizations that follow. Values of the header phis that
+// are live after the loop are merged by phis in a new block joining both
+// exits.
+class LoopUnroller : public ValueObject {
+ public:
+  explicit LoopUnroller(FlowGraph* flow_graph);
+
+  // Returns true if any loop was unrolled.
+  bool Optimize();
+
+ private:
+  bool CanUnroll(LoopInfo* loop) const;
+  void Unroll(LoopInfo* loop);
+
+  // The definition holding the value of [def] in the copy of the body.
+  Definition* Map(Definition* def) const;
+
+  // Gives [to] the deopt id of [from] and a copy of its environment, in
+  // which the values are mapped to the copy of the body.
+  void CopyEnvironment(Instruction* from, Instruction* to, bool map) const;
+
+  // Returns a new block jumping to [join], with the environment of [join].
+  TargetEntryInstr* NewExit(JoinEntryInstr* join, bool map);
+
+  // Adds a phi to [join] merging the values of [phi] at both exits.
+  PhiInstr* AddExitPhi(JoinEntryInstr* join, PhiInstr* phi);
+
+  typedef RawPointerKeyValueTrait<Definition, Definition*> DefinitionKV;
+
+  FlowGraph* const flow_graph_;
+  Zone* const zone_;
+  DirectChainedHashMap<DefinitionKV> map_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopUnroller);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
@@ -0,0 +1,376 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            vectorize_loops,
+            true,
+            "Vectorize element-wise loops over Float64List.");
+DEFINE_FLAG(bool, trace_loop_vectorization, false, "Trace loop vectorization.");
+
+LoopVectorizer::LoopVectorizer(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph),
+      zone_(flow_graph->zone()),
+      vectors_(zone_),
+      pre_header_goto_(nullptr) {}
+
+bool LoopVectorizer::Optimize() {
+#if defined(TARGET_ARCH_X64)
+  if (!FLAG_vectorize_loops || !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return false;
+  }
+
+  const LoopHierarchy& loop_hierarchy = flow_graph_->GetLoopHierarchy();
+  loop_hierarchy.ComputeInduction();
+
+  // Vectorizing a loop adds blocks but does not change the blocks of the
+  // other loops, so all loops are vectorized before the block order is
+  // recomputed.
+  bool changed = false;
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    LoopInfo* loop = headers[i]->loop_info();
+    if (CanVectorize(loop)) {
+      Vectorize(loop);
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    flow_graph_->DiscoverBlocks();
+    GrowableArray<BitVector*> dominance_frontier;
+    flow_graph_->ComputeDominators(&dominance_frontier);
+  }
+  return changed;
+#else
+  // Float64x2 operations are only generated for x64, where each of them is a
+  // single SSE2 instruction.
+  return false;
+#endif
+}
+
+static bool IsInvariant(LoopInfo* loop, Definition* def) {
+  return !loop->Contains(def->GetBlock());
+}
+
+// Returns true if [def] is a double of the [body] which has a vector version.
+static bool IsVector(BlockEntryInstr* body, Definition* def) {
+  return (def->GetBlock() == body) &&
+         (def->IsLoadIndexed() || def->IsBinaryDoubleOp());
+}
+
+// Returns true if the element of the internal Float64List [array] at [index]
+// is accessed after a check of [index] against the length of [array], which
+// is added to [limits].
+static bool IsCheckedAccess(LoopInfo* loop,
+                            intptr_t class_id,
+                            Value* array,
+                            Value* index,
+                            GrowableArray<Definition*>* limits) {
+  if ((class_id != kTypedDataFloat64ArrayCid) ||
+      (array->definition()->representation() != kTagged) ||
+      !IsInvariant(loop, array->definition())) {
+    return false;
+  }
+  CheckArrayBoundInstr* check = index->definition()->AsCheckArrayBound();
+  if (check == nullptr) {
+    return false;
+  }
+  LoadFieldInstr* length = check->length()->definition()->AsLoadField();
+  if ((length == nullptr) ||
+      !length->slot().IsIdentical(Slot::TypedDataBase_length()) ||
+      (length->instance()->definition()->OriginalDefinition() !=
+       array->definition()->OriginalDefinition()) ||
+      !IsInvariant(loop, length)) {
+    return false;
+  }
+  for (intptr_t i = 0; i < limits->length(); ++i) {
+    if (limits->At(i) == length) {
+      return true;
+    }
+  }
+  limits->Add(length);
+  return true;
+}
+
+bool LoopVectorizer::CanVectorize(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if ((header == nullptr) || header->InsideTryBlock() ||
+      (header->PredecessorCount() != 2) || (loop->back_edges().length() != 1)) {
+    return false;
+  }
+
+  // The loop consists of the header and a single body block.
+  TargetEntryInstr* body = loop->back_edges()[0]->AsTargetEntry();
+  if ((body == nullptr) || (body->PredecessorAt(0) != header)) {
+    return false;
+  }
+  const intptr_t back_index = header->IndexOfPredecessor(body);
+  pre_header_goto_ =
+      header->PredecessorAt(1 - back_index)->last_instruction()->AsGoto();
+  if (pre_header_goto_ == nullptr) {
+    return false;
+  }
+
+  // The only phi is a Smi counter counting up by one from a non-negative
+  // constant, so that it is a valid index as long as it is below a length.
+  PhiInstr* counter = nullptr;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    if (counter != nullptr) {
+      return false;
+    }
+    counter = it.Current();
+  }
+  int64_t stride = 0;
+  int64_t start = 0;
+  if ((counter == nullptr) || (counter->representation() != kTagged)) {
+    return false;
+  }
+  InductionVar* induction = loop->LookupInduction(counter);
+  if (!InductionVar::IsLinear(induction, &stride) || (stride != 1) ||
+      !InductionVar::IsConstant(induction->initial(), &start) || (start < 0)) {
+    return false;
+  }
+  BinarySmiOpInstr* increment =
+      counter->InputAt(back_index)->definition()->AsBinarySmiOp();
+  if ((increment == nullptr) || (increment->GetBlock() != body)) {
+    return false;
+  }
+
+  // The header only tests counter < n, and stays in the loop when it holds.
+  for (Instruction* instr = header->next(); instr != header->last_instruction();
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow()) {
+      return false;
+    }
+  }
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if ((branch == nullptr) || (branch->true_successor() != body)) {
+    return false;
+  }
+  RelationalOpInstr* test = branch->comparison()->AsRelationalOp();
+  if ((test == nullptr) || (test->kind() != Token::kLT) ||
+      (test->operation_cid() != kSmiCid) ||
+      (test->left()->definition() != counter) ||
+      !IsInvariant(loop, test->right()->definition())) {
+    return false;
+  }
+  limits_.Clear();
+  limits_.Add(test->right()->definition());
+
+  // The body only computes with Float64List elements at the counter and with
+  // loop invariant doubles, and stores the results.
+  bool has_store = false;
+  for (Instruction* instr = body->next(); instr != body->last_instruction();
+       instr = instr->next()) {
+    if (instr == increment) {
+      continue;
+    }
+    if (CheckArrayBoundInstr* check = instr->AsCheckArrayBound()) {
+      if (check->index()->definition() != counter) {
+        return false;
+      }
+    } else if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+      if (!IsCheckedAccess(loop, load->class_id(), load->array(),
+                           load->index(), &limits_)) {
+        return false;
+      }
+    } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+      if (!IsCheckedAccess(loop, store->class_id(), store->array(),
+                           store->index(), &limits_)) {
+        return false;
+      }
+      Definition* value = store->value()->definition();
+      if (!IsVector(body, value) && !IsInvariant(loop, value)) {
+        return false;
+      }
+      has_store = true;
+    } else if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+      switch (op->op_kind()) {
+        case Token::kADD:
+        case Token::kSUB:
+        case Token::kMUL:
+        case Token::kDIV:
+          break;
+        default:
+          return false;
+      }
+      for (intptr_t i = 0; i < op->InputCount(); ++i) {
+        Definition* input = op->InputAt(i)->definition();
+        if (!IsVector(body, input) && !IsInvariant(loop, input)) {
+          return false;
+        }
+      }
+    } else {
+      return false;
+    }
+  }
+  return has_store;
+}
+
+void LoopVectorizer::CopyEnvironment(Instruction* from,
+                                     Instruction* to,
+                                     Definition* old_def,
+                                     Definition* new_def) const {
+  if (from->env() == nullptr) {
+    to->CopyDeoptIdFrom(*from);
+    return;
+  }
+  to->InheritDeoptTarget(zone_, from);
+  if (old_def != nullptr) {
+    for (Environment::DeepIterator it(to->env()); !it.Done(); it.Advance()) {
+      Value* value = it.CurrentValue();
+      if (value->definition() == old_def) {
+        value->BindToEnvironment(new_def);
+      }
+    }
+  }
+}
+
+Definition* LoopVectorizer::NewIncrement(Definition* def) {
+  BinarySmiOpInstr* increment = new (zone_) BinarySmiOpInstr(
+      Token::kADD, new (zone_) Value(def),
+      new (zone_) Value(
+          flow_graph_->GetConstant(Smi::ZoneHandle(zone_, Smi::New(1)))),
+      DeoptId::kNone);
+  increment->set_can_overflow(false);
+  return increment;
+}
+
+Definition* LoopVectorizer::Vector(Definition* def) {
+  Definition* vector = vectors_.LookupValue(def);
+  if (vector == nullptr) {
+    vector = SimdOpInstr::Create(MethodRecognizer::kFloat64x2Splat,
+                                 new (zone_) Value(def), DeoptId::kNone);
+    flow_graph_->InsertBefore(pre_header_goto_, vector, nullptr,
+                              FlowGraph::kValue);
+    vectors_.Insert(DefinitionKV::Pair(def, vector));
+  }
+  return vector;
+}
+
+void LoopVectorizer::Vectorize(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  TargetEntryInstr* body = loop->back_edges()[0]->AsTargetEntry();
+  GotoInstr* back_edge = body->last_instruction()->AsGoto();
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  const intptr_t back_index = header->IndexOfPredecessor(body);
+  PhiInstr* counter = PhiIterator(header).Current();
+  Definition* increment = counter->InputAt(back_index)->definition();
+
+  if (FLAG_trace_loop_vectorization) {
+    THR_Print("Vectorizing loop B%" Pd " in %s\n", header->block_id(),
+              flow_graph_->function().ToFullyQualifiedCString());
+  }
+
+  // The vector body may run while counter + 1 is below the bound of the loop
+  // and the lengths of all the arrays, computed in the pre-header.
+  Definition* limit = limits_[0];
+  for (intptr_t i = 1; i < limits_.length(); ++i) {
+    MathMinMaxInstr* min = new (zone_) MathMinMaxInstr(
+        MethodRecognizer::kMathMin, new (zone_) Value(limit),
+        new (zone_) Value(limits_[i]), DeoptId::kNone, kSmiCid);
+    flow_graph_->InsertBefore(pre_header_goto_, min, nullptr,
+                              FlowGraph::kValue);
+    limit = min;
+  }
+
+  TargetEntryInstr* test_entry = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), body->try_index(), DeoptId::kNone);
+  CopyEnvironment(body, test_entry, nullptr, nullptr);
+  Definition* next = NewIncrement(counter);
+  Instruction* last =
+      flow_graph_->AppendTo(test_entry, next, nullptr, FlowGraph::kValue);
+  RelationalOpInstr* compare = new (zone_) RelationalOpInstr(
+      branch->comparison()->token_pos(), Token::kLT, new (zone_) Value(next),
+      new (zone_) Value(limit), kSmiCid, DeoptId::kNone);
+  BranchInstr* test = new (zone_) BranchInstr(compare, DeoptId::kNone);
+  CopyEnvironment(body, test, nullptr, nullptr);
+  flow_graph_->AppendTo(last, test, nullptr, FlowGraph::kEffect);
+  test_entry->set_last_instruction(test);
+  *branch->true_successor_address() = test_entry;
+
+  // The vector body accesses the elements at counter and counter + 1 at
+  // once, in the order of the original body.
+  TargetEntryInstr* vector_entry = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), body->try_index(), DeoptId::kNone);
+  CopyEnvironment(body, vector_entry, nullptr, nullptr);
+  vectors_.Clear();
+  last = vector_entry;
+  for (Instruction* instr = body->next(); instr != back_edge;
+       instr = instr->next()) {
+    if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+      LoadIndexedInstr* vector = new (zone_) LoadIndexedInstr(
+          new (zone_) Value(load->array()->definition()),
+          new (zone_) Value(counter), /*index_unboxed=*/false,
+          load->index_scale(), kTypedDataFloat64x2ArrayCid, kUnalignedAccess,
+          DeoptId::kNone, load->token_pos());
+      last = flow_graph_->AppendTo(last, vector, nullptr, FlowGraph::kValue);
+      vectors_.Insert(DefinitionKV::Pair(load, vector));
+    } else if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+      SimdOpInstr* vector = SimdOpInstr::Create(
+          SimdOpInstr::KindForOperator(kFloat64x2Cid, op->op_kind()),
+          new (zone_) Value(Vector(op->left()->definition())),
+          new (zone_) Value(Vector(op->right()->definition())),
+          DeoptId::kNone);
+      last = flow_graph_->AppendTo(last, vector, nullptr, FlowGraph::kValue);
+      vectors_.Insert(DefinitionKV::Pair(op, vector));
+    } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+      StoreIndexedInstr* vector = new (zone_) StoreIndexedInstr(
+          new (zone_) Value(store->array()->definition()),
+          new (zone_) Value(counter),
+          new (zone_) Value(Vector(store->value()->definition())),
+          kNoStoreBarrier, /*index_unboxed=*/false, store->index_scale(),
+          kTypedDataFloat64x2ArrayCid, kUnalignedAccess, DeoptId::kNone,
+          store->token_pos(), Instruction::kNotSpeculative);
+      last = flow_graph_->AppendTo(last, vector, nullptr, FlowGraph::kEffect);
+    }
+    // Bounds checks and the increment of the counter have no vector version.
+  }
+  Definition* next_next = NewIncrement(next);
+  last = flow_graph_->AppendTo(last, next_next, nullptr, FlowGraph::kValue);
+
+  // Both bodies jump back to the header through a new block, which merges
+  // the next values of the counter.
+  JoinEntryInstr* latch = new (zone_) JoinEntryInstr(
+      flow_graph_->allocate_block_id(), header->try_index(), DeoptId::kNone);
+  GotoInstr* vector_back_edge = new (zone_) GotoInstr(latch, DeoptId::kNone);
+  CopyEnvironment(header, vector_back_edge, counter, next_next);
+  last->AppendInstruction(vector_back_edge);
+  vector_entry->set_last_instruction(vector_back_edge);
+  back_edge->set_successor(latch);
+
+  // The original body has the smaller block id, so its value comes first.
+  PhiInstr* latch_phi = flow_graph_->AddPhi(latch, increment, next_next);
+  latch_phi->set_representation(kTagged);
+  CopyEnvironment(header, latch, counter, latch_phi);
+  GotoInstr* latch_back_edge = new (zone_) GotoInstr(header, DeoptId::kNone);
+  CopyEnvironment(header, latch_back_edge, counter, latch_phi);
+  latch->LinkTo(latch_back_edge);
+  latch->set_last_instruction(latch_back_edge);
+
+  *test->true_successor_address() = vector_entry;
+  *test->false_successor_address() = body;
+
+  // The header is now entered from the pre-header and the new block, which
+  // has the larger block id. Phi inputs follow the order of the
+  // predecessors.
+  Value* entry_value = counter->InputAt(1 - back_index);
+  counter->InputAt(back_index)->RemoveFromUseList();
+  Value* back_value = new (zone_) Value(latch_phi);
+  counter->SetInputAt(0, entry_value);
+  counter->SetInputAt(1, back_value);
+  latch_phi->AddInputUse(back_value);
+}
+
+}  // namespace dart
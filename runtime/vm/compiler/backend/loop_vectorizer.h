@@ -0,0 +1,90 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+class FlowGraph;
+class LoopInfo;
+
+// Vectorizes element-wise loops over Float64List, such as
+//
+//   for (int i = 0; i < n; i++) c[i] = a[i] * b[i] + k;
+//
+// so that two elements are processed at once with Float64x2 operations.
+//
+// Only loops made of a header, holding nothing but the phi of the loop
+// counter, the stack overflow check and the test i < n, and of a single body
+// block are vectorized. The body may only load and store Float64List
+// elements at index i, and compute with them and with loop invariant doubles
+// (+, -, * and /), which is exactly what the Float64x2 operations compute on
+// each lane. A vector body is added next to the original one, which is kept
+// as the scalar epilogue:
+//
+//          header: i = phi(i0, i'), CheckStackOverflow, i < n --> exit
+//          i + 1 < min(n, length of the arrays) ?
+//          /                             \
+//   vector body for i and i + 1     original body
+//   i + 2                           i + 1
+//          \                             /
+//          i' = phi(...), goto header
+//
+// The vector body is only taken when both elements are within the bounds of
+// all the arrays, so it needs no bounds checks and never deoptimizes. The
+// scalar body handles the last odd element, and anything the bounds checks
+// must report, exactly as before.
+class LoopVectorizer : public ValueObject {
+ public:
+  explicit LoopVectorizer(FlowGraph* flow_graph);
+
+  // Returns true if any loop was vectorized.
+  bool Optimize();
+
+ private:
+  bool CanVectorize(LoopInfo* loop);
+  void Vectorize(LoopInfo* loop);
+
+  // Returns the Float64x2 value for the double [def] of the body: either its
+  // vector version, or a splat of the loop invariant [def] in the pre-header.
+  Definition* Vector(Definition* def);
+
+  // Gives [to] the deopt id of [from] and a copy of its environment, in which
+  // [old_def] is replaced by [new_def].
+  void CopyEnvironment(Instruction* from,
+                       Instruction* to,
+                       Definition* old_def,
+                       Definition* new_def) const;
+
+  // Returns i + 1 for the tagged loop counter [def], which the loop test
+  // guarantees to not overflow.
+  Definition* NewIncrement(Definition* def);
+
+  typedef RawPointerKeyValueTrait<Definition, Definition*> DefinitionKV;
+
+  FlowGraph* const flow_graph_;
+  Zone* const zone_;
+
+  // The lengths which bound the loop counter, collected by CanVectorize.
+  GrowableArray<Definition*> limits_;
+
+  // Maps the doubles of the body to their Float64x2 version.
+  DirectChainedHashMap<DefinitionKV> vectors_;
+  GotoInstr* pre_header_goto_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopVectorizer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
@@ -513,4 +513,211 @@ ISOLATE_UNIT_TEST_CASE(SecondExitDown) {
   EXPECT_STREQ(expected, ComputeInduction(thread, script_chars));
 }
 
+//
+// Loop unrolling tests.
+//
+
+DECLARE_FLAG(bool, unroll_loops);
+
+// Helper method to optimize "foo", count its branches and indexed loads, and
+// attach the optimized code to it.
+static void OptimizeAndCount(const Library& root_library,
+                             intptr_t* branches,
+                             intptr_t* loads) {
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  *branches = 0;
+  *loads = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsBranch()) (*branches)++;
+      if (it.Current()->IsLoadIndexed()) (*loads)++;
+    }
+  }
+  pipeline.CompileGraphAndAttachFunction();
+}
+
+ISOLATE_UNIT_TEST_CASE(UnrollTypedDataLoop) {
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      foo(Uint8List a, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+          sum += a[i];
+        }
+        return sum;
+      }
+      main() {
+        final a = new Uint8List(8);
+        for (int i = 0; i < 8; i++) {
+          a[i] = i + 1;
+        }
+        return foo(a, 4) * 100 + foo(a, 5);
+      }
+    )";
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  auto& result = Object::Handle(Invoke(root_library, "main"));
+  EXPECT_EQ(1015, Smi::Cast(result).Value());
+
+  intptr_t branches = 0;
+  intptr_t loads = 0;
+  {
+    SetFlagScope<bool> sfs(&FLAG_unroll_loops, false);
+    OptimizeAndCount(root_library, &branches, &loads);
+  }
+  EXPECT_EQ(1, loads);
+
+  // The body is copied, with a copy of the loop test in front of it.
+  intptr_t unrolled_branches = 0;
+  intptr_t unrolled_loads = 0;
+  OptimizeAndCount(root_library, &unrolled_branches, &unrolled_loads);
+  EXPECT_EQ(branches + 1, unrolled_branches);
+  EXPECT_EQ(2, unrolled_loads);
+
+  // Both an even and an odd number of iterations leave the loop with the
+  // right sum.
+  result = Invoke(root_library, "main");
+  EXPECT_EQ(1015, Smi::Cast(result).Value());
+}
+
+ISOLATE_UNIT_TEST_CASE(NoUnrollLoopWithSecondExit) {
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      foo(Uint8List a, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+          if (a[i] == 0) break;
+          sum += a[i];
+        }
+        return sum;
+      }
+      main() {
+        final a = new Uint8List(8);
+        for (int i = 0; i < 4; i++) {
+          a[i] = i + 1;
+        }
+        return foo(a, 8);
+      }
+    )";
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  Invoke(root_library, "main");
+
+  intptr_t branches = 0;
+  intptr_t loads = 0;
+  {
+    SetFlagScope<bool> sfs(&FLAG_unroll_loops, false);
+    OptimizeAndCount(root_library, &branches, &loads);
+  }
+  intptr_t unrolled_branches = 0;
+  intptr_t unrolled_loads = 0;
+  OptimizeAndCount(root_library, &unrolled_branches, &unrolled_loads);
+  EXPECT_EQ(branches, unrolled_branches);
+  EXPECT_EQ(loads, unrolled_loads);
+}
+
+//
+// Loop vectorization tests.
+//
+
+DECLARE_FLAG(bool, vectorize_loops);
+
+// Helper method to optimize "foo", count its SIMD operations, and attach the
+// optimized code to it.
+static intptr_t OptimizeAndCountSimdOps(const Library& root_library) {
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  intptr_t simd_ops = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsSimdOp()) simd_ops++;
+    }
+  }
+  pipeline.CompileGraphAndAttachFunction();
+  return simd_ops;
+}
+
+ISOLATE_UNIT_TEST_CASE(VectorizeFloat64ListLoop) {
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      foo(Float64List a, Float64List b, int n) {
+        for (int i = 0; i < n; i++) {
+          b[i] = a[i] * 2.0 + 1.0;
+        }
+      }
+      bar(int n) {
+        final a = new Float64List(8);
+        final b = new Float64List(8);
+        for (int i = 0; i < 8; i++) {
+          a[i] = i + 1.0;
+        }
+        try {
+          foo(a, b, n);
+        } on RangeError {
+          // All elements are written before the error.
+        }
+        double sum = 0.0;
+        for (int i = 0; i < 8; i++) {
+          sum += b[i];
+        }
+        return sum.toInt();
+      }
+      main() {
+        return bar(4) * 10000 + bar(5) * 100 + bar(9);
+      }
+    )";
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  auto& result = Object::Handle(Invoke(root_library, "main"));
+  EXPECT_EQ(243580, Smi::Cast(result).Value());
+
+  {
+    SetFlagScope<bool> sfs(&FLAG_vectorize_loops, false);
+    EXPECT_EQ(0, OptimizeAndCountSimdOps(root_library));
+  }
+
+#if defined(TARGET_ARCH_X64)
+  EXPECT(OptimizeAndCountSimdOps(root_library) > 0);
+#endif
+
+  // An even and an odd number of elements, and a bound beyond the end of
+  // the lists, give the same results as the scalar loop.
+  result = Invoke(root_library, "main");
+  EXPECT_EQ(243580, Smi::Cast(result).Value());
+}
+
+ISOLATE_UNIT_TEST_CASE(NoVectorizeReductionLoop) {
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      foo(Float64List a, int n) {
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) {
+          sum += a[i];
+        }
+        return sum;
+      }
+      main() {
+        final a = new Float64List(8);
+        for (int i = 0; i < 8; i++) {
+          a[i] = i + 1.0;
+        }
+        return foo(a, 8).toInt();
+      }
+    )";
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  auto& result = Object::Handle(Invoke(root_library, "main"));
+  EXPECT_EQ(36, Smi::Cast(result).Value());
+
+  // Adding the elements in pairs would round the sum differently.
+  EXPECT_EQ(0, OptimizeAndCountSimdOps(root_library));
+}
+
 }  // namespace dart
@@ -443,6 +443,7 @@ class Place : public ValueObject {
   static bool IsAllocation(Definition* defn) {
     return (defn != NULL) &&
            (defn->IsAllocateObject() || defn->IsCreateArray() ||
+            defn->IsAllocateContext() ||
             defn->IsAllocateUninitializedContext() ||
             (defn->IsStaticCall() &&
              defn->AsStaticCall()->IsRecognizedFactory()));
@@ -1905,7 +1906,11 @@ class LoadOptimizer : public ValueObject {
         // side-effects. If we add 'null' as known values for these fields
         // here we will incorrectly propagate this null across constructor
         // invocation.
-        if (auto alloc = instr->AsAllocateObject()) {
+        // Contexts allocated by AllocateContext are null-initialized as
+        // well, unlike those allocated by AllocateUninitializedContext.
+        if (instr->IsAllocateObject() || instr->IsAllocateContext()) {
+          AllocationInstr* alloc = instr->AsAllocation();
+          AllocateObjectInstr* alloc_object = instr->AsAllocateObject();
           for (Value* use = alloc->input_use_list(); use != NULL;
                use = use->next_use()) {
             // Look for all immediate loads/stores from this object.
@@ -1935,11 +1940,12 @@ class LoadOptimizer : public ValueObject {
               }
 
               Definition* forward_def = graph_->constant_null();
-              if (alloc->type_arguments() != nullptr) {
+              if ((alloc_object != nullptr) &&
+                  (alloc_object->type_arguments() != nullptr)) {
                 const Slot& type_args_slot = Slot::GetTypeArgumentsSlotFor(
-                    graph_->thread(), alloc->cls());
+                    graph_->thread(), alloc_object->cls());
                 if (slot->IsIdentical(type_args_slot)) {
-                  forward_def = alloc->type_arguments()->definition();
+                  forward_def = alloc_object->type_arguments()->definition();
                 }
               }
               gen->Add(place_id);
@@ -2893,7 +2899,8 @@ void DeadStoreElimination::Optimize(FlowGraph* graph) {
 // Returns true if the given instruction is an allocation that
 // can be sunk by the Allocation Sinking pass.
 static bool IsSupportedAllocation(Instruction* instr) {
-  return instr->IsAllocateObject() || instr->IsAllocateUninitializedContext();
+  return instr->IsAllocateObject() || instr->IsAllocateContext() ||
+         instr->IsAllocateUninitializedContext();
 }
 
 enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
@@ -3325,6 +3332,9 @@ void AllocationSinking::CreateMaterializationAt(
   if (alloc->IsAllocateObject()) {
     mat = new (Z)
         MaterializeObjectInstr(alloc->AsAllocateObject(), slots, values);
+  } else if (alloc->IsAllocateContext()) {
+    mat = new (Z)
+        MaterializeObjectInstr(alloc->AsAllocateContext(), slots, values);
   } else {
     ASSERT(alloc->IsAllocateUninitializedContext());
     mat = new (Z) MaterializeObjectInstr(
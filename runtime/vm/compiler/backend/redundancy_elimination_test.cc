@@ -1114,4 +1114,77 @@ ISOLATE_UNIT_TEST_CASE(LoadOptimizer_RedundantInitializerCallInLoop) {
   EXPECT(load_field_in_loop2->calls_initializer());
 }
 
+#if defined(DART_PRECOMPILER)
+
+// Counts the allocations of contexts and objects left in the graph.
+static intptr_t CountAllocations(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsAllocateContext() ||
+          it.Current()->IsAllocateObject()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+// The closure and the context holding its captured variable do not escape
+// once the closure call is inlined, so neither is allocated.
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_NonEscapingClosureAndContext) {
+  const char* kScript = R"(
+    @pragma('vm:never-inline')
+    int use(int x) => x;
+
+    int foo(int x) {
+      int y = use(x);
+      final f = (int z) => y + z;
+      return f(1) + f(2);
+    }
+
+    main() {
+      foo(1);
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  ASSERT(flow_graph != nullptr);
+
+  EXPECT_EQ(0, CountAllocations(flow_graph));
+}
+
+// A closure that is passed to a call which is not inlined escapes, and so
+// does its context.
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_EscapingClosureAndContext) {
+  const char* kScript = R"(
+    @pragma('vm:never-inline')
+    int call(int Function(int) f) => f(1);
+
+    int foo(int x) {
+      int y = x;
+      return call((int z) => y + z);
+    }
+
+    main() {
+      foo(1);
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  ASSERT(flow_graph != nullptr);
+
+  EXPECT_EQ(2, CountAllocations(flow_graph));
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
 }  // namespace dart
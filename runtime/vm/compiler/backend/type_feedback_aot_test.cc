@@ -0,0 +1,158 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compilation_trace.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/datastream.h"
+#include "vm/object.h"
+#include "vm/program_visitor.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+
+static uint8_t* malloc_allocator(uint8_t* ptr,
+                                 intptr_t old_size,
+                                 intptr_t new_size) {
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+// Saves the type feedback of the code run so far and reads it back the way
+// Precompiler::LoadTypeFeedback does.
+static TypeFeedbackProfile* SaveAndLoadTypeFeedback(Thread* thread) {
+  uint8_t* buffer = nullptr;
+  WriteStream write_stream(&buffer, malloc_allocator, KB);
+  TypeFeedbackSaver saver(&write_stream);
+  saver.WriteHeader();
+  saver.SaveClasses();
+  saver.SaveFields();
+  ProgramVisitor::WalkProgram(thread->zone(), thread->isolate(), &saver);
+
+  ReadStream read_stream(buffer, write_stream.bytes_written());
+  auto profile = new (thread->zone()) TypeFeedbackProfile(thread->zone());
+  const auto& error = Object::Handle(
+      TypeFeedbackLoader(thread).LoadProfile(&read_stream, profile));
+  free(buffer);
+  EXPECT(error.IsNull());
+  return profile;
+}
+
+ISOLATE_UNIT_TEST_CASE(IRTest_TypeFeedbackAOT) {
+  const char* kScript =
+      R"(
+      abstract class Shape {
+        int area();
+      }
+
+      class Square implements Shape {
+        int area() => 4;
+      }
+
+      class Circle implements Shape {
+        int area() => 3;
+      }
+
+      class Triangle implements Shape {
+        int area() => 2;
+      }
+
+      int foo(Shape shape, int i) {
+        if (i < 0) {
+          return -1;
+        }
+        return shape.area();
+      }
+
+      main() {
+        final shapes = <Shape>[Square(), Circle(), Triangle()];
+        for (int i = 0; i < 100; i++) {
+          foo(shapes[i % 2], i);
+        }
+      }
+      )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+
+  TypeFeedbackProfile* profile = SaveAndLoadTypeFeedback(thread);
+  const TypeFeedbackProfile::FunctionFeedback* feedback =
+      profile->Lookup(function);
+  EXPECT(feedback != nullptr);
+  EXPECT(!feedback->edge_counters.IsNull());
+
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  pipeline.set_type_feedback(profile);
+  FlowGraph* flow_graph = pipeline.RunPasses({
+      CompilerPass::kComputeSSA,
+      CompilerPass::kReorderBlocks,
+  });
+
+  // The counters only apply to a graph of the same shape as the JIT's.
+  EXPECT_EQ(feedback->edge_counters.Length(), flow_graph->preorder().length());
+  EXPECT_EQ(100, flow_graph->graph_entry()->entry_count());
+
+  // The call of area() gets the receivers seen during training.
+  InstanceCallInstr* area_call = nullptr;
+  BranchInstr* branch = nullptr;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    BlockEntryInstr* block = block_it.Current();
+    if (block->last_instruction()->IsBranch() && (branch == nullptr)) {
+      branch = block->last_instruction()->AsBranch();
+    }
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      InstanceCallInstr* call = it.Current()->AsInstanceCall();
+      if ((call != nullptr) && call->function_name().Equals("area")) {
+        area_call = call;
+      }
+    }
+  }
+  RELEASE_ASSERT(area_call != nullptr);
+  RELEASE_ASSERT(branch != nullptr);
+
+  EXPECT(area_call->HasICData());
+  const ICData& ic_data = *area_call->ic_data();
+  EXPECT_EQ(2, ic_data.NumberOfChecks());
+  const intptr_t square_cid =
+      Class::Handle(GetClass(root_library, "Square")).id();
+  const intptr_t circle_cid =
+      Class::Handle(GetClass(root_library, "Circle")).id();
+  intptr_t total_count = 0;
+  for (intptr_t i = 0; i < ic_data.NumberOfChecks(); i++) {
+    const intptr_t cid = ic_data.GetReceiverClassIdAt(i);
+    EXPECT((cid == square_cid) || (cid == circle_cid));
+    total_count += ic_data.GetCountAt(i);
+  }
+  EXPECT_EQ(100, total_count);
+
+  // The hot successor of the never taken `i < 0` check is laid out right
+  // after the check, the cold one after that.
+  TargetEntryInstr* cold = branch->true_successor();
+  TargetEntryInstr* hot = branch->false_successor();
+  EXPECT(hot->edge_weight() > cold->edge_weight());
+
+  GrowableArray<BlockEntryInstr*>* order = flow_graph->CodegenBlockOrder(true);
+  intptr_t branch_index = -1;
+  intptr_t hot_index = -1;
+  intptr_t cold_index = -1;
+  for (intptr_t i = 0; i < order->length(); i++) {
+    if ((*order)[i] == branch->GetBlock()) {
+      branch_index = i;
+    } else if ((*order)[i] == hot) {
+      hot_index = i;
+    } else if ((*order)[i] == cold) {
+      cold_index = i;
+    }
+  }
+  EXPECT(branch_index >= 0);
+  EXPECT_EQ(branch_index + 1, hot_index);
+  EXPECT(cold_index > hot_index);
+}
+
+#endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+
+}  // namespace dart
@@ -5,6 +5,7 @@
 #include "vm/compiler/compiler_pass.h"
 
 #include "vm/compiler/backend/block_scheduler.h"
+#include "vm/compiler/backend/bounds_check_hoister.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
 #include "vm/compiler/backend/flow_graph_checker.h"
@@ -13,6 +14,8 @@
 #include "vm/compiler/backend/il_serializer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_unroller.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
@@ -327,6 +330,11 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(LICM);
   INVOKE_PASS(TryOptimizePatterns);
   INVOKE_PASS(DSE);
+  INVOKE_PASS(LoopVectorization);
+  if (mode == kAOT) {
+    INVOKE_PASS(BoundsCheckHoisting);
+  }
+  INVOKE_PASS(LoopUnrolling);
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
@@ -461,6 +469,21 @@ COMPILER_PASS(LICM, {
 
 COMPILER_PASS(DSE, { DeadStoreElimination::Optimize(flow_graph); });
 
+COMPILER_PASS(BoundsCheckHoisting, {
+  BoundsCheckHoister hoister(flow_graph);
+  hoister.Optimize();
+});
+
+COMPILER_PASS(LoopUnrolling, {
+  LoopUnroller unroller(flow_graph);
+  unroller.Optimize();
+});
+
+COMPILER_PASS(LoopVectorization, {
+  LoopVectorizer vectorizer(flow_graph);
+  vectorizer.Optimize();
+});
+
 COMPILER_PASS(RangeAnalysis, {
   // We have to perform range analysis after LICM because it
   // optimistically moves CheckSmi through phis into loop preheaders
@@ -24,6 +24,7 @@ namespace dart {
   V(AllocationSinking_Sink)                                                    \
   V(ApplyClassIds)                                                             \
   V(ApplyICData)                                                               \
+  V(BoundsCheckHoisting)                                                       \
   V(BranchSimplify)                                                            \
   V(CSE)                                                                       \
   V(Canonicalize)                                                              \
@@ -38,6 +39,8 @@ namespace dart {
   V(IfConvert)                                                                 \
   V(Inlining)                                                                  \
   V(LICM)                                                                      \
+  V(LoopUnrolling)                                                             \
+  V(LoopVectorization)                                                         \
   V(OptimisticallySpecializeSmiPhis)                                           \
   V(OptimizeBranches)                                                          \
   V(OptimizeTypedDataAccesses)                                                 \
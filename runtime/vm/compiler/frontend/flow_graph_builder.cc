@@ -51,10 +51,15 @@ void InlineExitCollector::PrepareGraphs(FlowGraph* callee_graph) {
   ASSERT(call_->env() != NULL);
   ASSERT(call_->deopt_id() != DeoptId::kNone);
   const intptr_t outer_deopt_id = call_->deopt_id();
-  // Scale the edge weights by the call count for the inlined function.
+  // Scale the edge weights by the call count for the inlined function. In AOT
+  // mode the caller has no entry count unless type feedback was loaded for it.
+  const intptr_t caller_entry_count =
+      caller_graph_->graph_entry()->entry_count();
   double scale_factor =
-      static_cast<double>(call_->CallCount()) /
-      static_cast<double>(caller_graph_->graph_entry()->entry_count());
+      (caller_entry_count == 0)
+          ? 0.0
+          : static_cast<double>(call_->CallCount()) /
+                static_cast<double>(caller_entry_count);
   for (BlockIterator block_it = callee_graph->postorder_iterator();
        !block_it.Done(); block_it.Advance()) {
     BlockEntryInstr* block = block_it.Current();
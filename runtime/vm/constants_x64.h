@@ -90,6 +90,26 @@ enum XmmRegister {
   kNoXmmRegister = -1  // Signals an illegal register.
 };
 
+// The 256-bit AVX registers, whose lower halves are the XMM registers.
+enum YmmRegister {
+  YMM0 = 0,
+  YMM1 = 1,
+  YMM2 = 2,
+  YMM3 = 3,
+  YMM4 = 4,
+  YMM5 = 5,
+  YMM6 = 6,
+  YMM7 = 7,
+  YMM8 = 8,
+  YMM9 = 9,
+  YMM10 = 10,
+  YMM11 = 11,
+  YMM12 = 12,
+  YMM13 = 13,
+  YMM14 = 14,
+  YMM15 = 15,
+};
+
 // Architecture independent aliases.
 typedef XmmRegister FpuRegister;
 const FpuRegister FpuTMP = XMM15;
@@ -108,6 +108,19 @@ static inline Condition InvertCondition(Condition c) {
   F(min, 0xD)                                                                  \
   F(div, 0xE)                                                                  \
   F(max, 0xF)
+
+// The packed arithmetic and bitwise operations above which have a
+// three-operand AVX form.
+#define XMM_VEX_ALU_CODES(F)                                                   \
+  F(and, 4)                                                                    \
+  F(or, 6)                                                                     \
+  F(xor, 7)                                                                    \
+  F(add, 8)                                                                    \
+  F(mul, 9)                                                                    \
+  F(sub, 0xC)                                                                  \
+  F(min, 0xD)                                                                  \
+  F(div, 0xE)                                                                  \
+  F(max, 0xF)
 // clang-format on
 
 // Table 3-1, first part
@@ -15,6 +15,7 @@
 namespace dart {
 
 DECLARE_FLAG(bool, use_sse41);
+DECLARE_FLAG(bool, use_avx);
 
 class HostCPUFeatures : public AllStatic {
  public:
@@ -40,6 +41,20 @@ class HostCPUFeatures : public AllStatic {
     DEBUG_ASSERT(initialized_);
     return abm_supported_;
   }
+  static bool avx_supported() {
+    DEBUG_ASSERT(initialized_);
+    return avx_supported_ && FLAG_use_avx;
+  }
+  static bool avx2_supported() {
+    DEBUG_ASSERT(initialized_);
+    return avx2_supported_ && FLAG_use_avx;
+  }
+  // Whether the CPU can run AVX code, even when --no-use-avx keeps the
+  // compiler from emitting it.
+  static bool avx_hardware_supported() {
+    DEBUG_ASSERT(initialized_);
+    return avx_supported_;
+  }
 
  private:
   static const char* hardware_;
@@ -47,6 +62,8 @@ class HostCPUFeatures : public AllStatic {
   static bool sse4_1_supported_;
   static bool popcnt_supported_;
   static bool abm_supported_;
+  static bool avx_supported_;
+  static bool avx2_supported_;
 #if defined(DEBUG)
   static bool initialized_;
 #endif
@@ -61,6 +78,14 @@ class TargetCPUFeatures : public AllStatic {
   static bool sse4_1_supported() { return HostCPUFeatures::sse4_1_supported(); }
   static bool popcnt_supported() { return HostCPUFeatures::popcnt_supported(); }
   static bool abm_supported() { return HostCPUFeatures::abm_supported(); }
+  // AOT compiled code may run on other machines than the one compiling it,
+  // so it does not use AVX.
+  static bool avx_supported() {
+    return !FLAG_precompiled_mode && HostCPUFeatures::avx_supported();
+  }
+  static bool avx2_supported() {
+    return !FLAG_precompiled_mode && HostCPUFeatures::avx2_supported();
+  }
   static bool double_truncate_round_supported() { return false; }
 };
 
@@ -21,6 +21,8 @@ bool CpuId::sse2_ = false;
 bool CpuId::sse41_ = false;
 bool CpuId::popcnt_ = false;
 bool CpuId::abm_ = false;
+bool CpuId::avx_ = false;
+bool CpuId::avx2_ = false;
 
 const char* CpuId::id_string_ = nullptr;
 const char* CpuId::brand_string_ = nullptr;
@@ -37,6 +39,27 @@ void CpuId::GetCpuId(int32_t level, uint32_t info[4]) {
 #endif
 }
 
+void CpuId::GetCpuIdCount(int32_t level, int32_t count, uint32_t info[4]) {
+#if defined(HOST_OS_WINDOWS)
+  __cpuidex(reinterpret_cast<int*>(info), level, count);
+#else
+  __get_cpuid_count(level, count, &info[0], &info[1], &info[2], &info[3]);
+#endif
+}
+
+bool CpuId::OSSavesYmmState() {
+  // XCR0 tells which register states the OS saves: bit 1 is SSE (XMM) and
+  // bit 2 is AVX (upper halves of YMM).
+#if defined(HOST_OS_WINDOWS)
+  const uint64_t xcr0 = _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  const uint64_t xcr0 = (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+  return (xcr0 & 0x6) == 0x6;
+}
+
 void CpuId::Init() {
   uint32_t info[4] = {static_cast<uint32_t>(-1)};
 
@@ -48,11 +71,22 @@ void CpuId::Init() {
   *reinterpret_cast<uint32_t*>(id_string + 4) = info[3];
   *reinterpret_cast<uint32_t*>(id_string + 8) = info[2];
   CpuId::id_string_ = id_string;
+  const uint32_t max_level = info[0];
 
   GetCpuId(1, info);
   CpuId::sse41_ = (info[2] & (1 << 19)) != 0;
   CpuId::sse2_ = (info[3] & (1 << 26)) != 0;
   CpuId::popcnt_ = (info[2] & (1 << 23)) != 0;
+  // AVX is only usable if the OS supports XSAVE (OSXSAVE) and saves the YMM
+  // registers.
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  CpuId::avx_ = osxsave && ((info[2] & (1 << 28)) != 0) && OSSavesYmmState();
+
+  if (max_level >= 7) {
+    uint32_t extended_info[4] = {0, 0, 0, 0};
+    GetCpuIdCount(7, 0, extended_info);
+    CpuId::avx2_ = CpuId::avx_ && ((extended_info[1] & (1 << 5)) != 0);
+  }
 
   GetCpuId(0x80000001, info);
   CpuId::abm_ = (info[2] & (1 << 5)) != 0;
@@ -113,6 +147,12 @@ const char* CpuId::field(CpuInfoIndices idx) {
       if (abm()) {
         p += snprintf(p, q - p, "abm ");
       }
+      if (avx()) {
+        p += snprintf(p, q - p, "avx ");
+      }
+      if (avx2()) {
+        p += snprintf(p, q - p, "avx2 ");
+      }
       // Remove last space before returning string.
       if (p != buffer) *(p - 1) = '\0';
       return strdup(buffer);
@@ -35,15 +35,23 @@ class CpuId : public AllStatic {
   static bool sse41() { return sse41_; }
   static bool popcnt() { return popcnt_; }
   static bool abm() { return abm_; }
+  static bool avx() { return avx_; }
+  static bool avx2() { return avx2_; }
 
   static bool sse2_;
   static bool sse41_;
   static bool popcnt_;
   static bool abm_;
+  static bool avx_;
+  static bool avx2_;
   static const char* id_string_;
   static const char* brand_string_;
 
   static void GetCpuId(int32_t level, uint32_t info[4]);
+  static void GetCpuIdCount(int32_t level, int32_t count, uint32_t info[4]);
+
+  // Returns true if the OS saves the YMM registers on context switches.
+  static bool OSSavesYmmState();
 };
 
 }  // namespace dart
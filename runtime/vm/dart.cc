@@ -960,6 +960,12 @@ const char* Dart::FeaturesString(Isolate* isolate,
 #else
     buffer.AddString(" x64-sysv");
 #endif
+    // JIT code may use AVX, which the loading machine must then support.
+    // SnapshotHeaderReader::VerifyFeatures checks this against the CPU
+    // rather than against --use-avx.
+    if (TargetCPUFeatures::avx_supported()) {
+      buffer.AddString(" avx");
+    }
 
 #else
 #error What architecture?
@@ -6350,6 +6350,20 @@ Dart_Handle Dart_LoadTypeFeedback(uint8_t* buffer, intptr_t buffer_length) {
   if (Api::IsError(state)) {
     return state;
   }
+#if defined(DART_PRECOMPILER)
+  if (FLAG_precompiled_mode) {
+    // The precompiler reads the feedback once it has sorted the classes, see
+    // Precompiler::LoadTypeFeedback.
+    const TypedData& feedback = TypedData::Handle(
+        Z, TypedData::New(kTypedDataUint8ArrayCid, buffer_length, Heap::kOld));
+    {
+      NoSafepointScope no_safepoint;
+      memmove(feedback.DataAddr(0), buffer, buffer_length);
+    }
+    T->isolate()->object_store()->set_aot_type_feedback(feedback);
+    return Api::Success();
+  }
+#endif  // defined(DART_PRECOMPILER)
   ReadStream stream(buffer, buffer_length);
   TypeFeedbackLoader loader(thread);
   const Object& error = Object::Handle(loader.LoadFeedback(&stream));
@@ -3142,6 +3142,9 @@ class _DetachedSocket extends Stream<Uint8List> implements Socket {
     _socket.setRawOption(option);
   }
 
+  Future<int> sendFile(RandomAccessFile file, [int offset = 0, int length]) =>
+      _socket.sendFile(file, offset, length);
+
   Map _toJSON(bool ref) {
     return (_socket as dynamic)._toJSON(ref);
   }
@@ -67,4 +67,5 @@ class _IOCrypto {
 _setupHooks() {
   VMLibraryHooks.eventHandlerSendData = _EventHandler._sendData;
   VMLibraryHooks.timerMillisecondClock = _EventHandler._timerMillisecondClock;
+  VMLibraryHooks.timerWheelFactory = _TimerWheel._create;
 }
@@ -15,3 +15,34 @@ class _EventHandler {
   static int _timerMillisecondClock()
       native "EventHandler_TimerMillisecondClock";
 }
+
+// The native timer wheel that the timers of dart:isolate keep long timers in
+// when the VM runs with --timer-wheel. See runtime/bin/timer_wheel.h.
+class _TimerWheel extends NativeFieldWrapperClass1 {
+  _TimerWheel(int now) {
+    _init(now);
+  }
+
+  static _TimerWheel _create() {
+    if (!_enabled()) return null;
+    return new _TimerWheel(_EventHandler._timerMillisecondClock());
+  }
+
+  // Adds a timer due at [wakeupTime] and returns its handle. Handles of
+  // removed and expired timers are reused before new ones are taken, so a new
+  // handle is at most the number of handles handed out before.
+  int add(int wakeupTime) native "TimerWheel_Add";
+
+  void remove(int handle) native "TimerWheel_Remove";
+
+  // Removes the timers that are due at [now] and returns their handles.
+  List<int> advance(int now) native "TimerWheel_Advance";
+
+  // A time at or before the earliest wakeup time of the timers in the wheel,
+  // or -1 if it is empty.
+  int get nextExpiry native "TimerWheel_NextExpiry";
+
+  void _init(int now) native "TimerWheel_Init";
+
+  static bool _enabled() native "TimerWheel_Enabled";
+}
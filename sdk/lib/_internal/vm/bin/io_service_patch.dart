@@ -100,3 +100,83 @@ class _IOService {
     return _id++;
   }
 }
+
+@patch
+class _FileIOEngine {
+  static RawReceivePort _receivePort;
+  static SendPort _replyToPort;
+  static HashMap<int, Completer> _messageMap = new HashMap<int, Completer>();
+  static int _id = 0;
+  static bool _submitScheduled = false;
+
+  @patch
+  static Future _dispatch(int request, List data) {
+    if (request != _IOService.fileRead &&
+        request != _IOService.fileReadInto &&
+        request != _IOService.fileWriteFrom) {
+      return _IOService._dispatch(request, data);
+    }
+    int id;
+    do {
+      id = _getNextId();
+    } while (_messageMap.containsKey(id));
+    _ensureInitialize();
+    final Completer completer = new Completer();
+    _messageMap[id] = completer;
+    try {
+      if (request == _IOService.fileWriteFrom) {
+        _write(data[0], _replyToPort, id, data[1], data[2], data[3]);
+      } else {
+        _read(data[0], _replyToPort, id, data[1],
+            request == _IOService.fileReadInto);
+      }
+    } catch (error, stackTrace) {
+      _messageMap.remove(id).completeError(error, stackTrace);
+      if (_messageMap.length == 0) {
+        _finalize();
+      }
+      return completer.future;
+    }
+    if (!_submitScheduled) {
+      _submitScheduled = true;
+      scheduleMicrotask(_submitQueued);
+    }
+    return completer.future;
+  }
+
+  static void _submitQueued() {
+    _submitScheduled = false;
+    _submit();
+  }
+
+  static void _ensureInitialize() {
+    if (_receivePort == null) {
+      _receivePort = new RawReceivePort();
+      _replyToPort = _receivePort.sendPort;
+      _receivePort.handler = (data) {
+        assert(data is List && data.length == 2);
+        _messageMap.remove(data[0]).complete(data[1]);
+        if (_messageMap.length == 0) {
+          _finalize();
+        }
+      };
+    }
+  }
+
+  static void _finalize() {
+    _id = 0;
+    _receivePort.close();
+    _receivePort = null;
+  }
+
+  static int _getNextId() {
+    if (_id == 0x7FFFFFFF) _id = 0;
+    return _id++;
+  }
+
+  static void _read(int pointer, SendPort replyPort, int id, int length,
+      bool into) native "FileIOEngine_Read";
+  static void _write(int pointer, SendPort replyPort, int id, List<int> buffer,
+      int start, int end) native "FileIOEngine_Write";
+  static void _submit() native "FileIOEngine_Submit";
+}
@@ -124,6 +124,34 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
   // This is a security issue, as it exposes a raw pointer to Dart code.
   int _pointer() native "SecureSocket_FilterPointer";
 
+  int _socketPointer(RawSocket socket) {
+    if (socket is! _RawSocket) return 0;
+    _NativeSocket nativeSocket = (socket as _RawSocket)._socket;
+    if (nativeSocket.isClosing || nativeSocket.isClosed) return 0;
+    int pointer = _nativeSocketPointer(nativeSocket);
+    if (pointer != 0) nativeSocket.borrow();
+    return pointer;
+  }
+
+  int _nativeSocketPointer(_NativeSocket socket)
+      native "SecureSocket_SocketPointer";
+
+  void _socketTransferred(
+      RawSocket socket, int bytesRead, int bytesWritten, bool writeBlocked) {
+    _NativeSocket nativeSocket = (socket as _RawSocket)._socket;
+    nativeSocket.returnBorrowed();
+    if (nativeSocket.isClosing || nativeSocket.isClosed) return;
+    // The native socket's idea of the available data and of whether it can
+    // be written to is only kept up to date by its own reads and writes.
+    nativeSocket.available = nativeSocket.nativeAvailable();
+    if (writeBlocked) nativeSocket.writeAvailable = false;
+    var resourceInfo = nativeSocket.resourceInfo;
+    if (resourceInfo != null) {
+      if (bytesRead > 0) resourceInfo.addRead(bytesRead);
+      if (bytesWritten > 0) resourceInfo.addWrite(bytesWritten);
+    }
+  }
+
   @pragma("vm:entry-point", "get")
   List<_ExternalBuffer> buffers;
 }
@@ -10,8 +10,12 @@
 class RawServerSocket {
   @patch
   static Future<RawServerSocket> bind(address, int port,
-      {int backlog: 0, bool v6Only: false, bool shared: false}) {
-    return _RawServerSocket.bind(address, port, backlog, v6Only, shared);
+      {int backlog: 0,
+      bool v6Only: false,
+      bool shared: false,
+      bool reusePort: false}) {
+    return _RawServerSocket.bind(
+        address, port, backlog, v6Only, shared, reusePort);
   }
 }
 
@@ -87,6 +91,19 @@ class InternetAddress {
     return _NativeSocket.lookup(host, type: type);
   }
 
+  @patch
+  static void configureLookupCache(
+      {int maxEntries: 256,
+      Duration ttl: const Duration(seconds: 30),
+      Duration negativeTtl: const Duration(seconds: 5)}) {
+    _NativeSocket.configureLookupCache(
+        maxEntries: maxEntries, ttl: ttl, negativeTtl: negativeTtl);
+  }
+
+  @patch
+  static Map<String, int> get lookupCacheStatistics =>
+      _NativeSocket.lookupCacheStatistics();
+
   @patch
   static InternetAddress _cloneWithNewHost(
       InternetAddress address, String host) {
@@ -350,6 +367,22 @@ class _NetworkInterface implements NetworkInterface {
 // implicit constructor.
 class _NativeSocketNativeWrapper extends NativeFieldWrapperClass1 {}
 
+// The state of a _NativeSocket.sendFile call that has not yet sent all of
+// its data.
+class _SendFileRequest {
+  final _RandomAccessFile file;
+  int offset;
+  int remaining;
+  int sent = 0;
+  // Whether a part of the file is being sent by the IO service.
+  bool inFlight = false;
+  // Whether the socket became writable while a part was in flight.
+  bool writeEventPending = false;
+  final Completer<int> completer = new Completer<int>();
+
+  _SendFileRequest(this.file, this.offset, this.remaining);
+}
+
 // The _NativeSocket class encapsulates an OS socket.
 class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   // Bit flags used when communicating between the eventhandler and
@@ -416,6 +449,17 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   static const int normalTokenBatchSize = 8;
   static const int listeningTokenBatchSize = 2;
 
+  // Must match SocketBase::kMaxWriteVectors in runtime/bin/socket_base.h.
+  static const int _maxWriteVectors = 64;
+
+  // Must match the side table layout in Socket_RecvFromBatch and
+  // Socket_SendToBatch in runtime/bin/socket.cc.
+  static const int _batchAddressStride = 17;
+  static const int _batchMetadataStride = 4;
+
+  // Must match SocketBase::kMaxDatagramBatch in runtime/bin/socket_base.h.
+  static const int _maxDatagramBatch = 64;
+
   static const Duration _retryDuration = const Duration(milliseconds: 250);
   static const Duration _retryDurationLoopback =
       const Duration(milliseconds: 25);
@@ -463,6 +507,27 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   bool writeEventIssued = false;
   bool writeAvailable = false;
 
+  // A sendFile in progress, continued from write events until it is done.
+  _SendFileRequest _sendFileRequest;
+
+  // Writes of at least this many bytes are sent with zero-copy sends. 0 when
+  // zero-copy sends are not enabled.
+  int _zeroCopyThreshold = 0;
+  // Whether zero-copy sends were ever enabled, and buffers may still be
+  // pinned.
+  bool _zeroCopyUsed = false;
+
+  // The threshold used when zero-copy sends are enabled with
+  // [SocketOption.zeroCopy]. Below this size copying the data is cheaper than
+  // pinning its pages and reaping the completion.
+  static const int _defaultZeroCopyThreshold = 16 * 1024;
+
+  // The number of requests on other threads that use the file descriptor of
+  // this socket. The socket is not closed while there are any.
+  int _borrowers = 0;
+  static const Duration _zeroCopyClosePollInterval =
+      const Duration(milliseconds: 5);
+
   static bool connectedResourceHandler = false;
   _ReadWriteResourceInfo resourceInfo;
 
@@ -485,6 +550,36 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     });
   }
 
+  // See HostLookupCache in host_lookup_cache.h.
+  static void configureLookupCache(
+      {int maxEntries, Duration ttl, Duration negativeTtl}) {
+    if (maxEntries < 0) throw new RangeError.value(maxEntries, "maxEntries");
+    if (ttl.isNegative) throw new RangeError.value(ttl.inMilliseconds, "ttl");
+    if (negativeTtl.isNegative) {
+      throw new RangeError.value(negativeTtl.inMilliseconds, "negativeTtl");
+    }
+    _configureLookupCache(
+        maxEntries, ttl.inMilliseconds, negativeTtl.inMilliseconds);
+  }
+
+  // Returns the counters of the lookup cache. Keep the keys in sync with
+  // HostLookupCache::Statistic in host_lookup_cache.h.
+  static Map<String, int> lookupCacheStatistics() {
+    List<int> values = _lookupCacheStatistics();
+    return <String, int>{
+      "hits": values[0],
+      "negativeHits": values[1],
+      "misses": values[2],
+      "coalesced": values[3],
+      "entries": values[4],
+    };
+  }
+
+  static void _configureLookupCache(int maxEntries, int ttlMillis,
+      int negativeTtlMillis) native "Socket_ConfigureLookupCache";
+  static List<int> _lookupCacheStatistics()
+      native "Socket_GetLookupCacheStatistics";
+
   static Future<InternetAddress> reverseLookup(InternetAddress addr) {
     return _IOService._dispatch(_IOService.socketReverseLookup,
         [(addr as _InternetAddress)._in_addr]).then((response) {
@@ -727,8 +822,8 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
-  static Future<_NativeSocket> bind(
-      host, int port, int backlog, bool v6Only, bool shared) async {
+  static Future<_NativeSocket> bind(host, int port, int backlog, bool v6Only,
+      bool shared, bool reusePort) async {
     _throwOnBadPort(port);
     if (host is String) {
       host = escapeLinkLocalAddress(host);
@@ -746,8 +841,8 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       result = socket.nativeCreateUnixDomainBindListen(
           path, backlog, shared, _Namespace._namespace);
     } else {
-      result = socket.nativeCreateBindListen(
-          address._in_addr, port, backlog, v6Only, shared, address._scope_id);
+      result = socket.nativeCreateBindListen(address._in_addr, port, backlog,
+          v6Only, shared, reusePort, address._scope_id);
     }
     if (result is OSError) {
       throw new SocketException("Failed to create server socket",
@@ -907,16 +1002,24 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     if (isClosing || isClosed) return 0;
     if (bytes == 0) return 0;
     try {
-      _BufferAndStart bufferAndStart =
-          _ensureFastAndSerializableByteData(buffer, offset, offset + bytes);
+      // A zero-copy send needs the buffer itself, so it must not be copied
+      // here. The native side falls back to copying when it has to.
+      bool zeroCopy = _zeroCopyThreshold > 0 &&
+          bytes >= _zeroCopyThreshold &&
+          buffer is Uint8List;
+      _BufferAndStart bufferAndStart = zeroCopy
+          ? new _BufferAndStart(buffer, offset)
+          : _ensureFastAndSerializableByteData(buffer, offset, offset + bytes);
       if (!const bool.fromEnvironment("dart.vm.product")) {
         _SocketProfile.collectStatistic(
             nativeGetSocketId(),
             _SocketProfileType.writeBytes,
             bufferAndStart.buffer.length - bufferAndStart.start);
       }
-      int result =
-          nativeWrite(bufferAndStart.buffer, bufferAndStart.start, bytes);
+      int result = zeroCopy
+          ? nativeWriteZeroCopy(
+              bufferAndStart.buffer, bufferAndStart.start, bytes)
+          : nativeWrite(bufferAndStart.buffer, bufferAndStart.start, bytes);
       // The result may be negative, if we forced a short write for testing
       // purpose. In such case, don't mark writeAvailable as false, as we don't
       // know if we'll receive an event. It's better to just retry.
@@ -938,6 +1041,249 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     }
   }
 
+  // Writes the given buffers, starting at [offset] in the first one, with a
+  // single gathering write where the platform supports it. Returns the total
+  // number of bytes written, which may cover only a prefix of [buffers].
+  int writeVector(List<List<int>> buffers, int offset) {
+    if (isClosing || isClosed) return 0;
+    if (buffers.isEmpty) return 0;
+    // Zero-copy sends take one buffer at a time.
+    if (_zeroCopyThreshold > 0) {
+      return write(buffers[0], offset, buffers[0].length - offset);
+    }
+    try {
+      var count = buffers.length;
+      if (count > _maxWriteVectors) count = _maxWriteVectors;
+      var nativeBuffers = new List(count);
+      var starts = new List<int>(count);
+      var ends = new List<int>(count);
+      int bytes = 0;
+      for (int i = 0; i < count; i++) {
+        var buffer = buffers[i];
+        int start = (i == 0) ? offset : 0;
+        _BufferAndStart bufferAndStart =
+            _ensureFastAndSerializableByteData(buffer, start, buffer.length);
+        nativeBuffers[i] = bufferAndStart.buffer;
+        starts[i] = bufferAndStart.start;
+        ends[i] = bufferAndStart.start + buffer.length - start;
+        bytes += buffer.length - start;
+      }
+      int result = nativeWriteVector(nativeBuffers, starts, ends);
+      // See write() for the meaning of a negative result.
+      if (result >= 0 && result < bytes) {
+        writeAvailable = false;
+      }
+      if (result < 0) result = -result;
+      if (!const bool.fromEnvironment("dart.vm.product")) {
+        _SocketProfile.collectStatistic(
+            nativeGetSocketId(), _SocketProfileType.writeBytes, result);
+      }
+      if (resourceInfo != null) {
+        resourceInfo.addWrite(result);
+      }
+      return result;
+    } catch (e) {
+      StackTrace st = StackTrace.current;
+      scheduleMicrotask(() => reportError(e, st, "Write failed"));
+      return 0;
+    }
+  }
+
+  // Receives up to [buffer.length ~/ slotSize] datagrams, datagram i being
+  // stored at offset i * slotSize of [buffer]. Entries
+  // [_batchMetadataStride * i, ...] of [metadata] receive its length, source
+  // port, UDP_GRO segment size and whether it was truncated, and entries
+  // [_batchAddressStride * i, ...] of [addresses] receive the source address
+  // length followed by the address bytes. Returns the number of datagrams
+  // received.
+  int receiveBatch(Uint8List buffer, int slotSize, Int32List metadata,
+      Uint8List addresses) {
+    if (isClosing || isClosed) return 0;
+    try {
+      int count = nativeRecvFromBatch(buffer, slotSize, metadata, addresses);
+      if (count > 0) {
+        int bytes = 0;
+        for (int i = 0; i < count; i++) {
+          bytes += metadata[i * _batchMetadataStride];
+        }
+        if (resourceInfo != null) {
+          resourceInfo.totalRead += bytes;
+          resourceInfo.didRead();
+        }
+        if (!const bool.fromEnvironment("dart.vm.product")) {
+          _SocketProfile.collectStatistic(
+              nativeGetSocketId(), _SocketProfileType.readBytes, bytes);
+        }
+      }
+      _availableDatagram = nativeAvailableDatagram();
+      return count;
+    } on ArgumentError {
+      // Malformed side tables are reported to the caller.
+      rethrow;
+    } catch (e) {
+      reportError(e, StackTrace.current, "Receive failed");
+      return 0;
+    }
+  }
+
+  // Sends the datagrams [offsets[i], offsets[i + 1]) of [buffer] to the
+  // address at [_batchAddressStride * i] of [addresses] and port [ports[i]].
+  // Returns the number of datagrams sent.
+  int sendBatch(Uint8List buffer, Int32List offsets, Uint8List addresses,
+      Int32List ports) {
+    if (isClosing || isClosed) return 0;
+    try {
+      int count = nativeSendToBatch(buffer, offsets, addresses, ports);
+      if (count > 0) {
+        int bytes = offsets[count] - offsets[0];
+        if (resourceInfo != null) {
+          resourceInfo.addWrite(bytes);
+        }
+        if (!const bool.fromEnvironment("dart.vm.product")) {
+          _SocketProfile.collectStatistic(
+              nativeGetSocketId(), _SocketProfileType.writeBytes, bytes);
+        }
+      }
+      return count;
+    } on ArgumentError {
+      // Malformed side tables are reported to the caller.
+      rethrow;
+    } catch (e) {
+      StackTrace st = StackTrace.current;
+      scheduleMicrotask(() => reportError(e, st, "Send failed"));
+      return 0;
+    }
+  }
+
+  // Enables zero-copy sends for writes of at least [threshold] bytes. Small
+  // writes are cheaper to copy than to pin, so they keep the copying path.
+  // Only external Uint8List buffers are sent without copying, as other
+  // buffers may be moved by the GC. The kernel reads from the buffer after
+  // write returns, so the buffer is pinned until the kernel reports the send
+  // as completed, and its contents must not be changed until then. Returns
+  // false if the platform does not support zero-copy sends.
+  bool enableZeroCopy(int threshold) {
+    if (threshold <= 0) throw new RangeError.value(threshold);
+    if (!isTcp || isClosing || isClosed) return false;
+    try {
+      if (!nativeEnableZeroCopy()) return false;
+    } catch (e) {
+      return false;
+    }
+    _zeroCopyThreshold = threshold;
+    _zeroCopyUsed = true;
+    return true;
+  }
+
+  // Sends [length] bytes of [file] starting at [offset] to the socket. Where
+  // the platform allows it the data goes directly from the file to the socket
+  // without being copied through Dart buffers, and the IO service does the
+  // sending so that reading the file does not block the isolate. When the
+  // socket buffer is full the transfer continues on the next write event.
+  // Other writes must not be issued until the returned future completes.
+  Future<int> sendFile(RandomAccessFile file, int offset, int length) {
+    if (isClosing || isClosed) {
+      return new Future.error(const SocketException.closed());
+    }
+    if (_sendFileRequest != null) {
+      return new Future.error(
+          new StateError("A sendFile is already in progress"));
+    }
+    if (offset < 0) return new Future.error(new RangeError.value(offset));
+    if (length < 0) return new Future.error(new RangeError.value(length));
+    var request =
+        new _SendFileRequest(file as _RandomAccessFile, offset, length);
+    _sendFileRequest = request;
+    _continueSendFile();
+    return request.completer.future;
+  }
+
+  void _continueSendFile() {
+    var request = _sendFileRequest;
+    if (request.inFlight) {
+      request.writeEventPending = true;
+      return;
+    }
+    if (request.remaining == 0) {
+      _sendFileRequest = null;
+      request.completer.complete(request.sent);
+      return;
+    }
+    if (isClosing) {
+      _failSendFile(request, const SocketException.closed(), null);
+      return;
+    }
+    int socketPointer = nativeSendFileSocketPointer();
+    if (socketPointer == 0) {
+      _sendFileOnIsolate(request);
+      return;
+    }
+    // The IO service uses the file descriptor until it responds, so the
+    // socket is not closed before then.
+    borrow();
+    request.inFlight = true;
+    request.writeEventPending = false;
+    request.file._dispatch(_IOService.socketSendFile,
+        [null, socketPointer, request.offset, request.remaining]).then(
+        (response) {
+      request.inFlight = false;
+      if (isErrorResponse(response)) {
+        throw createError(response, "Send file failed");
+      }
+      if (response == 0 && !request.writeEventPending) {
+        // The socket buffer is full, wait for the next write event.
+        writeAvailable = false;
+      } else {
+        _sentFilePart(request, response);
+        _continueSendFile();
+      }
+    }).catchError((e, st) {
+      request.inFlight = false;
+      _failSendFile(request, e, st);
+    }).whenComplete(returnBorrowed);
+  }
+
+  // Sends the file on platforms where the socket can only be written to from
+  // the isolate.
+  void _sendFileOnIsolate(_SendFileRequest request) {
+    try {
+      while (request.remaining > 0) {
+        int sent = nativeSendFile(
+            request.file._ops, request.offset, request.remaining);
+        if (sent == 0) {
+          // The socket buffer is full, wait for the next write event.
+          writeAvailable = false;
+          return;
+        }
+        _sentFilePart(request, sent);
+      }
+    } catch (e, st) {
+      _failSendFile(request, createError(e, "Send file failed"), st);
+      return;
+    }
+    _continueSendFile();
+  }
+
+  void _sentFilePart(_SendFileRequest request, int sent) {
+    request.offset += sent;
+    request.remaining -= sent;
+    request.sent += sent;
+    if (resourceInfo != null) {
+      resourceInfo.addWrite(sent);
+    }
+    if (!const bool.fromEnvironment("dart.vm.product")) {
+      _SocketProfile.collectStatistic(
+          nativeGetSocketId(), _SocketProfileType.writeBytes, sent);
+    }
+  }
+
+  void _failSendFile(_SendFileRequest request, error, StackTrace st) {
+    // The request may have failed already because the socket was destroyed.
+    if (!identical(_sendFileRequest, request)) return;
+    _sendFileRequest = null;
+    request.completer.completeError(error, st);
+  }
+
   int send(List<int> buffer, int offset, int bytes, InternetAddress address,
       int port) {
     _throwOnBadPort(port);
@@ -1087,6 +1433,14 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
         if (i == writeEvent) {
           writeAvailable = true;
+          if (_zeroCopyUsed) {
+            // Completions of zero-copy sends are delivered as write events.
+            nativeReapZeroCopy(false);
+          }
+          if (_sendFileRequest != null) {
+            _continueSendFile();
+            if (_sendFileRequest != null) continue;
+          }
           issueWriteEvent(delayed: false);
           continue;
         }
@@ -1115,6 +1469,11 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
           if (resourceInfo != null) {
             _SocketResourceInfo.SocketClosed(resourceInfo);
           }
+          if (_sendFileRequest != null) {
+            _sendFileRequest.completer
+                .completeError(const SocketException.closed());
+            _sendFileRequest = null;
+          }
           isClosed = true;
           closeCompleter.complete();
           disconnectFromEventHandler();
@@ -1175,12 +1534,52 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   Future close() {
     if (!isClosing && !isClosed) {
-      sendToEventHandler(1 << closeCommand);
       isClosing = true;
+      _closeWhenUnused();
     }
     return closeCompleter.future;
   }
 
+  // Marks the file descriptor as used by a request on another thread, which
+  // must call [returnBorrowed] when it is done with it.
+  void borrow() {
+    assert(!isClosing && !isClosed);
+    _borrowers++;
+  }
+
+  void returnBorrowed() {
+    assert(_borrowers > 0);
+    _borrowers--;
+    if (_borrowers == 0 && isClosing && !isClosed) _closeWhenUnused();
+  }
+
+  // Sends the close command once nothing uses the file descriptor anymore.
+  //
+  // The kernel reads the buffers of zero-copy sends until it reports them as
+  // completed, which it does through the error queue of the socket. So the
+  // close is also held back, and the buffers stay pinned, until every send
+  // has completed. A connection that fails completes its outstanding sends
+  // too.
+  void _closeWhenUnused() {
+    assert(isClosing);
+    if (_borrowers > 0) return;
+    if (_zeroCopyUsed && nativeReapZeroCopy(true) > 0) {
+      new Timer.periodic(_zeroCopyClosePollInterval, (Timer timer) {
+        if (nativeReapZeroCopy(true) > 0) return;
+        timer.cancel();
+        _sendCloseCommand();
+      });
+      return;
+    }
+    _sendCloseCommand();
+  }
+
+  void _sendCloseCommand() {
+    connectToEventHandler();
+    _EventHandler._sendData(this, eventPort.sendPort,
+        (typeFlags & typeTypeMask) | (1 << closeCommand));
+  }
+
   void shutdown(SocketDirection direction) {
     if (!isClosing && !isClosed) {
       switch (direction) {
@@ -1294,11 +1693,19 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   getOption(SocketOption option) {
     if (option == null) throw new ArgumentError.notNull("option");
+    if (option == SocketOption.zeroCopy) return _zeroCopyThreshold > 0;
     return nativeGetOption(option._value, address.type._value);
   }
 
   bool setOption(SocketOption option, value) {
     if (option == null) throw new ArgumentError.notNull("option");
+    if (option == SocketOption.zeroCopy) {
+      if (!value) {
+        _zeroCopyThreshold = 0;
+        return true;
+      }
+      return enableZeroCopy(_defaultZeroCopyThreshold);
+    }
     nativeSetOption(option._value, address.type._value, value);
     return true;
   }
@@ -1363,8 +1770,22 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   Datagram nativeRecvFrom() native "Socket_RecvFrom";
   int nativeWrite(List<int> buffer, int offset, int bytes)
       native "Socket_WriteList";
+  int nativeWriteVector(List buffers, List<int> starts, List<int> ends)
+      native "Socket_WriteVector";
+  bool nativeEnableZeroCopy() native "Socket_EnableZeroCopy";
+  int nativeWriteZeroCopy(List<int> buffer, int offset, int bytes)
+      native "Socket_WriteZeroCopy";
+  int nativeReapZeroCopy(bool poll) native "Socket_ReapZeroCopy";
   int nativeSendTo(List<int> buffer, int offset, int bytes, Uint8List address,
       int port) native "Socket_SendTo";
+  int nativeSendFile(_RandomAccessFileOps file, int offset, int length)
+      native "Socket_SendFile";
+  int nativeSendFileSocketPointer() native "Socket_SendFileSocketPointer";
+  int nativeRecvFromBatch(Uint8List buffer, int slotSize, Int32List metadata,
+      Uint8List addresses) native "Socket_RecvFromBatch";
+  int nativeGetMaxDatagramSize() native "Socket_GetMaxDatagramSize";
+  int nativeSendToBatch(Uint8List buffer, Int32List offsets,
+      Uint8List addresses, Int32List ports) native "Socket_SendToBatch";
   nativeCreateConnect(Uint8List addr, int port, int scope_id)
       native "Socket_CreateConnect";
   nativeCreateUnixDomainConnect(String addr, _Namespace namespace)
@@ -1375,7 +1796,8 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       _Namespace namespace) native "Socket_CreateUnixDomainBindConnect";
   bool isBindError(int errorNumber) native "SocketBase_IsBindError";
   nativeCreateBindListen(Uint8List addr, int port, int backlog, bool v6Only,
-      bool shared, int scope_id) native "ServerSocket_CreateBindListen";
+      bool shared, bool reusePort, int scope_id)
+      native "ServerSocket_CreateBindListen";
   nativeCreateUnixDomainBindListen(String addr, int backlog, bool shared,
       _Namespace namespace) native "ServerSocket_CreateUnixDomainBindListen";
   nativeCreateBindDatagram(Uint8List addr, int port, bool reuseAddress,
@@ -1403,11 +1825,12 @@ class _RawServerSocket extends Stream<RawSocket> implements RawServerSocket {
   StreamController<RawSocket> _controller;
   bool _v6Only;
 
-  static Future<_RawServerSocket> bind(
-      address, int port, int backlog, bool v6Only, bool shared) {
+  static Future<_RawServerSocket> bind(address, int port, int backlog,
+      bool v6Only, bool shared, bool reusePort) {
     _throwOnBadPort(port);
     if (backlog < 0) throw new ArgumentError("Invalid backlog $backlog");
-    return _NativeSocket.bind(address, port, backlog, v6Only, shared)
+    return _NativeSocket.bind(
+            address, port, backlog, v6Only, shared, reusePort)
         .then((socket) => new _RawServerSocket(socket, v6Only));
   }
 
@@ -1596,6 +2019,9 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
   int write(List<int> buffer, [int offset, int count]) =>
       _socket.write(buffer, offset, count);
 
+  int _writeVector(List<List<int>> buffers, int offset) =>
+      _socket.writeVector(buffers, offset);
+
   Future<RawSocket> close() => _socket.close().then<RawSocket>((_) {
         if (!const bool.fromEnvironment("dart.vm.product")) {
           _SocketProfile.collectStatistic(
@@ -1670,17 +2096,22 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
 class ServerSocket {
   @patch
   static Future<ServerSocket> _bind(address, int port,
-      {int backlog: 0, bool v6Only: false, bool shared: false}) {
-    return _ServerSocket.bind(address, port, backlog, v6Only, shared);
+      {int backlog: 0,
+      bool v6Only: false,
+      bool shared: false,
+      bool reusePort: false}) {
+    return _ServerSocket.bind(
+        address, port, backlog, v6Only, shared, reusePort);
   }
 }
 
 class _ServerSocket extends Stream<Socket> implements ServerSocket {
   final _socket;
 
-  static Future<_ServerSocket> bind(
-      address, int port, int backlog, bool v6Only, bool shared) {
-    return _RawServerSocket.bind(address, port, backlog, v6Only, shared)
+  static Future<_ServerSocket> bind(address, int port, int backlog,
+      bool v6Only, bool shared, bool reusePort) {
+    return _RawServerSocket.bind(
+            address, port, backlog, v6Only, shared, reusePort)
         .then((socket) => new _ServerSocket(socket));
   }
 
@@ -1731,11 +2162,16 @@ class Socket {
 }
 
 class _SocketStreamConsumer extends StreamConsumer<List<int>> {
+  // The number of buffers queued before the stream is paused. Queued buffers
+  // are flushed together with a single gathering write.
+  static const int _maxQueuedBuffers = _NativeSocket._maxWriteVectors;
+
   StreamSubscription subscription;
   final _Socket socket;
-  int offset;
-  List<int> buffer;
+  int offset = 0;
+  final List<List<int>> buffers = <List<int>>[];
   bool paused = false;
+  bool streamDone = false;
   Completer streamCompleter;
 
   _SocketStreamConsumer(this.socket);
@@ -1743,11 +2179,19 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   Future<Socket> addStream(Stream<List<int>> stream) {
     socket._ensureRawSocketSubscription();
     streamCompleter = new Completer<Socket>();
+    streamDone = false;
     if (socket._raw != null) {
       subscription = stream.listen((data) {
         assert(!paused);
-        assert(buffer == null);
-        buffer = data;
+        buffers.add(data);
+        if (buffers.length > 1) {
+          // Waiting for a write event, which flushes all queued buffers.
+          if (buffers.length >= _maxQueuedBuffers) {
+            paused = true;
+            subscription.pause();
+          }
+          return;
+        }
         offset = 0;
         try {
           write();
@@ -1760,7 +2204,12 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
         socket.destroy();
         done(error, stackTrace);
       }, onDone: () {
-        done();
+        // Queued buffers are still to be written.
+        if (buffers.isEmpty) {
+          done();
+        } else {
+          streamDone = true;
+        }
       }, cancelOnError: true);
     }
     return streamCompleter.future;
@@ -1773,21 +2222,24 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
 
   void write() {
     if (subscription == null) return;
-    assert(buffer != null);
+    assert(buffers.isNotEmpty);
     // Write as much as possible.
-    offset += socket._write(buffer, offset, buffer.length - offset);
-    if (offset < buffer.length) {
-      if (!paused) {
-        paused = true;
-        subscription.pause();
-      }
-      socket._enableWriteEvent();
+    var buffer = buffers[0];
+    if (buffers.length == 1) {
+      offset += socket._write(buffer, offset, buffer.length - offset);
     } else {
-      buffer = null;
-      if (paused) {
-        paused = false;
-        subscription.resume();
-      }
+      offset += socket._writeVector(buffers, offset);
+    }
+    while (buffers.isNotEmpty && offset >= buffers[0].length) {
+      offset -= buffers.removeAt(0).length;
+    }
+    if (buffers.isNotEmpty) {
+      socket._enableWriteEvent();
+    } else if (streamDone) {
+      done();
+    } else if (paused) {
+      paused = false;
+      subscription.resume();
     }
   }
 
@@ -1806,12 +2258,17 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
     if (subscription == null) return;
     subscription.cancel();
     subscription = null;
+    buffers.clear();
+    offset = 0;
     paused = false;
     socket._disableWriteEvent();
   }
 }
 
 class _Socket extends Stream<Uint8List> implements Socket {
+  // The chunk size used by sendFile when the file is copied.
+  static const int _sendFileChunkSize = 64 * 1024;
+
   RawSocket _raw; // Set to null when the raw socket is closed.
   bool _closed = false; // Set to true when the raw socket is closed.
   StreamController<Uint8List> _controller;
@@ -1884,6 +2341,44 @@ class _Socket extends Stream<Uint8List> implements Socket {
 
   Future flush() => _sink.flush();
 
+  Future<int> sendFile(RandomAccessFile file,
+      [int offset = 0, int length]) async {
+    if (offset < 0) throw new RangeError.value(offset, "offset");
+    int bytes = length ?? await file.length() - offset;
+    if (bytes < 0) throw new RangeError.value(bytes, "length");
+    // Data added before goes first.
+    await flush();
+    final raw = _raw;
+    if (raw == null) throw const SocketException.closed();
+    if (raw is _RawSocket && file is _RandomAccessFile) {
+      return raw._socket.sendFile(file, offset, bytes);
+    }
+    return _sendFileCopy(file, offset, bytes);
+  }
+
+  // Sends the file by reading and adding it a chunk at a time, for sockets
+  // which cannot send it directly.
+  Future<int> _sendFileCopy(
+      RandomAccessFile file, int offset, int length) async {
+    int position = await file.position();
+    int sent = 0;
+    try {
+      await file.setPosition(offset);
+      while (sent < length) {
+        int chunkSize = length - sent;
+        if (chunkSize > _sendFileChunkSize) chunkSize = _sendFileChunkSize;
+        var chunk = await file.read(chunkSize);
+        if (chunk.isEmpty) break;
+        add(chunk);
+        sent += chunk.length;
+      }
+      await flush();
+    } finally {
+      await file.setPosition(position);
+    }
+    return sent;
+  }
+
   Future close() => _sink.close();
 
   Future get done => _sink.done;
@@ -1936,7 +2431,7 @@ class _Socket extends Stream<Uint8List> implements Socket {
     _detachReady = new Completer();
     _sink.close();
     return _detachReady.future.then((_) {
-      assert(_consumer.buffer == null);
+      assert(_consumer.buffers.isEmpty);
       var raw = _raw;
       _raw = null;
       return [raw, _subscription];
@@ -2022,6 +2517,17 @@ class _Socket extends Stream<Uint8List> implements Socket {
     return 0;
   }
 
+  // Writes the queued [buffers] of the consumer, starting at [offset] in the
+  // first one. Only plain sockets gather the writes; secure sockets write
+  // the first buffer.
+  int _writeVector(List<List<int>> buffers, int offset) {
+    var raw = _raw;
+    if (raw is _RawSocket) {
+      return raw._writeVector(buffers, offset);
+    }
+    return _write(buffers[0], offset, buffers[0].length - offset);
+  }
+
   void _enableWriteEvent() {
     if (_raw != null) {
       _raw.writeEventsEnabled = true;
@@ -2068,6 +2574,14 @@ class _RawDatagramSocket extends Stream<RawSocketEvent>
   bool _readEventsEnabled = true;
   bool _writeEventsEnabled = true;
 
+  // The buffers used by receiveBatch, reused while the batch size stays the
+  // same. Each datagram gets a slot of _batchSlotSize bytes, the largest
+  // datagram the socket accepts when the buffers were allocated.
+  Uint8List _batchBuffer;
+  int _batchSlotSize = 0;
+  Int32List _batchMetadata;
+  Uint8List _batchAddresses;
+
   _RawDatagramSocket(this._socket) {
     var zone = Zone.current;
     _controller = new StreamController<RawSocketEvent>(
@@ -2130,6 +2644,92 @@ class _RawDatagramSocket extends Stream<RawSocketEvent>
     return _socket.receive();
   }
 
+  List<Datagram> receiveBatch([int maxDatagrams = 8]) {
+    RangeError.checkValueInInterval(
+        maxDatagrams, 1, _NativeSocket._maxDatagramBatch, "maxDatagrams");
+    var buffer = _batchBuffer;
+    var metadata = _batchMetadata;
+    var addresses = _batchAddresses;
+    if (buffer == null ||
+        metadata == null ||
+        addresses == null ||
+        metadata.length != maxDatagrams * _NativeSocket._batchMetadataStride) {
+      _batchSlotSize = _socket.nativeGetMaxDatagramSize();
+      buffer = _batchBuffer = new Uint8List(maxDatagrams * _batchSlotSize);
+      metadata = _batchMetadata =
+          new Int32List(maxDatagrams * _NativeSocket._batchMetadataStride);
+      addresses = _batchAddresses =
+          new Uint8List(maxDatagrams * _NativeSocket._batchAddressStride);
+    }
+    int count =
+        _socket.receiveBatch(buffer, _batchSlotSize, metadata, addresses);
+    var result = <Datagram>[];
+    for (int i = 0; i < count; i++) {
+      int entry = i * _NativeSocket._batchMetadataStride;
+      int length = metadata[entry];
+      int port = metadata[entry + 1];
+      int segmentSize = metadata[entry + 2];
+      bool truncated = metadata[entry + 3] != 0;
+      int addressStart = i * _NativeSocket._batchAddressStride + 1;
+      var address = new InternetAddress.fromRawAddress(addresses.sublist(
+          addressStart, addressStart + addresses[addressStart - 1]));
+      // A datagram coalesced by UDP_GRO holds segments of segmentSize bytes,
+      // the last of which may be shorter, and is the one cut off when the
+      // datagram did not fit its slot.
+      if (segmentSize <= 0) segmentSize = length;
+      int start = buffer.offsetInBytes + i * _batchSlotSize;
+      int offset = 0;
+      do {
+        int end = offset + segmentSize;
+        if (end > length) end = length;
+        result.add(new Datagram(
+            new Uint8List.view(buffer.buffer, start + offset, end - offset),
+            address,
+            port,
+            truncated && end == length));
+        offset = end;
+      } while (offset < length);
+    }
+    return result;
+  }
+
+  int sendBatch(List<Datagram> datagrams) {
+    int count = datagrams.length;
+    if (count > _NativeSocket._maxDatagramBatch) {
+      count = _NativeSocket._maxDatagramBatch;
+    }
+    if (count == 0) return 0;
+    int bytes = 0;
+    for (int i = 0; i < count; i++) {
+      var datagram = datagrams[i];
+      _throwOnBadPort(datagram.port);
+      if (datagram.address.type == InternetAddressType.unix) {
+        throw new ArgumentError.value(
+            datagram.address, "address", "Unix domain address");
+      }
+      bytes += datagram.data.length;
+    }
+    var buffer = new Uint8List(bytes);
+    var offsets = new Int32List(count + 1);
+    var addresses = new Uint8List(count * _NativeSocket._batchAddressStride);
+    var ports = new Int32List(count);
+    int offset = 0;
+    for (int i = 0; i < count; i++) {
+      var datagram = datagrams[i];
+      offsets[i] = offset;
+      buffer.setRange(offset, offset + datagram.data.length, datagram.data);
+      offset += datagram.data.length;
+      var rawAddress = datagram.address.rawAddress;
+      int addressStart = i * _NativeSocket._batchAddressStride;
+      addresses[addressStart] = rawAddress.length;
+      addresses.setRange(
+          addressStart + 1, addressStart + 1 + rawAddress.length, rawAddress);
+      ports[i] = datagram.port;
+    }
+    offsets[count] = offset;
+    return _socket.sendBatch(buffer, offsets, addresses, ports);
+  }
+
   void joinMulticast(InternetAddress group, [NetworkInterface interface]) {
     _socket.joinMulticast(group, interface);
   }
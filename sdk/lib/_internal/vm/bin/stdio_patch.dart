@@ -33,6 +33,9 @@ class _StdIOUtils {
       throw FileSystemException(
           "Failed to get type of stdio handle (fd $fd)", "", type);
     }
+    if (_BufferedStdConsumer._enabled()) {
+      return new Stdout._(new IOSink(new _BufferedStdConsumer(fd)), fd);
+    }
     return new Stdout._(new IOSink(new _StdConsumer(fd)), fd);
   }
 
@@ -52,6 +55,10 @@ class _StdIOUtils {
 
   @patch
   static _getStdioHandleType(int fd) native "File_GetStdioHandleType";
+
+  @patch
+  static Map<String, Object> _bufferedStdioStatistics() =>
+      _BufferedStdConsumer.statistics();
 }
 
 @patch
@@ -163,6 +170,55 @@ class Stdout {
   static _getAnsiSupported(int fd) native "Stdout_AnsiSupported";
 }
 
+// Writes to stdout or stderr through the native buffer of --buffered-stdio,
+// which a separate thread writes out.
+class _BufferedStdConsumer implements StreamConsumer<List<int>> {
+  final int _fd;
+
+  _BufferedStdConsumer(this._fd);
+
+  Future addStream(Stream<List<int>> stream) {
+    var completer = new Completer();
+    var sub;
+    sub = stream.listen((data) {
+      try {
+        _write(_fd, data is Uint8List ? data : new Uint8List.fromList(data));
+      } catch (e, s) {
+        sub.cancel();
+        completer.completeError(e, s);
+      }
+    },
+        onError: completer.completeError,
+        onDone: completer.complete,
+        cancelOnError: true);
+    return completer.future;
+  }
+
+  Future close() {
+    _flush();
+    return new Future.value();
+  }
+
+  // Returns the counters of the buffer. Keep the keys in sync with
+  // StdioBuffer::Statistic in stdio.h and with StdioBufferStatistics in
+  // runtime/vm/service/service_extension.md.
+  static Map<String, Object> statistics() {
+    List<int> values = _statistics();
+    return <String, Object>{
+      "enabled": _enabled(),
+      "bytesWritten": values[0],
+      "bytesDropped": values[1],
+      "writes": values[2],
+      "blockedMicroseconds": values[3],
+    };
+  }
+
+  static bool _enabled() native "Stdout_BufferedEnabled";
+  static void _write(int fd, Uint8List data) native "Stdout_BufferedWrite";
+  static void _flush() native "Stdout_BufferedFlush";
+  static List<int> _statistics() native "Stdout_GetBufferedStatistics";
+}
+
 bool _getStdioHandle(_NativeSocket socket, int num)
     native "Socket_GetStdioHandle";
 _getSocketType(_NativeSocket nativeSocket) native "Socket_GetType";
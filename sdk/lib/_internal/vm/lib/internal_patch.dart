@@ -62,6 +62,11 @@ class VMLibraryHooks {
   // Example: "dart:io _EventHandler._timerMillisecondClock"
   static var timerMillisecondClock;
 
+  // A nullary closure that answers a new native timer wheel, or null if the
+  // timers should not use one.
+  // Example: "dart:io _TimerWheel._create"
+  static var timerWheelFactory;
+
   // Implementation of Resource.readAsBytes.
   static var resourceReadAsBytes;
 
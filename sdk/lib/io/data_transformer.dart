@@ -157,6 +157,15 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
    */
   final List<int> dictionary;
 
+  /**
+   * When true, large inputs are compressed in blocks on several threads.
+   *
+   * The result is a single valid stream, but it is not identical to, and
+   * slightly larger than, the one compressed on a single thread. Streams with
+   * a [dictionary] or a [level] of `0` are always compressed on one thread.
+   */
+  final bool parallel;
+
   ZLibCodec(
       {this.level: ZLibOption.defaultLevel,
       this.windowBits: ZLibOption.defaultWindowBits,
@@ -164,7 +173,8 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
       this.strategy: ZLibOption.strategyDefault,
       this.dictionary,
       this.raw: false,
-      this.gzip: false}) {
+      this.gzip: false,
+      this.parallel: false}) {
     _validateZLibeLevel(level);
     _validateZLibMemLevel(memLevel);
     _validateZLibStrategy(strategy);
@@ -178,6 +188,7 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
         strategy = ZLibOption.strategyDefault,
         raw = false,
         gzip = false,
+        parallel = false,
         dictionary = null;
 
   /**
@@ -190,7 +201,8 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
       memLevel: memLevel,
       strategy: strategy,
       dictionary: dictionary,
-      raw: raw);
+      raw: raw,
+      parallel: parallel);
 
   /**
    * Get a [ZLibDecoder] for decoding `ZLib` compressed data.
@@ -274,6 +286,15 @@ class GZipCodec extends Codec<List<int>, List<int>> {
    */
   final bool raw;
 
+  /**
+   * When true, large inputs are compressed in blocks on several threads.
+   *
+   * The result is a single valid stream, but it is not identical to, and
+   * slightly larger than, the one compressed on a single thread. Streams with
+   * a [dictionary] or a [level] of `0` are always compressed on one thread.
+   */
+  final bool parallel;
+
   GZipCodec(
       {this.level: ZLibOption.defaultLevel,
       this.windowBits: ZLibOption.defaultWindowBits,
@@ -281,7 +302,8 @@ class GZipCodec extends Codec<List<int>, List<int>> {
       this.strategy: ZLibOption.strategyDefault,
       this.dictionary,
       this.raw: false,
-      this.gzip: true}) {
+      this.gzip: true,
+      this.parallel: false}) {
     _validateZLibeLevel(level);
     _validateZLibMemLevel(memLevel);
     _validateZLibStrategy(strategy);
@@ -295,6 +317,7 @@ class GZipCodec extends Codec<List<int>, List<int>> {
         strategy = ZLibOption.strategyDefault,
         raw = false,
         gzip = true,
+        parallel = false,
         dictionary = null;
 
   /**
@@ -307,7 +330,8 @@ class GZipCodec extends Codec<List<int>, List<int>> {
       memLevel: memLevel,
       strategy: strategy,
       dictionary: dictionary,
-      raw: raw);
+      raw: raw,
+      parallel: parallel);
 
   /**
    * Get a [ZLibDecoder] for decoding `GZip` compressed data.
@@ -381,6 +405,15 @@ class ZLibEncoder extends Converter<List<int>, List<int>> {
    */
   final bool raw;
 
+  /**
+   * When true, large inputs are compressed in blocks on several threads.
+   *
+   * The result is a single valid stream, but it is not identical to, and
+   * slightly larger than, the one compressed on a single thread. Streams with
+   * a [dictionary] or a [level] of `0` are always compressed on one thread.
+   */
+  final bool parallel;
+
   ZLibEncoder(
       {this.gzip: false,
       this.level: ZLibOption.defaultLevel,
@@ -388,7 +421,8 @@ class ZLibEncoder extends Converter<List<int>, List<int>> {
       this.memLevel: ZLibOption.defaultMemLevel,
       this.strategy: ZLibOption.strategyDefault,
       this.dictionary,
-      this.raw: false}) {
+      this.raw: false,
+      this.parallel: false}) {
     _validateZLibeLevel(level);
     _validateZLibMemLevel(memLevel);
     _validateZLibStrategy(strategy);
@@ -416,8 +450,8 @@ class ZLibEncoder extends Converter<List<int>, List<int>> {
     if (sink is! ByteConversionSink) {
       sink = new ByteConversionSink.from(sink);
     }
-    return new _ZLibEncoderSink._(
-        sink, gzip, level, windowBits, memLevel, strategy, dictionary, raw);
+    return new _ZLibEncoderSink._(sink, gzip, level, windowBits, memLevel,
+        strategy, dictionary, raw, parallel);
   }
 }
 
@@ -498,9 +532,10 @@ abstract class RawZLibFilter {
     int strategy: ZLibOption.strategyDefault,
     List<int> dictionary,
     bool raw: false,
+    bool parallel: false,
   }) {
-    return _makeZLibDeflateFilter(
-        gzip, level, windowBits, memLevel, strategy, dictionary, raw);
+    return _makeZLibDeflateFilter(gzip, level, windowBits, memLevel, strategy,
+        dictionary, raw, parallel);
   }
 
   /**
@@ -538,7 +573,8 @@ abstract class RawZLibFilter {
       int memLevel,
       int strategy,
       List<int> dictionary,
-      bool raw);
+      bool raw,
+      bool parallel);
 
   external static RawZLibFilter _makeZLibInflateFilter(
       int windowBits, List<int> dictionary, bool raw);
@@ -573,11 +609,12 @@ class _ZLibEncoderSink extends _FilterSink {
       int memLevel,
       int strategy,
       List<int> dictionary,
-      bool raw)
+      bool raw,
+      bool parallel)
       : super(
             sink,
-            RawZLibFilter._makeZLibDeflateFilter(
-                gzip, level, windowBits, memLevel, strategy, dictionary, raw));
+            RawZLibFilter._makeZLibDeflateFilter(gzip, level, windowBits,
+                memLevel, strategy, dictionary, raw, parallel));
 }
 
 class _ZLibDecoderSink extends _FilterSink {
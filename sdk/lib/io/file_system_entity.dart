@@ -58,6 +58,8 @@ class FileStat {
   static const _accessedTime = 3;
   static const _mode = 4;
   static const _size = 5;
+  // The size in bytes of the native stat data of a single path.
+  static const _statDataBytes = 6 * 8;
 
   static final _epoch = DateTime.fromMillisecondsSinceEpoch(0, isUtc: true);
   static final _notFound = new FileStat._internal(
@@ -107,6 +109,20 @@ class FileStat {
   FileStat._internal(this.changed, this.modified, this.accessed, this.type,
       this.mode, this.size);
 
+  // Creates a FileStat from the result of a native stat, where [field]
+  // returns the value at the given index of the native stat data.
+  static FileStat _fromStatData(int field(int index)) {
+    var type = FileSystemEntityType._lookup(field(_type));
+    if (type == FileSystemEntityType.notFound) return FileStat._notFound;
+    return new FileStat._internal(
+        new DateTime.fromMillisecondsSinceEpoch(field(_changedTime)),
+        new DateTime.fromMillisecondsSinceEpoch(field(_modifiedTime)),
+        new DateTime.fromMillisecondsSinceEpoch(field(_accessedTime)),
+        type,
+        field(_mode),
+        field(_size));
+  }
+
   external static _statSync(_Namespace namespace, String path);
 
   /**
@@ -176,6 +192,76 @@ class FileStat {
     });
   }
 
+  /**
+   * Asynchronously calls the operating system's `stat()` function (or
+   * equivalent) on each of [paths].
+   *
+   * Returns a [Future] which completes with a list of the results, in the
+   * same order as [paths]. Each result is the same as [statSync] would return
+   * for the corresponding path. All of the paths are stat'ed by a single
+   * request to the I/O service, which is considerably cheaper than calling
+   * [stat] for each path when there are many of them.
+   */
+  static Future<List<FileStat>> statAll(List<String> paths) {
+    final IOOverrides overrides = IOOverrides.current;
+    if (overrides == null) {
+      return _statAll(paths);
+    }
+    return Future.wait(paths.map(overrides.stat));
+  }
+
+  static Future<List<FileStat>> _statAll(List<String> paths) {
+    // Trailing path is not supported on Windows.
+    if (Platform.isWindows) {
+      paths = paths.map(FileSystemEntity._trimTrailingPathSeparators).toList();
+    } else {
+      paths = paths.toList(growable: false);
+    }
+    return _File._dispatchWithNamespace(
+        _IOService.fileStatBatch, [null, paths]).then((response) {
+      if (_isErrorResponse(response)) {
+        throw _exceptionFromResponse(response, "Stat failed", "");
+      }
+      Uint8List packed = response[1];
+      var data =
+          new ByteData.view(packed.buffer, packed.offsetInBytes, packed.length);
+      return new List<FileStat>.generate(paths.length, (int i) {
+        int offset = i * _statDataBytes;
+        return FileStat._fromStatData(
+            (int field) => data.getInt64(offset + field * 8, Endian.host));
+      });
+    });
+  }
+
+  /**
+   * Lists the contents of the directory at [path] together with the [FileStat]
+   * of each entry.
+   *
+   * The entries are the same as those of [Directory.list] with the same
+   * [recursive] and [followLinks] arguments. The [FileStat] of an entry is
+   * the same as [stat] would return for its path, so for a link it describes
+   * the target of the link. The native listing fetches the metadata while it
+   * reads the directory and delivers entries in large batches, which is much
+   * faster than calling [FileSystemEntity.stat] on each listed entry.
+   */
+  static Stream<MapEntry<FileSystemEntity, FileStat>> listWithStat(String path,
+      {bool recursive: false, bool followLinks: true}) {
+    final IOOverrides overrides = IOOverrides.current;
+    if (overrides != null) {
+      return new Directory(path)
+          .list(recursive: recursive, followLinks: followLinks)
+          .asyncMap((entity) => overrides.stat(entity.path).then(
+              (stat) => new MapEntry<FileSystemEntity, FileStat>(entity, stat)));
+    }
+    return new _AsyncDirectoryLister<MapEntry<FileSystemEntity, FileStat>>(
+            FileSystemEntity._toUtf8Array(
+                FileSystemEntity._ensureTrailingPathSeparators(path)),
+            recursive,
+            followLinks,
+            true)
+        .stream;
+  }
+
   String toString() => """
 FileStat: type $type
           changed $changed
@@ -468,7 +554,9 @@ abstract class FileSystemEntity {
    *   * `Windows`: Uses `ReadDirectoryChangesW`. The implementation only
    *     supports watching directories. Recursive watching is supported.
    *   * `Linux`: Uses `inotify`. The implementation supports watching both
-   *     files and directories. Recursive watching is not supported.
+   *     files and directories. Recursive watching is supported, and
+   *     directories are watched as they are created below the watched
+   *     directory.
    *     Note: When watching files directly, delete events might not happen
    *     as expected.
    *   * `OS X`: Uses `FSEvents`. The implementation supports watching both
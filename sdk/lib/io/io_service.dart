@@ -12,7 +12,7 @@ class _IOService {
   static const int fileCreate = 1;
   static const int fileDelete = 2;
   static const int fileRename = 3;
-  static const int fileCopy = 4;
+  // 4 was fileCopy, which copy replaced with fileCopyChunk requests.
   static const int fileOpen = 5;
   static const int fileResolveSymbolicLinks = 6;
   static const int fileClose = 7;
@@ -51,6 +51,17 @@ class _IOService {
   static const int directoryListStop = 40;
   static const int directoryRename = 41;
   static const int sslProcessFilter = 42;
+  static const int fileStatBatch = 43;
+  static const int fileCopyChunk = 44;
+  static const int socketSendFile = 45;
 
   external static Future _dispatch(int request, List data);
 }
+
+// Runs file reads and writes on the native file I/O engine, which posts the
+// results straight back to the isolate and submits all requests issued in the
+// same turn of the event loop as one batch. Other requests are passed on to
+// [_IOService].
+class _FileIOEngine {
+  external static Future _dispatch(int request, List data);
+}
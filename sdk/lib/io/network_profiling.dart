@@ -7,7 +7,7 @@
 part of dart.io;
 
 const int _versionMajor = 1;
-const int _versionMinor = 1;
+const int _versionMinor = 2;
 
 const String _tcpSocket = 'tcp';
 const String _udpSocket = 'udp';
@@ -24,6 +24,9 @@ abstract class _NetworkProfiling {
   static const _kGetSocketProfileRPC = 'ext.dart.io.getSocketProfile';
   static const _kPauseSocketProfilingRPC = 'ext.dart.io.pauseSocketProfiling';
   static const _kStartSocketProfilingRPC = 'ext.dart.io.startSocketProfiling';
+  // Stdio relative RPCs
+  static const _kGetStdioBufferStatisticsRPC =
+      'ext.dart.io.getStdioBufferStatistics';
 
   // TODO(zichangguo): This version number represents the version of service
   // extension of dart:io. Consider moving this out of web profiler class,
@@ -38,6 +41,8 @@ abstract class _NetworkProfiling {
     registerExtension(_kStartSocketProfilingRPC, _serviceExtensionHandler);
     registerExtension(_kPauseSocketProfilingRPC, _serviceExtensionHandler);
     registerExtension(_kClearSocketProfileRPC, _serviceExtensionHandler);
+    registerExtension(
+        _kGetStdioBufferStatisticsRPC, _serviceExtensionHandler);
     registerExtension(_kGetVersionRPC, _serviceExtensionHandler);
   }
 
@@ -64,6 +69,9 @@ abstract class _NetworkProfiling {
         case _kClearSocketProfileRPC:
           responseJson = _SocketProfile.clear();
           break;
+        case _kGetStdioBufferStatisticsRPC:
+          responseJson = _getStdioBufferStatistics();
+          break;
         case _kGetVersionRPC:
           responseJson = getVersion();
           break;
@@ -100,6 +108,11 @@ String _getHttpEnableTimelineLogging() => json.encode({
       'enabled': HttpClient.enableTimelineLogging,
     });
 
+String _getStdioBufferStatistics() => json.encode({
+      'type': 'StdioBufferStatistics',
+      ..._StdIOUtils._bufferedStdioStatistics(),
+    });
+
 String _setHttpEnableTimelineLogging(Map<String, String> parameters) {
   const String kEnable = 'enable';
   if (!parameters.containsKey(kEnable)) {
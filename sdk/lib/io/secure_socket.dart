@@ -420,6 +420,8 @@ class _FilterStatus {
   bool writePlaintextNoLongerFull = false;
   bool readEncryptedNoLongerFull = false;
   bool writeEncryptedNoLongerEmpty = false;
+  // Set if the filter could not write all encrypted data to the socket.
+  bool socketWriteBlocked = false;
 
   _FilterStatus();
 }
@@ -473,6 +475,11 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
   bool _connectPending = true;
   bool _filterPending = false;
   bool _filterActive = false;
+  // The active filter request reads from or writes to the network socket.
+  bool _filterUsesSocket = false;
+  // The last filter request read encrypted data from the network socket,
+  // rather than from the read encrypted buffer.
+  bool _filterReadsSocket = false;
 
   _SecureFilter _secureFilter = new _SecureFilter._();
   String _selectedProtocol;
@@ -634,6 +641,8 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
     _closedWrite = true;
     _closedRead = true;
     if (_socket != null) {
+      // While a filter request uses the socket, the native socket holds
+      // back closing it until the request completes.
       _socket.close().then(_completeCloseCompleter);
     } else {
       _completeCloseCompleter();
@@ -773,7 +782,13 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
   }
 
   void _readHandler() {
-    _readSocket();
+    if (_filterReadsSocket && _status == connectedStatus) {
+      // The filter reads the data from the socket itself. Stop the read
+      // events until it has.
+      _socket.readEventsEnabled = false;
+    } else {
+      _readSocket();
+    }
     _scheduleFilter();
   }
 
@@ -914,7 +929,13 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
           _secureFilter = null;
           return;
         }
-        _socket.readEventsEnabled = true;
+        // When the filter reads from the socket itself, it cannot do so while
+        // the read plaintext buffer is full.
+        _socket.readEventsEnabled = !_filterReadsSocket ||
+            _secureFilter.buffers[readPlaintextId].free > 0;
+        if (_filterStatus.socketWriteBlocked) {
+          _socket.writeEventsEnabled = true;
+        }
         if (_filterStatus.writeEmpty && _closedWrite && !_socketClosedWrite) {
           // Checks for and handles all cases of partially closed sockets.
           shutdown(SocketDirection.send);
@@ -1034,17 +1055,45 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
 
   Future<_FilterStatus> _pushAllFilterStages() {
     bool wasInHandshake = _status != connectedStatus;
-    List args = new List(2 + bufferCount * 2);
+    var bufs = _secureFilter.buffers;
+    // Once connected, the filter reads and writes the encrypted data on the
+    // socket itself, unless that would reorder it with data still waiting
+    // in the encrypted buffers.
+    bool readSocket = !wasInHandshake &&
+        !_socketClosedRead &&
+        _bufferedData == null &&
+        bufs[readEncryptedId].isEmpty;
+    bool writeSocket = !wasInHandshake &&
+        !_socketClosedWrite &&
+        bufs[writeEncryptedId].isEmpty;
+    int socketPointer = 0;
+    if (readSocket || writeSocket) {
+      socketPointer = _secureFilter._socketPointer(_socket);
+    }
+    _filterUsesSocket = socketPointer != 0;
+    _filterReadsSocket = _filterUsesSocket && readSocket;
+    List args = new List(5 + bufferCount * 2);
     args[0] = _secureFilter._pointer();
     args[1] = wasInHandshake;
-    var bufs = _secureFilter.buffers;
     for (var i = 0; i < bufferCount; ++i) {
       args[2 * i + 2] = bufs[i].start;
       args[2 * i + 3] = bufs[i].end;
     }
+    args[2 + bufferCount * 2] = socketPointer;
+    args[3 + bufferCount * 2] = readSocket;
+    args[4 + bufferCount * 2] = writeSocket;
 
     return _IOService._dispatch(_IOService.sslProcessFilter, args)
         .then((response) {
+      if (_filterUsesSocket) {
+        _filterUsesSocket = false;
+        bool transferred = response.length > 2;
+        _secureFilter._socketTransferred(
+            _socket,
+            transferred ? response[2 * bufferCount] : 0,
+            transferred ? response[2 * bufferCount + 1] : 0,
+            transferred ? response[2 * bufferCount + 2] : false);
+      }
       if (response.length == 2) {
         if (wasInHandshake) {
           // If we're in handshake, throw a handshake error.
@@ -1061,10 +1110,13 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
       int end(int index) => response[2 * index + 1];
 
       _FilterStatus status = new _FilterStatus();
+      status.socketWriteBlocked = response[2 * bufferCount + 2];
       // Compute writeEmpty as "write plaintext buffer and write encrypted
-      // buffer were empty when we started and are empty now".
+      // buffer were empty when we started and are empty now, and nothing
+      // is left to be written to the socket".
       status.writeEmpty = bufs[writePlaintextId].isEmpty &&
-          start(writeEncryptedId) == end(writeEncryptedId);
+          start(writeEncryptedId) == end(writeEncryptedId) &&
+          !status.socketWriteBlocked;
       // If we were in handshake when this started, _writeEmpty may be false
       // because the handshake wrote data after we checked.
       if (wasInHandshake) status.writeEmpty = false;
@@ -1266,6 +1318,19 @@ abstract class _SecureFilter {
   // value is passed to the IO service through a call to dispatch().
   int _pointer();
 
+  // Returns a pointer to the native socket of [socket] that the filter can
+  // read from and write to on the IO service thread, or 0 if it cannot.
+  // Like _pointer, this retains the native socket, and should only be called
+  // when the result is passed to the IO service through a call to dispatch().
+  int _socketPointer(RawSocket socket);
+
+  // Updates [socket] after a filter request read [bytesRead] bytes from it
+  // and wrote [bytesWritten] bytes to it on the IO service thread. Must be
+  // called once for every non-zero result of [_socketPointer], as the socket
+  // is not closed until then.
+  void _socketTransferred(
+      RawSocket socket, int bytesRead, int bytesWritten, bool writeBlocked);
+
   List<_ExternalBuffer> get buffers;
 }
 
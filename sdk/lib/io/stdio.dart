@@ -486,4 +486,8 @@ class _StdIOUtils {
   /// Returns the socket type or `null` if [socket] is not a builtin socket.
   external static int _socketType(Socket socket);
   external static _getStdioHandleType(int fd);
+
+  /// Returns the counters of the --buffered-stdio buffer, keyed by name,
+  /// and whether it is `enabled`.
+  external static Map<String, Object> _bufferedStdioStatistics();
 }
@@ -425,6 +425,19 @@ class InternetAddress {
     throw UnsupportedError("InternetAddress.lookup");
   }
 
+  @patch
+  static void configureLookupCache(
+      {int maxEntries = 256,
+      Duration ttl = const Duration(seconds: 30),
+      Duration negativeTtl = const Duration(seconds: 5)}) {
+    throw UnsupportedError("InternetAddress.configureLookupCache");
+  }
+
+  @patch
+  static Map<String, int> get lookupCacheStatistics {
+    throw UnsupportedError("InternetAddress.lookupCacheStatistics");
+  }
+
   @patch
   static InternetAddress _cloneWithNewHost(
       InternetAddress address, String host) {
@@ -457,7 +470,10 @@ class NetworkInterface {
 class RawServerSocket {
   @patch
   static Future<RawServerSocket> bind(address, int port,
-      {int backlog = 0, bool v6Only = false, bool shared = false}) {
+      {int backlog = 0,
+      bool v6Only = false,
+      bool shared = false,
+      bool reusePort = false}) {
     throw UnsupportedError("RawServerSocket.bind");
   }
 }
@@ -466,7 +482,10 @@ class RawServerSocket {
 class ServerSocket {
   @patch
   static Future<ServerSocket> _bind(address, int port,
-      {int backlog = 0, bool v6Only = false, bool shared = false}) {
+      {int backlog = 0,
+      bool v6Only = false,
+      bool shared = false,
+      bool reusePort = false}) {
     throw UnsupportedError("ServerSocket.bind");
   }
 }
@@ -589,6 +608,11 @@ class _StdIOUtils {
   static _getStdioHandleType(int fd) {
     throw UnsupportedError("StdIOUtils._getStdioHandleType");
   }
+
+  @patch
+  static Map<String, Object> _bufferedStdioStatistics() {
+    throw UnsupportedError("StdIOUtils._bufferedStdioStatistics");
+  }
 }
 
 @patch
@@ -617,7 +641,8 @@ class RawZLibFilter {
       int memLevel,
       int strategy,
       List<int>? dictionary,
-      bool raw) {
+      bool raw,
+      bool parallel) {
     throw UnsupportedError("_newZLibDeflateFilter");
   }
 
@@ -705,3 +730,11 @@ class _IOService {
     throw UnsupportedError("_IOService._dispatch");
   }
 }
+
+@patch
+class _FileIOEngine {
+  @patch
+  static Future _dispatch(int request, List data) {
+    throw UnsupportedError("_FileIOEngine._dispatch");
+  }
+}
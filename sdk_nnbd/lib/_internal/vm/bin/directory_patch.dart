@@ -37,6 +37,27 @@ class _Directory {
       bool followLinks) native "Directory_FillWithDirectoryListing";
 }
 
+@patch
+class _DirectoryWalker {
+  @patch
+  static int _start(
+      _Namespace namespace,
+      Uint8List rawPath,
+      SendPort replyPort,
+      List<String>? include,
+      List<String>? exclude,
+      int concurrency) native "Directory_StartWalk";
+  @patch
+  static void _pause(int pointer) native "Directory_PauseWalk";
+  @patch
+  static void _resume(int pointer) native "Directory_ResumeWalk";
+  @patch
+  static void _stop(int pointer) native "Directory_StopWalk";
+  @patch
+  static bool _matchGlob(String pattern, String name)
+      native "Directory_MatchGlob";
+}
+
 @patch
 class _AsyncDirectoryListerOps {
   @patch
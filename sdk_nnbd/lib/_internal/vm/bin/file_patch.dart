@@ -83,6 +83,7 @@ class _RandomAccessFileOpsImpl extends NativeFieldWrapperClass1
   length() native "File_Length";
   flush() native "File_Flush";
   lock(int lock, int start, int end) native "File_Lock";
+  map(int position, int length, int advice) native "File_Map";
 }
 
 class _WatcherPath {
@@ -346,8 +347,10 @@ class _InotifyFileSystemWatcher extends _FileSystemWatcher {
 
   void _newWatcher() {
     int id = _FileSystemWatcher._id!;
+    // The events of all paths are read from a pipe filled by a native thread.
+    int socketId = _FileSystemWatcher._getSocketId(id, 0);
     _subscription =
-        _FileSystemWatcher._listenOnSocket(id, id, 0).listen((event) {
+        _FileSystemWatcher._listenOnSocket(socketId, id, 0).listen((event) {
       if (_idMap.containsKey(event[0])) {
         if (event[1] != null) {
           _idMap[event[0]]!.add(event[1]);
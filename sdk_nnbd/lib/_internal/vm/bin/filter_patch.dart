@@ -21,11 +21,13 @@ class _ZLibInflateFilter extends _FilterImpl {
 
 class _ZLibDeflateFilter extends _FilterImpl {
   _ZLibDeflateFilter(bool gzip, int level, int windowBits, int memLevel,
-      int strategy, List<int>? dictionary, bool raw) {
-    _init(gzip, level, windowBits, memLevel, strategy, dictionary, raw);
+      int strategy, List<int>? dictionary, bool raw, bool parallel) {
+    _init(gzip, level, windowBits, memLevel, strategy, dictionary, raw,
+        parallel);
   }
   void _init(bool gzip, int level, int windowBits, int memLevel, int strategy,
-      List<int>? dictionary, bool raw) native "Filter_CreateZLibDeflate";
+      List<int>? dictionary, bool raw, bool parallel)
+      native "Filter_CreateZLibDeflate";
 }
 
 @patch
@@ -38,9 +40,10 @@ class RawZLibFilter {
           int memLevel,
           int strategy,
           List<int>? dictionary,
-          bool raw) =>
-      new _ZLibDeflateFilter(
-          gzip, level, windowBits, memLevel, strategy, dictionary, raw);
+          bool raw,
+          bool parallel) =>
+      new _ZLibDeflateFilter(gzip, level, windowBits, memLevel, strategy,
+          dictionary, raw, parallel);
   @patch
   static RawZLibFilter _makeZLibInflateFilter(
           int windowBits, List<int>? dictionary, bool raw) =>
@@ -131,6 +131,20 @@ class _Timer implements Timer {
   static _Timer? _firstZeroTimer;
   static _Timer _lastZeroTimer = _sentinelTimer;
 
+  // When the embedder provides a native timer wheel (dart --timer-wheel),
+  // timers of at least _WHEEL_MIN_MILLISECONDS are kept in it instead of the
+  // heap, so that adding and canceling them does not depend on the number of
+  // active timers. The wheel has coarse slots, so these timers may fire a
+  // little after their wakeup time.
+  static const _WHEEL_MIN_MILLISECONDS = 1000;
+  static var _wheel;
+  static bool _wheelChecked = false;
+  // The timers in the wheel, indexed by their wheel handle.
+  static final _wheelTimers = <_Timer?>[];
+  static int _wheelCount = 0;
+  // A time at or before the earliest wakeup time of the timers in the wheel.
+  static int _wheelWakeupTime = 0;
+
   // We use an id to be able to sort timers with the same expiration time.
   // ids are recycled after ID_MASK enqueues or when the timer queue is empty.
   static const _ID_MASK = 0x1fffffff;
@@ -148,6 +162,7 @@ class _Timer implements Timer {
   final bool _repeating; // Indicates periodic timers.
   var _indexOrNext; // Index if part of the TimerHeap, link otherwise.
   int _id; // Incrementing id to enable sorting of timers with same expiry.
+  int? _wheelHandle; // Handle in the timer wheel. null if not in the wheel.
 
   int _tick = 0; // Backing for [tick],
 
@@ -217,6 +232,19 @@ class _Timer implements Timer {
   // the corresponding pending message.
   void cancel() {
     _callback = null;
+    final wheelHandle = _wheelHandle;
+    if (wheelHandle != null) {
+      _wheel.remove(wheelHandle);
+      _wheelTimers[wheelHandle] = null;
+      _wheelHandle = null;
+      _wheelCount--;
+      if (_wheelCount == 0) {
+        // A timer armed later must not inherit the wakeup of this one.
+        _wheelWakeupTime = 0;
+        _notifyEventHandler();
+      }
+      return;
+    }
     // Only heap timers are really removed. Zero timers need to consume their
     // corresponding wakeup message so they are left in the queue.
     if (!_isInHeap) return;
@@ -251,6 +279,8 @@ class _Timer implements Timer {
       }
       // Every zero timer gets its own event.
       _notifyZeroHandler();
+    } else if ((_milliSeconds >= _WHEEL_MIN_MILLISECONDS) && _useWheel) {
+      _addToWheel();
     } else {
       _heap.add(this);
       if (_heap.isFirst(this)) {
@@ -259,6 +289,32 @@ class _Timer implements Timer {
     }
   }
 
+  static bool get _useWheel {
+    if (!_wheelChecked) {
+      _wheelChecked = true;
+      var factory = VMLibraryHooks.timerWheelFactory;
+      if (factory != null) {
+        _wheel = factory();
+      }
+    }
+    return _wheel != null;
+  }
+
+  void _addToWheel() {
+    int handle = _wheel.add(_wakeupTime);
+    _wheelHandle = handle;
+    if (handle == _wheelTimers.length) {
+      _wheelTimers.add(this);
+    } else {
+      _wheelTimers[handle] = this;
+    }
+    _wheelCount++;
+    if ((_wheelWakeupTime == 0) || (_wakeupTime < _wheelWakeupTime)) {
+      _wheelWakeupTime = _wakeupTime;
+      _notifyEventHandler();
+    }
+  }
+
   // Enqueue one message for each zero timer. To be able to distinguish from
   // EventHandler messages we send a _ZERO_EVENT instead of a _TIMEOUT_EVENT.
   static void _notifyZeroHandler() {
@@ -301,7 +357,7 @@ class _Timer implements Timer {
     }
 
     // If there are no pending timers. Close down the receive port.
-    if ((_firstZeroTimer == null) && _heap.isEmpty) {
+    if ((_firstZeroTimer == null) && _heap.isEmpty && (_wheelCount == 0)) {
       // No pending timers: Close the receive port and let the event handler
       // know.
       if (_sendPort != null) {
@@ -309,7 +365,7 @@ class _Timer implements Timer {
         _shutdownTimerHandler();
       }
       return;
-    } else if (_heap.isEmpty) {
+    } else if (_heap.isEmpty && (_wheelCount == 0)) {
       // Only zero timers are left. Cancel any scheduled wakeups.
       _cancelWakeup();
       return;
@@ -317,7 +373,11 @@ class _Timer implements Timer {
 
     // Only send a message if the requested wakeup time differs from the
     // already scheduled wakeup time.
-    var wakeupTime = _heap.first._wakeupTime;
+    var wakeupTime =
+        _heap.isEmpty ? _wheelWakeupTime : _heap.first._wakeupTime;
+    if ((_wheelCount > 0) && (_wheelWakeupTime < wakeupTime)) {
+      wakeupTime = _wheelWakeupTime;
+    }
     if ((_scheduledWakeupTime == 0) || (wakeupTime != _scheduledWakeupTime)) {
       _scheduleWakeup(wakeupTime);
     }
@@ -348,13 +408,35 @@ class _Timer implements Timer {
         pendingTimers.add(timer);
       }
     }
+    _queueFromWheel(pendingTimers);
     return pendingTimers;
   }
 
+  // Moves the timers in the wheel that are due to [pendingTimers], keeping it
+  // ordered by wakeup time.
+  static void _queueFromWheel(List pendingTimers) {
+    if (_wheelCount == 0) {
+      return;
+    }
+    List<int> expired = _wheel.advance(VMLibraryHooks.timerMillisecondClock());
+    for (int i = 0; i < expired.length; i++) {
+      int handle = expired[i];
+      _Timer timer = _wheelTimers[handle]!;
+      _wheelTimers[handle] = null;
+      timer._wheelHandle = null;
+      pendingTimers.add(timer);
+    }
+    _wheelCount -= expired.length;
+    _wheelWakeupTime = (_wheelCount == 0) ? 0 : _wheel.nextExpiry;
+    if ((expired.length > 0) && (pendingTimers.length > 1)) {
+      pendingTimers.sort((a, b) => a._compareTo(b));
+    }
+  }
+
   static void _runTimers(List pendingTimers) {
     // If there are no pending timers currently reset the id space before we
     // have a chance to enqueue new timers.
-    if (_heap.isEmpty && (_firstZeroTimer == null)) {
+    if (_heap.isEmpty && (_firstZeroTimer == null) && (_wheelCount == 0)) {
       _idCount = 0;
     }
 
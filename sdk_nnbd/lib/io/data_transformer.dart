@@ -155,6 +155,15 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
    */
   final List<int>? dictionary;
 
+  /**
+   * When true, large inputs are compressed in blocks on several threads.
+   *
+   * The result is a single valid stream, but it is not identical to, and
+   * slightly larger than, the one compressed on a single thread. Streams with
+   * a [dictionary] or a [level] of `0` are always compressed on one thread.
+   */
+  final bool parallel;
+
   ZLibCodec(
       {this.level: ZLibOption.defaultLevel,
       this.windowBits: ZLibOption.defaultWindowBits,
@@ -162,7 +171,8 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
       this.strategy: ZLibOption.strategyDefault,
       this.dictionary,
       this.raw: false,
-      this.gzip: false}) {
+      this.gzip: false,
+      this.parallel: false}) {
     _validateZLibeLevel(level);
     _validateZLibMemLevel(memLevel);
     _validateZLibStrategy(strategy);
@@ -176,6 +186,7 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
         strategy = ZLibOption.strategyDefault,
         raw = false,
         gzip = false,
+        parallel = false,
         dictionary = null;
 
   /**
@@ -188,7 +199,8 @@ class ZLibCodec extends Codec<List<int>, List<int>> {
       memLevel: memLevel,
       strategy: strategy,
       dictionary: dictionary,
-      raw: raw);
+      raw: raw,
+      parallel: parallel);
 
   /**
    * Get a [ZLibDecoder] for decoding `ZLib` compressed data.
@@ -272,6 +284,15 @@ class GZipCodec extends Codec<List<int>, List<int>> {
    */
   final bool raw;
 
+  /**
+   * When true, large inputs are compressed in blocks on several threads.
+   *
+   * The result is a single valid stream, but it is not identical to, and
+   * slightly larger than, the one compressed on a single thread. Streams with
+   * a [dictionary] or a [level] of `0` are always compressed on one thread.
+   */
+  final bool parallel;
+
   GZipCodec(
       {this.level: ZLibOption.defaultLevel,
       this.windowBits: ZLibOption.defaultWindowBits,
@@ -279,7 +300,8 @@ class GZipCodec extends Codec<List<int>, List<int>> {
       this.strategy: ZLibOption.strategyDefault,
       this.dictionary,
       this.raw: false,
-      this.gzip: true}) {
+      this.gzip: true,
+      this.parallel: false}) {
     _validateZLibeLevel(level);
     _validateZLibMemLevel(memLevel);
     _validateZLibStrategy(strategy);
@@ -293,6 +315,7 @@ class GZipCodec extends Codec<List<int>, List<int>> {
         strategy = ZLibOption.strategyDefault,
         raw = false,
         gzip = true,
+        parallel = false,
         dictionary = null;
 
   /**
@@ -305,7 +328,8 @@ class GZipCodec extends Codec<List<int>, List<int>> {
       memLevel: memLevel,
       strategy: strategy,
       dictionary: dictionary,
-      raw: raw);
+      raw: raw,
+      parallel: parallel);
 
   /**
    * Get a [ZLibDecoder] for decoding `GZip` compressed data.
@@ -379,6 +403,15 @@ class ZLibEncoder extends Converter<List<int>, List<int>> {
    */
   final bool raw;
 
+  /**
+   * When true, large inputs are compressed in blocks on several threads.
+   *
+   * The result is a single valid stream, but it is not identical to, and
+   * slightly larger than, the one compressed on a single thread. Streams with
+   * a [dictionary] or a [level] of `0` are always compressed on one thread.
+   */
+  final bool parallel;
+
   ZLibEncoder(
       {this.gzip: false,
       this.level: ZLibOption.defaultLevel,
@@ -386,7 +419,8 @@ class ZLibEncoder extends Converter<List<int>, List<int>> {
       this.memLevel: ZLibOption.defaultMemLevel,
       this.strategy: ZLibOption.strategyDefault,
       this.dictionary,
-      this.raw: false}) {
+      this.raw: false,
+      this.parallel: false}) {
     _validateZLibeLevel(level);
     _validateZLibMemLevel(memLevel);
     _validateZLibStrategy(strategy);
@@ -414,8 +448,8 @@ class ZLibEncoder extends Converter<List<int>, List<int>> {
     if (sink is! ByteConversionSink) {
       sink = new ByteConversionSink.from(sink);
     }
-    return new _ZLibEncoderSink._(
-        sink, gzip, level, windowBits, memLevel, strategy, dictionary, raw);
+    return new _ZLibEncoderSink._(sink, gzip, level, windowBits, memLevel,
+        strategy, dictionary, raw, parallel);
   }
 }
 
@@ -496,9 +530,10 @@ abstract class RawZLibFilter {
     int strategy: ZLibOption.strategyDefault,
     List<int>? dictionary,
     bool raw: false,
+    bool parallel: false,
   }) {
-    return _makeZLibDeflateFilter(
-        gzip, level, windowBits, memLevel, strategy, dictionary, raw);
+    return _makeZLibDeflateFilter(gzip, level, windowBits, memLevel, strategy,
+        dictionary, raw, parallel);
   }
 
   /**
@@ -536,7 +571,8 @@ abstract class RawZLibFilter {
       int memLevel,
       int strategy,
       List<int>? dictionary,
-      bool raw);
+      bool raw,
+      bool parallel);
 
   external static RawZLibFilter _makeZLibInflateFilter(
       int windowBits, List<int>? dictionary, bool raw);
@@ -571,11 +607,12 @@ class _ZLibEncoderSink extends _FilterSink {
       int memLevel,
       int strategy,
       List<int>? dictionary,
-      bool raw)
+      bool raw,
+      bool parallel)
       : super(
             sink,
-            RawZLibFilter._makeZLibDeflateFilter(
-                gzip, level, windowBits, memLevel, strategy, dictionary, raw));
+            RawZLibFilter._makeZLibDeflateFilter(gzip, level, windowBits,
+                memLevel, strategy, dictionary, raw, parallel));
 }
 
 class _ZLibDecoderSink extends _FilterSink {
@@ -237,6 +237,45 @@ abstract class Directory implements FileSystemEntity {
     return overrides.getSystemTempDirectory();
   }
 
+  /**
+   * Lists the directory tree at [path] using several threads.
+   *
+   * Returns a stream of the files, directories and links under [path], in
+   * no particular order. Up to [concurrency] threads list the subdirectories
+   * of [path] in parallel, and the entries are delivered in large batches,
+   * so this is much faster than [list] for large trees. [concurrency]
+   * defaults to the number of processors, up to 8. Links are reported as
+   * [Link]s and are never followed.
+   *
+   * Entries whose name matches one of the [exclude] patterns are skipped,
+   * and so is everything under an excluded directory. If [include] is given,
+   * only the files and links whose name matches one of its patterns are
+   * reported, and directories are not. Patterns are matched against the
+   * name of an entry, not its path. In a pattern, `*` matches any sequence
+   * of characters, `?` matches any single character, and `[abc]`, `[a-z]`
+   * and `[!abc]` match any character in, or not in, a set.
+   *
+   * A directory that cannot be listed is reported as a
+   * [FileSystemException] error on the stream, and the rest of the tree is
+   * still walked. While the stream is paused, the threads finish listing
+   * the directories they are in but do not start on others.
+   */
+  static Stream<FileSystemEntity> walk(String path,
+      {List<String>? include, List<String>? exclude, int? concurrency}) {
+    if (concurrency == null) {
+      concurrency =
+          min(Platform.numberOfProcessors, _DirectoryWalker.maxConcurrency);
+    }
+    RangeError.checkValueInInterval(
+        concurrency, 1, _DirectoryWalker.maxConcurrency, 'concurrency');
+    final IOOverrides? overrides = IOOverrides.current;
+    if (overrides != null) {
+      return _DirectoryWalker._walkOverridden(
+          overrides, path, include, exclude);
+    }
+    return new _DirectoryWalker(path, include, exclude, concurrency).stream;
+  }
+
   /**
    * Creates a temporary directory in this directory. Additional random
    * characters are appended to [prefix] to produce a unique directory
@@ -224,7 +224,7 @@ class _Directory extends FileSystemEntity implements Directory {
 
   Stream<FileSystemEntity> list(
       {bool recursive: false, bool followLinks: true}) {
-    return new _AsyncDirectoryLister(
+    return new _AsyncDirectoryLister<FileSystemEntity>(
             // FIXME(bkonyi): here we're using `path` directly, which might cause issues
             // if it is not UTF-8 encoded.
             FileSystemEntity._toUtf8Array(
@@ -284,12 +284,21 @@ abstract class _AsyncDirectoryListerOps {
   int? getPointer();
 }
 
-class _AsyncDirectoryLister {
+// Lists a directory as a stream of [FileSystemEntity] objects or, when
+// [withStat] is set, as a stream of [MapEntry] objects pairing each
+// [FileSystemEntity] with its [FileStat].
+class _AsyncDirectoryLister<T> {
   static const int listFile = 0;
   static const int listDirectory = 1;
   static const int listLink = 2;
   static const int listError = 3;
   static const int listDone = 4;
+  static const int listStat = 5;
+
+  // The layout of the records in a listStat response. These must agree with
+  // AsyncDirectoryListing in directory.h.
+  static const int _packedStatSize = FileStat._statDataBytes;
+  static const int _packedHeaderSize = _packedStatSize + 8;
 
   static const int responseType = 0;
   static const int responsePath = 1;
@@ -299,15 +308,17 @@ class _AsyncDirectoryLister {
   final Uint8List rawPath;
   final bool recursive;
   final bool followLinks;
+  final bool withStat;
 
-  final controller = new StreamController<FileSystemEntity>(sync: true);
+  final controller = new StreamController<T>(sync: true);
   bool canceled = false;
   bool nextRunning = false;
   bool closed = false;
   _AsyncDirectoryListerOps? _ops;
   Completer closeCompleter = new Completer();
 
-  _AsyncDirectoryLister(this.rawPath, this.recursive, this.followLinks) {
+  _AsyncDirectoryLister(this.rawPath, this.recursive, this.followLinks,
+      [this.withStat = false]) {
     controller
       ..onListen = onListen
       ..onResume = onResume
@@ -323,11 +334,11 @@ class _AsyncDirectoryLister {
     return _ops?.getPointer();
   }
 
-  Stream<FileSystemEntity> get stream => controller.stream;
+  Stream<T> get stream => controller.stream;
 
   void onListen() {
     _File._dispatchWithNamespace(_IOService.directoryListStart,
-        [null, rawPath, recursive, followLinks]).then((response) {
+        [null, rawPath, recursive, followLinks, withStat]).then((response) {
       if (response is int) {
         _ops = new _AsyncDirectoryListerOps(response);
         next();
@@ -380,13 +391,18 @@ class _AsyncDirectoryLister {
           assert(i % 2 == 0);
           switch (result[i++]) {
             case listFile:
-              controller.add(new File.fromRawPath(result[i]));
+              controller.add(new File.fromRawPath(result[i]) as T);
               break;
             case listDirectory:
-              controller.add(new Directory.fromRawPath(result[i]));
+              controller.add(new Directory.fromRawPath(result[i]) as T);
               break;
             case listLink:
-              controller.add(new Link.fromRawPath(result[i]));
+              controller.add(new Link.fromRawPath(result[i]) as T);
+              break;
+            case listStat:
+              if (result[i] != null) {
+                addStatEntries(result[i]);
+              }
               break;
             case listError:
               error(result[i]);
@@ -402,6 +418,32 @@ class _AsyncDirectoryLister {
     });
   }
 
+  void addStatEntries(Uint8List packed) {
+    var data =
+        new ByteData.view(packed.buffer, packed.offsetInBytes, packed.length);
+    int offset = 0;
+    while (offset < packed.length) {
+      int stat(int field) => data.getInt64(offset + field * 8, Endian.host);
+      int type = data.getInt32(offset + _packedStatSize, Endian.host);
+      int length = data.getInt32(offset + _packedStatSize + 4, Endian.host);
+      int pathStart = offset + _packedHeaderSize;
+      var rawPath = packed.sublist(pathStart, pathStart + length);
+      FileSystemEntity entity;
+      if (type == listFile) {
+        entity = new File.fromRawPath(rawPath);
+      } else if (type == listDirectory) {
+        entity = new Directory.fromRawPath(rawPath);
+      } else {
+        entity = new Link.fromRawPath(rawPath);
+      }
+      var fileStat = FileStat._fromStatData(stat);
+      controller.add(new MapEntry<FileSystemEntity, FileStat>(entity, fileStat)
+          as T);
+      // Records are padded to a multiple of 8 bytes.
+      offset = (pathStart + length + 7) & ~7;
+    }
+  }
+
   void _cleanup() {
     controller.close();
     closeCompleter.complete();
@@ -447,3 +489,145 @@ class _AsyncDirectoryLister {
     }
   }
 }
+
+// Walks a directory tree on several native threads for [Directory.walk].
+class _DirectoryWalker {
+  // Keep in sync with DirectoryWalker in directory_walker.h.
+  static const int maxConcurrency = 8;
+
+  // The layout of the records in a batch of entries.
+  static const int _headerSize = 8;
+
+  final String path;
+  final Uint8List rawPath;
+  final List<String>? include;
+  final List<String>? exclude;
+  final int concurrency;
+
+  final controller = new StreamController<FileSystemEntity>(sync: true);
+  RawReceivePort? port;
+  int? pointer;
+
+  _DirectoryWalker(this.path, this.include, this.exclude, this.concurrency)
+      : rawPath = FileSystemEntity._toUtf8Array(
+            FileSystemEntity._ensureTrailingPathSeparators(path)) {
+    controller
+      ..onListen = onListen
+      ..onPause = onPause
+      ..onResume = onResume
+      ..onCancel = close;
+  }
+
+  Stream<FileSystemEntity> get stream => controller.stream;
+
+  void onListen() {
+    final port = new RawReceivePort(handleMessage);
+    this.port = port;
+    try {
+      pointer = _start(_Namespace._namespace, rawPath, port.sendPort, include,
+          exclude, concurrency);
+    } catch (e, s) {
+      controller.addError(e, s);
+      close();
+    }
+  }
+
+  void onPause() {
+    final pointer = this.pointer;
+    if (pointer != null) _pause(pointer);
+  }
+
+  void onResume() {
+    final pointer = this.pointer;
+    if (pointer != null) _resume(pointer);
+  }
+
+  void handleMessage(message) {
+    if (message is Uint8List) {
+      addEntries(message);
+    } else if (message is List) {
+      assert(message[0] == _AsyncDirectoryLister.listError);
+      var errorInfo = message[2];
+      var err = new OSError(errorInfo[_osErrorResponseMessage],
+          errorInfo[_osErrorResponseErrorCode]);
+      controller.addError(new FileSystemException(
+          "Directory listing failed", message[1] ?? path, err));
+    } else {
+      assert(message == _AsyncDirectoryLister.listDone);
+      close();
+    }
+  }
+
+  void addEntries(Uint8List batch) {
+    var data =
+        new ByteData.view(batch.buffer, batch.offsetInBytes, batch.length);
+    int offset = 0;
+    while (offset < batch.length) {
+      int type = data.getInt32(offset, Endian.host);
+      int length = data.getInt32(offset + 4, Endian.host);
+      int pathStart = offset + _headerSize;
+      // The entity copies the path, so a view of the batch is enough.
+      var rawPath = new Uint8List.view(
+          batch.buffer, batch.offsetInBytes + pathStart, length);
+      if (type == _AsyncDirectoryLister.listFile) {
+        controller.add(new File.fromRawPath(rawPath));
+      } else if (type == _AsyncDirectoryLister.listDirectory) {
+        controller.add(new Directory.fromRawPath(rawPath));
+      } else {
+        controller.add(new Link.fromRawPath(rawPath));
+      }
+      // Records are padded to a multiple of 8 bytes.
+      offset = (pathStart + length + 7) & ~7;
+    }
+  }
+
+  void close() {
+    final pointer = this.pointer;
+    if (pointer != null) {
+      _stop(pointer);
+      this.pointer = null;
+    }
+    port?.close();
+    port = null;
+    controller.close();
+  }
+
+  // Walks the tree with [Directory.list] for an [IOOverrides], filtering the
+  // entries as the native walker does.
+  static Stream<FileSystemEntity> _walkOverridden(
+      IOOverrides overrides,
+      String path,
+      List<String>? include,
+      List<String>? exclude) {
+    var root = FileSystemEntity._ensureTrailingPathSeparators(path);
+    Pattern separator = Platform.isWindows ? new RegExp(r'[/\\]') : '/';
+    bool matchesAny(List<String> patterns, String name) =>
+        patterns.any((pattern) => _matchGlob(pattern, name));
+    return overrides
+        .createDirectory(path)
+        .list(recursive: true, followLinks: false)
+        .where((entity) {
+      var names = entity.path.substring(root.length).split(separator);
+      if (exclude != null && names.any((name) => matchesAny(exclude, name))) {
+        return false;
+      }
+      if (include == null) return true;
+      return entity is! Directory && matchesAny(include, names.last);
+    });
+  }
+
+  // Matches [name] against the glob [pattern] with the native walker's
+  // matcher, so that both ways of walking filter alike.
+  external static bool _matchGlob(String pattern, String name);
+
+  external static int _start(
+      _Namespace namespace,
+      Uint8List rawPath,
+      SendPort replyPort,
+      List<String>? include,
+      List<String>? exclude,
+      int concurrency);
+  external static void _pause(int pointer);
+  external static void _resume(int pointer);
+  external static void _stop(int pointer);
+}
@@ -97,6 +97,33 @@ class FileLock {
   const FileLock._internal(this._type);
 }
 
+/**
+ * The expected access pattern of a memory mapping created by
+ * [RandomAccessFile.mapSync].
+ *
+ * The pattern is passed on to the operating system as a hint, which it may
+ * use to tune read-ahead and the reclamation of the mapped pages.
+ */
+class FileAccessPattern {
+  /// No particular access pattern. The operating system's default.
+  static const normal = const FileAccessPattern._internal(0);
+
+  /// The mapping is read from start to end. Pages are read ahead
+  /// aggressively, and may be reclaimed soon after they have been read.
+  static const sequential = const FileAccessPattern._internal(1);
+
+  /// The mapping is accessed in random order, so reading ahead is of no use.
+  static const random = const FileAccessPattern._internal(2);
+
+  /// The whole mapping will be needed soon, and should be read into memory
+  /// in the background.
+  static const willNeed = const FileAccessPattern._internal(3);
+
+  final int _advice;
+
+  const FileAccessPattern._internal(this._advice);
+}
+
 /**
  * A reference to a file on the file system.
  *
@@ -945,6 +972,34 @@ abstract class RandomAccessFile {
    */
   void unlockSync([int start = 0, int end = -1]);
 
+  /**
+   * Synchronously maps [length] bytes of the file, starting at byte
+   * [position], into memory, and returns them as a read-only [Uint8List].
+   *
+   * If [length] is omitted, the file is mapped from [position] to its end.
+   * The mapped range must lie within the file.
+   *
+   * The bytes are not copied: they are read from the file on demand as the
+   * list is accessed, and the pages backing the list are shared with the
+   * operating system's file cache, and with any other process mapping the
+   * same file. This makes mapping much cheaper than [readSync] for large
+   * files of which only parts are accessed, or which are accessed by several
+   * processes. The [accessPattern] tells the operating system how the list
+   * will be accessed.
+   *
+   * The mapping is removed when the returned list is garbage collected, and
+   * remains valid after this file is closed. Writes to the file may or may
+   * not be visible through the list, and accessing the list after the file
+   * has been truncated below the mapped range may crash the process.
+   *
+   * On Windows, the bytes are read into memory rather than mapped, and the
+   * position of this file is changed.
+   */
+  Uint8List mapSync(
+      {int position: 0,
+      int? length,
+      FileAccessPattern accessPattern: FileAccessPattern.normal});
+
   /**
    * Returns a human-readable string for this RandomAccessFile instance.
    */
@@ -321,14 +321,24 @@ class _File extends FileSystemEntity implements File {
     return new File(newPath);
   }
 
-  Future<File> copy(String newPath) {
-    return _dispatchWithNamespace(
-        _IOService.fileCopy, [null, _rawPath, newPath]).then((response) {
+  Future<File> copy(String newPath) =>
+      _copyFrom(newPath, 0, const [0, 0, 0, 0]);
+
+  // Large files are copied by a sequence of requests, each copying the next
+  // chunk of the file, so that no IO service thread is occupied for long.
+  // [identity] is what the first request found out about the two files, and
+  // lets the later ones check that they still copy between the same files.
+  Future<File> _copyFrom(String newPath, int offset, List identity) {
+    return _dispatchWithNamespace(_IOService.fileCopyChunk,
+        [null, _rawPath, newPath, offset]..addAll(identity)).then((response) {
       if (_isErrorResponse(response)) {
         throw _exceptionFromResponse(
             response, "Cannot copy file to '$newPath'", path);
       }
-      return new File(newPath);
+      if (response[2]) {
+        return new File(newPath);
+      }
+      return _copyFrom(newPath, response[1], response.sublist(3));
     });
   }
 
@@ -659,6 +669,7 @@ abstract class _RandomAccessFileOps {
   length();
   flush();
   lock(int lock, int start, int end);
+  map(int position, int length, int advice);
 }
 
 class _RandomAccessFile implements RandomAccessFile {
@@ -958,6 +969,31 @@ class _RandomAccessFile implements RandomAccessFile {
     return result;
   }
 
+  Uint8List mapSync(
+      {int position: 0,
+      int? length,
+      FileAccessPattern accessPattern: FileAccessPattern.normal}) {
+    _checkAvailable();
+    ArgumentError.checkNotNull(position, 'position');
+    ArgumentError.checkNotNull(accessPattern, 'accessPattern');
+    int fileLength = lengthSync();
+    RangeError.checkValueInInterval(position, 0, fileLength, 'position');
+    if (length == null) {
+      length = fileLength - position;
+    } else {
+      RangeError.checkValueInInterval(
+          length, 0, fileLength - position, 'length');
+    }
+    if (length == 0) {
+      return new UnmodifiableUint8ListView(new Uint8List(0));
+    }
+    var result = _ops.map(position, length, accessPattern._advice);
+    if (result is OSError) {
+      throw new FileSystemException("mapSync failed", path, result);
+    }
+    return new UnmodifiableUint8ListView(result);
+  }
+
   Future<RandomAccessFile> flush() {
     return _dispatch(_IOService.fileFlush, [null]).then((response) {
       if (_isErrorResponse(response)) {
@@ -1073,7 +1109,7 @@ class _RandomAccessFile implements RandomAccessFile {
     }
     _asyncDispatched = true;
     data[0] = _pointer();
-    return _IOService._dispatch(request, data).whenComplete(() {
+    return _FileIOEngine._dispatch(request, data).whenComplete(() {
       _asyncDispatched = false;
     });
   }
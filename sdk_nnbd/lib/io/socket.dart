@@ -205,6 +205,34 @@ abstract class InternetAddress {
   external static Future<List<InternetAddress>> lookup(String host,
       {InternetAddressType type: InternetAddressType.any});
 
+  /**
+   * Enables or configures the cache of [lookup] results.
+   *
+   * The cache is disabled by default. Once enabled, successful lookups are
+   * reused for [ttl], and lookups of hosts that do not exist for
+   * [negativeTtl]; other failures are not cached. The system resolver does
+   * not report the time to live of DNS records, so these times apply to all
+   * hosts. At most [maxEntries] hosts are kept, and a [maxEntries] of 0
+   * disables the cache again. Changing the configuration empties the cache.
+   *
+   * The cache is shared by all isolates in the process.
+   */
+  @Since("2.9")
+  external static void configureLookupCache(
+      {int maxEntries: 256,
+      Duration ttl: const Duration(seconds: 30),
+      Duration negativeTtl: const Duration(seconds: 5)});
+
+  /**
+   * The counters of the [lookup] cache.
+   *
+   * The map has the keys `hits`, `negativeHits` (cached lookups of hosts that
+   * do not exist), `misses`, `coalesced` (lookups that shared a lookup of the
+   * same host that was in progress) and `entries` (the current size).
+   */
+  @Since("2.9")
+  external static Map<String, int> get lookupCacheStatistics;
+
   /**
    * Clones the given [address] with the new [host].
    *
@@ -313,9 +341,20 @@ abstract class RawServerSocket implements Stream<RawSocket> {
    * other isolates are bound to the port, then the incoming connections will be
    * distributed among all the bound `RawServerSocket`s. Connections can be
    * distributed over multiple isolates this way.
+   *
+   * The optional argument [reusePort] gives each `RawServerSocket` bound with it
+   * its own listening socket with the `SO_REUSEPORT` option on Linux and
+   * Android. All of them must be bound with `reusePort` to the same
+   * `address`, `port` and `v6Only`, and the kernel then distributes the
+   * incoming connections among them, including those bound by other
+   * processes. On other platforms such sockets share one listening socket,
+   * as if bound with [shared].
    */
   external static Future<RawServerSocket> bind(address, int port,
-      {int backlog: 0, bool v6Only: false, bool shared: false});
+      {int backlog: 0,
+      bool v6Only: false,
+      bool shared: false,
+      @Since("2.9") bool reusePort: false});
 
   /**
    * Returns the port used by this socket.
@@ -378,20 +417,37 @@ abstract class ServerSocket implements Stream<Socket> {
    * isolates are bound to the port, then the incoming connections will be
    * distributed among all the bound `ServerSocket`s. Connections can be
    * distributed over multiple isolates this way.
+   *
+   * The optional argument [reusePort] gives each `ServerSocket` bound with it
+   * its own listening socket with the `SO_REUSEPORT` option on Linux and
+   * Android. All of them must be bound with `reusePort` to the same
+   * `address`, `port` and `v6Only`, and the kernel then distributes the
+   * incoming connections among them, including those bound by other
+   * processes. On other platforms such sockets share one listening socket,
+   * as if bound with [shared].
    */
   static Future<ServerSocket> bind(address, int port,
-      {int backlog: 0, bool v6Only: false, bool shared: false}) {
+      {int backlog: 0,
+      bool v6Only: false,
+      bool shared: false,
+      @Since("2.9") bool reusePort: false}) {
     final IOOverrides? overrides = IOOverrides.current;
     if (overrides == null) {
       return ServerSocket._bind(address, port,
-          backlog: backlog, v6Only: v6Only, shared: shared);
+          backlog: backlog,
+          v6Only: v6Only,
+          shared: shared,
+          reusePort: reusePort);
     }
     return overrides.serverSocketBind(address, port,
         backlog: backlog, v6Only: v6Only, shared: shared);
   }
 
   external static Future<ServerSocket> _bind(address, int port,
-      {int backlog: 0, bool v6Only: false, bool shared: false});
+      {int backlog: 0,
+      bool v6Only: false,
+      bool shared: false,
+      bool reusePort: false});
   /**
    * Returns the port used by this socket.
    */
@@ -447,6 +503,21 @@ class SocketOption {
   @Deprecated("Use tcpNoDelay instead")
   static const SocketOption TCP_NODELAY = tcpNoDelay;
 
+  /**
+   * Enable or disable zero-copy sends on a TCP socket. When enabled, large
+   * writes of external [Uint8List]s, such as those created with
+   * `Pointer.asTypedList` from `dart:ffi`, are sent directly from the buffer
+   * instead of being copied into the kernel. The buffer is kept alive until
+   * the kernel has sent its contents, and must not be modified until then.
+   * Closing the socket waits for all such sends to complete.
+   *
+   * Setting this option returns `false` where zero-copy sends are not
+   * supported, which is everywhere but Linux 4.14 and later.
+   *
+   * zeroCopy is disabled by default.
+   */
+  static const SocketOption zeroCopy = const SocketOption._(5);
+
   static const SocketOption _ipMulticastLoop = const SocketOption._(1);
   static const SocketOption _ipMulticastHops = const SocketOption._(2);
   static const SocketOption _ipMulticastIf = const SocketOption._(3);
@@ -898,6 +969,22 @@ abstract class Socket implements Stream<Uint8List>, IOSink {
    */
   InternetAddress get remoteAddress;
 
+  /**
+   * Sends [length] bytes of [file], starting at [offset], on this socket.
+   *
+   * The data is sent after all data added to the socket before. If [length]
+   * is omitted, the rest of the file is sent. The position of [file] is not
+   * changed.
+   *
+   * On Linux, Android and macOS the kernel sends the data straight from the
+   * file, without copying it through Dart. On other platforms, and on secure
+   * sockets, the data is copied.
+   *
+   * Returns a future which completes with the number of bytes sent. No data
+   * may be added to the socket until it completes.
+   */
+  Future<int> sendFile(RandomAccessFile file, [int offset = 0, int? length]);
+
   Future close();
 
   Future get done;
@@ -913,7 +1000,14 @@ class Datagram {
   InternetAddress address;
   int port;
 
-  Datagram(this.data, this.address, this.port);
+  /**
+   * Whether the datagram was longer than the space available to receive it,
+   * in which case [data] holds only its start.
+   */
+  @Since("2.9")
+  bool truncated;
+
+  Datagram(this.data, this.address, this.port, [this.truncated = false]);
 }
 
 /**
@@ -1027,6 +1121,32 @@ abstract class RawDatagramSocket extends Stream<RawSocketEvent> {
    */
   Datagram? receive();
 
+  /**
+   * Receive up to [maxDatagrams] datagrams at once.
+   *
+   * Returns the datagrams which are available, which may be none. On Linux
+   * they are read with a single system call, and datagrams which the kernel
+   * coalesced because `UDP_GRO` is enabled on the socket are split again.
+   *
+   * [maxDatagrams] must be between 1 and 64. Datagrams up to the largest
+   * size the socket accepts are received in full; longer ones are cut off
+   * and marked [Datagram.truncated].
+   *
+   * The [Datagram.data] of the returned datagrams are views into a buffer
+   * which the socket reuses, and are only valid until the next call to
+   * [receiveBatch]. Copy them to keep them longer.
+   */
+  List<Datagram> receiveBatch([int maxDatagrams = 8]);
+
+  /**
+   * Send [datagrams], each to its [Datagram.address] and [Datagram.port].
+   *
+   * Returns the number of datagrams sent, which may be less than the length
+   * of [datagrams]. At most 64 datagrams are sent per call. On Linux they
+   * are sent with a single system call.
+   */
+  int sendBatch(List<Datagram> datagrams);
+
   /**
    * Join a multicast group.
    *
@@ -0,0 +1,17 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:io';
+
+main() async {
+  // More than the 1MB that is buffered, so that printing waits for the
+  // buffer to drain.
+  for (var i = 0; i < 20000; i++) {
+    print('$i ${'=' * 100}');
+  }
+  stderr.writeln('done');
+  await stderr.flush();
+  // The output still buffered is written out before exiting.
+  exit(0);
+}
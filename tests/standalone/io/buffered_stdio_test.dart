@@ -0,0 +1,36 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// OtherResources=buffered_stdio_script.dart
+
+// Tests that with --buffered-stdio all output is written, in order, when a
+// script prints more than fits in the buffer and exits right after.
+
+import 'dart:io';
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+void main() {
+  asyncStart();
+  Process.run(
+          Platform.executable,
+          []
+            ..addAll(Platform.executableArguments)
+            ..add('--buffered-stdio')
+            ..add(Platform.script
+                .resolve('buffered_stdio_script.dart')
+                .toFilePath()))
+      .then((result) {
+    Expect.equals(0, result.exitCode);
+    var lines = result.stdout.split('\n');
+    Expect.equals(20001, lines.length);
+    for (var i = 0; i < 20000; i++) {
+      Expect.equals('$i ${'=' * 100}', lines[i]);
+    }
+    Expect.equals('', lines.last);
+    Expect.equals('done\n', result.stderr);
+    asyncEnd();
+  });
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:io Directory.walk().
+
+import 'dart:async';
+import 'dart:io';
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+import "package:path/path.dart";
+
+Future<Directory> createTree() async {
+  var directory = await Directory.systemTemp.createTemp('dart_directory_walk');
+  for (var name in ["a", "b", "c", "skip"]) {
+    for (int i = 0; i < 4; i++) {
+      var subdirectory = new Directory(join(directory.path, name, "sub$i"));
+      await subdirectory.create(recursive: true);
+      for (int j = 0; j < 50; j++) {
+        await new File(join(subdirectory.path, "file$j.txt")).create();
+      }
+      await new File(join(subdirectory.path, "main.dart")).create();
+    }
+  }
+  return directory;
+}
+
+Future testWalkAll(Directory directory) async {
+  var expected = new Set<String>();
+  await for (var entity
+      in directory.list(recursive: true, followLinks: false)) {
+    expected.add(entity.path);
+  }
+  for (int concurrency = 1; concurrency <= 8; concurrency *= 2) {
+    var walked = new Set<String>();
+    await for (var entity
+        in Directory.walk(directory.path, concurrency: concurrency)) {
+      Expect.isTrue(walked.add(entity.path));
+      Expect.equals(
+          entity is Directory, FileSystemEntity.isDirectorySync(entity.path));
+    }
+    Expect.setEquals(expected, walked);
+  }
+}
+
+Future testWalkFiltered(Directory directory) async {
+  var walked = await Directory.walk(directory.path,
+      include: ["*.txt", "*.dart"],
+      exclude: ["skip", "sub[!1-2]", "file?.txt"]).map((e) => e.path).toSet();
+  var expected = new Set<String>();
+  for (var name in ["a", "b", "c"]) {
+    for (int i = 1; i <= 2; i++) {
+      var subdirectory = join(directory.path, name, "sub$i");
+      for (int j = 10; j < 50; j++) {
+        expected.add(join(subdirectory, "file$j.txt"));
+      }
+      expected.add(join(subdirectory, "main.dart"));
+    }
+  }
+  Expect.setEquals(expected, walked);
+}
+
+class WalkOverrides extends IOOverrides {}
+
+Future testWalkFilteredOverridden(Directory directory) async {
+  // Under IOOverrides the walk falls back to Directory.list, and must filter
+  // with the same glob semantics as the native walker.
+  var patterns = [
+    ["*.txt"],
+    ["sub[!1-2]", "file?.txt"],
+    ["[a-b]", "*[0-9][0-9].txt"],
+    ["file[13579]*", "*.dart"],
+  ];
+  for (var include in patterns) {
+    for (var exclude in patterns) {
+      var native = await Directory.walk(directory.path,
+          include: include, exclude: exclude).map((e) => e.path).toSet();
+      var overridden = await IOOverrides.runWithIOOverrides(
+          () => Directory.walk(directory.path,
+              include: include, exclude: exclude).map((e) => e.path).toSet(),
+          new WalkOverrides());
+      Expect.setEquals(native, overridden, "include $include exclude $exclude");
+    }
+  }
+}
+
+Future testWalkCancel(Directory directory) async {
+  var first = await Directory.walk(directory.path).take(10).toList();
+  Expect.equals(10, first.length);
+}
+
+Future testWalkPause(Directory directory) async {
+  var count = 0;
+  var completer = new Completer();
+  late StreamSubscription subscription;
+  subscription = Directory.walk(directory.path).listen((entity) {
+    if (++count % 100 == 0) {
+      subscription.pause(new Future.delayed(const Duration(milliseconds: 1)));
+    }
+  }, onDone: completer.complete);
+  await completer.future;
+  Expect.equals(4 * (1 + 4 * (1 + 51)), count);
+}
+
+Future testWalkNonExistent(Directory directory) async {
+  var missing = join(directory.path, "missing");
+  var errors = [];
+  await for (var entity in Directory.walk(missing).handleError(errors.add)) {
+    Expect.fail("Unexpected entity $entity");
+  }
+  Expect.equals(1, errors.length);
+  Expect.isTrue(errors[0] is FileSystemException);
+  Expect.throws(() => Directory.walk(directory.path, concurrency: 0),
+      (e) => e is RangeError);
+}
+
+main() async {
+  asyncStart();
+  var directory = await createTree();
+  await testWalkAll(directory);
+  await testWalkFiltered(directory);
+  await testWalkFilteredOverridden(directory);
+  await testWalkCancel(directory);
+  await testWalkPause(directory);
+  await testWalkNonExistent(directory);
+  await directory.delete(recursive: true);
+  asyncEnd();
+}
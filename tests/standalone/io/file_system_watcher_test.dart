@@ -4,6 +4,7 @@
 
 // VMOptions=--enable-isolate-groups
 // VMOptions=--no-enable-isolate-groups
+// VMOptions=--file-watcher-coalescing=100
 
 import "dart:async";
 import "dart:io";
@@ -223,12 +224,36 @@ void testMultipleEvents() {
   file2.deleteSync();
 }
 
+void testCreateThenModify() {
+  // On Linux a modification queued behind the create of the same file may be
+  // merged into it, and must still be reported after the create.
+  if (!Platform.isLinux) return;
+  var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
+  var file = new File(join(dir.path, 'file'));
+
+  var watcher = dir.watch();
+
+  asyncStart();
+  var types = [];
+  var sub;
+  sub = watcher.listen((event) {
+    types.add(event.type);
+    if (event.type == FileSystemEvent.modify) {
+      Expect.equals(FileSystemEvent.create, types.first);
+      sub.cancel();
+      asyncEnd();
+      dir.deleteSync(recursive: true);
+    }
+  }, onError: (e) {
+    dir.deleteSync(recursive: true);
+    throw e;
+  });
+
+  file.writeAsStringSync('a');
+}
+
 void testWatchRecursive() {
   var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
-  if (Platform.isLinux) {
-    Expect.throws(() => dir.watch(recursive: true));
-    return;
-  }
   var dir2 = new Directory(join(dir.path, 'dir'));
   dir2.createSync();
   var file = new File(join(dir.path, 'dir/file'));
@@ -251,6 +276,29 @@ void testWatchRecursive() {
   file.createSync();
 }
 
+void testWatchRecursiveNewDir() {
+  var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
+  var file = new File(join(dir.path, 'dir/subdir/file'));
+
+  var watcher = dir.watch(recursive: true);
+
+  asyncStart();
+  var sub;
+  sub = watcher.listen((event) {
+    if (event.path.endsWith('file')) {
+      sub.cancel();
+      asyncEnd();
+      dir.deleteSync(recursive: true);
+    }
+  }, onError: (e) {
+    dir.deleteSync(recursive: true);
+    throw e;
+  });
+
+  // The file may be created before the new directories are watched.
+  file.createSync(recursive: true);
+}
+
 void testWatchNonRecursive() {
   var dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
   var dir2 = new Directory(join(dir.path, 'dir'));
@@ -472,6 +520,9 @@ void main() {
   testWatchDeleteDir();
   testWatchOnlyModifyFile();
   testMultipleEvents();
+  testCreateThenModify();
+  testWatchRecursive();
+  testWatchRecursiveNewDir();
   testWatchNonRecursive();
   testWatchNonExisting();
   testWatchMoveSelf();
@@ -0,0 +1,98 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests RandomAccessFile reads and writes issued in the same turn of the
+// event loop, which are submitted to the file I/O engine as one batch.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int fileCount = 300;
+const int chunkSize = 100000;
+
+Uint8List chunk(int seed) {
+  var bytes = new Uint8List(chunkSize);
+  for (int i = 0; i < bytes.length; i++) {
+    bytes[i] = (i * seed) & 0xff;
+  }
+  return bytes;
+}
+
+Future expectFileSystemException(Future future) async {
+  try {
+    await future;
+  } on FileSystemException {
+    return;
+  }
+  Expect.fail("Expected a FileSystemException");
+}
+
+Future testBatch(Directory directory) async {
+  // More files than the io_uring has entries, so that some of the requests
+  // are left to the worker threads.
+  var files = <RandomAccessFile>[];
+  for (int i = 0; i < fileCount; i++) {
+    var file = new File("${directory.path}/$i");
+    files.add(await file.open(mode: FileMode.write));
+  }
+  await Future.wait([
+    for (int i = 0; i < fileCount; i++) files[i].writeFrom(chunk(i)),
+  ]);
+  // writeFrom accepts any list of ints.
+  await Future.wait([
+    for (int i = 0; i < fileCount; i++) files[i].writeFrom([1, 2, 3], 1),
+  ]);
+  await Future.wait([for (var file in files) file.setPosition(0)]);
+
+  var reads = await Future.wait([
+    for (int i = 0; i < fileCount; i++) files[i].read(chunkSize + 10),
+  ]);
+  for (int i = 0; i < fileCount; i++) {
+    var expected = chunk(i);
+    Expect.equals(chunkSize + 2, reads[i].length);
+    Expect.listEquals(expected, reads[i].sublist(0, chunkSize));
+    Expect.listEquals([2, 3], reads[i].sublist(chunkSize));
+  }
+
+  // Reading at the end of the file reads nothing.
+  var buffer = new Uint8List(10);
+  var counts = await Future.wait(
+      [for (var file in files) file.readInto(buffer, 2, 8)]);
+  Expect.isTrue(counts.every((count) => count == 0));
+  await Future.wait([for (var file in files) file.close()]);
+}
+
+Future testErrors(Directory directory) async {
+  var file = new File("${directory.path}/errors");
+  file.writeAsBytesSync([1, 2, 3]);
+
+  // Reading a file opened for writing only fails in the engine.
+  var raf = await file.open(mode: FileMode.writeOnly);
+  await expectFileSystemException(raf.read(3));
+  await raf.close();
+
+  // Writing a file opened for reading fails in the engine.
+  raf = await file.open();
+  await expectFileSystemException(raf.writeFrom([4, 5, 6]));
+  // A closed file fails before the request is queued.
+  await raf.close();
+  await expectFileSystemException(raf.read(3));
+  Expect.listEquals([1, 2, 3], file.readAsBytesSync());
+}
+
+main() {
+  asyncTest(() async {
+    var directory = Directory.systemTemp.createTempSync("dart_file_batch");
+    try {
+      await testBatch(directory);
+      await testErrors(directory);
+    } finally {
+      directory.deleteSync(recursive: true);
+    }
+  });
+}
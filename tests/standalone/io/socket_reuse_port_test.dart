@@ -0,0 +1,107 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--reuse-port-cpu-affinity
+//
+// Tests server sockets bound with reusePort, each of which gets its own
+// SO_REUSEPORT listening socket: the group spreads connections across its
+// members, and keeps working as members close.
+
+import 'dart:async';
+import 'dart:io';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+const int groupSize = 4;
+const int connectionCount = 40;
+
+// Connects [count] clients to [port], each of which expects the index of the
+// server socket that accepted it. Returns how many connections each server
+// socket accepted.
+Future<List<int>> connectClients(int port, int count) async {
+  var accepted = new List<int>.filled(groupSize, 0);
+  for (int i = 0; i < count; i++) {
+    var client = await Socket.connect(InternetAddress.loopbackIPv4, port);
+    var data = await client.fold<List<int>>(
+        <int>[], (previous, element) => previous..addAll(element));
+    Expect.equals(1, data.length);
+    accepted[data[0]]++;
+    client.destroy();
+  }
+  return accepted;
+}
+
+Future testGroup(int backlog) async {
+  var servers = <ServerSocket>[];
+  servers.add(await ServerSocket.bind(InternetAddress.loopbackIPv4, 0,
+      backlog: backlog, reusePort: true));
+  int port = servers[0].port;
+  for (int i = 1; i < groupSize; i++) {
+    var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, port,
+        backlog: backlog, reusePort: true);
+    Expect.equals(port, server.port);
+    servers.add(server);
+  }
+  for (int i = 0; i < groupSize; i++) {
+    servers[i].listen((socket) {
+      socket.add([i]);
+      socket.close();
+    });
+  }
+
+  var accepted = await connectClients(port, connectionCount);
+  Expect.equals(connectionCount, accepted.reduce((a, b) => a + b));
+  // The kernel picks the member by a hash of the connection, so the
+  // connections, which come from different ports, are spread across the
+  // group. With CPU affinity they may all be received by one CPU.
+  bool cpuAffinity =
+      Platform.executableArguments.contains('--reuse-port-cpu-affinity');
+  if ((Platform.isLinux || Platform.isAndroid) && !cpuAffinity) {
+    Expect.isTrue(accepted.where((count) => count > 0).length > 1,
+        "All connections went to one member: $accepted");
+  }
+
+  // The remaining members take all connections once the others close.
+  for (int i = 0; i < groupSize - 2; i++) {
+    await servers[i].close();
+  }
+  accepted = await connectClients(port, connectionCount);
+  Expect.equals(0, accepted[0] + accepted[1]);
+  Expect.equals(
+      connectionCount, accepted[groupSize - 2] + accepted[groupSize - 1]);
+  await servers[groupSize - 2].close();
+  accepted = await connectClients(port, connectionCount);
+  Expect.equals(connectionCount, accepted[groupSize - 1]);
+  await servers[groupSize - 1].close();
+
+  // The port can be bound again once the whole group has closed.
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, port,
+      shared: true);
+  Expect.equals(port, server.port);
+  await server.close();
+}
+
+Future testMismatchedFlags() async {
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0,
+      reusePort: true);
+  if (Platform.isLinux || Platform.isAndroid) {
+    // Sockets in a SO_REUSEPORT group cannot share a port with other ones.
+    try {
+      await ServerSocket.bind(InternetAddress.loopbackIPv4, server.port,
+          shared: true);
+      Expect.fail("Binding without reusePort should fail");
+    } on SocketException catch (_) {}
+  }
+  await server.close();
+}
+
+main() {
+  asyncTest(() async {
+    await testGroup(0);
+    await testGroup(1);
+    await testMismatchedFlags();
+  });
+}
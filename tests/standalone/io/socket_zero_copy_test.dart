@@ -0,0 +1,80 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--short_socket_write
+//
+// Tests SocketOption.zeroCopy.
+
+import "dart:async";
+import "dart:ffi";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int bufferSize = 1000000;
+
+final DynamicLibrary libc = DynamicLibrary.process();
+final Pointer<Uint8> Function(int) malloc = libc.lookupFunction<
+    Pointer<Uint8> Function(IntPtr), Pointer<Uint8> Function(int)>("malloc");
+final void Function(Pointer<Uint8>) free = libc.lookupFunction<
+    Void Function(Pointer<Uint8>), void Function(Pointer<Uint8>)>("free");
+
+Future testZeroCopy() async {
+  // Only external typed data is sent without copying.
+  var pointer = malloc(bufferSize);
+  var buffer = pointer.asTypedList(bufferSize);
+  for (int i = 0; i < buffer.length; i++) {
+    buffer[i] = (i * 7) & 0xff;
+  }
+
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  var received = server.first.then((socket) => socket.fold<BytesBuilder>(
+      new BytesBuilder(), (builder, data) => builder..add(data)));
+  var client = await Socket.connect(server.address, server.port);
+  Expect.isFalse(client.getOption(SocketOption.zeroCopy));
+  bool enabled = client.setOption(SocketOption.zeroCopy, true);
+  if (!Platform.isLinux) Expect.isFalse(enabled);
+  Expect.equals(enabled, client.getOption(SocketOption.zeroCopy));
+
+  client.add([1, 2, 3]);
+  client.add(buffer);
+  client.add(buffer);
+  client.add([4, 5, 6]);
+  // The close completes only after the kernel is done with the buffer.
+  await client.close();
+  free(pointer);
+
+  var bytes = (await received).takeBytes();
+  Expect.equals(2 * bufferSize + 6, bytes.length);
+  Expect.listEquals([1, 2, 3], bytes.sublist(0, 3));
+  for (int i = 0; i < 2 * bufferSize; i++) {
+    Expect.equals(((i % bufferSize) * 7) & 0xff, bytes[3 + i]);
+  }
+  Expect.listEquals([4, 5, 6], bytes.sublist(bytes.length - 3));
+  await server.close();
+}
+
+Future testDisable() async {
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  var received = server.first.then((socket) => socket.fold<int>(
+      0, (length, data) => length + data.length));
+  var client = await Socket.connect(server.address, server.port);
+  client.setOption(SocketOption.zeroCopy, true);
+  Expect.isTrue(client.setOption(SocketOption.zeroCopy, false));
+  Expect.isFalse(client.getOption(SocketOption.zeroCopy));
+  client.add(new Uint8List(bufferSize));
+  await client.close();
+  Expect.equals(bufferSize, await received);
+  await server.close();
+}
+
+main() {
+  asyncTest(() async {
+    await testZeroCopy();
+    await testDisable();
+  });
+}
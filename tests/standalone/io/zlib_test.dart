@@ -245,6 +245,44 @@ void testZlibWithDictionary() {
   });
 }
 
+void testZlibParallel() {
+  // Large enough to be split into many blocks, with matches across blocks.
+  var data = new Uint8List(3 * 1024 * 1024 + 17);
+  for (int i = 0; i < data.length; i++) {
+    data[i] = (i * 7 + (i >> 12)) & 0xff;
+  }
+
+  [1, 6, 9].forEach((level) {
+    [false, true].forEach((gzip) {
+      var encoded = new ZLibEncoder(gzip: gzip, level: level, parallel: true)
+          .convert(data);
+      Expect.listEquals(data, new ZLibDecoder().convert(encoded));
+    });
+    var encoded =
+        new ZLibEncoder(level: level, raw: true, parallel: true).convert(data);
+    Expect.listEquals(data, new ZLibDecoder(raw: true).convert(encoded));
+  });
+  Expect.listEquals(
+      [], new ZLibDecoder().convert(new GZipCodec(parallel: true).encode([])));
+
+  asyncStart();
+  var controller = new StreamController<List<int>>(sync: true);
+  controller.stream
+      .transform(new GZipCodec(parallel: true).encoder)
+      .fold<List<int>>(<int>[], (buffer, chunk) {
+    buffer.addAll(chunk);
+    return buffer;
+  }).then((encoded) {
+    Expect.listEquals(data, gzip.decode(encoded));
+    asyncEnd();
+  });
+  for (int i = 0; i < data.length; i += 100000) {
+    int end = i + 100000 < data.length ? i + 100000 : data.length;
+    controller.add(data.sublist(i, end));
+  }
+  controller.close();
+}
+
 var generateListTypes = [
   (list) => list,
   (list) => new Uint8List.fromList(list),
@@ -287,5 +325,6 @@ void main() {
   testZlibInflateThrowsWithSmallerWindow();
   testZlibInflateWithLargerWindow();
   testZlibWithDictionary();
+  testZlibParallel();
   asyncEnd();
 }
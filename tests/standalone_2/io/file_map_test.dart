@@ -0,0 +1,63 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing RandomAccessFile.mapSync().
+
+import 'dart:io';
+import 'dart:typed_data';
+
+import "package:expect/expect.dart";
+import "package:path/path.dart";
+
+void testMap(Directory directory) {
+  var file = new File(join(directory.path, "file"));
+  var bytes = new Uint8List(100000);
+  for (int i = 0; i < bytes.length; i++) {
+    bytes[i] = i % 251;
+  }
+  file.writeAsBytesSync(bytes);
+  var raf = file.openSync();
+
+  var all = raf.mapSync();
+  Expect.listEquals(bytes, all);
+
+  // An unaligned position and an explicit length.
+  var part = raf.mapSync(
+      position: 4097, length: 1000, accessPattern: FileAccessPattern.random);
+  Expect.equals(1000, part.length);
+  Expect.listEquals(bytes.sublist(4097, 5097), part);
+
+  for (var pattern in [
+    FileAccessPattern.normal,
+    FileAccessPattern.sequential,
+    FileAccessPattern.willNeed
+  ]) {
+    Expect.listEquals(bytes.sublist(99000),
+        raf.mapSync(position: 99000, accessPattern: pattern));
+  }
+
+  var empty = raf.mapSync(position: bytes.length);
+  Expect.equals(0, empty.length);
+  Expect.throws(() => raf.mapSync(position: -1), (e) => e is RangeError);
+  Expect.throws(() => raf.mapSync(position: 1, length: bytes.length),
+      (e) => e is RangeError);
+
+  // The mapped lists are read-only.
+  Expect.throws(() => all[0] = 1, (e) => e is UnsupportedError);
+  Expect.throws(() => empty.setRange(0, 0, []), (e) => e is UnsupportedError);
+
+  // The mapping outlives the file.
+  raf.closeSync();
+  Expect.equals(bytes[12345], all[12345]);
+  Expect.throws(() => raf.mapSync(), (e) => e is FileSystemException);
+}
+
+void main() {
+  var directory = Directory.systemTemp.createTempSync('dart_file_map');
+  try {
+    testMap(directory);
+  } finally {
+    directory.deleteSync(recursive: true);
+  }
+}
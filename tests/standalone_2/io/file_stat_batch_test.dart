@@ -0,0 +1,65 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:io FileStat.statAll() and
+// FileStat.listWithStat().
+
+import 'dart:async';
+import 'dart:io';
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+import "package:path/path.dart";
+
+Future testStatAll() async {
+  var directory = await Directory.systemTemp.createTemp('dart_file_stat');
+  var file = new File(join(directory.path, "file"));
+  await file.writeAsString("Dart IO library test of FileStat");
+  var missing = join(directory.path, "missing");
+  var stats = await FileStat.statAll([file.path, missing, directory.path]);
+  Expect.equals(3, stats.length);
+  Expect.equals(FileSystemEntityType.file, stats[0].type);
+  Expect.equals(32, stats[0].size);
+  Expect.equals(file.statSync().modified, stats[0].modified);
+  Expect.equals(FileSystemEntityType.notFound, stats[1].type);
+  Expect.equals(FileSystemEntityType.directory, stats[2].type);
+  Expect.equals(0, (await FileStat.statAll([])).length);
+  await directory.delete(recursive: true);
+}
+
+Future testListWithStat() async {
+  var directory = await Directory.systemTemp.createTemp('dart_file_stat');
+  var subdirectory = new Directory(join(directory.path, "subdirectory"));
+  await subdirectory.create();
+  var names = <String>[];
+  for (int i = 0; i < 1000; i++) {
+    var file = new File(join(subdirectory.path, "file$i"));
+    await file.writeAsString("x" * (i % 10));
+    names.add(file.path);
+  }
+  var listed = <String, FileStat>{};
+  await for (var entry
+      in FileStat.listWithStat(directory.path, recursive: true)) {
+    var stat = await entry.key.stat();
+    Expect.equals(stat.type, entry.value.type);
+    Expect.equals(stat.size, entry.value.size);
+    Expect.equals(stat.modified, entry.value.modified);
+    listed[entry.key.path] = entry.value;
+  }
+  Expect.equals(names.length + 1, listed.length);
+  Expect.equals(FileSystemEntityType.directory, listed[subdirectory.path].type);
+  for (int i = 0; i < names.length; i++) {
+    Expect.isTrue(listed[names[i]] != null);
+    Expect.equals(FileSystemEntityType.file, listed[names[i]].type);
+    Expect.equals(i % 10, listed[names[i]].size);
+  }
+  await directory.delete(recursive: true);
+}
+
+main() async {
+  asyncStart();
+  await testStatAll();
+  await testListWithStat();
+  asyncEnd();
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests the cache of InternetAddress.lookup results. The statistics are
+// process wide, so the tests run one after the other.
+
+import "dart:async";
+import "dart:io";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+List<String> addressesOf(List<InternetAddress> addresses) =>
+    addresses.map((address) => address.address).toList();
+
+void expectStatistics(Map<String, int> before,
+    {int hits: 0, int misses: 0, int entries}) {
+  var after = InternetAddress.lookupCacheStatistics;
+  Expect.equals(before["hits"] + hits, after["hits"], "hits");
+  Expect.equals(before["misses"] + misses, after["misses"], "misses");
+  Expect.equals(entries, after["entries"], "entries");
+}
+
+Future testDisabledByDefault() async {
+  var before = InternetAddress.lookupCacheStatistics;
+  var first = await InternetAddress.lookup("localhost");
+  var second = await InternetAddress.lookup("localhost");
+  Expect.listEquals(addressesOf(first), addressesOf(second));
+  expectStatistics(before, misses: 2, entries: 0);
+}
+
+Future testHitsMissesAndExpiry() async {
+  InternetAddress.configureLookupCache(
+      maxEntries: 4,
+      ttl: const Duration(milliseconds: 500),
+      negativeTtl: Duration.zero);
+  var before = InternetAddress.lookupCacheStatistics;
+  Expect.equals(0, before["entries"]);
+
+  var first = await InternetAddress.lookup("localhost");
+  Expect.isTrue(first.isNotEmpty);
+  expectStatistics(before, misses: 1, entries: 1);
+
+  var second = await InternetAddress.lookup("localhost");
+  Expect.listEquals(addressesOf(first), addressesOf(second));
+  Expect.equals("localhost", second.first.host);
+  expectStatistics(before, hits: 1, misses: 1, entries: 1);
+
+  // Each address type has its own entry.
+  await InternetAddress.lookup("localhost", type: InternetAddressType.IPv4);
+  expectStatistics(before, hits: 1, misses: 2, entries: 2);
+
+  await new Future.delayed(const Duration(milliseconds: 600));
+  var expired = await InternetAddress.lookup("localhost");
+  Expect.listEquals(addressesOf(first), addressesOf(expired));
+  expectStatistics(before, hits: 1, misses: 3, entries: 2);
+
+  InternetAddress.configureLookupCache(maxEntries: 0);
+  expectStatistics(before, hits: 1, misses: 3, entries: 0);
+}
+
+Future testConcurrentLookup() async {
+  var before = InternetAddress.lookupCacheStatistics;
+  var results = await Future.wait(
+      new List.generate(8, (_) => InternetAddress.lookup("localhost")));
+  var expected = addressesOf(results.first);
+  for (var addresses in results) {
+    Expect.listEquals(expected, addressesOf(addresses));
+    Expect.equals("localhost", addresses.first.host);
+  }
+  // Every lookup either called the resolver or shared a call in progress.
+  var after = InternetAddress.lookupCacheStatistics;
+  Expect.equals(before["misses"] + before["coalesced"] + 8,
+      after["misses"] + after["coalesced"]);
+  Expect.equals(before["hits"], after["hits"]);
+  Expect.equals(0, after["entries"]);
+}
+
+void main() {
+  asyncTest(() async {
+    await testDisabledByDefault();
+    await testHitsMissesAndExpiry();
+    await testConcurrentLookup();
+  });
+}
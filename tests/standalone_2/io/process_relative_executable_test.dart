@@ -0,0 +1,57 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests that a relative executable path is resolved against the working
+// directory the process is started in.
+
+import "dart:async";
+import "dart:convert";
+import "dart:io";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+Future<String> runRelative(
+    String executable, String workingDirectory, ProcessStartMode mode) async {
+  var process = await Process.start(executable, ["argument"],
+      workingDirectory: workingDirectory, mode: mode);
+  var output = await process.stdout.transform(utf8.decoder).join();
+  if (mode == ProcessStartMode.normal) {
+    await process.stderr.drain();
+    Expect.equals(0, await process.exitCode);
+  }
+  return output;
+}
+
+main() {
+  if (Platform.isWindows) return;
+  asyncTest(() async {
+    var directory =
+        Directory.systemTemp.createTempSync("dart_process_relative");
+    try {
+      new Directory("${directory.path}/bin").createSync();
+      var script = new File("${directory.path}/bin/script.sh");
+      script.writeAsStringSync("#!/bin/sh\necho \"\$(pwd -P) \$1\"\n");
+      var chmod = Process.runSync("chmod", ["+x", script.path]);
+      Expect.equals(0, chmod.exitCode);
+      // The executable does not exist relative to the current directory.
+      Expect.isFalse(new File("bin/script.sh").existsSync());
+
+      var root = directory.resolveSymbolicLinksSync();
+      for (var mode in [
+        ProcessStartMode.normal,
+        ProcessStartMode.detachedWithStdio
+      ]) {
+        Expect.equals("$root argument\n",
+            await runRelative("bin/script.sh", directory.path, mode));
+        Expect.equals("$root argument\n",
+            await runRelative("./bin/script.sh", directory.path, mode));
+        Expect.equals("$root/bin argument\n",
+            await runRelative("../bin/script.sh", script.parent.path, mode));
+      }
+    } finally {
+      directory.deleteSync(recursive: true);
+    }
+  });
+}
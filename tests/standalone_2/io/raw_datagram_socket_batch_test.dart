@@ -0,0 +1,113 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests RawDatagramSocket.receiveBatch and RawDatagramSocket.sendBatch.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int datagramCount = 20;
+
+Uint8List datagramData(int i) {
+  // Includes an empty datagram.
+  var data = new Uint8List(i * 50);
+  for (int j = 0; j < data.length; j++) {
+    data[j] = (i + j) & 0xff;
+  }
+  return data;
+}
+
+Future testSendAndReceive(InternetAddress address) async {
+  var sender = await RawDatagramSocket.bind(address, 0);
+  var receiver = await RawDatagramSocket.bind(address, 0);
+  var received = <Datagram>[];
+  var completer = new Completer();
+  receiver.listen((event) {
+    if (event != RawSocketEvent.read) return;
+    var batch = receiver.receiveBatch(8);
+    Expect.isTrue(batch.length <= 8);
+    for (var datagram in batch) {
+      Expect.isFalse(datagram.truncated);
+      // The data is a view into the buffer of the socket, which the next
+      // call to receiveBatch overwrites.
+      Expect.identical(batch.first.data.buffer, datagram.data.buffer);
+      received.add(new Datagram(new Uint8List.fromList(datagram.data),
+          datagram.address, datagram.port));
+    }
+    if (received.length == datagramCount) completer.complete();
+  });
+
+  var datagrams = <Datagram>[];
+  for (int i = 0; i < datagramCount; i++) {
+    datagrams.add(new Datagram(datagramData(i), address, receiver.port));
+  }
+  int sent = 0;
+  while (sent < datagrams.length) {
+    sent += sender.sendBatch(datagrams.sublist(sent));
+  }
+  await completer.future;
+
+  for (int i = 0; i < datagramCount; i++) {
+    Expect.listEquals(datagramData(i), received[i].data);
+    Expect.equals(address, received[i].address);
+    Expect.equals(sender.port, received[i].port);
+  }
+  sender.close();
+  receiver.close();
+}
+
+Future testLargeDatagram(InternetAddress address) async {
+  var sender = await RawDatagramSocket.bind(address, 0);
+  var receiver = await RawDatagramSocket.bind(address, 0);
+  var data = new Uint8List(60000);
+  for (int i = 0; i < data.length; i++) {
+    data[i] = i & 0xff;
+  }
+  var completer = new Completer<Datagram>();
+  receiver.listen((event) {
+    if (event != RawSocketEvent.read) return;
+    var batch = receiver.receiveBatch(2);
+    if (batch.isNotEmpty) completer.complete(batch.first);
+  });
+  Expect.equals(data.length, sender.send(data, address, receiver.port));
+  var datagram = await completer.future;
+  Expect.isFalse(datagram.truncated);
+  Expect.listEquals(data, datagram.data);
+  sender.close();
+  receiver.close();
+}
+
+Future testArguments() async {
+  var socket = await RawDatagramSocket.bind(InternetAddress.loopbackIPv4, 0);
+  Expect.throws(() => socket.receiveBatch(0), (e) => e is RangeError);
+  Expect.throws(() => socket.receiveBatch(65), (e) => e is RangeError);
+  Expect.equals(0, socket.receiveBatch().length);
+  Expect.equals(0, socket.sendBatch(<Datagram>[]));
+  Expect.throws(
+      () => socket.sendBatch(<Datagram>[
+            new Datagram(
+                new Uint8List(1), InternetAddress.loopbackIPv4, 0x10000)
+          ]),
+      (e) => e is ArgumentError);
+
+  // At most 64 datagrams are sent per call.
+  var datagrams = new List<Datagram>.generate(
+      100,
+      (i) => new Datagram(
+          new Uint8List(1), InternetAddress.loopbackIPv4, socket.port));
+  Expect.equals(64, socket.sendBatch(datagrams));
+  socket.close();
+}
+
+main() {
+  asyncTest(() async {
+    await testSendAndReceive(InternetAddress.loopbackIPv4);
+    await testLargeDatagram(InternetAddress.loopbackIPv4);
+    await testArguments();
+  });
+}
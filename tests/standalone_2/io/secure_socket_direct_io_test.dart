@@ -0,0 +1,112 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--short_socket_read
+// VMOptions=--short_socket_write
+// VMOptions=--short_socket_read --short_socket_write
+// OtherResources=certificates/server_chain.pem
+// OtherResources=certificates/server_key.pem
+// OtherResources=certificates/trusted_certs.pem
+//
+// Tests secure sockets once they are connected, when the filter reads and
+// writes the encrypted data on the socket itself, including closing the
+// socket while a filter request is using it.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+String localFile(path) => Platform.script.resolve(path).toFilePath();
+
+final SecurityContext serverContext = new SecurityContext()
+  ..useCertificateChain(localFile('certificates/server_chain.pem'))
+  ..usePrivateKey(localFile('certificates/server_key.pem'),
+      password: 'dartdart');
+
+final SecurityContext clientContext = new SecurityContext()
+  ..setTrustedCertificates(localFile('certificates/trusted_certs.pem'));
+
+const int dataSize = 4 * 1024 * 1024;
+
+Uint8List makeData() {
+  var data = new Uint8List(dataSize);
+  for (int i = 0; i < data.length; i++) {
+    data[i] = (i * 13) & 0xff;
+  }
+  return data;
+}
+
+Future testEcho() async {
+  var server = await SecureServerSocket.bind("localhost", 0, serverContext);
+  server.listen((socket) {
+    socket.cast<List<int>>().pipe(socket);
+  });
+  var client = await SecureSocket.connect("localhost", server.port,
+      context: clientContext);
+  var data = makeData();
+  var received = client.fold<BytesBuilder>(
+      new BytesBuilder(), (builder, chunk) => builder..add(chunk));
+  // Write in pieces so that reads and writes interleave.
+  for (int i = 0; i < dataSize; i += 100000) {
+    client.add(new Uint8List.view(
+        data.buffer, i, i + 100000 > dataSize ? dataSize - i : 100000));
+  }
+  await client.close();
+  var echoed = (await received).takeBytes();
+  Expect.equals(dataSize, echoed.length);
+  for (int i = 0; i < dataSize; i++) {
+    if (echoed[i] != data[i]) Expect.fail("Mismatch at $i");
+  }
+  await server.close();
+}
+
+// Closes the client while the filter is busy reading the data sent by the
+// server, and the server while it is busy writing.
+Future testCloseDuringIO(bool destroy) async {
+  var server = await SecureServerSocket.bind("localhost", 0, serverContext);
+  var serverDone = new Completer();
+  server.listen((socket) {
+    socket.add(makeData());
+    socket.close().then((_) {}, onError: (_) {}).whenComplete(() {
+      socket.destroy();
+      serverDone.complete();
+    });
+    socket.listen((_) {}, onError: (_) {});
+  });
+  var client = await SecureSocket.connect("localhost", server.port,
+      context: clientContext);
+  var closed = new Completer();
+  int received = 0;
+  client.listen((data) {
+    received += data.length;
+    if (received > 0 && !closed.isCompleted) {
+      closed.complete();
+      if (destroy) {
+        client.destroy();
+      } else {
+        client.close();
+      }
+    }
+  }, onError: (_) {}, onDone: () {
+    if (!closed.isCompleted) closed.complete();
+  });
+  await closed.future;
+  await client.done.catchError((_) {});
+  await serverDone.future;
+  await server.close();
+}
+
+main() {
+  asyncTest(() async {
+    await testEcho();
+    for (int i = 0; i < 10; i++) {
+      await testCloseDuringIO(false);
+      await testCloseDuringIO(true);
+    }
+  });
+}
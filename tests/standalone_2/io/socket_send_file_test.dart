@@ -0,0 +1,120 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--short_socket_write
+//
+// Tests Socket.sendFile.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int fileSize = 1000000;
+
+Future testSendFile(Directory directory) async {
+  var bytes = new Uint8List(fileSize);
+  for (int i = 0; i < bytes.length; i++) {
+    bytes[i] = (i * 7) & 0xff;
+  }
+  var file = new File("${directory.path}/file");
+  file.writeAsBytesSync(bytes);
+  var raf = await file.open();
+  await raf.setPosition(7);
+
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  var received = server.first.then((socket) => socket.fold<BytesBuilder>(
+      new BytesBuilder(), (builder, data) => builder..add(data)));
+  var client = await Socket.connect(server.address, server.port);
+
+  // Data added before is sent first.
+  client.add([1, 2, 3]);
+  Expect.equals(500000, await client.sendFile(raf, 1000, 500000));
+  Expect.equals(fileSize, await client.sendFile(raf));
+  Expect.equals(0, await client.sendFile(raf, fileSize, 0));
+  client.add([4, 5, 6]);
+  await client.close();
+
+  var expected = new BytesBuilder()
+    ..add([1, 2, 3])
+    ..add(bytes.sublist(1000, 501000))
+    ..add(bytes)
+    ..add([4, 5, 6]);
+  Expect.listEquals(expected.takeBytes(), (await received).takeBytes());
+
+  // The position of the file is left alone.
+  Expect.equals(7, await raf.position());
+  await raf.close();
+  client.destroy();
+  await server.close();
+}
+
+Future expectRangeError(Future<int> result) async {
+  try {
+    await result;
+  } on RangeError {
+    return;
+  }
+  Expect.fail("Expected a RangeError");
+}
+
+Future testArguments(Directory directory) async {
+  var file = new File("${directory.path}/small");
+  file.writeAsBytesSync([1, 2, 3]);
+  var raf = await file.open();
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  server.listen((socket) => socket.drain());
+  var client = await Socket.connect(server.address, server.port);
+
+  await expectRangeError(client.sendFile(raf, -1));
+  await expectRangeError(client.sendFile(raf, 0, -1));
+  await expectRangeError(client.sendFile(raf, 4));
+
+  await raf.close();
+  client.destroy();
+  await server.close();
+}
+
+Future testDestroyWhileSending(Directory directory) async {
+  // More than the socket buffers hold, so the send waits for the peer, which
+  // does not read.
+  const int largeFileSize = 32 * 1024 * 1024;
+  var file = new File("${directory.path}/large");
+  file.writeAsBytesSync(new Uint8List(largeFileSize));
+  var raf = await file.open();
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  var accepted = server.first;
+  var client = await Socket.connect(server.address, server.port);
+  var peer = await accepted;
+
+  var sent = client.sendFile(raf);
+  await new Future.delayed(const Duration(milliseconds: 100));
+  client.destroy();
+  try {
+    await sent;
+    Expect.fail("Expected a SocketException");
+  } on SocketException {}
+
+  // The file can be used again once the send has failed.
+  Expect.equals(largeFileSize, await raf.length());
+  await raf.close();
+  peer.destroy();
+  await server.close();
+}
+
+main() {
+  asyncTest(() async {
+    var directory = Directory.systemTemp.createTempSync('dart_send_file');
+    try {
+      await testSendFile(directory);
+      await testArguments(directory);
+      await testDestroyWhileSending(directory);
+    } finally {
+      directory.deleteSync(recursive: true);
+    }
+  });
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--short_socket_read
+// VMOptions=--short_socket_write
+// VMOptions=--short_socket_read --short_socket_write
+//
+// Tests that many chunks added to a Socket, which queue up while the socket
+// is not writable and are then flushed with gathering writes, arrive intact
+// and in order.
+
+import "dart:async";
+import "dart:io";
+import "dart:typed_data";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int chunkCount = 2000;
+
+// Chunks of varying length, including empty ones, alternating between
+// typed data and plain lists, which are copied before they are written.
+List<List<int>> makeChunks() {
+  var chunks = <List<int>>[];
+  int value = 0;
+  for (int i = 0; i < chunkCount; i++) {
+    int length = (i * 37) % 3001;
+    List<int> chunk =
+        (i % 3 == 0) ? new List<int>.filled(length, 0) : new Uint8List(length);
+    for (int j = 0; j < length; j++) {
+      chunk[j] = value++ & 0xff;
+    }
+    chunks.add(chunk);
+  }
+  return chunks;
+}
+
+Future testManyChunks() async {
+  var chunks = makeChunks();
+  var expected = new BytesBuilder();
+  chunks.forEach(expected.add);
+
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  var received = server.first.then((socket) => socket.fold<BytesBuilder>(
+      new BytesBuilder(), (builder, data) => builder..add(data)));
+  var client = await Socket.connect(server.address, server.port);
+  chunks.forEach(client.add);
+  await client.close();
+  Expect.listEquals(expected.takeBytes(), (await received).takeBytes());
+  client.destroy();
+  await server.close();
+}
+
+Future testAddStream() async {
+  var chunks = makeChunks();
+  var expected = new BytesBuilder();
+  chunks.forEach(expected.add);
+
+  var server = await ServerSocket.bind(InternetAddress.loopbackIPv4, 0);
+  var received = server.first.then((socket) => socket.fold<BytesBuilder>(
+      new BytesBuilder(), (builder, data) => builder..add(data)));
+  var client = await Socket.connect(server.address, server.port);
+  // The stream ends while chunks are still queued in the socket.
+  await client.addStream(new Stream<List<int>>.fromIterable(chunks));
+  await client.close();
+  Expect.listEquals(expected.takeBytes(), (await received).takeBytes());
+  client.destroy();
+  await server.close();
+}
+
+main() {
+  asyncTest(() async {
+    await testManyChunks();
+    await testAddStream();
+  });
+}
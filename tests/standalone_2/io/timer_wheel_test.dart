@@ -0,0 +1,91 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--timer-wheel
+
+// Tests that timers of a second or more, which --timer-wheel keeps in the
+// native timer wheel, fire in order, not before their wakeup time, and not
+// after being canceled, also when they are armed after all others have been
+// canceled.
+
+import 'dart:async';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+void testOrder() {
+  asyncStart();
+  final watch = new Stopwatch()..start();
+  final fired = <int>[];
+  final durations = [1100, 1000, 1050, 1000, 10, 1200];
+  for (int i = 0; i < durations.length; i++) {
+    new Timer(new Duration(milliseconds: durations[i]), () {
+      Expect.isTrue(watch.elapsedMilliseconds >= durations[i]);
+      fired.add(i);
+      if (fired.length == durations.length) {
+        Expect.listEquals([4, 1, 3, 2, 0, 5], fired);
+        asyncEnd();
+      }
+    });
+  }
+}
+
+void testCancel() {
+  asyncStart();
+  final timers = <Timer>[];
+  for (int i = 0; i < 1000; i++) {
+    timers.add(new Timer(new Duration(milliseconds: 1000 + i), () {
+      Expect.fail('Canceled timer fired');
+    }));
+  }
+  for (final timer in timers) {
+    Expect.isTrue(timer.isActive);
+    timer.cancel();
+    Expect.isFalse(timer.isActive);
+  }
+  final kept = new Timer(const Duration(milliseconds: 1500), asyncEnd);
+  Expect.isTrue(kept.isActive);
+}
+
+// Runs while no other timers are pending, so that only the new timer can
+// wake the isolate up.
+void testArmAfterCancelingAll(void next()) {
+  asyncStart();
+  final timers = <Timer>[];
+  for (int i = 0; i < 10; i++) {
+    timers.add(new Timer(new Duration(milliseconds: 1000 + i), () {
+      Expect.fail('Canceled timer fired');
+    }));
+  }
+  for (final timer in timers) {
+    timer.cancel();
+  }
+  final watch = new Stopwatch()..start();
+  new Timer(const Duration(milliseconds: 2000), () {
+    Expect.isTrue(watch.elapsedMilliseconds >= 2000);
+    next();
+    asyncEnd();
+  });
+}
+
+void testPeriodic() {
+  asyncStart();
+  final watch = new Stopwatch()..start();
+  new Timer.periodic(const Duration(milliseconds: 1000), (Timer timer) {
+    Expect.isTrue(watch.elapsedMilliseconds >= 1000 * timer.tick);
+    if (timer.tick == 2) {
+      timer.cancel();
+      asyncEnd();
+    }
+  });
+}
+
+void main() {
+  testArmAfterCancelingAll(() {
+    testOrder();
+    testCancel();
+    testPeriodic();
+  });
+}